@@ -0,0 +1,249 @@
+// This file is part of the SgCityBuilder package.
+// 
+// Filename: Benchmark.cpp
+// Author:   stwe
+// 
+// License:  MIT
+// 
+// 2020 (c) stwe <https://github.com/stwe/SgCityBuilder>
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <numeric>
+#include <algorithm>
+#include <stdexcept>
+#include "Benchmark.h"
+#include "city/FrameArena.h"
+
+namespace
+{
+    std::string ReadString(const std::string& t_line, const std::string& t_key)
+    {
+        const auto key{ "\"" + t_key + "\": \"" };
+        const auto begin{ t_line.find(key) };
+        if (begin == std::string::npos)
+        {
+            return {};
+        }
+
+        const auto valueBegin{ begin + key.size() };
+
+        return t_line.substr(valueBegin, t_line.find('"', valueBegin) - valueBegin);
+    }
+
+    double ReadNumber(const std::string& t_line, const std::string& t_key)
+    {
+        const auto key{ "\"" + t_key + "\": " };
+        const auto begin{ t_line.find(key) };
+        if (begin == std::string::npos)
+        {
+            return 0.0;
+        }
+
+        return std::stod(t_line.substr(begin + key.size()));
+    }
+
+    bool IsSameBenchmark(const sg::city::benchmark::Result& t_lhs, const sg::city::benchmark::Result& t_rhs)
+    {
+        return t_lhs.name == t_rhs.name && t_lhs.mapSize == t_rhs.mapSize && t_lhs.count == t_rhs.count;
+    }
+}
+
+//-------------------------------------------------
+// Ctors. / Dtor.
+//-------------------------------------------------
+
+sg::city::benchmark::Runner::Runner(Options t_options)
+    : m_options{ std::move(t_options) }
+{
+}
+
+//-------------------------------------------------
+// Getter
+//-------------------------------------------------
+
+const sg::city::benchmark::Options& sg::city::benchmark::Runner::GetOptions() const noexcept
+{
+    return m_options;
+}
+
+const sg::city::benchmark::Runner::ResultContainer& sg::city::benchmark::Runner::GetResults() const noexcept
+{
+    return m_results;
+}
+
+bool sg::city::benchmark::Runner::IsEnabled(const std::string& t_name) const
+{
+    return m_options.filter.empty() || t_name.find(m_options.filter) != std::string::npos;
+}
+
+//-------------------------------------------------
+// Run
+//-------------------------------------------------
+
+void sg::city::benchmark::Runner::Run(const std::string& t_name, const int t_mapSize, const uint32_t t_count, const Function& t_setup, const Function& t_function)
+{
+    if (!IsEnabled(t_name))
+    {
+        return;
+    }
+
+    // warm-up
+    if (t_setup)
+    {
+        t_setup();
+    }
+    t_function();
+    memory::FrameArena::Get().Reset();
+
+    std::vector<double> times;
+    auto totalMs{ 0.0 };
+
+    while (times.size() < m_options.maxIterations &&
+          (times.size() < m_options.minIterations || totalMs < m_options.minTimeMs))
+    {
+        if (t_setup)
+        {
+            t_setup();
+        }
+
+        const auto start{ std::chrono::steady_clock::now() };
+        t_function();
+        const auto end{ std::chrono::steady_clock::now() };
+
+        const auto ms{ std::chrono::duration<double, std::milli>(end - start).count() };
+        times.push_back(ms);
+        totalMs += ms;
+
+        // an iteration is a frame
+        memory::FrameArena::Get().Reset();
+    }
+
+    std::sort(times.begin(), times.end());
+
+    Result result;
+    result.name = t_name;
+    result.mapSize = t_mapSize;
+    result.count = t_count;
+    result.iterations = static_cast<uint32_t>(times.size());
+    result.minMs = times.front();
+    result.medianMs = times[times.size() / 2];
+    result.meanMs = totalMs / static_cast<double>(times.size());
+    result.maxMs = times.back();
+
+    std::printf("%-32s size %5d count %7u | median %10.4f ms | min %10.4f ms | max %10.4f ms | %u it\n",
+        t_name.c_str(), t_mapSize, t_count, result.medianMs, result.minMs, result.maxMs, result.iterations);
+
+    m_results.push_back(result);
+}
+
+//-------------------------------------------------
+// Json
+//-------------------------------------------------
+
+void sg::city::benchmark::Runner::WriteJson(const std::string& t_fileName) const
+{
+    std::ofstream file{ t_fileName };
+    if (!file)
+    {
+        throw std::runtime_error("[Runner::WriteJson()] Unable to open " + t_fileName);
+    }
+
+    // one result per line, so that ReadJson() needs no Json library
+    file << "{\n";
+    file << "  \"version\": 1,\n";
+    file << "  \"results\": [\n";
+
+    for (auto i{ 0u }; i < m_results.size(); ++i)
+    {
+        const auto& result{ m_results[i] };
+
+        char line[512];
+        std::snprintf(line, sizeof(line),
+            "    { \"name\": \"%s\", \"mapSize\": %d, \"count\": %u, \"iterations\": %u, \"minMs\": %.6f, \"medianMs\": %.6f, \"meanMs\": %.6f, \"maxMs\": %.6f }%s\n",
+            result.name.c_str(), result.mapSize, result.count, result.iterations,
+            result.minMs, result.medianMs, result.meanMs, result.maxMs,
+            i + 1 < m_results.size() ? "," : ""
+        );
+
+        file << line;
+    }
+
+    file << "  ]\n";
+    file << "}\n";
+}
+
+sg::city::benchmark::Runner::ResultContainer sg::city::benchmark::Runner::ReadJson(const std::string& t_fileName)
+{
+    std::ifstream file{ t_fileName };
+    if (!file)
+    {
+        throw std::runtime_error("[Runner::ReadJson()] Unable to open " + t_fileName);
+    }
+
+    ResultContainer results;
+
+    std::string line;
+    while (std::getline(file, line))
+    {
+        if (line.find("\"name\"") == std::string::npos)
+        {
+            continue;
+        }
+
+        Result result;
+        result.name = ReadString(line, "name");
+        result.mapSize = static_cast<int>(ReadNumber(line, "mapSize"));
+        result.count = static_cast<uint32_t>(ReadNumber(line, "count"));
+        result.iterations = static_cast<uint32_t>(ReadNumber(line, "iterations"));
+        result.minMs = ReadNumber(line, "minMs");
+        result.medianMs = ReadNumber(line, "medianMs");
+        result.meanMs = ReadNumber(line, "meanMs");
+        result.maxMs = ReadNumber(line, "maxMs");
+
+        results.push_back(result);
+    }
+
+    return results;
+}
+
+//-------------------------------------------------
+// Baseline
+//-------------------------------------------------
+
+uint32_t sg::city::benchmark::Runner::CompareWithBaseline(const std::string& t_fileName) const
+{
+    const auto baseline{ ReadJson(t_fileName) };
+
+    auto regressions{ 0u };
+
+    std::printf("\nBaseline %s (threshold %.0f%%)\n", t_fileName.c_str(), m_options.threshold * 100.0);
+
+    for (const auto& result : m_results)
+    {
+        const auto it{ std::find_if(baseline.begin(), baseline.end(), [&result](const Result& t_baseline)
+        {
+            return IsSameBenchmark(result, t_baseline);
+        }) };
+
+        if (it == baseline.end() || it->medianMs <= 0.0)
+        {
+            std::printf("%-32s size %5d count %7u | new\n", result.name.c_str(), result.mapSize, result.count);
+            continue;
+        }
+
+        const auto change{ result.medianMs / it->medianMs - 1.0 };
+        const auto regression{ change > m_options.threshold };
+        if (regression)
+        {
+            regressions++;
+        }
+
+        std::printf("%-32s size %5d count %7u | %10.4f ms -> %10.4f ms | %+7.1f%%%s\n",
+            result.name.c_str(), result.mapSize, result.count, it->medianMs, result.medianMs, change * 100.0,
+            regression ? " REGRESSION" : "");
+    }
+
+    return regressions;
+}
@@ -0,0 +1,130 @@
+// This file is part of the SgCityBuilder package.
+// 
+// Filename: Benchmark.h
+// Author:   stwe
+// 
+// License:  MIT
+// 
+// 2020 (c) stwe <https://github.com/stwe/SgCityBuilder>
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <functional>
+
+namespace sg::city::benchmark
+{
+    struct Options
+    {
+        std::vector<int> mapSizes{ 64, 256, 1024 };
+        std::vector<uint32_t> carCounts{ 1000, 10000, 100000 };
+
+        std::string outFileName{ "benchmark.json" };
+        std::string baselineFileName;
+
+        /**
+         * @brief Only benchmarks whose name contains this string are run.
+         */
+        std::string filter;
+
+        /**
+         * @brief A median slower than the baseline by more than this fraction is a regression.
+         */
+        double threshold{ 0.1 };
+
+        uint32_t minIterations{ 3 };
+        uint32_t maxIterations{ 50 };
+
+        /**
+         * @brief The iterations are stopped after this time if minIterations are done.
+         */
+        double minTimeMs{ 250.0 };
+    };
+
+    struct Result
+    {
+        std::string name;
+        int mapSize{ 0 };
+        uint32_t count{ 0 };
+        uint32_t iterations{ 0 };
+        double minMs{ 0.0 };
+        double medianMs{ 0.0 };
+        double meanMs{ 0.0 };
+        double maxMs{ 0.0 };
+    };
+
+    /**
+     * @brief Measures the benchmarks, writes the results as Json and compares them with a baseline.
+     */
+    class Runner
+    {
+    public:
+        using Function = std::function<void()>;
+        using ResultContainer = std::vector<Result>;
+
+        //-------------------------------------------------
+        // Ctors. / Dtor.
+        //-------------------------------------------------
+
+        Runner() = delete;
+
+        explicit Runner(Options t_options);
+
+        Runner(const Runner& t_other) = delete;
+        Runner(Runner&& t_other) noexcept = delete;
+        Runner& operator=(const Runner& t_other) = delete;
+        Runner& operator=(Runner&& t_other) noexcept = delete;
+
+        ~Runner() noexcept = default;
+
+        //-------------------------------------------------
+        // Getter
+        //-------------------------------------------------
+
+        [[nodiscard]] const Options& GetOptions() const noexcept;
+        [[nodiscard]] const ResultContainer& GetResults() const noexcept;
+
+        [[nodiscard]] bool IsEnabled(const std::string& t_name) const;
+
+        //-------------------------------------------------
+        // Run
+        //-------------------------------------------------
+
+        /**
+         * @brief Measures a function. The first call is a warm-up and is not measured.
+         * @param t_name The name of the benchmark, e.g. "Map/FindConnectedRegions".
+         * @param t_mapSize The Map size or 0.
+         * @param t_count E.g. the number of cars or 0.
+         * @param t_setup Called before each call of t_function and not measured. May be empty.
+         * @param t_function The measured function.
+         */
+        void Run(const std::string& t_name, int t_mapSize, uint32_t t_count, const Function& t_setup, const Function& t_function);
+
+        //-------------------------------------------------
+        // Json
+        //-------------------------------------------------
+
+        void WriteJson(const std::string& t_fileName) const;
+
+        [[nodiscard]] static ResultContainer ReadJson(const std::string& t_fileName);
+
+        //-------------------------------------------------
+        // Baseline
+        //-------------------------------------------------
+
+        /**
+         * @brief Compares the medians with a previous run.
+         * @param t_fileName The Json file of the previous run.
+         * @return The number of regressions.
+         */
+        [[nodiscard]] uint32_t CompareWithBaseline(const std::string& t_fileName) const;
+
+    protected:
+
+    private:
+        Options m_options;
+        ResultContainer m_results;
+    };
+}
@@ -0,0 +1,155 @@
+// This file is part of the SgCityBuilder package.
+// 
+// Filename: CheckFixture.cpp
+// Author:   stwe
+// 
+// License:  MIT
+// 
+// 2020 (c) stwe <https://github.com/stwe/SgCityBuilder>
+
+#include <cstdio>
+#include "CheckFixture.h"
+#include "Layout.h"
+#include "map/tile/Tile.h"
+
+//-------------------------------------------------
+// Check
+//-------------------------------------------------
+
+uint32_t sg::city::benchmark::Check(const char* t_name, const bool t_passed)
+{
+    std::printf("%s %s\n", t_passed ? "PASS" : "FAIL", t_name);
+
+    return t_passed ? 0 : 1;
+}
+
+//-------------------------------------------------
+// Ctors. / Dtor.
+//-------------------------------------------------
+
+sg::city::benchmark::CheckFixture::CheckFixture(const int t_mapSize)
+{
+    // the initial tracks and regions, like Scenario::CreateMapFromValues()
+    m_map = std::make_unique<map::Map>(nullptr, "", m_random);
+    m_map->CreateMapFromValues(t_mapSize, Layout::CreateGrid(t_mapSize, m_random));
+
+    for (auto roadIndex : m_map->roadIndices)
+    {
+        m_map->GetTiles()[roadIndex]->Update();
+    }
+
+    m_map->FindConnectedRegions();
+
+    // the initial upload is not part of the checks
+    auto backend{ std::make_unique<gpu::RecordingBackend>() };
+    m_recordingBackend = backend.get();
+    gpu::Gpu::SetBackend(std::move(backend));
+
+    m_map->FlushTileAttributes();
+    m_recordingBackend->Clear();
+
+    m_spatialIndex = std::make_unique<spatial::SpatialIndex>(t_mapSize, m_registry);
+    m_systems = std::make_unique<system::Systems>(*m_map, *m_spatialIndex, m_registry, m_random);
+    m_systems->InitPopulation();
+
+    SubscribeSystems();
+}
+
+//-------------------------------------------------
+// Getter
+//-------------------------------------------------
+
+sg::city::map::Map& sg::city::benchmark::CheckFixture::GetMap() const
+{
+    return *m_map;
+}
+
+entt::registry& sg::city::benchmark::CheckFixture::GetRegistry()
+{
+    return m_registry;
+}
+
+sg::city::event::EventBus& sg::city::benchmark::CheckFixture::GetEventBus()
+{
+    return m_eventBus;
+}
+
+sg::city::gpu::RecordingBackend& sg::city::benchmark::CheckFixture::GetRecordingBackend() const
+{
+    return *m_recordingBackend;
+}
+
+const sg::city::system::Systems& sg::city::benchmark::CheckFixture::GetSystems() const
+{
+    return *m_systems;
+}
+
+//-------------------------------------------------
+// Edit
+//-------------------------------------------------
+
+int sg::city::benchmark::CheckFixture::FindEmptyTileNextToRoad() const
+{
+    const auto& tiles{ m_map->GetTiles() };
+
+    for (auto i{ 0 }; i < static_cast<int>(tiles.size()); ++i)
+    {
+        if (tiles[i]->type != map::tile::TileType::NONE)
+        {
+            continue;
+        }
+
+        for (const auto& neighbour : tiles[i]->GetNeighbours())
+        {
+            if (tiles[neighbour.second]->type == map::tile::TileType::TRAFFIC)
+            {
+                return i;
+            }
+        }
+    }
+
+    return -1;
+}
+
+void sg::city::benchmark::CheckFixture::ReplaceTile(const int t_tileIndex, const map::tile::TileType t_tileType)
+{
+    const auto oldType{ m_map->GetTiles()[t_tileIndex]->type };
+
+    m_map->ReplaceTile(t_tileIndex, t_tileType);
+
+    m_eventBus.Publish(event::TileChanged{ t_tileIndex, oldType, t_tileType });
+    if (t_tileType == map::tile::TileType::TRAFFIC)
+    {
+        m_eventBus.Publish(event::RoadTopologyChanged{ t_tileIndex });
+    }
+
+    m_eventBus.Dispatch();
+}
+
+//-------------------------------------------------
+// Helper
+//-------------------------------------------------
+
+void sg::city::benchmark::CheckFixture::SubscribeSystems()
+{
+    // the same names and order as City::SubscribeSystems()
+    m_eventBus.Subscribe<event::TileChanged>("Tiles", [this](const std::vector<event::TileChanged>& t_events)
+    {
+        m_systems->UpdateChangedTiles(t_events);
+    });
+
+    m_eventBus.Subscribe<event::TileChanged>("Population", [this](const std::vector<event::TileChanged>& t_events)
+    {
+        m_systems->UpdatePopulationTiles(t_events);
+    });
+
+    m_eventBus.Subscribe<event::TileChanged>("Regions", [this](const std::vector<event::TileChanged>&)
+    {
+        m_systems->UpdateRegions();
+    });
+
+    m_eventBus.Subscribe<event::RoadTopologyChanged>("Roads", [this](const std::vector<event::RoadTopologyChanged>& t_events)
+    {
+        m_systems->UpdateRoads(t_events);
+    });
+}
@@ -0,0 +1,103 @@
+// This file is part of the SgCityBuilder package.
+// 
+// Filename: CheckFixture.h
+// Author:   stwe
+// 
+// License:  MIT
+// 
+// 2020 (c) stwe <https://github.com/stwe/SgCityBuilder>
+
+#pragma once
+
+#include <memory>
+#include <cstdint>
+#include <entt/entt.hpp>
+#include "map/Map.h"
+#include "city/Gpu.h"
+#include "city/EventBus.h"
+#include "city/SpatialIndex.h"
+#include "city/Systems.h"
+
+namespace sg::city::benchmark
+{
+    /**
+     * @brief Prints the result of a check.
+     * @param t_name The name of the check, e.g. "Upload/OneRoadUnderBudget".
+     * @param t_passed The result.
+     * @return 1 if the check failed, otherwise 0.
+     */
+    uint32_t Check(const char* t_name, bool t_passed);
+
+    /**
+     * @brief The headless City all checks start from: a procedural grid Layout with its tracks and regions,
+     *        the systems with population and demand subscribed like in City::SubscribeSystems() and a gpu::RecordingBackend.
+     *        The initial upload is already cleared from the backend.
+     */
+    class CheckFixture
+    {
+    public:
+        //-------------------------------------------------
+        // Ctors. / Dtor.
+        //-------------------------------------------------
+
+        CheckFixture() = delete;
+
+        explicit CheckFixture(int t_mapSize);
+
+        CheckFixture(const CheckFixture& t_other) = delete;
+        CheckFixture(CheckFixture&& t_other) noexcept = delete;
+        CheckFixture& operator=(const CheckFixture& t_other) = delete;
+        CheckFixture& operator=(CheckFixture&& t_other) noexcept = delete;
+
+        ~CheckFixture() noexcept = default;
+
+        //-------------------------------------------------
+        // Getter
+        //-------------------------------------------------
+
+        [[nodiscard]] map::Map& GetMap() const;
+        [[nodiscard]] entt::registry& GetRegistry();
+        [[nodiscard]] event::EventBus& GetEventBus();
+        [[nodiscard]] gpu::RecordingBackend& GetRecordingBackend() const;
+        [[nodiscard]] const system::Systems& GetSystems() const;
+
+        //-------------------------------------------------
+        // Edit
+        //-------------------------------------------------
+
+        /**
+         * @brief The first empty Tile next to a road.
+         * @return The index of the Tile or -1.
+         */
+        [[nodiscard]] int FindEmptyTileNextToRoad() const;
+
+        /**
+         * @brief Replaces a Tile and dispatches its events like an edit of the City.
+         * @param t_tileIndex The index of the Tile.
+         * @param t_tileType The new type.
+         */
+        void ReplaceTile(int t_tileIndex, map::tile::TileType t_tileType);
+
+    protected:
+
+    private:
+        random::Random m_random;
+        std::unique_ptr<map::Map> m_map;
+
+        /**
+         * @brief The cars. Declared after the Map, so the cars are destroyed before the tracks.
+         */
+        entt::registry m_registry;
+
+        std::unique_ptr<spatial::SpatialIndex> m_spatialIndex;
+        std::unique_ptr<system::Systems> m_systems;
+        event::EventBus m_eventBus;
+
+        /**
+         * @brief Owned by the Gpu.
+         */
+        gpu::RecordingBackend* m_recordingBackend{ nullptr };
+
+        void SubscribeSystems();
+    };
+}
@@ -0,0 +1,289 @@
+// This file is part of the SgCityBuilder package.
+// 
+// Filename: Checks.cpp
+// Author:   stwe
+// 
+// License:  MIT
+// 
+// 2020 (c) stwe <https://github.com/stwe/SgCityBuilder>
+
+#include <string>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <algorithm>
+#include <stdexcept>
+#include <glm/gtc/matrix_transform.hpp>
+#include "Checks.h"
+#include "CheckFixture.h"
+#include "map/Chunk.h"
+#include "map/PngDecoder.h"
+#include "map/MapImporter.h"
+#include "map/tile/RoadTile.h"
+#include "city/SaveGame.h"
+#include "city/Timer.h"
+#include "simulation/PopulationGrowth.h"
+
+namespace
+{
+    bool IsVisible(const sg::city::map::Map::ChunkIndexContainer& t_visibleChunks, const uint32_t t_chunkIndex)
+    {
+        return std::find(t_visibleChunks.begin(), t_visibleChunks.end(), t_chunkIndex) != t_visibleChunks.end();
+    }
+
+    // relative to the working directory of the checks
+    const std::string MAP_IMAGE_PATH{ "../SgCityBuilder/res/config/" };
+
+    struct MapImage
+    {
+        const char* fileName;
+        uint64_t hash;
+        uint32_t roads;
+        uint32_t buildings;
+        uint32_t trees;
+    };
+
+    /**
+     * @brief FNV-1a over all decoded samples.
+     */
+    uint64_t HashPng(const std::string& t_fileName)
+    {
+        sg::city::map::PngDecoder decoder{ t_fileName };
+
+        const auto rowBytes{ decoder.GetHeader().width * decoder.GetChannels() };
+        auto hash{ 14695981039346656037ull };
+
+        decoder.Decode([&](const uint32_t, const uint8_t* t_pixels)
+        {
+            for (auto i{ 0u }; i < rowBytes; ++i)
+            {
+                hash = (hash ^ t_pixels[i]) * 1099511628211ull;
+            }
+        });
+
+        return hash;
+    }
+
+    bool IsRejected(const std::string& t_fileName)
+    {
+        try
+        {
+            HashPng(t_fileName);
+        }
+        catch (const std::runtime_error&)
+        {
+            return true;
+        }
+
+        return false;
+    }
+
+    void WriteFile(const std::string& t_fileName, const std::string& t_bytes)
+    {
+        std::ofstream file{ t_fileName, std::ios::binary };
+        file.write(t_bytes.data(), static_cast<std::streamsize>(t_bytes.size()));
+    }
+}
+
+uint32_t sg::city::benchmark::RunCullingChecks()
+{
+    // 4x4 Chunks; Chunk x, z covers Map-x [64x, 64x + 64) and World-z (-64z - 64, -64z]
+    static constexpr auto MAP_SIZE{ 4 * map::Chunk::SIZE };
+    static constexpr auto CHUNKS_PER_ROW{ 4u };
+
+    const auto chunkIndex = [](const uint32_t t_chunkX, const uint32_t t_chunkZ)
+    {
+        return t_chunkZ * CHUNKS_PER_ROW + t_chunkX;
+    };
+
+    CheckFixture fixture{ MAP_SIZE };
+    const auto& map{ fixture.GetMap() };
+
+    const auto projection{ glm::perspective(glm::radians(45.0f), 1.0f, 0.1f, 1000.0f) };
+
+    map::Map::ChunkIndexContainer visibleChunks;
+    auto failed{ 0u };
+
+    // the Map is at the origin, so the view-projection matrix is the model-view-projection matrix
+
+    // in the middle of the Map, looking along -z
+    const auto lookAhead{ projection * glm::lookAt(glm::vec3(128.0f, 5.0f, -128.0f), glm::vec3(128.0f, 0.0f, -200.0f), glm::vec3(0.0f, 1.0f, 0.0f)) };
+    map.FindVisibleChunks(lookAhead, visibleChunks);
+
+    failed += Check("Culling/ChunkInFront", IsVisible(visibleChunks, chunkIndex(2, 3)));
+    failed += Check("Culling/ChunkBehind", !IsVisible(visibleChunks, chunkIndex(2, 0)));
+    failed += Check("Culling/ChunkLeft", !IsVisible(visibleChunks, chunkIndex(0, 2)));
+    failed += Check("Culling/ChunkRight", !IsVisible(visibleChunks, chunkIndex(3, 2)));
+
+    // high above the center, looking down: the whole Map fits into the view
+    const auto topDown{ projection * glm::lookAt(glm::vec3(128.0f, 600.0f, -128.0f), glm::vec3(128.0f, 0.0f, -128.0f), glm::vec3(0.0f, 0.0f, -1.0f)) };
+    map.FindVisibleChunks(topDown, visibleChunks);
+
+    failed += Check("Culling/AllChunksFromAbove", visibleChunks.size() == map.GetChunks().size());
+
+    // looking up into the sky: no Chunk
+    const auto sky{ projection * glm::lookAt(glm::vec3(128.0f, 50.0f, -128.0f), glm::vec3(128.0f, 100.0f, -129.0f), glm::vec3(0.0f, 0.0f, -1.0f)) };
+    map.FindVisibleChunks(sky, visibleChunks);
+
+    failed += Check("Culling/NoChunkInTheSky", visibleChunks.empty());
+
+    return failed;
+}
+
+uint32_t sg::city::benchmark::RunUploadChecks()
+{
+    static constexpr auto MAP_SIZE{ 2 * map::Chunk::SIZE };
+    static constexpr auto UPLOAD_BUDGET_BYTES{ 4096u };
+
+    CheckFixture fixture{ MAP_SIZE };
+
+    const auto tileIndex{ fixture.FindEmptyTileNextToRoad() };
+
+    auto failed{ Check("Upload/EmptyTileNextToRoad", tileIndex >= 0) };
+    if (tileIndex < 0)
+    {
+        return failed;
+    }
+
+    fixture.ReplaceTile(tileIndex, map::tile::TileType::TRAFFIC);
+    fixture.GetMap().FlushTileAttributes();
+
+    const auto uploadBytes{ fixture.GetRecordingBackend().GetUploadBytes() };
+    std::printf("INFO Upload/OneRoad %llu bytes\n", static_cast<unsigned long long>(uploadBytes));
+
+    failed += Check("Upload/OneRoadUnderBudget", uploadBytes < UPLOAD_BUDGET_BYTES);
+
+    return failed;
+}
+
+uint32_t sg::city::benchmark::RunPngChecks()
+{
+    static constexpr MapImage MAP_IMAGES[]
+    {
+        { "CityMap0.png", 0x076cba5a6a17d4e3ull, 3522, 14, 0 },
+        { "CityMap1.png", 0x754f106e618010f5ull, 2130, 1267, 886 },
+        { "Map8x8.png", 0x43cc52cf76bb90f1ull, 28, 0, 0 },
+        { "Map8x8_empty.png", 0xab0c262759a1d225ull, 0, 0, 0 },
+    };
+
+    auto failed{ 0u };
+
+    for (const auto& mapImage : MAP_IMAGES)
+    {
+        const auto fileName{ MAP_IMAGE_PATH + mapImage.fileName };
+        const auto name{ std::string("Png/") + mapImage.fileName };
+
+        failed += Check((name + "/Hash").c_str(), HashPng(fileName) == mapImage.hash);
+
+        const auto importedMap{ map::MapImporter::Import(fileName) };
+        failed += Check((name + "/Zones").c_str(),
+            importedMap.roads == mapImage.roads && importedMap.buildings == mapImage.buildings && importedMap.trees == mapImage.trees);
+    }
+
+    // damaged copies of a bundled image
+    std::ifstream file{ MAP_IMAGE_PATH + "CityMap0.png", std::ios::binary };
+    const std::string bytes{ std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>() };
+
+    const auto idat{ bytes.find("IDAT") };
+    if (Check("Png/IdatFound", idat != std::string::npos && idat + 64 < bytes.size()) > 0)
+    {
+        return failed + 1;
+    }
+
+    const std::string truncatedFileName{ "CheckTruncated.png" };
+    WriteFile(truncatedFileName, bytes.substr(0, bytes.size() - 40));
+    failed += Check("Png/TruncatedRejected", IsRejected(truncatedFileName));
+    std::remove(truncatedFileName.c_str());
+
+    auto corruptBytes{ bytes };
+    corruptBytes[idat + 20] = static_cast<char>(~corruptBytes[idat + 20]);
+
+    const std::string corruptFileName{ "CheckCorrupt.png" };
+    WriteFile(corruptFileName, corruptBytes);
+    failed += Check("Png/CorruptRejected", IsRejected(corruptFileName));
+    std::remove(corruptFileName.c_str());
+
+    failed += Check("Png/MissingRejected", IsRejected("CheckMissing.png"));
+
+    return failed;
+}
+
+uint32_t sg::city::benchmark::RunRestoreChecks()
+{
+    static constexpr auto MAP_SIZE{ 2048 };
+    static constexpr auto RESTORE_BUDGET_MS{ 1000.0f };
+    static constexpr auto SAVE_FILE_NAME{ "CheckRestore.city" };
+
+    save::SaveData savedData;
+
+    {
+        CheckFixture fixture{ MAP_SIZE };
+        const auto& savedMap{ fixture.GetMap() };
+        const auto& populationGrowth{ fixture.GetSystems().GetPopulationGrowth() };
+
+        savedMap.Save(savedData);
+
+        for (auto i{ 0 }; i < savedMap.GetNrOfAllTiles(); ++i)
+        {
+            if (savedMap.GetTiles()[i]->type == map::tile::TileType::RESIDENTIAL)
+            {
+                save::BuildingRecord building;
+                building.tileIndex = i;
+                building.population = populationGrowth.GetPopulation()[i];
+                building.floors = populationGrowth.GetFloors()[i];
+                savedData.buildings.push_back(building);
+            }
+        }
+
+        save::SaveGame::Write(SAVE_FILE_NAME, savedData);
+    }
+
+    // declared before the Map, so the Systems are destroyed first
+    random::Random random;
+    std::unique_ptr<map::Map> restoredMap;
+    entt::registry registry;
+    std::unique_ptr<spatial::SpatialIndex> spatialIndex;
+    std::unique_ptr<system::Systems> systems;
+
+    auto durationMs{ 0.0f };
+
+    {
+        timer::Timer timer{ &durationMs };
+
+        const auto saveData{ save::SaveGame::Read(SAVE_FILE_NAME) };
+
+        // like Scenario::Init() with a save file
+        restoredMap = std::make_unique<map::Map>(nullptr, "", random);
+        restoredMap->CreateMapFromTypes(saveData.mapSize, saveData.tileTypes);
+        restoredMap->Restore(saveData);
+
+        spatialIndex = std::make_unique<spatial::SpatialIndex>(saveData.mapSize, registry);
+        systems = std::make_unique<system::Systems>(*restoredMap, *spatialIndex, registry, random);
+        systems->RestorePopulation(saveData);
+    }
+
+    std::remove(SAVE_FILE_NAME);
+
+    std::printf("INFO Restore/%dx%d %.1f ms, %zu roads\n", MAP_SIZE, MAP_SIZE, static_cast<double>(durationMs), savedData.roads.size());
+
+    auto failed{ Check("Restore/UnderBudget", durationMs < RESTORE_BUDGET_MS) };
+
+    // the restored roads have the saved types and their tracks
+    auto restoredRoads{ true };
+    for (const auto& road : savedData.roads)
+    {
+        const auto& roadTile{ static_cast<const map::tile::RoadTile&>(*restoredMap->GetTiles()[road.tileIndex]) };
+        restoredRoads = restoredRoads && static_cast<uint8_t>(roadTile.roadType) == road.roadType && !roadTile.GetAutoTracks().empty();
+    }
+
+    failed += Check("Restore/Roads", restoredRoads);
+    auto restoredPopulation{ true };
+    for (const auto& building : savedData.buildings)
+    {
+        restoredPopulation = restoredPopulation && systems->GetPopulationGrowth().GetPopulation()[building.tileIndex] == building.population;
+    }
+
+    failed += Check("Restore/Population", restoredPopulation);
+
+    return failed;
+}
@@ -0,0 +1,43 @@
+// This file is part of the SgCityBuilder package.
+// 
+// Filename: Checks.h
+// Author:   stwe
+// 
+// License:  MIT
+// 
+// 2020 (c) stwe <https://github.com/stwe/SgCityBuilder>
+
+#pragma once
+
+#include <cstdint>
+
+namespace sg::city::benchmark
+{
+    /**
+     * @brief The culling of the Map Chunks against known camera matrices.
+     *        Chunks in front of the camera must be visible, Chunks behind or beside it culled.
+     * @return The number of failed checks.
+     */
+    uint32_t RunCullingChecks();
+
+    /**
+     * @brief The upload of one road placed next to an existing road, recorded without a Gpu.
+     *        The road goes through Map::ReplaceTile() and the EventBus like an edit of the City.
+     * @return The number of failed checks.
+     */
+    uint32_t RunUploadChecks();
+
+    /**
+     * @brief Decodes the bundled Map images against known hashes and imports them against known zone counts.
+     *        A truncated and a corrupt copy of an image must be rejected.
+     * @return The number of failed checks.
+     */
+    uint32_t RunPngChecks();
+
+    /**
+     * @brief Saves a 2048x2048 grid City and times its restore: SaveGame::Read() and the Cpu side of City::Restore(),
+     *        i.e. the Map, its tracks and the population. The buildings and cars need a Gpu.
+     * @return The number of failed checks.
+     */
+    uint32_t RunRestoreChecks();
+}
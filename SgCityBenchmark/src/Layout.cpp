@@ -0,0 +1,48 @@
+// This file is part of the SgCityBuilder package.
+// 
+// Filename: Layout.cpp
+// Author:   stwe
+// 
+// License:  MIT
+// 
+// 2020 (c) stwe <https://github.com/stwe/SgCityBuilder>
+
+#include "Layout.h"
+
+//-------------------------------------------------
+// Create
+//-------------------------------------------------
+
+sg::city::map::Map::MapValuesContainer sg::city::benchmark::Layout::CreateGrid(const int t_mapSize, const random::Random& t_random, const int t_blockSize)
+{
+    map::Map::MapValuesContainer values(static_cast<size_t>(t_mapSize) * t_mapSize, NONE_VALUE);
+
+    for (auto z{ 0 }; z < t_mapSize; ++z)
+    {
+        // one stream per row: the layout does not depend on the Map size
+        auto stream{ t_random.GetStream(random::Domain::LAYOUT, z, 0) };
+
+        for (auto x{ 0 }; x < t_mapSize; ++x)
+        {
+            auto& value{ values[static_cast<size_t>(z) * t_mapSize + x] };
+
+            if (x % t_blockSize == 0 || z % t_blockSize == 0)
+            {
+                value = ROAD_VALUE;
+                continue;
+            }
+
+            const auto percent{ stream.NextInt(0, 99) };
+            if (percent < RESIDENTIAL_PERCENT)
+            {
+                value = RESIDENTIAL_VALUE;
+            }
+            else if (percent < RESIDENTIAL_PERCENT + TREE_PERCENT)
+            {
+                value = TREE_VALUE;
+            }
+        }
+    }
+
+    return values;
+}
@@ -0,0 +1,55 @@
+// This file is part of the SgCityBuilder package.
+// 
+// Filename: Layout.h
+// Author:   stwe
+// 
+// License:  MIT
+// 
+// 2020 (c) stwe <https://github.com/stwe/SgCityBuilder>
+
+#pragma once
+
+#include "map/Map.h"
+
+namespace sg::city::benchmark
+{
+    /**
+     * @brief Creates procedural Map values, so that the benchmarks need no map file.
+     */
+    class Layout
+    {
+    public:
+        //-------------------------------------------------
+        // Const
+        //-------------------------------------------------
+
+        // the values of the map file
+        static constexpr auto ROAD_VALUE{ 1.0f };
+        static constexpr auto RESIDENTIAL_VALUE{ 0.5f };
+        static constexpr auto TREE_VALUE{ 0.25f };
+        static constexpr auto NONE_VALUE{ 0.0f };
+
+        static constexpr auto DEFAULT_BLOCK_SIZE{ 8 };
+
+        static constexpr auto RESIDENTIAL_PERCENT{ 60 };
+        static constexpr auto TREE_PERCENT{ 10 };
+
+        //-------------------------------------------------
+        // Create
+        //-------------------------------------------------
+
+        /**
+         * @brief A grid of roads. The blocks between the roads are filled with residential Tiles and trees.
+         * @param t_mapSize The number of Tiles in the x and z direction.
+         * @param t_random The residential Tiles and trees are taken from the LAYOUT streams.
+         * @param t_blockSize The distance between two roads.
+         * @return The Map values.
+         */
+        [[nodiscard]] static map::Map::MapValuesContainer CreateGrid(int t_mapSize, const random::Random& t_random, int t_blockSize = DEFAULT_BLOCK_SIZE);
+
+    protected:
+
+    private:
+
+    };
+}
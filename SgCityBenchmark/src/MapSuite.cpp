@@ -0,0 +1,219 @@
+// This file is part of the SgCityBuilder package.
+// 
+// Filename: MapSuite.cpp
+// Author:   stwe
+// 
+// License:  MIT
+// 
+// 2020 (c) stwe <https://github.com/stwe/SgCityBuilder>
+
+#include <cstdio>
+#include <algorithm>
+#include "Suites.h"
+#include "Benchmark.h"
+#include "Layout.h"
+#include "city/SaveGame.h"
+#include "map/Map.h"
+#include "map/DirtyRanges.h"
+#include "map/BuildingGenerator.h"
+#include "map/tile/RoadTile.h"
+
+namespace
+{
+    using MapUniquePtr = std::unique_ptr<sg::city::map::Map>;
+    using TileIndexContainer = std::vector<int>;
+
+    MapUniquePtr CreateMap(const int t_mapSize, const sg::city::random::Random& t_random, sg::city::map::Map::MapValuesContainer t_values)
+    {
+        auto map{ std::make_unique<sg::city::map::Map>(nullptr, "", t_random) };
+        map->CreateMapFromValues(t_mapSize, std::move(t_values));
+
+        return map;
+    }
+
+    TileIndexContainer GetRoadIndices(const sg::city::map::Map& t_map)
+    {
+        TileIndexContainer roadIndices;
+
+        for (const auto& tile : t_map.GetTiles())
+        {
+            if (tile->type == sg::city::map::tile::TileType::TRAFFIC)
+            {
+                roadIndices.push_back(tile->GetMapIndex());
+            }
+        }
+
+        return roadIndices;
+    }
+
+    void RebuildRoads(sg::city::map::Map& t_map, const TileIndexContainer& t_roadIndices)
+    {
+        auto& tiles{ t_map.GetTiles() };
+
+        for (auto roadIndex : t_roadIndices)
+        {
+            dynamic_cast<sg::city::map::tile::RoadTile*>(tiles[roadIndex].get())->ClearTracksAndStops();
+        }
+
+        for (auto roadIndex : t_roadIndices)
+        {
+            tiles[roadIndex]->Update();
+        }
+    }
+}
+
+void sg::city::benchmark::RunMapSuite(Runner& t_runner, const int t_mapSize)
+{
+    const random::Random random;
+    const auto values{ Layout::CreateGrid(t_mapSize, random) };
+
+    //-------------------------------------------------
+    // Construction
+    //-------------------------------------------------
+
+    // the destruction of the previous Map is not measured
+    MapUniquePtr constructedMap;
+    t_runner.Run("Map/CreateMapFromValues", t_mapSize, 0,
+        [&constructedMap]() { constructedMap.reset(); },
+        [&]() { constructedMap = CreateMap(t_mapSize, random, values); }
+    );
+    constructedMap.reset();
+
+    // all other benchmarks share one Map
+    auto map{ CreateMap(t_mapSize, random, values) };
+    const auto roadIndices{ GetRoadIndices(*map) };
+
+    // the initial tracks, like City::StoreRoads()
+    RebuildRoads(*map, roadIndices);
+
+    //-------------------------------------------------
+    // Regions
+    //-------------------------------------------------
+
+    t_runner.Run("Map/FindConnectedRegions", t_mapSize, 0, {}, [&map]()
+    {
+        map->FindConnectedRegions();
+    });
+
+    //-------------------------------------------------
+    // Save game
+    //-------------------------------------------------
+
+    static constexpr auto SAVE_FILE_NAME{ "benchmark.city" };
+
+    // the file is also read if Save/Write is filtered out
+    save::SaveData saveData;
+    map->Save(saveData);
+    save::SaveGame::Write(SAVE_FILE_NAME, saveData);
+
+    t_runner.Run("Save/Write", t_mapSize, static_cast<uint32_t>(saveData.roads.size()), {}, [&saveData]()
+    {
+        save::SaveGame::Write(SAVE_FILE_NAME, saveData);
+    });
+
+    // read, check and rebuild the Map; the destruction of the previous Map is not measured
+    MapUniquePtr restoredMap;
+    t_runner.Run("Save/Restore", t_mapSize, static_cast<uint32_t>(saveData.roads.size()),
+        [&restoredMap]() { restoredMap.reset(); },
+        [&]()
+        {
+            const auto readData{ save::SaveGame::Read(SAVE_FILE_NAME) };
+
+            restoredMap = std::make_unique<map::Map>(nullptr, "", random);
+            restoredMap->CreateMapFromTypes(readData.mapSize, readData.tileTypes);
+            restoredMap->Restore(readData);
+        }
+    );
+    restoredMap.reset();
+
+    std::remove(SAVE_FILE_NAME);
+
+    //-------------------------------------------------
+    // Roads
+    //-------------------------------------------------
+
+    t_runner.Run("Roads/FullRebuild", t_mapSize, static_cast<uint32_t>(roadIndices.size()), {}, [&]()
+    {
+        RebuildRoads(*map, roadIndices);
+    });
+
+    // a crossing near the center with its road neighbours, like City::UpdateRoads()
+    const auto center{ t_mapSize / 2 / Layout::DEFAULT_BLOCK_SIZE * Layout::DEFAULT_BLOCK_SIZE };
+    const auto centerIndex{ map->GetTileMapIndexByMapPosition(center, center) };
+
+    TileIndexContainer singleIndices{ centerIndex };
+    for (const auto& neighbour : map->GetTiles()[centerIndex]->GetNeighbours())
+    {
+        if (map->GetTiles()[neighbour.second]->type == map::tile::TileType::TRAFFIC)
+        {
+            singleIndices.push_back(neighbour.second);
+        }
+    }
+
+    std::sort(singleIndices.begin(), singleIndices.end());
+    singleIndices.erase(std::unique(singleIndices.begin(), singleIndices.end()), singleIndices.end());
+
+    t_runner.Run("Roads/SingleTileRebuild", t_mapSize, static_cast<uint32_t>(singleIndices.size()), {}, [&]()
+    {
+        RebuildRoads(*map, singleIndices);
+    });
+
+    //-------------------------------------------------
+    // Tiles
+    //-------------------------------------------------
+
+    // the Cpu side of the Tile upload: pack the attributes of the roads and merge the dirty slots
+    map::Map::TileAttributeContainer attributes(map->GetNrOfAllTiles(), 0);
+    map::DirtyRanges dirtyRanges;
+    auto uploads{ 0u };
+
+    t_runner.Run("Tiles/PackAndMerge", t_mapSize, static_cast<uint32_t>(roadIndices.size()), {}, [&]()
+    {
+        const auto& tiles{ map->GetTiles() };
+
+        for (auto roadIndex : roadIndices)
+        {
+            const auto slot{ map->GetTileSlot(roadIndex) };
+            attributes[slot] = tiles[roadIndex]->GetAttribute(0);
+            dirtyRanges.Add(slot);
+        }
+
+        uploads += static_cast<uint32_t>(dirtyRanges.Merge().size());
+    });
+
+    //-------------------------------------------------
+    // Buildings
+    //-------------------------------------------------
+
+    // a building with a random height on each residential Tile
+    map::BuildingGenerator::BuildingInstanceContainer instances;
+    auto stream{ random.GetStream(random::Domain::BUILDINGS, 0, 0) };
+
+    for (const auto& tile : map->GetTiles())
+    {
+        if (tile->type == map::tile::TileType::RESIDENTIAL)
+        {
+            map::BuildingGenerator::BuildingInstanceData instance{};
+            instance.position = glm::vec2(tile->GetWorldX(), tile->GetWorldZ());
+            instance.floors = static_cast<uint8_t>(stream.NextInt(1, static_cast<int>(map::BuildingGenerator::MAX_FLOORS)));
+            instance.colorIndex = static_cast<uint8_t>(stream.NextInt(0, 255));
+            instance.textureId = static_cast<uint8_t>(stream.NextInt(1, 2));
+            instances.push_back(instance);
+        }
+    }
+
+    map::BuildingGenerator::FloorMatrixContainer matrices;
+
+    t_runner.Run("Buildings/ExpandFloors", t_mapSize, static_cast<uint32_t>(instances.size()), {}, [&]()
+    {
+        matrices.clear();
+
+        for (const auto& instance : instances)
+        {
+            for (auto floor{ 0u }; floor < instance.floors; ++floor)
+            {
+                matrices.push_back(map::BuildingGenerator::CalcFloorMatrix(instance, floor));
+            }
+        }
+    });
+}
@@ -0,0 +1,663 @@
+// This file is part of the SgCityBuilder package.
+// 
+// Filename: Scenario.cpp
+// Author:   stwe
+// 
+// License:  MIT
+// 
+// 2020 (c) stwe <https://github.com/stwe/SgCityBuilder>
+
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <stdexcept>
+#include <ecs/component/Components.h>
+#include "Scenario.h"
+#include "Layout.h"
+#include "city/Memory.h"
+#include "city/Timer.h"
+#include "city/Gpu.h"
+#include "city/FrameArena.h"
+#include "city/SaveGame.h"
+#include "map/MapImporter.h"
+#include "map/tile/RoadTile.h"
+#include "automata/Automata.h"
+#include "automata/AutoTrack.h"
+
+//-------------------------------------------------
+// Ctors. / Dtor.
+//-------------------------------------------------
+
+sg::city::benchmark::Scenario::Scenario(ScenarioOptions t_options)
+    : m_options{ std::move(t_options) }
+{
+    const auto allocations{ memory::Memory::GetAllocations() };
+
+    Init();
+
+    m_setupAllocations = memory::Memory::GetAllocations() - allocations;
+}
+
+sg::city::benchmark::Scenario::~Scenario() noexcept = default;
+
+//-------------------------------------------------
+// Timeline
+//-------------------------------------------------
+
+sg::city::benchmark::Scenario::EditContainer sg::city::benchmark::Scenario::ReadTimeline(const std::string& t_fileName)
+{
+    std::ifstream file{ t_fileName };
+    if (!file)
+    {
+        throw std::runtime_error("[Scenario::ReadTimeline()] Unable to open " + t_fileName);
+    }
+
+    EditContainer edits;
+
+    std::string line;
+    auto lineNumber{ 0 };
+
+    while (std::getline(file, line))
+    {
+        lineNumber++;
+
+        std::istringstream stream{ line };
+
+        Edit edit;
+        std::string command;
+
+        if (!(stream >> edit.tick >> command))
+        {
+            continue;
+        }
+
+        auto valid{ false };
+
+        if (command == "cars")
+        {
+            edit.type = EditType::CARS;
+            valid = static_cast<bool>(stream >> edit.count);
+        }
+        else
+        {
+            if (command == "road")
+            {
+                edit.type = EditType::ROAD;
+            }
+            else if (command == "zone")
+            {
+                edit.type = EditType::ZONE;
+            }
+            else if (command == "clear")
+            {
+                edit.type = EditType::CLEAR;
+            }
+            else
+            {
+                throw std::runtime_error("[Scenario::ReadTimeline()] Unknown command " + command + " in line " + std::to_string(lineNumber));
+            }
+
+            valid = static_cast<bool>(stream >> edit.x0 >> edit.z0 >> edit.x1 >> edit.z1);
+        }
+
+        if (!valid)
+        {
+            throw std::runtime_error("[Scenario::ReadTimeline()] Invalid arguments in line " + std::to_string(lineNumber));
+        }
+
+        edits.push_back(edit);
+    }
+
+    std::stable_sort(edits.begin(), edits.end(), [](const Edit& t_lhs, const Edit& t_rhs)
+    {
+        return t_lhs.tick < t_rhs.tick;
+    });
+
+    return edits;
+}
+
+sg::city::benchmark::Scenario::EditContainer sg::city::benchmark::Scenario::CreateDefaultTimeline(const int t_mapSize, const uint32_t t_ticks)
+{
+    static constexpr auto PERIOD{ 60u };
+
+    const auto blockSize{ Layout::DEFAULT_BLOCK_SIZE };
+    const auto blocks{ std::max(1, t_mapSize / blockSize) };
+    const auto last{ t_mapSize - 1 };
+
+    EditContainer edits;
+
+    // fill the roads with cars
+    edits.push_back({ 0, EditType::CARS, 0, 0, 0, 0, static_cast<uint32_t>(t_mapSize) * 4 });
+
+    for (auto k{ 1u }; k * PERIOD < t_ticks; ++k)
+    {
+        const auto tick{ static_cast<uint64_t>(k) * PERIOD };
+
+        // zoning storm: a quarter of the Map becomes residential
+        const auto x0{ static_cast<int>(k * 7 % blocks) * blockSize };
+        const auto z0{ static_cast<int>(k * 11 % blocks) * blockSize };
+        edits.push_back({ tick, EditType::ZONE, x0, z0, std::min(last, x0 + t_mapSize / 2), std::min(last, z0 + t_mapSize / 2), 0 });
+
+        // demolish a row in the middle of a block and paint a road through it
+        const auto row{ std::min(last, static_cast<int>(k * 3 % blocks) * blockSize + blockSize / 2) };
+        edits.push_back({ tick + PERIOD / 3, EditType::CLEAR, 0, row, last, row, 0 });
+        edits.push_back({ tick + PERIOD / 3 + 1, EditType::ROAD, 0, row, last, row, 0 });
+
+        // bulk spawn
+        edits.push_back({ tick + 2 * PERIOD / 3, EditType::CARS, 0, 0, 0, 0, static_cast<uint32_t>(t_mapSize) });
+    }
+
+    return edits;
+}
+
+bool sg::city::benchmark::Scenario::IsImageFile(const std::string& t_fileName)
+{
+    static const std::string EXTENSION{ ".png" };
+
+    return t_fileName.size() >= EXTENSION.size() && t_fileName.compare(t_fileName.size() - EXTENSION.size(), EXTENSION.size(), EXTENSION) == 0;
+}
+
+//-------------------------------------------------
+// Run
+//-------------------------------------------------
+
+void sg::city::benchmark::Scenario::Run()
+{
+    size_t nextEdit{ 0 };
+    uint64_t lastEditTick{ 0 };
+
+    for (m_tick = 0; m_tick < m_options.ticks; ++m_tick)
+    {
+        std::array<uint64_t, memory::Memory::NR_OF_TAGS> tagAllocations{};
+        for (auto i{ 0u }; i < memory::Memory::NR_OF_TAGS; ++i)
+        {
+            tagAllocations[i] = memory::Memory::GetTagStats(static_cast<memory::Tag>(i)).allocations;
+        }
+
+        const auto allocations{ memory::Memory::GetAllocations() };
+
+        auto tickMs{ 0.0f };
+        auto editsMs{ 0.0f };
+        auto demandMs{ 0.0f };
+        auto populationMs{ 0.0f };
+        auto trafficMs{ 0.0f };
+        auto uploadsMs{ 0.0f };
+
+        {
+            timer::Timer tickTimer{ &tickMs };
+
+            {
+                timer::Timer timer{ &editsMs };
+
+                while (nextEdit < m_timeline.size() && m_timeline[nextEdit].tick <= m_tick)
+                {
+                    ApplyEdit(m_timeline[nextEdit++]);
+                    lastEditTick = m_tick;
+                }
+            }
+
+            m_eventBus->Dispatch();
+
+            // the same order as City::Update()
+            {
+                timer::Timer timer{ &demandMs };
+                m_systems->UpdateDemand(m_tick);
+            }
+
+            {
+                timer::Timer timer{ &populationMs };
+                m_systems->UpdatePopulation(m_tick);
+            }
+
+            {
+                timer::Timer timer{ &trafficMs };
+                m_systems->UpdateVehicles(DT);
+            }
+
+            {
+                timer::Timer timer{ &uploadsMs };
+                m_map->FlushTileAttributes();
+            }
+        }
+
+        const auto tickAllocations{ memory::Memory::GetAllocations() - allocations };
+        m_tickAllocations.push_back(tickAllocations);
+
+        for (auto i{ 0u }; i < memory::Memory::NR_OF_TAGS; ++i)
+        {
+            m_tagTickAllocations[i].push_back(memory::Memory::GetTagStats(static_cast<memory::Tag>(i)).allocations - tagAllocations[i]);
+        }
+
+        // the first STEADY_STATE_DELAY ticks are the warm-up
+        if (m_tick >= lastEditTick + STEADY_STATE_DELAY)
+        {
+            m_steadyStateTicks++;
+
+            if (tickAllocations > 0)
+            {
+                m_allocatingSteadyStateTicks++;
+            }
+        }
+
+        const auto uploadBytes{ gpu::Gpu::GetFrameTotal().uploadBytes };
+        m_tickUploadBytes.push_back(uploadBytes);
+        if (m_options.uploadBudgetBytes > 0 && uploadBytes > m_options.uploadBudgetBytes)
+        {
+            m_overBudgetTicks++;
+        }
+
+        gpu::Gpu::NextFrame();
+        memory::FrameArena::Get().Reset();
+
+        m_times["Edits"].push_back(editsMs);
+        m_times["Demand"].push_back(demandMs);
+        m_times["Population"].push_back(populationMs);
+        m_times["Traffic"].push_back(trafficMs);
+        m_times["Tick"].push_back(tickMs);
+        m_times["Uploads"].push_back(uploadsMs);
+
+        for (const auto& timing : m_eventBus->GetTimings())
+        {
+            m_times[timing.name].push_back(timing.ms);
+        }
+    }
+
+    m_peakRss = memory::Memory::GetPeakRss();
+}
+
+//-------------------------------------------------
+// Report
+//-------------------------------------------------
+
+uint32_t sg::city::benchmark::Scenario::GetOverBudgetTicks() const
+{
+    return m_overBudgetTicks;
+}
+
+uint32_t sg::city::benchmark::Scenario::GetAllocatingSteadyStateTicks() const
+{
+    return m_allocatingSteadyStateTicks;
+}
+
+void sg::city::benchmark::Scenario::PrintReport() const
+{
+    std::printf("Map %dx%d | %u ticks | %u cars | %u skipped edits\n",
+        m_options.mapSize, m_options.mapSize, m_options.ticks,
+        static_cast<uint32_t>(m_registry.size<automata::Automata>()), m_skippedEdits);
+
+    std::printf("%-12s %10s %10s %10s %10s\n", "Subsystem", "p50 ms", "p95 ms", "p99 ms", "max ms");
+
+    for (const auto& [name, times] : m_times)
+    {
+        const auto percentiles{ CalcPercentiles({ times.begin(), times.end() }) };
+        std::printf("%-12s %10.4f %10.4f %10.4f %10.4f\n", name.c_str(), percentiles.p50, percentiles.p95, percentiles.p99, percentiles.max);
+    }
+
+    const auto allocations{ CalcPercentiles({ m_tickAllocations.begin(), m_tickAllocations.end() }) };
+    std::printf("Allocations per tick: p50 %.0f | p95 %.0f | p99 %.0f | max %.0f | setup %llu\n",
+        allocations.p50, allocations.p95, allocations.p99, allocations.max, static_cast<unsigned long long>(m_setupAllocations));
+
+    std::printf("Steady-state ticks: %u | allocating: %u\n", m_steadyStateTicks, m_allocatingSteadyStateTicks);
+
+    std::printf("%-12s %10s %10s %12s %10s\n", "Memory", "live KB", "peak KB", "allocations", "max/tick");
+
+    for (auto i{ 0u }; i < memory::Memory::NR_OF_TAGS; ++i)
+    {
+        const auto tag{ static_cast<memory::Tag>(i) };
+        const auto tagStats{ memory::Memory::GetTagStats(tag) };
+        const auto& tickAllocations{ m_tagTickAllocations[i] };
+        const auto maxPerTick{ tickAllocations.empty() ? 0ull : *std::max_element(tickAllocations.begin(), tickAllocations.end()) };
+
+        std::printf("%-12s %10.1f %10.1f %12llu %10llu\n", memory::Memory::GetName(tag),
+            static_cast<double>(tagStats.liveBytes) / 1024.0,
+            static_cast<double>(tagStats.peakBytes) / 1024.0,
+            static_cast<unsigned long long>(tagStats.allocations),
+            static_cast<unsigned long long>(maxPerTick));
+    }
+
+    const auto uploads{ CalcPercentiles({ m_tickUploadBytes.begin(), m_tickUploadBytes.end() }) };
+    std::printf("Gpu upload per tick: p50 %.0f | p95 %.0f | p99 %.0f | max %.0f bytes\n",
+        uploads.p50, uploads.p95, uploads.p99, uploads.max);
+
+    if (m_options.uploadBudgetBytes > 0)
+    {
+        std::printf("Upload budget: %llu bytes | %u ticks over budget\n",
+            static_cast<unsigned long long>(m_options.uploadBudgetBytes), m_overBudgetTicks);
+    }
+
+    std::printf("Peak RSS: %.1f MB\n", static_cast<double>(m_peakRss) / (1024.0 * 1024.0));
+}
+
+void sg::city::benchmark::Scenario::WriteJson(const std::string& t_fileName) const
+{
+    std::ofstream file{ t_fileName };
+    if (!file)
+    {
+        throw std::runtime_error("[Scenario::WriteJson()] Unable to open " + t_fileName);
+    }
+
+    auto totalAllocations{ m_setupAllocations };
+    for (auto allocations : m_tickAllocations)
+    {
+        totalAllocations += allocations;
+    }
+
+    const auto allocations{ CalcPercentiles({ m_tickAllocations.begin(), m_tickAllocations.end() }) };
+
+    char line[512];
+
+    file << "{\n";
+    file << "  \"version\": 1,\n";
+
+    std::snprintf(line, sizeof(line), "  \"mapSize\": %d,\n  \"ticks\": %u,\n  \"peakRssBytes\": %llu,\n  \"setupAllocations\": %llu,\n  \"allocations\": %llu,\n",
+        m_options.mapSize, m_options.ticks,
+        static_cast<unsigned long long>(m_peakRss),
+        static_cast<unsigned long long>(m_setupAllocations),
+        static_cast<unsigned long long>(totalAllocations)
+    );
+    file << line;
+
+    std::snprintf(line, sizeof(line), "  \"tickAllocations\": { \"p50\": %.0f, \"p95\": %.0f, \"p99\": %.0f, \"max\": %.0f },\n",
+        allocations.p50, allocations.p95, allocations.p99, allocations.max);
+    file << line;
+
+    const auto uploads{ CalcPercentiles({ m_tickUploadBytes.begin(), m_tickUploadBytes.end() }) };
+    std::snprintf(line, sizeof(line), "  \"tickUploadBytes\": { \"p50\": %.0f, \"p95\": %.0f, \"p99\": %.0f, \"max\": %.0f },\n  \"uploadBudgetBytes\": %llu,\n  \"overBudgetTicks\": %u,\n",
+        uploads.p50, uploads.p95, uploads.p99, uploads.max,
+        static_cast<unsigned long long>(m_options.uploadBudgetBytes), m_overBudgetTicks);
+    file << line;
+
+    std::snprintf(line, sizeof(line), "  \"steadyStateTicks\": %u,\n  \"allocatingSteadyStateTicks\": %u,\n",
+        m_steadyStateTicks, m_allocatingSteadyStateTicks);
+    file << line;
+
+    file << "  \"memory\": [\n";
+
+    for (auto i{ 0u }; i < memory::Memory::NR_OF_TAGS; ++i)
+    {
+        const auto tag{ static_cast<memory::Tag>(i) };
+        const auto tagStats{ memory::Memory::GetTagStats(tag) };
+        const auto tickAllocations{ CalcPercentiles({ m_tagTickAllocations[i].begin(), m_tagTickAllocations[i].end() }) };
+
+        std::snprintf(line, sizeof(line), "    { \"name\": \"%s\", \"liveBytes\": %llu, \"peakBytes\": %llu, \"allocations\": %llu, \"p99TickAllocations\": %.0f, \"maxTickAllocations\": %.0f }%s\n",
+            memory::Memory::GetName(tag),
+            static_cast<unsigned long long>(tagStats.liveBytes),
+            static_cast<unsigned long long>(tagStats.peakBytes),
+            static_cast<unsigned long long>(tagStats.allocations),
+            tickAllocations.p99, tickAllocations.max,
+            i + 1 < memory::Memory::NR_OF_TAGS ? "," : "");
+        file << line;
+    }
+
+    file << "  ],\n";
+
+    file << "  \"subsystems\": [\n";
+
+    auto i{ 0u };
+    for (const auto& [name, times] : m_times)
+    {
+        const auto percentiles{ CalcPercentiles({ times.begin(), times.end() }) };
+
+        std::snprintf(line, sizeof(line), "    { \"name\": \"%s\", \"p50Ms\": %.6f, \"p95Ms\": %.6f, \"p99Ms\": %.6f, \"maxMs\": %.6f }%s\n",
+            name.c_str(), percentiles.p50, percentiles.p95, percentiles.p99, percentiles.max,
+            ++i < m_times.size() ? "," : "");
+        file << line;
+    }
+
+    file << "  ]\n";
+    file << "}\n";
+}
+
+sg::city::benchmark::Scenario::Percentiles sg::city::benchmark::Scenario::CalcPercentiles(std::vector<double> t_values)
+{
+    Percentiles percentiles;
+
+    if (t_values.empty())
+    {
+        return percentiles;
+    }
+
+    std::sort(t_values.begin(), t_values.end());
+
+    const auto rank = [&t_values](const double t_percentile)
+    {
+        const auto index{ static_cast<size_t>(std::ceil(t_percentile * static_cast<double>(t_values.size()))) };
+        return t_values[std::clamp(index, static_cast<size_t>(1), t_values.size()) - 1];
+    };
+
+    percentiles.p50 = rank(0.50);
+    percentiles.p95 = rank(0.95);
+    percentiles.p99 = rank(0.99);
+    percentiles.max = t_values.back();
+
+    return percentiles;
+}
+
+//-------------------------------------------------
+// Init
+//-------------------------------------------------
+
+void sg::city::benchmark::Scenario::Init()
+{
+    const auto isSaveFile{ save::SaveGame::IsSaveFile(m_options.mapFileName) };
+
+    save::SaveData saveData;
+    if (isSaveFile)
+    {
+        saveData = save::SaveGame::Read(m_options.mapFileName);
+        CreateMapFromSaveData(saveData);
+    }
+    else
+    {
+        CreateMapFromValues();
+    }
+
+    // no Gpu: record the uploads; the initial upload is not part of a tick
+    gpu::Gpu::SetBackend(std::make_unique<gpu::RecordingBackend>());
+    m_map->FlushTileAttributes();
+    gpu::Gpu::ResetCounters();
+
+    // a car index without buildings
+    m_spatialIndex = std::make_unique<spatial::SpatialIndex>(m_map->GetMapSize(), m_registry);
+    m_systems = std::make_unique<system::Systems>(*m_map, *m_spatialIndex, m_registry, m_random);
+
+    // the floors of the population have no buildings to change
+    if (isSaveFile)
+    {
+        m_systems->RestorePopulation(saveData);
+    }
+    else
+    {
+        m_systems->InitPopulation();
+    }
+
+    m_eventBus = std::make_unique<event::EventBus>();
+    SubscribeSystems();
+
+    m_timeline = m_options.timelineFileName.empty()
+        ? CreateDefaultTimeline(m_options.mapSize, m_options.ticks)
+        : ReadTimeline(m_options.timelineFileName);
+}
+
+void sg::city::benchmark::Scenario::CreateMapFromValues()
+{
+    map::Map::MapValuesContainer values;
+
+    if (m_options.mapFileName.empty())
+    {
+        values = Layout::CreateGrid(m_options.mapSize, m_random);
+    }
+    else if (IsImageFile(m_options.mapFileName))
+    {
+        // like the City loads a map file, but without a GL context
+        auto importedMap{ map::MapImporter::Import(m_options.mapFileName) };
+        if (importedMap.width != importedMap.height)
+        {
+            throw std::runtime_error("[Scenario::CreateMapFromValues()] The map image must be square.");
+        }
+
+        m_options.mapSize = static_cast<int>(importedMap.width);
+        values = std::move(importedMap.values);
+    }
+    else
+    {
+        throw std::runtime_error("[Scenario::CreateMapFromValues()] Unknown map file " + m_options.mapFileName);
+    }
+
+    m_map = std::make_unique<map::Map>(nullptr, m_options.mapFileName, m_random);
+    m_map->CreateMapFromValues(m_options.mapSize, std::move(values));
+
+    // the initial tracks and regions, like City::Init()
+    for (auto roadIndex : m_map->roadIndices)
+    {
+        m_map->GetTiles()[roadIndex]->Update();
+    }
+
+    m_map->FindConnectedRegions();
+}
+
+void sg::city::benchmark::Scenario::CreateMapFromSaveData(const save::SaveData& t_saveData)
+{
+    // like City::Restore(), but without buildings and cars - both need a Gpu
+    m_options.mapSize = t_saveData.mapSize;
+
+    m_map = std::make_unique<map::Map>(nullptr, m_options.mapFileName, m_random);
+    m_map->CreateMapFromTypes(t_saveData.mapSize, t_saveData.tileTypes);
+    m_map->Restore(t_saveData);
+}
+
+void sg::city::benchmark::Scenario::SubscribeSystems()
+{
+    // the same names and order as City::SubscribeSystems(); the buildings need a Gpu
+    m_eventBus->Subscribe<event::TileChanged>("Tiles", [this](const std::vector<event::TileChanged>& t_events)
+    {
+        m_systems->UpdateChangedTiles(t_events);
+    });
+
+    m_eventBus->Subscribe<event::TileChanged>("Population", [this](const std::vector<event::TileChanged>& t_events)
+    {
+        m_systems->UpdatePopulationTiles(t_events);
+    });
+
+    m_eventBus->Subscribe<event::TileChanged>("Regions", [this](const std::vector<event::TileChanged>&)
+    {
+        m_systems->UpdateRegions();
+    });
+
+    m_eventBus->Subscribe<event::RoadTopologyChanged>("Roads", [this](const std::vector<event::RoadTopologyChanged>& t_events)
+    {
+        m_systems->UpdateRoads(t_events);
+    });
+}
+
+//-------------------------------------------------
+// Edits
+//-------------------------------------------------
+
+void sg::city::benchmark::Scenario::ApplyEdit(const Edit& t_edit)
+{
+    const auto last{ m_options.mapSize - 1 };
+    const auto x0{ std::clamp(t_edit.x0, 0, last) };
+    const auto z0{ std::clamp(t_edit.z0, 0, last) };
+    const auto x1{ std::clamp(t_edit.x1, 0, last) };
+    const auto z1{ std::clamp(t_edit.z1, 0, last) };
+
+    switch (t_edit.type)
+    {
+    case EditType::ROAD:
+        for (auto x{ std::min(x0, x1) }; x <= std::max(x0, x1); ++x)
+        {
+            ReplaceTile(x, z0, map::tile::TileType::TRAFFIC);
+        }
+        for (auto z{ std::min(z0, z1) }; z <= std::max(z0, z1); ++z)
+        {
+            if (z != z0)
+            {
+                ReplaceTile(x1, z, map::tile::TileType::TRAFFIC);
+            }
+        }
+        break;
+    case EditType::ZONE:
+    case EditType::CLEAR:
+        for (auto z{ std::min(z0, z1) }; z <= std::max(z0, z1); ++z)
+        {
+            for (auto x{ std::min(x0, x1) }; x <= std::max(x0, x1); ++x)
+            {
+                ReplaceTile(x, z, t_edit.type == EditType::ZONE ? map::tile::TileType::RESIDENTIAL : map::tile::TileType::NONE);
+            }
+        }
+        break;
+    case EditType::CARS:
+        SpawnCars(t_edit.count);
+        break;
+    }
+}
+
+void sg::city::benchmark::Scenario::ReplaceTile(const int t_mapX, const int t_mapZ, const map::tile::TileType t_tileType)
+{
+    const auto tileIndex{ m_map->GetTileMapIndexByMapPosition(t_mapX, t_mapZ) };
+    const auto currentTileType{ m_map->GetTiles()[tileIndex]->type };
+
+    if (currentTileType == map::tile::TileType::TRAFFIC ||
+        (t_tileType == map::tile::TileType::TRAFFIC && currentTileType != map::tile::TileType::NONE) ||
+        currentTileType == t_tileType)
+    {
+        m_skippedEdits++;
+        return;
+    }
+
+    m_map->ReplaceTile(tileIndex, t_tileType);
+
+    m_eventBus->Publish(event::TileChanged{ tileIndex, currentTileType, t_tileType });
+
+    if (t_tileType == map::tile::TileType::TRAFFIC)
+    {
+        m_eventBus->Publish(event::RoadTopologyChanged{ tileIndex });
+    }
+}
+
+void sg::city::benchmark::Scenario::SpawnCars(const uint32_t t_count)
+{
+    auto& tiles{ m_map->GetTiles() };
+
+    std::vector<automata::AutoTrack*> safeTracks;
+    for (auto roadIndex : m_map->roadIndices)
+    {
+        for (auto& track : dynamic_cast<map::tile::RoadTile*>(tiles[roadIndex].get())->GetAutoTracks())
+        {
+            if (track->isSafe)
+            {
+                safeTracks.push_back(track.get());
+            }
+        }
+    }
+
+    if (safeTracks.empty())
+    {
+        return;
+    }
+
+    auto stream{ m_random.GetStream(random::Domain::SPAWN, 0, m_tick) };
+
+    for (auto i{ 0u }; i < t_count; ++i)
+    {
+        auto* track{ safeTracks[stream.NextIndex(static_cast<uint32_t>(safeTracks.size()))] };
+
+        // like City::CreateCarEntity() without the Model
+        const auto entity{ m_registry.create() };
+        m_registry.assign<ogl::ecs::component::TransformComponent>(entity);
+
+        auto& automata{ m_registry.assign<automata::Automata>(entity) };
+        automata.autoLength = 0.2f;
+        automata.currentTrack = track;
+        automata.rootNode = track->startNode.get();
+        automata.randomStream = m_random.GetStream(random::Domain::TRAFFIC, m_nextAutomataId++, m_tick);
+
+        track->automatas.push_back(entity);
+        automata.Update(0.0f, entity, m_registry);
+
+        m_spatialIndex->InsertVehicle(entity, automata);
+    }
+}
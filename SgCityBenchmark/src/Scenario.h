@@ -0,0 +1,270 @@
+// This file is part of the SgCityBuilder package.
+// 
+// Filename: Scenario.h
+// Author:   stwe
+// 
+// License:  MIT
+// 
+// 2020 (c) stwe <https://github.com/stwe/SgCityBuilder>
+
+#pragma once
+
+#include <map>
+#include <array>
+#include <memory>
+#include <string>
+#include <vector>
+#include <entt/entt.hpp>
+#include "map/Map.h"
+#include "city/EventBus.h"
+#include "city/Memory.h"
+#include "city/SpatialIndex.h"
+#include "city/Systems.h"
+
+namespace sg::city::benchmark
+{
+    struct ScenarioOptions
+    {
+        /**
+         * @brief A City saved by City::Save() (.city) or a map image (.png).
+         *        If empty, a procedural Layout of mapSize is used.
+         */
+        std::string mapFileName;
+        int mapSize{ 256 };
+
+        /**
+         * @brief The timeline script. If empty, the default timeline is used.
+         */
+        std::string timelineFileName;
+
+        uint32_t ticks{ 600 };
+
+        /**
+         * @brief The maximum Gpu upload of a tick in bytes. 0 disables the check.
+         */
+        uint64_t uploadBudgetBytes{ 0 };
+
+        /**
+         * @brief Fails the run if a steady-state tick allocates.
+         */
+        bool failOnSteadyStateAllocations{ false };
+
+        std::string outFileName{ "scenario.json" };
+    };
+
+    enum class EditType
+    {
+        ROAD,  // paints a road from (x0, z0) to (x1, z1), first along x, then along z
+        ZONE,  // makes all Tiles in the rectangle residential
+        CLEAR, // demolishes all Tiles in the rectangle except the roads
+        CARS   // spawns count cars on random safe tracks
+    };
+
+    struct Edit
+    {
+        uint64_t tick{ 0 };
+        EditType type{ EditType::ROAD };
+        int x0{ 0 };
+        int z0{ 0 };
+        int x1{ 0 };
+        int z1{ 0 };
+        uint32_t count{ 0 };
+    };
+
+    /**
+     * @brief Replays a timeline of edits on a headless City and measures each tick.
+     *        The systems are the Gpu-free part of the City: Tiles, regions, road tracks, population, demand and cars.
+     *        The Tile uploads are recorded by the gpu::RecordingBackend.
+     */
+    class Scenario
+    {
+    public:
+        using EditContainer = std::vector<Edit>;
+        using TimeContainer = std::vector<float>;
+        using SubsystemTimeContainer = std::map<std::string, TimeContainer>;
+        using AllocationContainer = std::vector<uint64_t>;
+        using UploadContainer = std::vector<uint64_t>;
+
+        struct Percentiles
+        {
+            double p50{ 0.0 };
+            double p95{ 0.0 };
+            double p99{ 0.0 };
+            double max{ 0.0 };
+        };
+
+        //-------------------------------------------------
+        // Const
+        //-------------------------------------------------
+
+        static constexpr auto DT{ 1.0f / 60.0f };
+
+        /**
+         * @brief A tick is in the steady state if no edit was applied in the last STEADY_STATE_DELAY ticks.
+         */
+        static constexpr uint64_t STEADY_STATE_DELAY{ 60 };
+
+        //-------------------------------------------------
+        // Ctors. / Dtor.
+        //-------------------------------------------------
+
+        Scenario() = delete;
+
+        explicit Scenario(ScenarioOptions t_options);
+
+        Scenario(const Scenario& t_other) = delete;
+        Scenario(Scenario&& t_other) noexcept = delete;
+        Scenario& operator=(const Scenario& t_other) = delete;
+        Scenario& operator=(Scenario&& t_other) noexcept = delete;
+
+        ~Scenario() noexcept;
+
+        //-------------------------------------------------
+        // Timeline
+        //-------------------------------------------------
+
+        /**
+         * @brief Reads a timeline script. Each line is "<tick> <command> <arguments>":
+         *        road x0 z0 x1 z1, zone x0 z0 x1 z1, clear x0 z0 x1 z1 or cars count.
+         *        Empty lines and lines starting with # are skipped.
+         * @param t_fileName The script.
+         * @return The edits sorted by tick.
+         */
+        [[nodiscard]] static EditContainer ReadTimeline(const std::string& t_fileName);
+
+        /**
+         * @brief Road painting, zoning storms and bulk car spawns spread over the ticks.
+         * @param t_mapSize The number of Tiles in the x and z direction.
+         * @param t_ticks The number of ticks.
+         * @return The edits sorted by tick.
+         */
+        [[nodiscard]] static EditContainer CreateDefaultTimeline(int t_mapSize, uint32_t t_ticks);
+
+        /**
+         * @brief A map image like the map files of the City; imported with the MapImporter.
+         * @param t_fileName The file name.
+         * @return True for a .png file.
+         */
+        [[nodiscard]] static bool IsImageFile(const std::string& t_fileName);
+
+        //-------------------------------------------------
+        // Run
+        //-------------------------------------------------
+
+        void Run();
+
+        //-------------------------------------------------
+        // Report
+        //-------------------------------------------------
+
+        /**
+         * @brief The number of ticks that uploaded more than the upload budget.
+         * @return uint32_t
+         */
+        [[nodiscard]] uint32_t GetOverBudgetTicks() const;
+
+        /**
+         * @brief The number of steady-state ticks that allocated.
+         * @return uint32_t
+         */
+        [[nodiscard]] uint32_t GetAllocatingSteadyStateTicks() const;
+
+        void PrintReport() const;
+        void WriteJson(const std::string& t_fileName) const;
+
+        /**
+         * @brief Nearest-rank percentiles.
+         * @param t_values The values; are sorted.
+         * @return Percentiles
+         */
+        [[nodiscard]] static Percentiles CalcPercentiles(std::vector<double> t_values);
+
+    protected:
+
+    private:
+        ScenarioOptions m_options;
+
+        random::Random m_random;
+
+        std::unique_ptr<map::Map> m_map;
+        std::unique_ptr<event::EventBus> m_eventBus;
+
+        /**
+         * @brief The cars. Declared after the Map, so the cars are destroyed before the tracks.
+         */
+        entt::registry m_registry;
+
+        std::unique_ptr<spatial::SpatialIndex> m_spatialIndex;
+
+        /**
+         * @brief The same Tile, road, population and car systems as the City.
+         */
+        std::unique_ptr<system::Systems> m_systems;
+
+        EditContainer m_timeline;
+
+        uint64_t m_tick{ 0 };
+        uint64_t m_nextAutomataId{ 0 };
+
+        /**
+         * @brief The time of each tick per subsystem in ms.
+         */
+        SubsystemTimeContainer m_times;
+
+        /**
+         * @brief The number of allocations of each tick.
+         */
+        AllocationContainer m_tickAllocations;
+
+        /**
+         * @brief The number of allocations of each tick per memory Tag.
+         */
+        std::array<AllocationContainer, memory::Memory::NR_OF_TAGS> m_tagTickAllocations;
+
+        uint32_t m_steadyStateTicks{ 0 };
+        uint32_t m_allocatingSteadyStateTicks{ 0 };
+
+        /**
+         * @brief The uploaded bytes of each tick.
+         */
+        UploadContainer m_tickUploadBytes;
+
+        uint32_t m_overBudgetTicks{ 0 };
+
+        uint64_t m_setupAllocations{ 0 };
+        uint64_t m_peakRss{ 0 };
+        uint32_t m_skippedEdits{ 0 };
+
+        //-------------------------------------------------
+        // Init
+        //-------------------------------------------------
+
+        void Init();
+        void CreateMapFromValues();
+
+        /**
+         * @brief Restores the Tiles, roads, signals and regions of a save file.
+         *        The buildings and cars of the file are not used.
+         * @param t_saveData The read save file.
+         */
+        void CreateMapFromSaveData(const save::SaveData& t_saveData);
+
+        void SubscribeSystems();
+
+        //-------------------------------------------------
+        // Edits
+        //-------------------------------------------------
+
+        void ApplyEdit(const Edit& t_edit);
+
+        /**
+         * @brief The rules of City::ReplaceTile() without buildings.
+         * @param t_mapX Map-x position of the Tile.
+         * @param t_mapZ Map-z position of the Tile.
+         * @param t_tileType The new TileType.
+         */
+        void ReplaceTile(int t_mapX, int t_mapZ, map::tile::TileType t_tileType);
+
+        void SpawnCars(uint32_t t_count);
+    };
+}
@@ -0,0 +1,36 @@
+// This file is part of the SgCityBuilder package.
+// 
+// Filename: Suites.h
+// Author:   stwe
+// 
+// License:  MIT
+// 
+// 2020 (c) stwe <https://github.com/stwe/SgCityBuilder>
+
+#pragma once
+
+#include <cstdint>
+
+namespace sg::city::benchmark
+{
+    class Runner;
+
+    /**
+     * @brief The Map size of the traffic benchmarks.
+     */
+    constexpr auto TRAFFIC_MAP_SIZE{ 256 };
+
+    /**
+     * @brief Map construction, regions, road rebuilds, Tile packing and building floors.
+     * @param t_runner The Runner.
+     * @param t_mapSize The number of Tiles in the x and z direction.
+     */
+    void RunMapSuite(Runner& t_runner, int t_mapSize);
+
+    /**
+     * @brief One Automata::Update() of all cars.
+     * @param t_runner The Runner.
+     * @param t_cars The number of cars on a TRAFFIC_MAP_SIZE Map.
+     */
+    void RunTrafficSuite(Runner& t_runner, uint32_t t_cars);
+}
@@ -0,0 +1,94 @@
+// This file is part of the SgCityBuilder package.
+// 
+// Filename: TrafficSuite.cpp
+// Author:   stwe
+// 
+// License:  MIT
+// 
+// 2020 (c) stwe <https://github.com/stwe/SgCityBuilder>
+
+#include <limits>
+#include <algorithm>
+#include <entt/entt.hpp>
+#include "Suites.h"
+#include "Benchmark.h"
+#include "Layout.h"
+#include "map/Map.h"
+#include "map/tile/RoadTile.h"
+#include "automata/Automata.h"
+#include "automata/AutoTrack.h"
+
+void sg::city::benchmark::RunTrafficSuite(Runner& t_runner, const uint32_t t_cars)
+{
+    static constexpr auto DT{ 1.0f / 60.0f };
+    static constexpr auto AUTO_LENGTH{ 0.2f };
+    static constexpr auto AUTO_DISTANCE{ 0.3f };
+
+    if (!t_runner.IsEnabled("Traffic/AutomataUpdate"))
+    {
+        return;
+    }
+
+    const random::Random random;
+
+    auto map{ std::make_unique<map::Map>(nullptr, "", random) };
+    map->CreateMapFromValues(TRAFFIC_MAP_SIZE, Layout::CreateGrid(TRAFFIC_MAP_SIZE, random));
+
+    // create the tracks and collect them
+    std::vector<automata::AutoTrack*> tracks;
+    for (auto& tile : map->GetTiles())
+    {
+        if (tile->type == map::tile::TileType::TRAFFIC)
+        {
+            tile->Update();
+
+            for (auto& track : dynamic_cast<map::tile::RoadTile*>(tile.get())->GetAutoTracks())
+            {
+                tracks.push_back(track.get());
+            }
+        }
+    }
+
+    if (tracks.empty())
+    {
+        return;
+    }
+
+    // the cars are distributed round-robin over the tracks; the first car of a track is in front
+    entt::registry registry;
+
+    for (auto i{ 0u }; i < t_cars; ++i)
+    {
+        auto* track{ tracks[i % tracks.size()] };
+        const auto positionOnTrack{ i / static_cast<uint32_t>(tracks.size()) };
+
+        const auto entity{ registry.create() };
+        auto& automata{ registry.assign<automata::Automata>(entity) };
+        automata.autoLength = AUTO_LENGTH;
+        automata.autoPosition = std::max(0.0f, track->trackLength - static_cast<float>(positionOnTrack) * AUTO_DISTANCE);
+        automata.currentTrack = track;
+        automata.rootNode = track->startNode.get();
+        automata.lifetime = std::numeric_limits<float>::max();
+        automata.randomStream = random.GetStream(random::Domain::TRAFFIC, i, 0);
+
+        track->automatas.push_back(entity);
+    }
+
+    // one tick of all cars, like City::UpdateVehicles() without the Transform
+    t_runner.Run("Traffic/AutomataUpdate", TRAFFIC_MAP_SIZE, t_cars, {}, [&registry]()
+    {
+        auto view{ registry.view<automata::Automata>() };
+
+        for (auto entity : view)
+        {
+            auto& automata{ view.get<automata::Automata>(entity) };
+            if (!automata.deleteAutomata)
+            {
+                automata.Update(DT, entity, registry);
+            }
+        }
+    });
+
+    // the tracks are destroyed with the Map
+    registry.clear();
+}
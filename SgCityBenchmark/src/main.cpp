@@ -0,0 +1,287 @@
+// This file is part of the SgCityBuilder package.
+// 
+// Filename: main.cpp
+// Author:   stwe
+// 
+// License:  MIT
+// 
+// 2020 (c) stwe <https://github.com/stwe/SgCityBuilder>
+
+#include <cstdio>
+#include <string>
+#include <sstream>
+#include <exception>
+#include <Log.h>
+#include "Benchmark.h"
+#include "Suites.h"
+#include "Scenario.h"
+#include "Checks.h"
+
+namespace
+{
+    template <typename T>
+    std::vector<T> ReadList(const std::string& t_value)
+    {
+        std::vector<T> values;
+        std::stringstream stream{ t_value };
+        std::string item;
+
+        while (std::getline(stream, item, ','))
+        {
+            values.push_back(static_cast<T>(std::stoll(item)));
+        }
+
+        return values;
+    }
+
+    void PrintUsage()
+    {
+        std::printf(
+            "Usage: SgCityBenchmark [options]\n"
+            "       SgCityBenchmark scenario [scenario options]\n"
+            "       SgCityBenchmark checks\n"
+            "\n"
+            "  --out <file>          Json result file (default: benchmark.json)\n"
+            "  --baseline <file>     Json result file of a previous run to compare with\n"
+            "  --threshold <value>   Allowed slowdown of the median, e.g. 0.1 for 10%%\n"
+            "  --sizes <list>        Map sizes, e.g. 64,256,1024,2048 (default: 64,256,1024)\n"
+            "  --cars <list>         Car counts (default: 1000,10000,100000)\n"
+            "  --filter <name>       Run only benchmarks whose name contains <name>\n"
+            "  --iterations <n>      Maximum number of measured iterations (default: 50)\n"
+            "\n"
+            "Scenario options:\n"
+            "  --map <file>          City saved as .city or a map image .png (default: procedural layout)\n"
+            "  --size <n>            Size of the procedural layout (default: 256)\n"
+            "  --timeline <file>     Timeline script (default: built-in timeline)\n"
+            "  --ticks <n>           Number of simulation ticks (default: 600)\n"
+            "  --out <file>          Json result file (default: scenario.json)\n"
+            "  --upload-budget <n>   Maximum Gpu upload of a tick in bytes; exceeding fails the run\n"
+            "  --strict-alloc <0|1>  Fail the run if a steady-state tick allocates (default: 0)\n"
+        );
+    }
+
+    bool ReadScenarioOptions(const int t_argc, char* t_argv[], sg::city::benchmark::ScenarioOptions& t_options)
+    {
+        for (auto i{ 2 }; i < t_argc; ++i)
+        {
+            const std::string arg{ t_argv[i] };
+
+            if (arg == "--help" || i + 1 >= t_argc)
+            {
+                return false;
+            }
+
+            const std::string value{ t_argv[++i] };
+
+            if (arg == "--map")
+            {
+                t_options.mapFileName = value;
+            }
+            else if (arg == "--size")
+            {
+                t_options.mapSize = std::stoi(value);
+            }
+            else if (arg == "--timeline")
+            {
+                t_options.timelineFileName = value;
+            }
+            else if (arg == "--ticks")
+            {
+                t_options.ticks = static_cast<uint32_t>(std::stoul(value));
+            }
+            else if (arg == "--out")
+            {
+                t_options.outFileName = value;
+            }
+            else if (arg == "--upload-budget")
+            {
+                t_options.uploadBudgetBytes = std::stoull(value);
+            }
+            else if (arg == "--strict-alloc")
+            {
+                t_options.failOnSteadyStateAllocations = value == "1";
+            }
+            else
+            {
+                std::printf("Unknown option %s\n", arg.c_str());
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    int RunScenario(const int t_argc, char* t_argv[])
+    {
+        sg::city::benchmark::ScenarioOptions options;
+        if (!ReadScenarioOptions(t_argc, t_argv, options))
+        {
+            PrintUsage();
+            return 2;
+        }
+
+        try
+        {
+            sg::city::benchmark::Scenario scenario{ options };
+            scenario.Run();
+            scenario.PrintReport();
+            scenario.WriteJson(options.outFileName);
+
+            if (scenario.GetOverBudgetTicks() > 0)
+            {
+                return 1;
+            }
+
+            if (options.failOnSteadyStateAllocations && scenario.GetAllocatingSteadyStateTicks() > 0)
+            {
+                std::printf("Steady-state ticks allocated.\n");
+                return 1;
+            }
+        }
+        catch (const std::exception& e)
+        {
+            std::printf("%s\n", e.what());
+            return 2;
+        }
+
+        return 0;
+    }
+
+    int RunChecks()
+    {
+        try
+        {
+            auto failed{ 0u };
+            failed += sg::city::benchmark::RunCullingChecks();
+            failed += sg::city::benchmark::RunUploadChecks();
+            failed += sg::city::benchmark::RunPngChecks();
+            failed += sg::city::benchmark::RunRestoreChecks();
+
+            if (failed > 0)
+            {
+                std::printf("\n%u check(s) failed\n", failed);
+                return 1;
+            }
+        }
+        catch (const std::exception& e)
+        {
+            std::printf("%s\n", e.what());
+            return 2;
+        }
+
+        return 0;
+    }
+
+    bool ReadOptions(const int t_argc, char* t_argv[], sg::city::benchmark::Options& t_options)
+    {
+        for (auto i{ 1 }; i < t_argc; ++i)
+        {
+            const std::string arg{ t_argv[i] };
+
+            if (arg == "--help")
+            {
+                return false;
+            }
+
+            if (i + 1 >= t_argc)
+            {
+                std::printf("Missing value for %s\n", arg.c_str());
+                return false;
+            }
+
+            const std::string value{ t_argv[++i] };
+
+            if (arg == "--out")
+            {
+                t_options.outFileName = value;
+            }
+            else if (arg == "--baseline")
+            {
+                t_options.baselineFileName = value;
+            }
+            else if (arg == "--threshold")
+            {
+                t_options.threshold = std::stod(value);
+            }
+            else if (arg == "--sizes")
+            {
+                t_options.mapSizes = ReadList<int>(value);
+            }
+            else if (arg == "--cars")
+            {
+                t_options.carCounts = ReadList<uint32_t>(value);
+            }
+            else if (arg == "--filter")
+            {
+                t_options.filter = value;
+            }
+            else if (arg == "--iterations")
+            {
+                t_options.maxIterations = static_cast<uint32_t>(std::stoul(value));
+            }
+            else
+            {
+                std::printf("Unknown option %s\n", arg.c_str());
+                return false;
+            }
+        }
+
+        return true;
+    }
+}
+
+int main(const int t_argc, char* t_argv[])
+{
+    sg::ogl::Log::Init();
+
+    if (t_argc > 1 && std::string(t_argv[1]) == "scenario")
+    {
+        return RunScenario(t_argc, t_argv);
+    }
+
+    if (t_argc > 1 && std::string(t_argv[1]) == "checks")
+    {
+        return RunChecks();
+    }
+
+    sg::city::benchmark::Options options;
+    if (!ReadOptions(t_argc, t_argv, options))
+    {
+        PrintUsage();
+        return 2;
+    }
+
+    try
+    {
+        sg::city::benchmark::Runner runner{ options };
+
+        for (auto mapSize : options.mapSizes)
+        {
+            RunMapSuite(runner, mapSize);
+        }
+
+        for (auto cars : options.carCounts)
+        {
+            RunTrafficSuite(runner, cars);
+        }
+
+        runner.WriteJson(options.outFileName);
+
+        if (!options.baselineFileName.empty())
+        {
+            const auto regressions{ runner.CompareWithBaseline(options.baselineFileName) };
+            if (regressions > 0)
+            {
+                std::printf("\n%u regression(s)\n", regressions);
+                return 1;
+            }
+        }
+    }
+    catch (const std::exception& e)
+    {
+        std::printf("%s\n", e.what());
+        return 2;
+    }
+
+    return 0;
+}
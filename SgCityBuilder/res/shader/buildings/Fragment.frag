@@ -4,8 +4,9 @@
 
 in vec3 vPosition;
 in vec2 vUv;
+in vec2 vUvPerFloor;
 in vec3 vColor;
-in float vUseTexture;
+in float vTextureId;
 
 // Out
 
@@ -27,6 +28,10 @@ uniform vec3 cameraPosition;
 uniform sampler2D quadTextureAtlas0;
 uniform sampler2D quadTextureAtlas1;
 
+// Const
+
+const float GROUND_FLOOR_HEIGHT = 0.25;
+
 // Global
 
 vec4 diffuse;
@@ -59,18 +64,22 @@ void main()
     vec3 normal = vec3(0.0, 1.0, 0.0);
     vec3 viewDir = normalize(cameraPosition - vPosition);
 
+    // the ground floor has no texture; the texture repeats once per upper floor
+    float floorY = vPosition.y - GROUND_FLOOR_HEIGHT;
+    vec2 uv = vUv + fract(max(floorY, 0.0)) * vUvPerFloor;
+
     vec4 col = vec4(vColor, 1.0);
-    if (vUseTexture < 0.5)
+    if (vTextureId < 0.5 || floorY <= 0.0)
     {
         diffuse = col;
     }
-    else if (vUseTexture > 1.5)
+    else if (vTextureId > 1.5)
     {
-        diffuse = texture(quadTextureAtlas1, vec2(vUv.x, vUv.y)) * col;
+        diffuse = texture(quadTextureAtlas1, uv) * col;
     }
     else
     {
-        diffuse = texture(quadTextureAtlas0, vec2(vUv.x, vUv.y)) * col;
+        diffuse = texture(quadTextureAtlas0, uv) * col;
     }
 
     // calc ambient
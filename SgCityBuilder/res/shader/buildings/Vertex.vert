@@ -1,34 +1,63 @@
 #version 330
 
+// The buildings are drawn with glDrawArraysInstancedBaseInstance, which needs OpenGL 4.2 or ARB_base_instance.
+
 // In
 
 layout (location = 0) in vec3 aPosition;
 layout (location = 1) in vec3 aNormal;
 layout (location = 2) in vec2 aUv;
-layout (location = 3) in mat4 aInstanceMatrix; // 3, 4, 5, 6
-layout (location = 7) in vec4 aInstanceColor;
+layout (location = 3) in vec2 aInstancePosition; // x, z of the Tile
+layout (location = 4) in uvec4 aInstanceData;    // floors, color index, texture, flags
 
 // Out
 
 out vec3 vPosition;
 out vec2 vUv;
+out vec2 vUvPerFloor;
 out vec3 vColor;
-out float vUseTexture;
+out float vTextureId;
 
 // Uniforms
 
 uniform mat4 projectionMatrix;
 uniform mat4 viewMatrix;
 
+// Const
+
+const float MIN_COLOR = 0.4;
+const float MAX_COLOR = 0.8;
+const float GROUND_FLOOR_HEIGHT = 0.25;
+
 // Main
 
 void main()
 {
-    vec4 worldPosition = aInstanceMatrix * vec4(aPosition, 1.0);
-    gl_Position = projectionMatrix * viewMatrix * worldPosition;
-
-    vPosition = vec3(worldPosition);
-    vUv = aUv;
-    vColor = aInstanceColor.xyz;
-    vUseTexture = aInstanceColor.w;
+    // one box per building: the flat ground floor and the upper floors stacked on top - see BuildingGenerator::CalcFloorMatrix()
+    float height = GROUND_FLOOR_HEIGHT + float(max(int(aInstanceData.x), 1) - 1);
+    float unitY = aPosition.y + 0.5;
+
+    vec3 worldPosition = vec3(aPosition.x + aInstancePosition.x + 0.5, unitY * height, aPosition.z + aInstancePosition.y - 0.5);
+    gl_Position = projectionMatrix * viewMatrix * vec4(worldPosition, 1.0);
+
+    // the walls run vertically through their atlas cell: along v for the z faces and along u for the x faces;
+    // the fragment shader adds the vertical part once per floor, so the texture repeats instead of stretching
+    if (abs(aNormal.y) > 0.5)
+    {
+        vUvPerFloor = vec2(0.0);
+    }
+    else if (abs(aNormal.z) > 0.5)
+    {
+        vUvPerFloor = vec2(0.0, 0.5);
+    }
+    else
+    {
+        vUvPerFloor = vec2(0.25, 0.0);
+    }
+
+    vUv = aUv - unitY * vUvPerFloor;
+
+    vPosition = worldPosition;
+    vColor = vec3(MIN_COLOR + (MAX_COLOR - MIN_COLOR) * float(aInstanceData.y) / 255.0);
+    vTextureId = float(aInstanceData.z);
 }
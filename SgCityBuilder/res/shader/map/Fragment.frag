@@ -4,9 +4,10 @@
 
 in vec3 vWorldPosition;
 in vec3 vPosition;
-in vec3 vColor;
-in float vTexture;
 in vec2 vUv;
+flat in int vTexture;
+flat in int vRegionColor;
+flat in int vHovered;
 
 // Out
 
@@ -27,6 +28,7 @@ uniform DirectionalLight directionalLight;
 uniform vec3 cameraPosition;
 uniform sampler2D tileTexture[5];
 uniform float showRegionColor;
+uniform sampler2D palette; // row 0: region colors, row 1: TileType colors
 
 // Global
 
@@ -62,7 +64,11 @@ void main()
 
     if(showRegionColor > 0.5)
     {
-        diffuse = vec4(vColor, 1.0);
+        // Tiles without region use the TileType color
+        if (vRegionColor > 0)
+            diffuse = texelFetch(palette, ivec2(vRegionColor - 1, 0), 0);
+        else
+            diffuse = texelFetch(palette, ivec2(vTexture, 1), 0);
     }
     else
     {
@@ -86,5 +92,11 @@ void main()
     vec3 lightResult = CalcDirectionalLight(normal, viewDir);
 
     // result
-    fragColor = vec4(ambient + lightResult, 1.0);
+    vec3 color = ambient + lightResult;
+
+    // highlight the Tile under the mouse
+    if (vHovered == 1)
+        color = mix(color, vec3(1.0), 0.35);
+
+    fragColor = vec4(color, 1.0);
 }
@@ -2,35 +2,47 @@
 
 // In
 
-layout (location = 0) in vec3 aPosition;
-layout (location = 1) in vec3 aNormal;
-layout (location = 2) in vec3 aColor;
-layout (location = 3) in float aTexture;
-layout (location = 4) in vec2 aUv;
+layout (location = 0) in vec2 aPosition; // unit quad
+layout (location = 1) in uint aTile;     // type | flags << 8 | region color << 16
 
 // Out
 
 out vec3 vWorldPosition;
 out vec3 vPosition;
-out vec3 vColor;
-out float vTexture;
 out vec2 vUv;
+flat out int vTexture;
+flat out int vRegionColor;
+flat out int vHovered;
 
 // Uniforms
 
 uniform mat4 mvpMatrix;
 uniform mat4 worldMatrix;
+uniform int chunkOriginX;
+uniform int chunkOriginZ;
+uniform int chunkWidth;
+uniform int hoveredTileX;
+uniform int hoveredTileZ;
 
 // Main
 
 void main()
 {
-    gl_Position = mvpMatrix * vec4(aPosition, 1.0);
+    // the Tile position is given by the instance within the Chunk
+    int tileX = chunkOriginX + gl_InstanceID % chunkWidth;
+    int tileZ = chunkOriginZ + gl_InstanceID / chunkWidth;
+    float mapX = float(tileX);
+    float mapZ = float(tileZ);
 
-    vWorldPosition = vec3(worldMatrix * vec4(aPosition, 1.0));
+    vec3 position = vec3(mapX + aPosition.x, 0.0, -(mapZ + aPosition.y));
 
-    vPosition = aPosition;
-    vColor = aColor;
-    vTexture = aTexture;
-    vUv = aUv;
+    gl_Position = mvpMatrix * vec4(position, 1.0);
+
+    vWorldPosition = vec3(worldMatrix * vec4(position, 1.0));
+
+    vPosition = position;
+    vUv = aPosition;
+    vTexture = int(aTile & 0xFFu);
+    vRegionColor = int(aTile >> 16u);
+    vHovered = (tileX == hoveredTileX && tileZ == hoveredTileZ) ? 1 : 0;
 }
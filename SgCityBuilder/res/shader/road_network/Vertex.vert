@@ -2,11 +2,8 @@
 
 // In
 
-layout (location = 0) in vec3 aPosition;
-layout (location = 1) in vec3 aNormal;
-layout (location = 2) in vec3 aColor;
-layout (location = 3) in float aTexture;
-layout (location = 4) in vec2 aUv;
+layout (location = 0) in vec2 aPosition; // unit quad
+layout (location = 1) in uint aTile;     // type | road type << 8 | region color << 16
 
 // Out
 
@@ -18,15 +15,47 @@ out vec2 vUv;
 
 uniform mat4 mvpMatrix;
 uniform mat4 worldMatrix;
+uniform int chunkOriginX;
+uniform int chunkOriginZ;
+uniform int chunkWidth;
+uniform float roadHeight;
+uniform float textureAtlasRows;
+
+// Const
+
+const uint TRAFFIC = 4u;
 
 // Main
 
 void main()
 {
-    gl_Position = mvpMatrix * vec4(aPosition, 1.0);
-
-    vWorldPosition = vec3(worldMatrix * vec4(aPosition, 1.0));
-
-    vPosition = aPosition;
-    vUv = aUv;
+    // all other Tiles are moved out of the clip space
+    if ((aTile & 0xFFu) != TRAFFIC)
+    {
+        gl_Position = vec4(2.0, 2.0, 2.0, 1.0);
+        vWorldPosition = vec3(0.0);
+        vPosition = vec3(0.0);
+        vUv = vec2(0.0);
+        return;
+    }
+
+    // the same positions as for the Tile, but just a little bit higher
+    // the Tile position is given by the instance within the Chunk
+    float mapX = float(chunkOriginX + gl_InstanceID % chunkWidth);
+    float mapZ = float(chunkOriginZ + gl_InstanceID / chunkWidth);
+
+    vec3 position = vec3(mapX + aPosition.x, roadHeight, -(mapZ + aPosition.y));
+
+    gl_Position = mvpMatrix * vec4(position, 1.0);
+
+    vWorldPosition = vec3(worldMatrix * vec4(position, 1.0));
+
+    // the road type is the index in the texture atlas
+    int roadType = int((aTile >> 8u) & 0xFFu);
+    int rows = int(textureAtlasRows);
+    float xOffset = float(roadType % rows) / textureAtlasRows;
+    float yOffset = 1.0 - float(roadType / rows) / textureAtlasRows;
+
+    vPosition = position;
+    vUv = aPosition / textureAtlasRows + vec2(xOffset, yOffset);
 }
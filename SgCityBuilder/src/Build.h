@@ -11,3 +11,6 @@
 
 //#define ENABLE_TRAFFIC_DEBUG
 #define LOAD_MAP_8_8
+#define ENABLE_PROFILER
+
+// ENABLE_ALLOCATION_TRACKING is set by the build (Debug and SgCityBenchmark), so the shipped game keeps the operator new of the runtime
@@ -7,14 +7,22 @@
 // 
 // 2020 (c) stwe <https://github.com/stwe/SgCityBuilder>
 
+#include <cstdio>
+#include <stdexcept>
 #include "GameState.h"
 #include "input/MousePicker.h"
 #include "city/City.h"
+#include "city/SpatialIndex.h"
+#include "city/EventBus.h"
 #include "ecs/Components.h"
 #include "map/Map.h"
-#include "automata/Automata.h"
-#include "automata/AutoTrack.h"
-//#include "city/Timer.h"
+#include "simulation/PopulationGrowth.h"
+#include "simulation/Demand.h"
+#include "city/Profiler.h"
+#include "city/PerformanceStats.h"
+#include "city/Gpu.h"
+#include "city/FrameArena.h"
+#include "city/SaveGame.h"
 
 //-------------------------------------------------
 // Ctors. / Dtor.
@@ -38,6 +46,8 @@ GameState::~GameState() noexcept
 
 bool GameState::Input()
 {
+    SG_CITY_PROFILE_ZONE("GameState::Input");
+
     if (ImGui::GetIO().WantCaptureMouse)
     {
         return true;
@@ -45,23 +55,28 @@ bool GameState::Input()
 
     m_scene->GetCurrentCamera().Input();
 
-    if (sg::ogl::input::MouseInput::IsLeftButtonPressed())
-    {
-        m_mousePicker->Update(
-            static_cast<float>(GetApplicationContext()->GetMouseInput().GetCurrentPos().x),
-            static_cast<float>(GetApplicationContext()->GetMouseInput().GetCurrentPos().y)
-        );
+    // the picking is cheap enough to be done every frame
+    m_mousePicker->Update(
+        static_cast<float>(GetApplicationContext()->GetMouseInput().GetCurrentPos().x),
+        static_cast<float>(GetApplicationContext()->GetMouseInput().GetCurrentPos().y)
+    );
 
-        m_mapPoint = m_mousePicker->GetCurrentMapPoint();
+    m_hoverPoint = m_mousePicker->GetCurrentMapPoint();
+    m_city->GetMap().hoveredTile = glm::ivec2(m_hoverPoint.x, m_hoverPoint.z);
 
-        if (m_mapPoint.x >= 0)
+    if (sg::ogl::input::MouseInput::IsLeftButtonPressed())
+    {
+        if (m_hoverPoint.x >= 0)
         {
+            m_mapPoint = m_hoverPoint;
+
             SG_OGL_LOG_INFO("[GameState::Input()] Replace Tile on x: {}, z: {}.", m_mapPoint.x, m_mapPoint.z);
+            // the City publishes the change; the systems react with the next update
             const auto[changedTileIndex, skip]{ m_city->ReplaceTile(m_mapPoint.x, m_mapPoint.z, m_currentEditTileType) };
 
-            if (!skip)
+            if (skip)
             {
-                m_changedTiles.push_back(changedTileIndex);
+                SG_OGL_LOG_INFO("[GameState::Input()] Tile {} not changed.", changedTileIndex);
             }
 
             // delete mouse state
@@ -76,24 +91,35 @@ bool GameState::Update(const double t_dt)
 {
     m_scene->GetCurrentCamera().Update(t_dt);
 
+    SG_CITY_PROFILE_ZONE("GameState::Update");
+
+    if (m_loadCity)
     {
-        //sg::city::timer::Timer timer;
-        m_city->Update(t_dt, m_changedTiles);
+        m_loadCity = false;
+        LoadCity();
     }
 
-    UpdateCars(t_dt);
+    m_city->Update(t_dt);
+
+    m_city->UpdateVehicles(t_dt);
 
     return true;
 }
 
 void GameState::Render()
 {
+    SG_CITY_PROFILE_ZONE("GameState::Render");
+
+    auto& performanceStats{ m_city->GetPerformanceStats() };
+    performanceStats.NextFrame();
+    sg::city::gpu::Gpu::NextFrame();
+
     // render Map
     m_city->Render();
 
 #ifdef ENABLE_TRAFFIC_DEBUG
-    // only render the AutoTracks after update of changed Tile is complete
-    if (m_changedTiles.empty() && m_renderAutoTracks)
+    // the changed Tiles are handled in the update, so the AutoTracks are always complete here
+    if (m_renderAutoTracks)
     {
         m_city->RenderAutoTracks();
     }
@@ -106,15 +132,37 @@ void GameState::Render()
 #endif
 
     // render cars
-    m_forwardRenderer->Render();
+    if (performanceStats.IsEnabled(sg::city::stats::Subsystem::CARS_RENDER))
+    {
+        SG_CITY_PROFILE_ZONE("ForwardRenderer::Render");
+        sg::city::stats::ScopedTime scopedTime{ performanceStats, sg::city::stats::Subsystem::CARS_RENDER };
+        m_forwardRenderer->Render();
+    }
 
     // render trees
-    m_instancingRenderSystem->Render();
+    if (performanceStats.IsEnabled(sg::city::stats::Subsystem::TREES_RENDER))
+    {
+        SG_CITY_PROFILE_ZONE("InstancingRenderSystem::Render");
+        sg::city::stats::ScopedTime scopedTime{ performanceStats, sg::city::stats::Subsystem::TREES_RENDER };
+        m_instancingRenderSystem->Render();
+    }
 
     // render skybox
-    m_skyboxRenderSystem->Render();
+    if (performanceStats.IsEnabled(sg::city::stats::Subsystem::SKYBOX_RENDER))
+    {
+        SG_CITY_PROFILE_ZONE("SkyboxRenderSystem::Render");
+        sg::city::stats::ScopedTime scopedTime{ performanceStats, sg::city::stats::Subsystem::SKYBOX_RENDER };
+        m_skyboxRenderSystem->Render();
+    }
 
-    RenderImGui();
+    {
+        SG_CITY_PROFILE_ZONE("GameState::RenderImGui");
+        sg::city::stats::ScopedTime scopedTime{ performanceStats, sg::city::stats::Subsystem::IMGUI };
+        RenderImGui();
+    }
+
+    // the temporary containers of this frame are released
+    sg::city::memory::FrameArena::Get().Reset();
 }
 
 //-------------------------------------------------
@@ -182,70 +230,46 @@ void GameState::CreateSkybox() const
     GetApplicationContext()->GetEntityFactory().CreateSkyboxEntity(cubemapFileNames);
 }
 
-//-------------------------------------------------
-// Cars
-//-------------------------------------------------
-
-void GameState::UpdateCars(const double t_dt) const
+void GameState::SaveCity() const
 {
-    auto del{ false };
-
-    // update Automatas
-    for (auto& automata : m_city->automatas)
+    try
     {
-        if (automata)
-        {
-            automata->Update(static_cast<float>(t_dt));
-
-            // the Update function may have set deleteAutomata to true
-            if (automata->deleteAutomata)
-            {
-                // despawn
-
-                // 1) remove from the track
-                automata->currentTrack->automatas.remove(automata.get());
-
-                // 2) eliminating one owner of the automata shared_ptr
-                //    the automata is also owned by a car entity
-                automata.reset();
-                del = true;
-            }
-        }
+        m_city->Save(SAVE_FILE_NAME);
     }
+    catch (const std::runtime_error& e)
+    {
+        SG_OGL_LOG_WARN("[GameState::SaveCity()] {}", e.what());
+    }
+}
 
-    if (del)
+void GameState::LoadCity()
+{
+    // read the whole file first, so a broken file keeps the current City
+    sg::city::save::SaveData saveData;
+    try
     {
-        // remove dead automata
-        m_city->automatas.remove(nullptr);
+        saveData = sg::city::save::SaveGame::Read(SAVE_FILE_NAME);
+    }
+    catch (const std::runtime_error& e)
+    {
+        SG_OGL_LOG_WARN("[GameState::LoadCity()] {}", e.what());
+        return;
     }
 
-    // get view
-    auto view{ m_scene->GetApplicationContext()->registry.view<
-        sg::ogl::ecs::component::ModelComponent,
-        sg::ogl::ecs::component::TransformComponent,
-        sg::city::ecs::AutomataComponent>()
-    };
+    // the registry holds the cars, plants, the sun and the skybox of the old City
+    m_mousePicker.reset();
+    GetApplicationContext()->registry.clear();
+    m_city.reset();
 
-    // change the Transform Component of each Entity in the View
-    for (auto entity : view)
-    {
-        auto& automataComponent{ view.get<sg::city::ecs::AutomataComponent>(entity) };
-        auto& transformComponent{ view.get<sg::ogl::ecs::component::TransformComponent>(entity) };
+    CreateDirectionalLight();
+    CreateSkybox();
 
-        if (automataComponent.automata->deleteAutomata)
-        {
-            // eliminating the other owner of the automata shared_ptr -> instance is destroyed
-            automataComponent.automata.reset();
+    m_city = std::make_unique<sg::city::city::City>(CITY_NAME, saveData, m_scene.get());
+    m_mousePicker = std::make_unique<sg::city::input::MousePicker>(m_scene.get(), m_city->GetMapSharedPtr());
 
-            // destroy car entity
-            m_scene->GetApplicationContext()->registry.destroy(entity);
-        }
-        else
-        {
-            transformComponent.position = glm::vec3(automataComponent.automata->position.x, 0.015f, automataComponent.automata->position.z);
-            transformComponent.rotation = glm::vec3(0.0f, automataComponent.automata->currentTrack->rotation, 0.0f);
-        }
-    }
+    // the saved Map may be smaller
+    m_mapPoint = glm::ivec3(0);
+    m_hoverPoint = glm::ivec3(-1);
 }
 
 //-------------------------------------------------
@@ -304,19 +328,31 @@ void GameState::RenderImGui()
     }
 
     ImGui::Text("Current number of regions: %i", m_city->GetMap().GetNumRegions());
+    ImGui::Text("Tile uploads: %u", m_city->GetMap().GetLastTileUploads());
+    ImGui::Text("Population: %.0f", m_city->GetPopulationGrowth().GetTotalPopulation());
+
+    for (const auto& timing : m_city->GetEventBus().GetTimings())
+    {
+        ImGui::Text("%s: %u events %.3f ms", timing.name.c_str(), timing.events, timing.ms);
+    }
+
+    const auto& demand{ m_city->GetDemand() };
+    ImGui::Text("Demand R: %.2f C: %.2f I: %.2f", demand.GetCityDemand().residential, demand.GetCityDemand().commercial, demand.GetCityDemand().industrial);
+    const auto& demandHistory{ m_city->GetPerformanceStats().GetHistory(sg::city::stats::Subsystem::DEMAND) };
+    ImGui::Text("Demand update: %.3f ms (max %.3f ms)", demandHistory.GetLast(), demandHistory.GetMax());
 
     ImGui::Spacing();
     ImGui::Separator();
     ImGui::Spacing();
 
-    if (ImGui::Button("Save map"))
+    if (ImGui::Button("Save city"))
     {
-        m_city->GetMap().SaveMap();
+        SaveCity();
     }
 
-    if (ImGui::Button("Load map"))
+    if (ImGui::Button("Load city"))
     {
-        m_city->GetMap().LoadMap();
+        m_loadCity = true;
     }
 
     ImGui::Spacing();
@@ -330,7 +366,26 @@ void GameState::RenderImGui()
         ImGui::Text("Current Tile z: %i", tile.GetMapZ());
     }
 
-    ImGui::Text("City Automatas: %i", m_city->automatas.size());
+    if (m_hoverPoint.x >= 0)
+    {
+        ImGui::Text("Hovered Tile x: %i z: %i", m_hoverPoint.x, m_hoverPoint.z);
+
+        const auto& spatialIndex{ m_city->GetSpatialIndex() };
+        const auto hoveredTileIndex{ m_city->GetMap().GetTileMapIndexByMapPosition(m_hoverPoint.x, m_hoverPoint.z) };
+        ImGui::Text("Cars on hovered Tile: %u", spatialIndex.GetVehicleCount(hoveredTileIndex));
+
+        const auto& pickResult{ m_mousePicker->GetCurrentPickResult() };
+        if (spatialIndex.PickVehicle(pickResult.point) != entt::null)
+        {
+            ImGui::Text("Car under the mouse");
+        }
+        else if (spatialIndex.PickBuilding(pickResult.point) >= 0)
+        {
+            ImGui::Text("Building under the mouse");
+        }
+    }
+
+    ImGui::Text("City Automatas: %u", m_city->GetSpatialIndex().GetVehicleCount());
 
     if (ImGui::Button("Spawn single car on current tile"))
     {
@@ -372,14 +427,217 @@ void GameState::RenderImGui()
     ImGui::Separator();
     ImGui::Spacing();
 
+#ifdef ENABLE_PROFILER
+    if (ImGui::Button(sg::city::profiler::Profiler::IsRunning() ? "Stop profiling" : "Start profiling"))
+    {
+        if (sg::city::profiler::Profiler::IsRunning())
+        {
+            sg::city::profiler::Profiler::Stop();
+            sg::city::profiler::Profiler::WriteChromeTrace("profile.json");
+            sg::city::profiler::Profiler::WriteBinary("profile.sgprof");
+        }
+        else
+        {
+            sg::city::profiler::Profiler::Start();
+        }
+    }
+
+    ImGui::Spacing();
+    ImGui::Separator();
+    ImGui::Spacing();
+#endif
+
     ImGui::SliderFloat3("Sun direction", reinterpret_cast<float*>(&m_scene->GetCurrentDirectionalLight().direction), -1.0f, 1.0f);
 
+    ImGui::Checkbox("Performance overlay", &m_showPerformanceOverlay);
+
     ImGui::End();
 
+    if (m_showPerformanceOverlay)
+    {
+        RenderPerformanceOverlay();
+    }
+
     ImGui::Render();
     ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
 }
 
+void GameState::RenderPerformanceOverlay()
+{
+    using sg::city::stats::History;
+    using sg::city::stats::PerformanceStats;
+    using sg::city::stats::Subsystem;
+    using sg::city::gpu::Gpu;
+    using sg::city::gpu::Source;
+    using sg::city::memory::Memory;
+    using sg::city::memory::Tag;
+
+    static const ImVec4 OVER_BUDGET_COLOR{ 1.0f, 0.3f, 0.3f, 1.0f };
+
+    auto& performanceStats{ m_city->GetPerformanceStats() };
+
+    ImGui::Begin("Performance", &m_showPerformanceOverlay);
+
+    // rolling histograms; the scale is twice the frame budget
+    char overlay[64];
+
+    const auto& frames{ performanceStats.GetFrameHistory() };
+    std::snprintf(overlay, sizeof(overlay), "%.2f ms (max %.2f ms)", frames.GetLast(), frames.GetMax());
+    ImGui::PlotHistogram("Frame", frames.GetValues().data(), History::HISTORY_SIZE, frames.GetOffset(), overlay, 0.0f, 2.0f * PerformanceStats::FRAME_BUDGET_MS, ImVec2(0.0f, 60.0f));
+
+    const auto& ticks{ performanceStats.GetTickHistory() };
+    std::snprintf(overlay, sizeof(overlay), "%.2f ms (max %.2f ms)", ticks.GetLast(), ticks.GetMax());
+    ImGui::PlotHistogram("Tick", ticks.GetValues().data(), History::HISTORY_SIZE, ticks.GetOffset(), overlay, 0.0f, 2.0f * PerformanceStats::FRAME_BUDGET_MS, ImVec2(0.0f, 60.0f));
+
+    ImGui::Text("Frame budget: %.2f ms", PerformanceStats::FRAME_BUDGET_MS);
+
+    const auto& uploadBytes{ performanceStats.GetUploadBytesHistory() };
+    ImGui::Text("Gpu upload: %.0f bytes/frame (max %.0f)", uploadBytes.GetLast(), uploadBytes.GetMax());
+
+#ifdef ENABLE_ALLOCATION_TRACKING
+    const auto& allocations{ performanceStats.GetAllocationsHistory() };
+    ImGui::Text("Allocations: %.0f/frame (max %.0f)", allocations.GetLast(), allocations.GetMax());
+#endif
+
+    const auto& frameArena{ sg::city::memory::FrameArena::Get() };
+    ImGui::Text("Frame arena: %.1f of %.1f KB (peak %.1f KB, %u grows)",
+        static_cast<double>(frameArena.GetLastFrameBytes()) / 1024.0,
+        static_cast<double>(frameArena.GetCapacity()) / 1024.0,
+        static_cast<double>(frameArena.GetPeakBytes()) / 1024.0,
+        frameArena.GetGrows());
+
+    const auto cars{ performanceStats.GetCars() };
+    const auto blockedCars{ performanceStats.GetBlockedCars() };
+    ImGui::Text("Cars: %u, blocked: %u (%.0f%%)", cars, blockedCars, cars > 0 ? 100.0f * static_cast<float>(blockedCars) / static_cast<float>(cars) : 0.0f);
+
+    ImGui::Spacing();
+    ImGui::Separator();
+    ImGui::Spacing();
+
+    // per subsystem: switch, last, average and max time
+    ImGui::Columns(4, "subsystems");
+    ImGui::Text("Subsystem");
+    ImGui::NextColumn();
+    ImGui::Text("Last ms");
+    ImGui::NextColumn();
+    ImGui::Text("Avg ms");
+    ImGui::NextColumn();
+    ImGui::Text("Max ms");
+    ImGui::NextColumn();
+    ImGui::Separator();
+
+    for (auto i{ 0u }; i < PerformanceStats::NR_OF_SUBSYSTEMS; ++i)
+    {
+        const auto subsystem{ static_cast<Subsystem>(i) };
+        const auto& history{ performanceStats.GetHistory(subsystem) };
+
+        if (PerformanceStats::CanBeDisabled(subsystem))
+        {
+            auto enabled{ performanceStats.IsEnabled(subsystem) };
+            if (ImGui::Checkbox(PerformanceStats::GetName(subsystem), &enabled))
+            {
+                performanceStats.SetEnabled(subsystem, enabled);
+            }
+        }
+        else
+        {
+            ImGui::Text("%s", PerformanceStats::GetName(subsystem));
+        }
+        ImGui::NextColumn();
+
+        ImGui::Text("%.3f", history.GetLast());
+        ImGui::NextColumn();
+        ImGui::Text("%.3f", history.GetAverage());
+        ImGui::NextColumn();
+
+        // a single subsystem blows the whole frame budget
+        if (history.GetMax() > PerformanceStats::FRAME_BUDGET_MS)
+        {
+            ImGui::TextColored(OVER_BUDGET_COLOR, "%.3f", history.GetMax());
+        }
+        else
+        {
+            ImGui::Text("%.3f", history.GetMax());
+        }
+        ImGui::NextColumn();
+    }
+
+    ImGui::Columns(1);
+
+    ImGui::Spacing();
+    ImGui::Separator();
+    ImGui::Spacing();
+
+    // uploads, draw calls and binds of the last frame per source
+    ImGui::Columns(5, "gpu");
+    ImGui::Text("Gpu");
+    ImGui::NextColumn();
+    ImGui::Text("Bytes");
+    ImGui::NextColumn();
+    ImGui::Text("Uploads");
+    ImGui::NextColumn();
+    ImGui::Text("Draws");
+    ImGui::NextColumn();
+    ImGui::Text("Binds");
+    ImGui::NextColumn();
+    ImGui::Separator();
+
+    for (auto i{ 0u }; i <= Gpu::NR_OF_SOURCES; ++i)
+    {
+        // the last row is the sum
+        const auto isTotal{ i == Gpu::NR_OF_SOURCES };
+        const auto counters{ isTotal ? Gpu::GetLastFrameTotal() : Gpu::GetLastFrameCounters(static_cast<Source>(i)) };
+
+        ImGui::Text("%s", isTotal ? "Total" : Gpu::GetName(static_cast<Source>(i)));
+        ImGui::NextColumn();
+        ImGui::Text("%llu", static_cast<unsigned long long>(counters.uploadBytes));
+        ImGui::NextColumn();
+        ImGui::Text("%u", counters.uploads);
+        ImGui::NextColumn();
+        ImGui::Text("%u", counters.drawCalls);
+        ImGui::NextColumn();
+        ImGui::Text("%u", counters.binds);
+        ImGui::NextColumn();
+    }
+
+    ImGui::Columns(1);
+
+    ImGui::Spacing();
+    ImGui::Separator();
+    ImGui::Spacing();
+
+    // live and peak memory and the allocations of the last frame per Tag
+    ImGui::Columns(4, "memory");
+    ImGui::Text("Memory");
+    ImGui::NextColumn();
+    ImGui::Text("Live KB");
+    ImGui::NextColumn();
+    ImGui::Text("Peak KB");
+    ImGui::NextColumn();
+    ImGui::Text("Allocs/frame");
+    ImGui::NextColumn();
+    ImGui::Separator();
+
+    for (auto i{ 0u }; i < Memory::NR_OF_TAGS; ++i)
+    {
+        const auto tag{ static_cast<Tag>(i) };
+        const auto tagStats{ Memory::GetTagStats(tag) };
+
+        ImGui::Text("%s", Memory::GetName(tag));
+        ImGui::NextColumn();
+        ImGui::Text("%.1f", static_cast<double>(tagStats.liveBytes) / 1024.0);
+        ImGui::NextColumn();
+        ImGui::Text("%.1f", static_cast<double>(tagStats.peakBytes) / 1024.0);
+        ImGui::NextColumn();
+        ImGui::Text("%llu", static_cast<unsigned long long>(performanceStats.GetTagAllocations(tag)));
+        ImGui::NextColumn();
+    }
+
+    ImGui::Columns(1);
+
+    ImGui::End();
+}
+
 void GameState::CleanUpImGui()
 {
     ImGui_ImplOpenGL3_Shutdown();
@@ -39,8 +39,6 @@ public:
 
     using DirectionalLightSharedPtr = std::shared_ptr<sg::ogl::light::Sun>;
 
-    using TileIndexContainer = std::vector<int>;
-
     //-------------------------------------------------
     // Const
     //-------------------------------------------------
@@ -48,6 +46,7 @@ public:
     static constexpr auto CITY_NAME{ "SgCity" };
     static constexpr auto MAP_8_8_FILE_NAME{ "res/config/Map8x8.png" };
     static constexpr auto MAP_FILE_NAME{ "res/config/CityMap1.png" };
+    static constexpr auto SAVE_FILE_NAME{ "res/config/City.city" };
 
     //-------------------------------------------------
     // Ctors. / Dtor.
@@ -76,6 +75,7 @@ protected:
 
 private:
     glm::ivec3 m_mapPoint{ glm::ivec3(0) };
+    glm::ivec3 m_hoverPoint{ glm::ivec3(-1) };
 
     FirstPersonCameraSharedPtr m_firstPersonCamera;
     SceneUniquePtr m_scene;
@@ -83,8 +83,6 @@ private:
     CityUniquePtr m_city;
     MousePickerUniquePtr m_mousePicker;
 
-    TileIndexContainer m_changedTiles;
-
     ForwardRendererUniquePtr m_forwardRenderer;
     SkyboxRenderSystemUniquePtr m_skyboxRenderSystem;
     InstancingRenderSystemUniquePtr m_instancingRenderSystem;
@@ -94,6 +92,13 @@ private:
     sg::city::map::tile::TileType m_currentEditTileType{ sg::city::map::tile::TileType::RESIDENTIAL };
     std::vector<bool> m_buttons{ false, true, false, false, false };
 
+    bool m_showPerformanceOverlay{ true };
+
+    /**
+     * @brief The City is replaced at the start of the next Update(), not while it is rendered.
+     */
+    bool m_loadCity{ false };
+
 #ifdef ENABLE_TRAFFIC_DEBUG
     bool m_renderAutoTracks{ false };
     bool m_renderNavigationNodes{ false };
@@ -106,12 +111,8 @@ private:
     void Init();
     void CreateDirectionalLight();
     void CreateSkybox() const;
-
-    //-------------------------------------------------
-    // Cars
-    //-------------------------------------------------
-
-    void UpdateCars(double t_dt) const;
+    void SaveCity() const;
+    void LoadCity();
 
     //-------------------------------------------------
     // ImGui
@@ -119,5 +120,6 @@ private:
 
     void InitImGui() const;
     void RenderImGui();
+    void RenderPerformanceOverlay();
     static void CleanUpImGui();
 };
@@ -11,17 +11,17 @@
 
 #include <glm/vec3.hpp>
 #include <memory>
-#include <list>
+#include "city/Memory.h"
 
 namespace sg::city::automata
 {
     class AutoTrack;
 
-    class AutoNode
+    class AutoNode : public memory::Tracked<memory::Tag::NAV_NODES>
     {
     public:
         using AutoTrackSharedPtr = std::shared_ptr<AutoTrack>;
-        using AutoTrackContainer = std::list<AutoTrackSharedPtr>;
+        using AutoTrackContainer = memory::TrackedVector<AutoTrackSharedPtr, memory::Tag::TRACKS>;
 
         //-------------------------------------------------
         // Public member
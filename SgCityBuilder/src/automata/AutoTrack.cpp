@@ -7,6 +7,7 @@
 // 
 // 2020 (c) stwe <https://github.com/stwe/SgCityBuilder>
 
+#include <algorithm>
 #include "AutoTrack.h"
 #include "AutoNode.h"
 #include <Log.h>
@@ -24,12 +25,25 @@ sg::city::automata::AutoTrack::~AutoTrack() noexcept
 // Getter
 //-------------------------------------------------
 
-glm::vec3 sg::city::automata::AutoTrack::GetPosition(const float t_dt, const AutoNodeSharedPtr& t_node) const
+glm::vec3 sg::city::automata::AutoTrack::GetPosition(const float t_dt, const AutoNode* t_node) const
 {
-    if (startNode == t_node)
+    if (startNode.get() == t_node)
     {
         return startNode->position + (endNode->position - startNode->position) * (t_dt / trackLength);
     }
 
     return endNode->position + (startNode->position - endNode->position) * (t_dt / trackLength);
 }
+
+//-------------------------------------------------
+// Cars
+//-------------------------------------------------
+
+void sg::city::automata::AutoTrack::RemoveAutomata(const entt::entity t_entity)
+{
+    const auto it{ std::find(automatas.begin(), automatas.end(), t_entity) };
+    if (it != automatas.end())
+    {
+        automatas.erase(it);
+    }
+}
@@ -10,8 +10,10 @@
 #pragma once
 
 #include <memory>
+#include <deque>
+#include <entt/entt.hpp>
 #include <glm/vec3.hpp>
-#include <list>
+#include "city/Memory.h"
 
 namespace sg::city::map::tile
 {
@@ -21,14 +23,16 @@ namespace sg::city::map::tile
 namespace sg::city::automata
 {
     class AutoNode;
-    class Automata;
 
     class AutoTrack
     {
     public:
         using AutoNodeSharedPtr = std::shared_ptr<AutoNode>;
 
-        using AutomataContainer = std::list<Automata*>;
+        /**
+         * @brief The car Entities on the track. The first one is in front.
+         */
+        using AutomataContainer = std::deque<entt::entity, memory::TrackingAllocator<entt::entity, memory::Tag::AUTOMATA>>;
 
         //-------------------------------------------------
         // Public member
@@ -67,7 +71,13 @@ namespace sg::city::automata
         // Getter
         //-------------------------------------------------
 
-        [[nodiscard]] glm::vec3 GetPosition(float t_dt, const AutoNodeSharedPtr& t_node) const;
+        [[nodiscard]] glm::vec3 GetPosition(float t_dt, const AutoNode* t_node) const;
+
+        //-------------------------------------------------
+        // Cars
+        //-------------------------------------------------
+
+        void RemoveAutomata(entt::entity t_entity);
 
     protected:
 
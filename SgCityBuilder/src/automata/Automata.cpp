@@ -7,30 +7,22 @@
 // 
 // 2020 (c) stwe <https://github.com/stwe/SgCityBuilder>
 
+#include <cmath>
+#include <algorithm>
 #include "Automata.h"
 #include "AutoTrack.h"
 #include "AutoNode.h"
-#include <Log.h>
-
-//-------------------------------------------------
-// Ctors. / Dtor.
-//-------------------------------------------------
-
-sg::city::automata::Automata::~Automata() noexcept
-{
-    SG_OGL_LOG_DEBUG("[Automata::~Automata()] Destruct Automata.");
-}
 
 //-------------------------------------------------
 // Logic
 //-------------------------------------------------
 
-void sg::city::automata::Automata::Update(const float t_dt)
+void sg::city::automata::Automata::Update(const float t_dt, const entt::entity t_entity, const entt::registry& t_registry)
 {
-    auto exitNode{ currentTrack->startNode };
+    auto* exitNode{ currentTrack->startNode.get() };
     if (exitNode == rootNode)
     {
-        exitNode = currentTrack->endNode;
+        exitNode = currentTrack->endNode.get();
     }
 
     auto canMove{ true };
@@ -79,21 +71,22 @@ void sg::city::automata::Automata::Update(const float t_dt)
     // Frage: ist dieses Auto ganz vorne in der Liste?
 
     // get an iterator for this automata
-    const auto itThisAutomata = std::find(currentTrack->automatas.begin(), currentTrack->automatas.end(), this);
+    const auto itThisAutomata = std::find(currentTrack->automatas.begin(), currentTrack->automatas.end(), t_entity);
 
     // dieses Auto ist ganz vorne
     if (*itThisAutomata == currentTrack->automatas.front()) // fuer A0 und A1 true
     {
         for (auto& track : exitNode->autoTracks) // A0 = currentTrack + Track 1   // A1 = nur der currentTrack
         {
-            if (track != currentTrack && !track->automatas.empty()) // wird nur von A0 durchlaufen
+            if (track.get() != currentTrack && !track->automatas.empty()) // wird nur von A0 durchlaufen
             {
                 // A0 und Track 1
 
                 // das Ende (letztes eingefuegtes Fahrzeug) des vorderen Tracks holen und den Abstand messen
                 // autoPosition      : 0......1
                 // autoLength immer  : 0.2
-                auto distanceFromAutomataExitNode{ track->automatas.back()->autoPosition - track->automatas.back()->autoLength };
+                const auto& lastAutomata{ t_registry.get<Automata>(track->automatas.back()) };
+                auto distanceFromAutomataExitNode{ lastAutomata.autoPosition - lastAutomata.autoLength };
 
                 // Am Anfang ist der Abstand negativ
 
@@ -110,9 +103,9 @@ void sg::city::automata::Automata::Update(const float t_dt)
                 //   0.4 < (1.0 + 0.9 - 0.2)
 
                 //   meine eigene auto position     < (track length              + distanceFromAutomataExitNode - autoLength)
-                if ((*itThisAutomata)->autoPosition < (currentTrack->trackLength + distanceFromAutomataExitNode - autoLength))
+                if (autoPosition < (currentTrack->trackLength + distanceFromAutomataExitNode - autoLength))
                 {
-                    distanceToAutomataInFront = (currentTrack->trackLength + distanceFromAutomataExitNode - 0.1f) - (*itThisAutomata)->autoPosition;
+                    distanceToAutomataInFront = (currentTrack->trackLength + distanceFromAutomataExitNode - 0.1f) - autoPosition;
                 }
                 else
                 {
@@ -129,20 +122,22 @@ void sg::city::automata::Automata::Update(const float t_dt)
         // hole den Automaten vor diesem
         itAutomataInFront--;
 
+        const auto& automataInFront{ t_registry.get<Automata>(*itAutomataInFront) };
+
         // itAutomataInFront Listenindex jetzt zB: 0
         // itThisAutomata    Listenindex jetzt zB: 1
 
         //                             Abstand zum vorderen Fahrzeug zB  = 0.4             > 0.3 ? Abstand zum vorderen Fahreug ok => Automat bewegen
         //                             [0] = 0.5       - [1] = 0.1       = 0.4             > 0.2 + 0.1
 
-        if (fabs((*itAutomataInFront)->autoPosition - (*itThisAutomata)->autoPosition) > (*itAutomataInFront)->autoLength + 0.1f)
+        if (fabs(automataInFront.autoPosition - autoPosition) > automataInFront.autoLength + 0.1f)
         {
             // abstand zum vorderen Fahrzeug groesser als 0.3
 
             //                                                         0.5 - 0.2 - 0.1   - 0.1   =>   distance 0.1  (nicht 0.4, da Abzug von autoLength und Konstante 0.1)
 
             // move Automata along track
-            distanceToAutomataInFront = (*itAutomataInFront)->autoPosition - (*itAutomataInFront)->autoLength - 0.1f - (*itThisAutomata)->autoPosition;
+            distanceToAutomataInFront = automataInFront.autoPosition - automataInFront.autoLength - 0.1f - autoPosition;
             // => 0.1 in disem Beispiel
         }
         else
@@ -165,16 +160,19 @@ void sg::city::automata::Automata::Update(const float t_dt)
         //autoPosition += t_dt * 0.125f;
     }
 
+    // waiting behind another car or at a stop
+    blocked = !canMove || (autoPosition >= currentTrack->trackLength && exitNode->block);
+
     if (autoPosition >= currentTrack->trackLength)
     {
         if (!exitNode->block)
         {
             autoPosition -= currentTrack->trackLength;
 
-            std::shared_ptr<AutoTrack> newTrack;
+            AutoTrack* newTrack{ nullptr };
 
             // es existiert nur noch ein Track und das ist der momentane Track
-            if (exitNode->autoTracks.size() == 1 && *exitNode->autoTracks.begin() == currentTrack)
+            if (exitNode->autoTracks.size() == 1 && exitNode->autoTracks.begin()->get() == currentTrack)
             {
                 // Automata zum loeschen markieren
                 deleteAutomata = true;
@@ -188,13 +186,13 @@ void sg::city::automata::Automata::Update(const float t_dt)
                 auto it{ exitNode->autoTracks.begin() };
 
                 // Track als neuen Track setzen
-                newTrack = *it;
+                newTrack = it->get();
 
                 // falls es sich um den momentanen Track handelt, den anderen nehmen
                 if (currentTrack == newTrack)
                 {
                     ++it;
-                    newTrack = *it;
+                    newTrack = it->get();
                 }
             }
             else // mehr als zwei Tracks
@@ -202,20 +200,20 @@ void sg::city::automata::Automata::Update(const float t_dt)
                 while (!newTrack)
                 {
                     // Zufallszahl zwischen 0 und der Anzahl Tracks
-                    const auto randomTrackIndex{ rand() % exitNode->autoTracks.size() };
+                    const auto randomTrackIndex{ randomStream.NextIndex(static_cast<uint32_t>(exitNode->autoTracks.size())) };
                     auto j{ 0u };
 
                     // fuer alle Tracks in der EndNode
                     for (auto it = exitNode->autoTracks.begin(); it != exitNode->autoTracks.end(); ++it)
                     {
                         // deref Iterator
-                        auto track = (*it);
+                        auto* track = it->get();
 
                         // neue EndNode aus dem Track ermitteln
-                        auto newExitNode = track->startNode;
+                        auto* newExitNode = track->startNode.get();
                         if (newExitNode == exitNode)
                         {
-                            newExitNode = track->endNode;
+                            newExitNode = track->endNode.get();
                         }
 
                         // => neuer Track mit neuer EndNode benutzen, wenn j stimmt
@@ -240,7 +238,7 @@ void sg::city::automata::Automata::Update(const float t_dt)
             currentTrack = newTrack;
 
             // Automaten hinten wieder anfuegen
-            currentTrack->automatas.push_back(this);
+            currentTrack->automatas.push_back(t_entity);
         }
         else
         {
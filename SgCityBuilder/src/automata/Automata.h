@@ -9,20 +9,22 @@
 
 #pragma once
 
-#include <memory>
+#include <entt/entt.hpp>
 #include <glm/vec3.hpp>
+#include "city/Random.h"
 
 namespace sg::city::automata
 {
     class AutoNode;
     class AutoTrack;
 
+    /**
+     * @brief A car. The Automata is a plain component of the car Entity, so all cars are stored
+     *        contiguously in the registry and are updated in a single pass.
+     */
     class Automata
     {
     public:
-        using AutoNodeSharedPtr = std::shared_ptr<AutoNode>;
-        using AutoTrackSharedPtr = std::shared_ptr<AutoTrack>;
-
         //-------------------------------------------------
         // Const
         //-------------------------------------------------
@@ -35,35 +37,49 @@ namespace sg::city::automata
 
         glm::vec3 position{ glm::vec3(0.0f) };
 
+        /**
+         * @brief The offset on the current track.
+         */
         float autoPosition{ 0.0f };
         float autoLength{ 0.0f };
 
-        AutoNodeSharedPtr rootNode;
-        AutoTrackSharedPtr currentTrack;
+        /**
+         * @brief The nodes and tracks are owned by the RoadTiles and live as long as the Map.
+         */
+        AutoNode* rootNode{ nullptr };
+        AutoTrack* currentTrack{ nullptr };
 
         bool deleteAutomata{ false };
-        bool isEntity{ false };
-
-        float lifetime{ DEFAULT_LIFETIME };
 
-        //-------------------------------------------------
-        // Ctors. / Dtor.
-        //-------------------------------------------------
+        /**
+         * @brief True if the car could not move in the last Update().
+         */
+        bool blocked{ false };
 
-        Automata() = default;
+        float lifetime{ DEFAULT_LIFETIME };
 
-        Automata(const Automata& t_other) = delete;
-        Automata(Automata&& t_other) noexcept = delete;
-        Automata& operator=(const Automata& t_other) = delete;
-        Automata& operator=(Automata&& t_other) noexcept = delete;
+        /**
+         * @brief Used to choose the next track at crossings.
+         */
+        random::RandomStream randomStream;
 
-        ~Automata() noexcept;
+        /**
+         * @brief The cell and the position within the cell in the SpatialIndex; -1 if not indexed.
+         */
+        int spatialTileIndex{ -1 };
+        uint32_t spatialSlot{ 0 };
 
         //-------------------------------------------------
         // Logic
         //-------------------------------------------------
 
-        void Update(float t_dt);
+        /**
+         * @brief Moves the car along its track.
+         * @param t_dt The elapsed time.
+         * @param t_entity The Entity of this car.
+         * @param t_registry Used to read the cars in front.
+         */
+        void Update(float t_dt, entt::entity t_entity, const entt::registry& t_registry);
 
     protected:
 
@@ -7,6 +7,8 @@
 // 
 // 2020 (c) stwe <https://github.com/stwe/SgCityBuilder>
 
+#include <algorithm>
+#include <iterator>
 #include <Core.h>
 #include <Log.h>
 #include <Application.h>
@@ -16,9 +18,19 @@
 #include <scene/Scene.h>
 #include <math/Transform.h>
 #include "City.h"
+#include "Build.h"
+#include "Profiler.h"
+#include "PerformanceStats.h"
+#include "SpatialIndex.h"
+#include "Systems.h"
+#include "EventBus.h"
+#include "FrameArena.h"
+#include "SaveGame.h"
+#include "Timer.h"
 #include "map/Map.h"
 #include "map/RoadNetwork.h"
 #include "map/BuildingGenerator.h"
+#include "map/DebugBatcher.h"
 #include "map/tile/RoadTile.h"
 #include "map/tile/BuildingTile.h"
 #include "renderer/MapRenderer.h"
@@ -26,6 +38,9 @@
 #include "renderer/BuildingsRenderer.h"
 #include "automata/Automata.h"
 #include "automata/AutoTrack.h"
+#include "automata/AutoNode.h"
+#include "simulation/PopulationGrowth.h"
+#include "simulation/Demand.h"
 
 //-------------------------------------------------
 // Ctors. / Dtor.
@@ -43,6 +58,20 @@ sg::city::city::City::City(std::string t_name, std::string t_mapFileName, ogl::s
     Init();
 }
 
+sg::city::city::City::City(std::string t_name, const save::SaveData& t_saveData, ogl::scene::Scene* t_scene)
+    : m_name{ std::move(t_name) }
+    , m_scene{ t_scene }
+    , m_random{ t_saveData.seed }
+    , m_tick{ t_saveData.tick }
+    , m_nextAutomataId{ t_saveData.nextAutomataId }
+{
+    SG_OGL_ASSERT(t_scene, "[City::City()] Null pointer.")
+
+    SG_OGL_LOG_DEBUG("[City::City()] Construct City from a save game.");
+
+    Restore(t_saveData);
+}
+
 sg::city::city::City::~City() noexcept
 {
     SG_OGL_LOG_DEBUG("[City::~City()] Destruct City.");
@@ -72,129 +101,161 @@ sg::city::city::City::MapSharedPtr sg::city::city::City::GetMapSharedPtr() const
     return m_map;
 }
 
-//-------------------------------------------------
-// Logic
-//-------------------------------------------------
+const sg::city::map::BuildingGenerator& sg::city::city::City::GetBuildingGenerator() const noexcept
+{
+    return *m_buildingGenerator;
+}
 
-void sg::city::city::City::Update(const double t_dt, TileIndexContainer& t_tileIndexContainer)
+sg::city::map::BuildingGenerator& sg::city::city::City::GetBuildingGenerator() noexcept
 {
-    // handle a changed Tile
+    return *m_buildingGenerator;
+}
 
-    for (auto tileIndex : t_tileIndexContainer)
-    {
-        // get Tile
-        auto& changedTile{ m_map->GetTiles()[tileIndex] };
+const sg::city::simulation::PopulationGrowth& sg::city::city::City::GetPopulationGrowth() const noexcept
+{
+    return m_systems->GetPopulationGrowth();
+}
 
-        // check if the new Tile is of type TRAFFIC
-        if (changedTile->type == map::tile::TileType::TRAFFIC)
-        {
-            ///////////////////// !! very expensive !! /////////////////////
+const sg::city::simulation::Demand& sg::city::city::City::GetDemand() const noexcept
+{
+    return m_systems->GetDemand();
+}
 
-            // the indices of the roads are in a separate vector to avoid unnecessary loops
+const sg::city::spatial::SpatialIndex& sg::city::city::City::GetSpatialIndex() const noexcept
+{
+    return *m_spatialIndex;
+}
 
-            auto& tiles{ m_map->GetTiles() };
+sg::city::spatial::SpatialIndex& sg::city::city::City::GetSpatialIndex() noexcept
+{
+    return *m_spatialIndex;
+}
 
-            for (auto roadIndex : m_map->roadIndices)
-            {
-                dynamic_cast<map::tile::RoadTile*>(tiles[roadIndex].get())->ClearTracksAndStops();
-            }
+const sg::city::event::EventBus& sg::city::city::City::GetEventBus() const noexcept
+{
+    return *m_eventBus;
+}
 
-            for (auto roadIndex : m_map->roadIndices)
-            {
-                dynamic_cast<map::tile::RoadTile*>(tiles[roadIndex].get())->Update();
-            }
+sg::city::event::EventBus& sg::city::city::City::GetEventBus() noexcept
+{
+    return *m_eventBus;
+}
 
-            m_roadNetwork->CreateRoadNetworkMesh();
+const sg::city::stats::PerformanceStats& sg::city::city::City::GetPerformanceStats() const noexcept
+{
+    return *m_performanceStats;
+}
 
-            //////////////////////////////////////////////////////////
-        }
-        else if (changedTile->type == map::tile::TileType::RESIDENTIAL)
-        {
-            auto* buildingTile{ dynamic_cast<map::tile::BuildingTile*>(changedTile.get()) };
-            SG_OGL_ASSERT(buildingTile, "[City::Update()] Null pointer.")
+sg::city::stats::PerformanceStats& sg::city::city::City::GetPerformanceStats() noexcept
+{
+    return *m_performanceStats;
+}
 
-            m_buildingGenerator->AddBuilding(*buildingTile);
+const sg::city::random::Random& sg::city::city::City::GetRandom() const noexcept
+{
+    return m_random;
+}
 
-            changedTile->Update();
-        }
-        else
-        {
-            changedTile->Update();
-        }
-    }
+uint64_t sg::city::city::City::GetTick() const noexcept
+{
+    return m_tick;
+}
 
-    if (!t_tileIndexContainer.empty())
-    {
-        t_tileIndexContainer.clear();
-    }
+//-------------------------------------------------
+// Logic
+//-------------------------------------------------
 
+void sg::city::city::City::Update(const double t_dt)
+{
+    SG_CITY_PROFILE_ZONE("City::Update");
 
-    // change StopPattern
+    auto& performanceStats{ *m_performanceStats };
 
-    /*
-    for (auto& tile : m_map->GetTiles())
+    // hand over the Tile changes to the systems
     {
-        if (tile->type == map::tile::TileType::TRAFFIC)
-        {
-            auto* roadTile{ dynamic_cast<map::tile::RoadTile*>(tile.get()) };
-            SG_OGL_ASSERT(roadTile, "[City::Update()] Null pointer.")
+        stats::ScopedTime scopedTime{ performanceStats, stats::Subsystem::EVENTS };
+        m_eventBus->Dispatch();
+    }
 
-            if (!roadTile->GetStopPatterns().empty() && !automatas.empty())
-            {
-                m_stopPatternTimer += static_cast<float>(t_dt) * STOP_PATTERN_SPEED;
-                if (m_stopPatternTimer >= 5.0f)
-                {
-                    m_stopPatternTimer = 0.0f;
-
-                    const auto lastIndex{ static_cast<int>(roadTile->GetStopPatterns().size()) - 1 };
-                    const auto currentIndex{ roadTile->GetCurrentStopPatternIndex() };
-
-                    if (currentIndex == lastIndex)
-                    {
-                        roadTile->ApplyStopPattern(0);
-                    }
-                    else
-                    {
-                        roadTile->ApplyStopPattern(currentIndex + 1);
-                    }
-
-                    SG_OGL_LOG_WARN("[City::Update()] StopPattern changed.");
-                }
-            }
-        }
+    // the demand controls the growth
+    if (performanceStats.IsEnabled(stats::Subsystem::DEMAND))
+    {
+        stats::ScopedTime scopedTime{ performanceStats, stats::Subsystem::DEMAND };
+        m_systems->UpdateDemand(m_tick);
     }
-    */
 
+    // grow a fraction of the residential Tiles
+    if (performanceStats.IsEnabled(stats::Subsystem::POPULATION))
+    {
+        stats::ScopedTime scopedTime{ performanceStats, stats::Subsystem::POPULATION };
+        m_systems->UpdatePopulation(m_tick);
+        UpdateFloors();
+    }
 
-    // connect regions
+    // upload the new and changed Tiles and buildings once per frame
+    {
+        stats::ScopedTime scopedTime{ performanceStats, stats::Subsystem::UPLOADS };
+        m_map->FlushTileAttributes();
+        m_buildingGenerator->FlushInstances();
+    }
+
+    performanceStats.AddUploadBytes(m_map->GetLastTileUploadBytes() + m_buildingGenerator->GetLastUploadBytes());
 
-    // todo must be fixed
-    //m_map->FindConnectedRegions();
+#ifdef ENABLE_TRAFFIC_DEBUG
+    m_map->GetDebugBatcher().Flush();
+#endif
 
 
     // create some Automatas
 
     if (spawnCars)
     {
-        if (automatas.size() < MAX_AUTOMATAS)
+        if (m_spatialIndex->GetVehicleCount() < MAX_AUTOMATAS)
         {
             auto newCarCreated{ false };
             auto attempts{ ATTEMPS };
 
+            auto randomStream{ m_random.GetStream(random::Domain::SPAWN, 0, m_tick) };
+            const auto mapSize{ static_cast<uint32_t>(m_map->GetMapSize()) };
+
             while (!newCarCreated && attempts > 0)
             {
                 attempts--;
-                newCarCreated = TrySpawnCarAtSafeTrack(rand() % m_map->GetMapSize(), rand() % m_map->GetMapSize());
+
+                const auto mapX{ static_cast<int>(randomStream.NextIndex(mapSize)) };
+                const auto mapZ{ static_cast<int>(randomStream.NextIndex(mapSize)) };
+
+                newCarCreated = TrySpawnCarAtSafeTrack(mapX, mapZ);
             }
         }
     }
+
+    m_tick++;
 }
 
 void sg::city::city::City::Render() const
 {
-    m_mapRenderer->Render();
-    m_roadNetworkRenderer->Render();
-    m_buildingsRenderer->Render();
+    SG_CITY_PROFILE_ZONE("City::Render");
+
+    auto& performanceStats{ *m_performanceStats };
+
+    if (performanceStats.IsEnabled(stats::Subsystem::MAP_RENDER))
+    {
+        stats::ScopedTime scopedTime{ performanceStats, stats::Subsystem::MAP_RENDER };
+        m_mapRenderer->Render();
+    }
+
+    if (performanceStats.IsEnabled(stats::Subsystem::ROAD_NETWORK_RENDER))
+    {
+        stats::ScopedTime scopedTime{ performanceStats, stats::Subsystem::ROAD_NETWORK_RENDER };
+        m_roadNetworkRenderer->Render();
+    }
+
+    if (performanceStats.IsEnabled(stats::Subsystem::BUILDINGS_RENDER))
+    {
+        stats::ScopedTime scopedTime{ performanceStats, stats::Subsystem::BUILDINGS_RENDER };
+        m_buildingsRenderer->Render();
+    }
 }
 
 //-------------------------------------------------
@@ -206,67 +267,46 @@ auto sg::city::city::City::ReplaceTile(const int t_mapX, const int t_mapZ, map::
     auto& tiles{ m_map->GetTiles() };
     const auto currentTileIndex{ m_map->GetTileMapIndexByMapPosition(t_mapX, t_mapZ) };
 
-    // there must be nothing on the tile yet - skip
-    if (tiles[currentTileIndex]->type != map::tile::TileType::NONE)
+    const auto currentTileType{ tiles[currentTileIndex]->type };
+
+    // roads cannot be removed yet and are only built on empty tiles - skip
+    if (currentTileType == map::tile::TileType::TRAFFIC ||
+        (t_tileType == map::tile::TileType::TRAFFIC && currentTileType != map::tile::TileType::NONE))
     {
         SG_OGL_LOG_INFO("[City::ReplaceTile()] There is already something on this tile. Skip replace.");
         return { currentTileIndex, true };
     }
 
     // if the type does not change - skip
-    if (tiles[currentTileIndex]->type == t_tileType)
+    if (currentTileType == t_tileType)
     {
         SG_OGL_LOG_INFO("[City::ReplaceTile()] This type already exists at this position. Skip replace.");
         return { currentTileIndex, true };
     }
 
-    // store neighbours
-    const auto neighbours{ tiles[currentTileIndex]->GetNeighbours() };
+    // demolish or rezone: remove an existing building
+    if (currentTileType == map::tile::TileType::RESIDENTIAL)
+    {
+        auto* buildingTile{ dynamic_cast<map::tile::BuildingTile*>(tiles[currentTileIndex].get()) };
+        SG_OGL_ASSERT(buildingTile, "[City::ReplaceTile()] Null pointer.")
 
-    // delete the unique pointer
-    tiles[currentTileIndex].reset();
+        m_buildingGenerator->RemoveBuilding(*buildingTile);
+        m_eventBus->Publish(event::BuildingChanged{ currentTileIndex, false });
+    }
 
-    SG_OGL_ASSERT(tiles[currentTileIndex] == nullptr, "[City::ReplaceTile()] The pointer should be nullptr.");
+    SG_CITY_PROFILE_MARKER("City::ReplaceTile");
 
-    if (t_tileType == map::tile::TileType::TRAFFIC)
-    {
-        auto newTile{ std::make_unique<map::tile::RoadTile>(
-                static_cast<float>(t_mapX),
-                static_cast<float>(t_mapZ),
-                m_map.get()
-            )
-        };
+    m_map->ReplaceTile(currentTileIndex, t_tileType);
 
-        tiles[currentTileIndex] = std::move(newTile);
-        tiles[currentTileIndex]->GetNeighbours() = neighbours;
+    m_eventBus->Publish(event::TileChanged{ currentTileIndex, currentTileType, t_tileType });
 
-        m_map->roadIndices.push_back(currentTileIndex);
-    }
-    else if(t_tileType == map::tile::TileType::RESIDENTIAL)
+    if (t_tileType == map::tile::TileType::TRAFFIC)
     {
-        auto newTile{ std::make_unique<map::tile::BuildingTile>(
-                static_cast<float>(t_mapX),
-                static_cast<float>(t_mapZ),
-                m_map.get()
-            )
-        };
-
-        tiles[currentTileIndex] = std::move(newTile);
-        tiles[currentTileIndex]->GetNeighbours() = neighbours;
+        m_eventBus->Publish(event::RoadTopologyChanged{ currentTileIndex });
     }
-    else
+    else if (t_tileType == map::tile::TileType::RESIDENTIAL)
     {
-        // default: create a new Tile with the new type
-        auto newTile{ std::make_unique<map::tile::Tile>(
-                static_cast<float>(t_mapX),
-                static_cast<float>(t_mapZ),
-                t_tileType,
-                m_map.get()
-            )
-        };
-
-        tiles[currentTileIndex] = std::move(newTile);
-        tiles[currentTileIndex]->GetNeighbours() = neighbours;
+        m_eventBus->Publish(event::BuildingChanged{ currentTileIndex, true });
     }
 
     return { currentTileIndex, false };
@@ -303,37 +343,120 @@ bool sg::city::city::City::TrySpawnCarAtSafeTrack(const int t_mapX, const int t_
     SG_OGL_ASSERT(*it, "[City::TrySpawnCarAtSafeTrack()] Invalid iterator.");
     SG_OGL_LOG_INFO("[City::TrySpawnCarAtSafeTrack()] Spawn a new car at Map x: {}, z: {}", tile->GetMapX(), tile->GetMapZ());
 
-    // create an Automata
-    auto automata{ std::make_unique<automata::Automata>() };
-    automata->autoLength = 0.2f;
-    automata->currentTrack = *it;
-    automata->currentTrack->automatas.push_back(automata.get());
-    automata->rootNode = (*it)->startNode;
-    automata->Update(0.0f);
-
-    automatas.push_back(std::move(automata));
-
-    CreateCarEntity();
+    CreateCarEntity(it->get());
 
     return true;
 }
 
 //-------------------------------------------------
-// Debug
+// Save game
 //-------------------------------------------------
 
-void sg::city::city::City::RenderAutoTracks() const
+void sg::city::city::City::Save(const std::string& t_fileName) const
 {
-    for (auto& tile : m_map->GetTiles())
+    SG_CITY_PROFILE_ZONE("City::Save");
+
+    save::SaveData saveData;
+    saveData.seed = m_random.GetSeed();
+    saveData.tick = m_tick;
+    saveData.nextAutomataId = m_nextAutomataId;
+
+    // Tiles, trees, regions, roads and signals
+    m_map->Save(saveData);
+
+    const auto& tiles{ m_map->GetTiles() };
+
+    for (auto i{ 0 }; i < m_map->GetNrOfAllTiles(); ++i)
+    {
+        if (tiles[i]->type != map::tile::TileType::RESIDENTIAL)
+        {
+            continue;
+        }
+
+        const auto* instance{ m_buildingGenerator->GetBuilding(i) };
+        if (!instance)
+        {
+            continue;
+        }
+
+        save::BuildingRecord building;
+        building.tileIndex = i;
+        building.population = m_systems->GetPopulationGrowth().GetPopulation()[i];
+        building.floors = instance->floors;
+        building.colorIndex = instance->colorIndex;
+        building.textureId = instance->textureId;
+
+        saveData.buildings.push_back(building);
+    }
+
+    // the cars of each track in their order on the track
+    auto& registry{ m_scene->GetApplicationContext()->registry };
+
+    for (const auto& road : saveData.roads)
     {
-        if (tile->type == map::tile::TileType::TRAFFIC)
+        const auto* roadTile{ dynamic_cast<const map::tile::RoadTile*>(tiles[road.tileIndex].get()) };
+        SG_OGL_ASSERT(roadTile, "[City::Save()] Null pointer.")
+
+        uint16_t trackIndex{ 0 };
+        for (const auto& autoTrack : roadTile->GetAutoTracks())
         {
-            auto* roadTile{ dynamic_cast<map::tile::RoadTile*>(tile.get()) };
-            SG_OGL_ASSERT(roadTile, "[City::RenderAutoTracks()] Null pointer.");
+            for (const auto entity : autoTrack->automatas)
+            {
+                const auto& automata{ registry.get<automata::Automata>(entity) };
+
+                save::VehicleRecord vehicle;
+                vehicle.tileIndex = road.tileIndex;
+                vehicle.trackIndex = trackIndex;
+                vehicle.rootIsEndNode = automata.rootNode == autoTrack->endNode.get() ? 1 : 0;
+                vehicle.blocked = automata.blocked ? 1 : 0;
+                vehicle.autoPosition = automata.autoPosition;
+                vehicle.autoLength = automata.autoLength;
+                vehicle.lifetime = automata.lifetime;
+                vehicle.positionX = automata.position.x;
+                vehicle.positionY = automata.position.y;
+                vehicle.positionZ = automata.position.z;
+                vehicle.randomKey = automata.randomStream.GetKey();
+                vehicle.randomCounter = automata.randomStream.GetCounter();
+
+                saveData.vehicles.push_back(vehicle);
+            }
 
-            roadTile->RenderAutoTracks();
+            trackIndex++;
         }
     }
+
+    save::SaveGame::Write(t_fileName, saveData);
+}
+
+//-------------------------------------------------
+// Cars
+//-------------------------------------------------
+
+void sg::city::city::City::UpdateVehicles(const double t_dt)
+{
+    SG_CITY_PROFILE_ZONE("City::UpdateVehicles");
+
+    if (!m_performanceStats->IsEnabled(stats::Subsystem::VEHICLES))
+    {
+        return;
+    }
+
+    stats::ScopedTime scopedTime{ *m_performanceStats, stats::Subsystem::VEHICLES };
+
+    const auto blockedCars{ m_systems->UpdateVehicles(static_cast<float>(t_dt)) };
+
+    m_performanceStats->SetCars(m_spatialIndex->GetVehicleCount(), blockedCars);
+
+    SG_CITY_PROFILE_COUNTER("Cars", m_spatialIndex->GetVehicleCount());
+}
+
+//-------------------------------------------------
+// Debug
+//-------------------------------------------------
+
+void sg::city::city::City::RenderAutoTracks() const
+{
+    m_map->RenderAutoTracks();
 }
 
 //-------------------------------------------------
@@ -343,8 +466,32 @@ void sg::city::city::City::RenderAutoTracks() const
 void sg::city::city::City::Init()
 {
     // create Map
-    m_map = std::make_shared<map::Map>(m_scene, m_mapFileName);
+    m_map = std::make_shared<map::Map>(m_scene, m_mapFileName, m_random);
     m_map->CreateMap();
+
+    InitSystems();
+
+    // create a building for each residential Tile
+    StoreBuildings();
+
+    // connect regions
+    m_map->FindConnectedRegions();
+
+    // give the buildings a start population and calculate the first demand
+    m_systems->InitPopulation();
+    UpdateFloors();
+
+    // a single upload for all buildings
+    m_buildingGenerator->FlushInstances();
+
+    // create a road for each traffic Tile
+    StoreRoads();
+
+    InitEntities();
+}
+
+void sg::city::city::City::InitSystems()
+{
     m_map->position = glm::vec3(0.0f);
     m_map->rotation = glm::vec3(0.0f);
     m_map->scale = glm::vec3(1.0f);
@@ -353,12 +500,19 @@ void sg::city::city::City::Init()
     m_roadNetwork = std::make_shared<map::RoadNetwork>(this);
     m_buildingGenerator = std::make_shared<map::BuildingGenerator>(this);
 
-    // create a building for each residential Tile
-    StoreBuildings();
+    // create the index of the cars and buildings
+    m_spatialIndex = std::make_unique<spatial::SpatialIndex>(this, m_scene->GetApplicationContext()->registry);
+    m_systems = std::make_unique<system::Systems>(*m_map, *m_spatialIndex, m_scene->GetApplicationContext()->registry, m_random);
 
-    // create a road for each traffic Tile
-    StoreRoads();
+    m_performanceStats = std::make_unique<stats::PerformanceStats>();
+
+    // the systems reacting on Tile changes
+    m_eventBus = std::make_unique<event::EventBus>();
+    SubscribeSystems();
+}
 
+void sg::city::city::City::InitEntities()
+{
     // create plants from the plants positions
     CreatePlants();
 
@@ -384,16 +538,14 @@ void sg::city::city::City::StoreBuildings() const
     }
 }
 
-void sg::city::city::City::StoreRoads()
+void sg::city::city::City::StoreRoads() const
 {
-    // das letzte Tile uebergeben -> alle Roads werden einmal neu erstellt
+    auto& tiles{ m_map->GetTiles() };
 
-    // todo: refactor Update Funktion
-    if (!m_map->roadIndices.empty())
+    // all roads are new - each road gets its type and tracks once
+    for (auto roadIndex : m_map->roadIndices)
     {
-        TileIndexContainer tiles;
-        tiles.push_back(m_map->roadIndices.back());
-        Update(0.016f, tiles);
+        tiles[roadIndex]->Update();
     }
 }
 
@@ -402,6 +554,7 @@ void sg::city::city::City::CreatePlants() const
     if (!m_map->plantPositions.empty())
     {
         std::vector<glm::mat4> matrices;
+        matrices.reserve(m_map->plantPositions.size());
 
         for (auto& plant : m_map->plantPositions)
         {
@@ -422,6 +575,159 @@ void sg::city::city::City::CreatePlants() const
     }
 }
 
+//-------------------------------------------------
+// Restore
+//-------------------------------------------------
+
+void sg::city::city::City::Restore(const save::SaveData& t_saveData)
+{
+    SG_CITY_PROFILE_ZONE("City::Restore");
+
+    auto durationMs{ 0.0f };
+
+    {
+        timer::Timer timer{ &durationMs };
+
+        // create the Tiles from the saved types
+        m_map = std::make_shared<map::Map>(m_scene, m_mapFileName, m_random);
+        m_map->CreateMap(t_saveData.mapSize, t_saveData.tileTypes);
+
+        InitSystems();
+
+        // the road types, signals, trees and regions are read, not derived from the neighbours
+        m_map->Restore(t_saveData);
+
+        RestoreBuildings(t_saveData);
+
+        m_systems->RestorePopulation(t_saveData);
+
+        // a single upload for all buildings
+        m_buildingGenerator->FlushInstances();
+
+        RestoreVehicles(t_saveData);
+
+        InitEntities();
+    }
+
+    SG_OGL_LOG_INFO("[City::Restore()] Restored a {}x{} City with {} buildings and {} cars in {} ms.",
+        t_saveData.mapSize, t_saveData.mapSize, t_saveData.buildings.size(), m_spatialIndex->GetVehicleCount(), durationMs);
+}
+
+void sg::city::city::City::RestoreBuildings(const save::SaveData& t_saveData) const
+{
+    auto& tiles{ m_map->GetTiles() };
+
+    for (const auto& building : t_saveData.buildings)
+    {
+        // SaveGame::Read() checked the TileType
+        SG_OGL_ASSERT(tiles[building.tileIndex]->type == map::tile::TileType::RESIDENTIAL, "[City::RestoreBuildings()] The Tile is not residential.")
+        auto* buildingTile{ static_cast<map::tile::BuildingTile*>(tiles[building.tileIndex].get()) };
+
+        m_buildingGenerator->RestoreBuilding(*buildingTile, building.floors, building.colorIndex, building.textureId);
+    }
+}
+
+void sg::city::city::City::RestoreVehicles(const save::SaveData& t_saveData)
+{
+    auto& registry{ m_scene->GetApplicationContext()->registry };
+    auto& tiles{ m_map->GetTiles() };
+
+    for (const auto& vehicle : t_saveData.vehicles)
+    {
+        SG_OGL_ASSERT(tiles[vehicle.tileIndex]->type == map::tile::TileType::TRAFFIC, "[City::RestoreVehicles()] The Tile is not a road.")
+        auto* roadTile{ static_cast<map::tile::RoadTile*>(tiles[vehicle.tileIndex].get()) };
+
+        auto& autoTracks{ roadTile->GetAutoTracks() };
+        if (vehicle.trackIndex >= autoTracks.size())
+        {
+            SG_OGL_LOG_WARN("[City::RestoreVehicles()] The road at Tile {} has no track {}. Skip car.", vehicle.tileIndex, vehicle.trackIndex);
+            continue;
+        }
+
+        auto* autoTrack{ std::next(autoTracks.begin(), vehicle.trackIndex)->get() };
+
+        const auto entity{ CreateCarModel(glm::vec3(vehicle.positionX, system::Systems::CAR_HEIGHT, vehicle.positionZ), autoTrack->rotation) };
+
+        auto& automata{ registry.assign<automata::Automata>(entity) };
+        automata.position = glm::vec3(vehicle.positionX, vehicle.positionY, vehicle.positionZ);
+        automata.autoPosition = vehicle.autoPosition;
+        automata.autoLength = vehicle.autoLength;
+        automata.currentTrack = autoTrack;
+        automata.rootNode = vehicle.rootIsEndNode ? autoTrack->endNode.get() : autoTrack->startNode.get();
+        automata.blocked = vehicle.blocked != 0;
+        automata.lifetime = vehicle.lifetime;
+        automata.randomStream = random::RandomStream(vehicle.randomKey, vehicle.randomCounter);
+
+        // the records of a track are in the order of the cars
+        autoTrack->automatas.push_back(entity);
+
+        m_spatialIndex->InsertVehicle(entity, automata);
+    }
+}
+
+void sg::city::city::City::SubscribeSystems()
+{
+    m_eventBus->Subscribe<event::TileChanged>("Tiles", [this](const std::vector<event::TileChanged>& t_events)
+    {
+        m_systems->UpdateChangedTiles(t_events);
+    });
+
+    m_eventBus->Subscribe<event::TileChanged>("Population", [this](const std::vector<event::TileChanged>& t_events)
+    {
+        m_systems->UpdatePopulationTiles(t_events);
+    });
+
+    m_eventBus->Subscribe<event::TileChanged>("Regions", [this](const std::vector<event::TileChanged>&)
+    {
+        // once per tick for all changed Tiles
+        m_systems->UpdateRegions();
+    });
+
+    m_eventBus->Subscribe<event::RoadTopologyChanged>("Roads", [this](const std::vector<event::RoadTopologyChanged>& t_events)
+    {
+        m_systems->UpdateRoads(t_events);
+    });
+
+    m_eventBus->Subscribe<event::BuildingChanged>("Buildings", [this](const std::vector<event::BuildingChanged>& t_events)
+    {
+        UpdateBuildings(t_events);
+    });
+}
+
+//-------------------------------------------------
+// Systems
+//-------------------------------------------------
+
+void sg::city::city::City::UpdateBuildings(const std::vector<event::BuildingChanged>& t_events) const
+{
+    auto& tiles{ m_map->GetTiles() };
+
+    for (const auto& buildingChanged : t_events)
+    {
+        // the removal is done immediately by ReplaceTile(), the old Tile is gone afterwards
+        if (!buildingChanged.hasBuilding || m_buildingGenerator->HasBuilding(buildingChanged.tileIndex))
+        {
+            continue;
+        }
+
+        auto* buildingTile{ dynamic_cast<map::tile::BuildingTile*>(tiles[buildingChanged.tileIndex].get()) };
+        SG_OGL_ASSERT(buildingTile, "[City::UpdateBuildings()] Null pointer.")
+
+        m_buildingGenerator->AddBuilding(*buildingTile);
+    }
+}
+
+void sg::city::city::City::UpdateFloors() const
+{
+    const auto& populationGrowth{ m_systems->GetPopulationGrowth() };
+    const auto& floors{ populationGrowth.GetFloors() };
+
+    for (const auto tileIndex : populationGrowth.GetChangedFloors())
+    {
+        m_buildingGenerator->SetFloors(tileIndex, floors[tileIndex]);
+    }
+}
+
 //-------------------------------------------------
 // Entity
 //-------------------------------------------------
@@ -445,28 +751,37 @@ void sg::city::city::City::CreateMapEntity()
     );
 }
 
-void sg::city::city::City::CreateCarEntity()
+void sg::city::city::City::CreateCarEntity(automata::AutoTrack* t_autoTrack)
 {
-    // create Entity from the last Automat in the list
-    auto& automata{ automatas.back() };
-
-    SG_OGL_ASSERT(!automata->isEntity, "[City::CreateCarEntity()] The Automat is already an Entity.");
+    auto& registry{ m_scene->GetApplicationContext()->registry };
 
     // add a Model
-    auto entity{ m_scene->GetApplicationContext()->GetEntityFactory().CreateModelEntity(
-        "res/model/CarKit/suv.obj",
-        glm::vec3(automata->position.x, 0.015f, automata->position.z),
-        glm::vec3(0.0f, 90.0f, 0.0f),
-        glm::vec3(0.17f),
-        false
+    const auto entity{ CreateCarModel(
+        glm::vec3(t_autoTrack->startNode->position.x, system::Systems::CAR_HEIGHT, t_autoTrack->startNode->position.z),
+        90.0f
     ) };
 
-    automata->isEntity = true;
-
     // add Automata as component
-    m_scene->GetApplicationContext()->registry.assign<ecs::AutomataComponent>(
-        entity,
-        automata
+    auto& automata{ registry.assign<automata::Automata>(entity) };
+    automata.autoLength = 0.2f;
+    automata.currentTrack = t_autoTrack;
+    automata.rootNode = t_autoTrack->startNode.get();
+    automata.randomStream = m_random.GetStream(random::Domain::TRAFFIC, m_nextAutomataId++, m_tick);
+
+    t_autoTrack->automatas.push_back(entity);
+    automata.Update(0.0f, entity, registry);
+
+    m_spatialIndex->InsertVehicle(entity, automata);
+}
+
+entt::entity sg::city::city::City::CreateCarModel(const glm::vec3& t_position, const float t_rotation) const
+{
+    return m_scene->GetApplicationContext()->GetEntityFactory().CreateModelEntity(
+        "res/model/CarKit/suv.obj",
+        t_position,
+        glm::vec3(0.0f, t_rotation, 0.0f),
+        glm::vec3(0.17f),
+        false
     );
 }
 
@@ -11,8 +11,9 @@
 
 #include <string>
 #include <memory>
-#include <list>
+#include <entt/entt.hpp>
 #include "map/tile/Tile.h"
+#include "Random.h"
 
 namespace sg::ogl::scene
 {
@@ -21,7 +22,7 @@ namespace sg::ogl::scene
 
 namespace sg::city::automata
 {
-    class Automata;
+    class AutoTrack;
 }
 
 namespace sg::city::map
@@ -31,6 +32,40 @@ namespace sg::city::map
     class BuildingGenerator;
 }
 
+namespace sg::city::simulation
+{
+    class PopulationGrowth;
+    class Demand;
+}
+
+namespace sg::city::spatial
+{
+    class SpatialIndex;
+}
+
+namespace sg::city::system
+{
+    class Systems;
+}
+
+namespace sg::city::event
+{
+    class EventBus;
+    struct TileChanged;
+    struct RoadTopologyChanged;
+    struct BuildingChanged;
+}
+
+namespace sg::city::stats
+{
+    class PerformanceStats;
+}
+
+namespace sg::city::save
+{
+    struct SaveData;
+}
+
 namespace sg::city::renderer
 {
     class MapRenderer;
@@ -46,16 +81,16 @@ namespace sg::city::city
         using MapSharedPtr = std::shared_ptr<map::Map>;
         using MapRendererUniquePtr = std::unique_ptr<renderer::MapRenderer>;
 
-        using AutomataSharedPtr = std::shared_ptr<automata::Automata>;
-        using AutomataContainer = std::list<AutomataSharedPtr>;
-
         using RoadNetworkSharedPtr = std::shared_ptr<map::RoadNetwork>;
         using RoadNetworkRendererUniquePtr = std::unique_ptr<renderer::RoadNetworkRenderer>;
 
         using BuildingGeneratorSharedPtr = std::shared_ptr<map::BuildingGenerator>;
         using BuildingsRendererUniquePtr = std::unique_ptr<renderer::BuildingsRenderer>;
 
-        using TileIndexContainer = std::vector<int>;
+        using SpatialIndexUniquePtr = std::unique_ptr<spatial::SpatialIndex>;
+        using SystemsUniquePtr = std::unique_ptr<system::Systems>;
+        using EventBusUniquePtr = std::unique_ptr<event::EventBus>;
+        using PerformanceStatsUniquePtr = std::unique_ptr<stats::PerformanceStats>;
 
         //-------------------------------------------------
         // Const
@@ -63,13 +98,11 @@ namespace sg::city::city
 
         static constexpr auto MAX_AUTOMATAS{ 8u };
         static constexpr auto ATTEMPS{ 12 };
-        static constexpr auto STOP_PATTERN_SPEED{ 0.75f };
 
         //-------------------------------------------------
         // Public member
         //-------------------------------------------------
 
-        AutomataContainer automatas;
         bool spawnCars{ false };
 
         //-------------------------------------------------
@@ -78,6 +111,15 @@ namespace sg::city::city
 
         City(std::string t_name, std::string t_mapFileName, ogl::scene::Scene* t_scene);
 
+        /**
+         * @brief Restores a saved City. The Tiles, roads, regions and buildings are created in bulk
+         *        from the saved arrays; nothing is derived from the neighbours or drawn again.
+         * @param t_name The name of the City.
+         * @param t_saveData The data read by save::SaveGame::Read().
+         * @param t_scene The parent Scene.
+         */
+        City(std::string t_name, const save::SaveData& t_saveData, ogl::scene::Scene* t_scene);
+
         City(const City& t_other) = delete;
         City(City&& t_other) noexcept = delete;
         City& operator=(const City& t_other) = delete;
@@ -95,17 +137,46 @@ namespace sg::city::city
         [[nodiscard]] map::Map& GetMap() noexcept;
         [[nodiscard]] MapSharedPtr GetMapSharedPtr() const;
 
+        [[nodiscard]] const map::BuildingGenerator& GetBuildingGenerator() const noexcept;
+        [[nodiscard]] map::BuildingGenerator& GetBuildingGenerator() noexcept;
+
+        [[nodiscard]] const simulation::PopulationGrowth& GetPopulationGrowth() const noexcept;
+        [[nodiscard]] const simulation::Demand& GetDemand() const noexcept;
+
+        [[nodiscard]] const spatial::SpatialIndex& GetSpatialIndex() const noexcept;
+        [[nodiscard]] spatial::SpatialIndex& GetSpatialIndex() noexcept;
+
+        [[nodiscard]] const event::EventBus& GetEventBus() const noexcept;
+        [[nodiscard]] event::EventBus& GetEventBus() noexcept;
+
+        [[nodiscard]] const stats::PerformanceStats& GetPerformanceStats() const noexcept;
+        [[nodiscard]] stats::PerformanceStats& GetPerformanceStats() noexcept;
+
+        [[nodiscard]] const random::Random& GetRandom() const noexcept;
+        [[nodiscard]] uint64_t GetTick() const noexcept;
+
         //-------------------------------------------------
         // Logic
         //-------------------------------------------------
 
-        void Update(double t_dt, TileIndexContainer& t_tileIndexContainer);
+        /**
+         * @brief Dispatches the Tile events of the last tick and runs the simulation.
+         * @param t_dt The elapsed time.
+         */
+        void Update(double t_dt);
         void Render() const;
 
         //-------------------------------------------------
         // Edit
         //-------------------------------------------------
 
+        /**
+         * @brief Replaces a Tile and publishes the events. The systems react with the next Update().
+         * @param t_mapX Map-x position of the Tile.
+         * @param t_mapZ Map-z position of the Tile.
+         * @param t_tileType The new TileType.
+         * @return The Tile index and true if the replace was skipped.
+         */
         [[nodiscard]] auto ReplaceTile(int t_mapX, int t_mapZ, map::tile::TileType t_tileType) const -> std::tuple<int, bool>;
 
         //-------------------------------------------------
@@ -120,6 +191,28 @@ namespace sg::city::city
          */
         bool TrySpawnCarAtSafeTrack(int t_mapX, int t_mapZ);
 
+        //-------------------------------------------------
+        // Save game
+        //-------------------------------------------------
+
+        /**
+         * @brief Writes the Tiles, roads, signals, regions, buildings, cars and the tick to a save file.
+         *        Throws a std::runtime_error if the file cannot be written.
+         * @param t_fileName The save file.
+         */
+        void Save(const std::string& t_fileName) const;
+
+        //-------------------------------------------------
+        // Cars
+        //-------------------------------------------------
+
+        /**
+         * @brief Moves all cars in a single pass over their components.
+         *        The despawned cars are destroyed together at the end.
+         * @param t_dt The elapsed time.
+         */
+        void UpdateVehicles(double t_dt);
+
         //-------------------------------------------------
         // Debug
         //-------------------------------------------------
@@ -145,6 +238,21 @@ namespace sg::city::city
          */
         ogl::scene::Scene* m_scene{ nullptr };
 
+        /**
+         * @brief The random service. All randomness of the City is derived from it.
+         */
+        random::Random m_random;
+
+        /**
+         * @brief The number of the current simulation tick.
+         */
+        uint64_t m_tick{ 0 };
+
+        /**
+         * @brief The Id for the next spawned Automata.
+         */
+        uint64_t m_nextAutomataId{ 0 };
+
         /**
          * @brief The Map of the City holding all Tiles.
          */
@@ -155,11 +263,6 @@ namespace sg::city::city
          */
         MapRendererUniquePtr m_mapRenderer;
 
-        /**
-         * @brief Is used as a timer to change the StopPattern.
-         */
-        float m_stopPatternTimer{ 0.0f };
-
         /**
          * @brief The RoadNetwork of the City.
          */
@@ -180,21 +283,69 @@ namespace sg::city::city
          */
         BuildingsRendererUniquePtr m_buildingsRenderer;
 
+        /**
+         * @brief Finds the cars and buildings on or near a Tile.
+         */
+        SpatialIndexUniquePtr m_spatialIndex;
+
+        /**
+         * @brief The Gpu-free systems shared with the benchmark.
+         */
+        SystemsUniquePtr m_systems;
+
+        /**
+         * @brief Delivers the Tile changes to the systems once per tick.
+         */
+        EventBusUniquePtr m_eventBus;
+
+        /**
+         * @brief The per-frame timings of the performance overlay and the switches of the subsystems.
+         */
+        PerformanceStatsUniquePtr m_performanceStats;
+
         //-------------------------------------------------
         // Init
         //-------------------------------------------------
 
         void Init();
+        void InitSystems();
+        void InitEntities();
         void StoreBuildings() const;
-        void StoreRoads();
+        void StoreRoads() const;
         void CreatePlants() const;
+        void SubscribeSystems();
+
+        //-------------------------------------------------
+        // Restore
+        //-------------------------------------------------
+
+        void Restore(const save::SaveData& t_saveData);
+        void RestoreBuildings(const save::SaveData& t_saveData) const;
+
+        /**
+         * @brief Puts the saved cars back on their tracks, in their saved order.
+         * @param t_saveData The saved cars.
+         */
+        void RestoreVehicles(const save::SaveData& t_saveData);
+
+        //-------------------------------------------------
+        // Systems
+        //-------------------------------------------------
+
+        void UpdateBuildings(const std::vector<event::BuildingChanged>& t_events) const;
+
+        /**
+         * @brief Gives the buildings the floors changed by the last population update.
+         */
+        void UpdateFloors() const;
 
         //-------------------------------------------------
         // Entity
         //-------------------------------------------------
 
         void CreateMapEntity();
-        void CreateCarEntity();
+        void CreateCarEntity(automata::AutoTrack* t_autoTrack);
+        [[nodiscard]] entt::entity CreateCarModel(const glm::vec3& t_position, float t_rotation) const;
         void CreateRoadNetworkEntity();
         void CreateBuildingsEntity();
     };
@@ -0,0 +1,212 @@
+// This file is part of the SgCityBuilder package.
+// 
+// Filename: EventBus.h
+// Author:   stwe
+// 
+// License:  MIT
+// 
+// 2020 (c) stwe <https://github.com/stwe/SgCityBuilder>
+
+#pragma once
+
+#include <tuple>
+#include <string>
+#include <vector>
+#include <functional>
+#include <unordered_map>
+#include "map/tile/Tile.h"
+#include "Timer.h"
+
+namespace sg::city::event
+{
+    //-------------------------------------------------
+    // Events
+    //-------------------------------------------------
+
+    /**
+     * @brief A Tile got a new type.
+     */
+    struct TileChanged
+    {
+        int tileIndex{ -1 };
+        map::tile::TileType oldType{ map::tile::TileType::NONE };
+        map::tile::TileType newType{ map::tile::TileType::NONE };
+    };
+
+    /**
+     * @brief A road was built. The tracks of the road and its road neighbours have to be rebuilt.
+     */
+    struct RoadTopologyChanged
+    {
+        int tileIndex{ -1 };
+    };
+
+    /**
+     * @brief A building was added to or removed from a Tile.
+     */
+    struct BuildingChanged
+    {
+        int tileIndex{ -1 };
+        bool hasBuilding{ false };
+    };
+
+    //-------------------------------------------------
+    // Coalesce
+    //-------------------------------------------------
+
+    // Several events of a Tile within one tick are merged into the first one.
+
+    inline void Coalesce(TileChanged& t_first, const TileChanged& t_next)
+    {
+        t_first.newType = t_next.newType;
+    }
+
+    inline void Coalesce(RoadTopologyChanged&, const RoadTopologyChanged&)
+    {
+    }
+
+    inline void Coalesce(BuildingChanged& t_first, const BuildingChanged& t_next)
+    {
+        t_first.hasBuilding = t_next.hasBuilding;
+    }
+
+    //-------------------------------------------------
+    // EventBus
+    //-------------------------------------------------
+
+    /**
+     * @brief Collects the events of a tick and hands them over to the subscribers in one batch.
+     *        The channels are dispatched in the order TileChanged, RoadTopologyChanged, BuildingChanged.
+     *        The time each subscriber needs is measured.
+     */
+    class EventBus
+    {
+    public:
+        template <typename TEvent>
+        using EventContainer = std::vector<TEvent>;
+
+        template <typename TEvent>
+        using Handler = std::function<void(const EventContainer<TEvent>&)>;
+
+        struct SubscriberTiming
+        {
+            std::string name;
+            float ms{ 0.0f };     // the time of the last dispatch
+            uint32_t events{ 0 }; // the number of events of the last dispatch
+        };
+
+        using TimingContainer = std::vector<SubscriberTiming>;
+
+        //-------------------------------------------------
+        // Getter
+        //-------------------------------------------------
+
+        [[nodiscard]] const TimingContainer& GetTimings() const noexcept
+        {
+            return m_timings;
+        }
+
+        //-------------------------------------------------
+        // Subscribe / Publish
+        //-------------------------------------------------
+
+        /**
+         * @brief Registers a system. The subscribers of a channel are called in the order of registration.
+         * @param t_name The name used for the timing.
+         * @param t_handler Receives all events of a tick.
+         */
+        template <typename TEvent>
+        void Subscribe(const std::string& t_name, Handler<TEvent> t_handler)
+        {
+            m_timings.push_back({ t_name, 0.0f, 0 });
+            GetChannel<TEvent>().subscribers.push_back({ m_timings.size() - 1, std::move(t_handler) });
+        }
+
+        template <typename TEvent>
+        void Publish(const TEvent& t_event)
+        {
+            auto& channel{ GetChannel<TEvent>() };
+
+            const auto it{ channel.slots.find(t_event.tileIndex) };
+            if (it != channel.slots.end())
+            {
+                Coalesce(channel.events[it->second], t_event);
+                return;
+            }
+
+            channel.slots.emplace(t_event.tileIndex, channel.events.size());
+            channel.events.push_back(t_event);
+        }
+
+        //-------------------------------------------------
+        // Dispatch
+        //-------------------------------------------------
+
+        /**
+         * @brief Should be called once per tick.
+         *        Events published by a subscriber are handled in the same tick if their channel comes later.
+         */
+        void Dispatch()
+        {
+            DispatchChannel<TileChanged>();
+            DispatchChannel<RoadTopologyChanged>();
+            DispatchChannel<BuildingChanged>();
+        }
+
+    protected:
+
+    private:
+        template <typename TEvent>
+        struct Subscriber
+        {
+            size_t timingIndex{ 0 };
+            Handler<TEvent> handler;
+        };
+
+        template <typename TEvent>
+        struct Channel
+        {
+            EventContainer<TEvent> events;
+            EventContainer<TEvent> dispatching;
+            std::unordered_map<int, size_t> slots; // the position of the event of each Tile
+            std::vector<Subscriber<TEvent>> subscribers;
+        };
+
+        std::tuple<Channel<TileChanged>, Channel<RoadTopologyChanged>, Channel<BuildingChanged>> m_channels;
+
+        TimingContainer m_timings;
+
+        template <typename TEvent>
+        Channel<TEvent>& GetChannel()
+        {
+            return std::get<Channel<TEvent>>(m_channels);
+        }
+
+        template <typename TEvent>
+        void DispatchChannel()
+        {
+            auto& channel{ GetChannel<TEvent>() };
+
+            // a subscriber may publish new events of the same type; they are handled in the next tick
+            channel.dispatching.swap(channel.events);
+            channel.slots.clear();
+
+            for (auto& subscriber : channel.subscribers)
+            {
+                auto& timing{ m_timings[subscriber.timingIndex] };
+                timing.events = static_cast<uint32_t>(channel.dispatching.size());
+
+                if (channel.dispatching.empty())
+                {
+                    timing.ms = 0.0f;
+                    continue;
+                }
+
+                timer::Timer timer{ &timing.ms };
+                subscriber.handler(channel.dispatching);
+            }
+
+            channel.dispatching.clear();
+        }
+    };
+}
@@ -0,0 +1,150 @@
+// This file is part of the SgCityBuilder package.
+// 
+// Filename: FrameArena.cpp
+// Author:   stwe
+// 
+// License:  MIT
+// 
+// 2020 (c) stwe <https://github.com/stwe/SgCityBuilder>
+
+#include <algorithm>
+#include <Core.h>
+#include <Log.h>
+#include "FrameArena.h"
+#include "Memory.h"
+
+//-------------------------------------------------
+// Ctors. / Dtor.
+//-------------------------------------------------
+
+sg::city::memory::FrameArena::FrameArena(const std::size_t t_capacity)
+{
+    CreateBuffer(t_capacity);
+}
+
+sg::city::memory::FrameArena::~FrameArena() noexcept
+{
+    m_resource.reset();
+    m_upstream.deallocate(m_buffer, m_capacity);
+}
+
+sg::city::memory::FrameArena& sg::city::memory::FrameArena::Get()
+{
+    static FrameArena frameArena;
+    return frameArena;
+}
+
+//-------------------------------------------------
+// Getter
+//-------------------------------------------------
+
+std::pmr::memory_resource* sg::city::memory::FrameArena::GetResource() noexcept
+{
+    return this;
+}
+
+std::size_t sg::city::memory::FrameArena::GetCapacity() const noexcept
+{
+    return m_capacity;
+}
+
+std::size_t sg::city::memory::FrameArena::GetUsedBytes() const noexcept
+{
+    return m_usedBytes;
+}
+
+std::size_t sg::city::memory::FrameArena::GetLastFrameBytes() const noexcept
+{
+    return m_lastFrameBytes;
+}
+
+std::size_t sg::city::memory::FrameArena::GetPeakBytes() const noexcept
+{
+    return m_peakBytes;
+}
+
+uint32_t sg::city::memory::FrameArena::GetGrows() const noexcept
+{
+    return m_grows;
+}
+
+//-------------------------------------------------
+// Frame
+//-------------------------------------------------
+
+void sg::city::memory::FrameArena::Reset()
+{
+    m_lastFrameBytes = m_usedBytes;
+    m_peakBytes = std::max(m_peakBytes, m_usedBytes);
+
+    // frees the overflow and starts again at the begin of the buffer
+    m_resource->release();
+
+    if (m_usedBytes > m_capacity)
+    {
+        auto capacity{ m_capacity };
+        while (capacity < m_usedBytes)
+        {
+            capacity *= 2;
+        }
+
+        SG_OGL_LOG_INFO("[FrameArena::Reset()] The frame needed {} bytes. The arena grows to {} bytes.", m_usedBytes, capacity);
+
+        m_resource.reset();
+        m_upstream.deallocate(m_buffer, m_capacity);
+        CreateBuffer(capacity);
+
+        m_grows++;
+    }
+
+    m_usedBytes = 0;
+}
+
+//-------------------------------------------------
+// Override
+//-------------------------------------------------
+
+void* sg::city::memory::FrameArena::do_allocate(const std::size_t t_bytes, const std::size_t t_alignment)
+{
+    m_usedBytes += t_bytes;
+
+    return m_resource->allocate(t_bytes, t_alignment);
+}
+
+void sg::city::memory::FrameArena::do_deallocate(void*, std::size_t, std::size_t)
+{
+    // released with the next Reset()
+}
+
+bool sg::city::memory::FrameArena::do_is_equal(const std::pmr::memory_resource& t_other) const noexcept
+{
+    return this == &t_other;
+}
+
+void* sg::city::memory::FrameArena::Upstream::do_allocate(const std::size_t t_bytes, const std::size_t t_alignment)
+{
+    SG_OGL_ASSERT(t_alignment <= alignof(std::max_align_t), "[FrameArena::Upstream::do_allocate()] Unsupported alignment.")
+
+    return Memory::Allocate(Tag::SCRATCH, t_bytes);
+}
+
+void sg::city::memory::FrameArena::Upstream::do_deallocate(void* t_ptr, const std::size_t t_bytes, std::size_t)
+{
+    Memory::Deallocate(Tag::SCRATCH, t_ptr, t_bytes);
+}
+
+bool sg::city::memory::FrameArena::Upstream::do_is_equal(const std::pmr::memory_resource& t_other) const noexcept
+{
+    return this == &t_other;
+}
+
+//-------------------------------------------------
+// Helper
+//-------------------------------------------------
+
+void sg::city::memory::FrameArena::CreateBuffer(const std::size_t t_capacity)
+{
+    m_capacity = t_capacity;
+    m_buffer = m_upstream.allocate(m_capacity);
+    m_resource.emplace(m_buffer, m_capacity, &m_upstream);
+}
@@ -0,0 +1,117 @@
+// This file is part of the SgCityBuilder package.
+// 
+// Filename: FrameArena.h
+// Author:   stwe
+// 
+// License:  MIT
+// 
+// 2020 (c) stwe <https://github.com/stwe/SgCityBuilder>
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <memory_resource>
+
+namespace sg::city::memory
+{
+    /**
+     * @brief A monotonic arena for the temporary containers of a frame (std::pmr).
+     *        A deallocation does nothing; Reset() releases everything at once.
+     *        If a frame needs more than the capacity, the rest comes from the heap and
+     *        the arena grows with the next Reset(), so a steady frame does not allocate.
+     *        Memory from the arena must not be kept beyond the frame.
+     */
+    class FrameArena : public std::pmr::memory_resource
+    {
+    public:
+        //-------------------------------------------------
+        // Const
+        //-------------------------------------------------
+
+        static constexpr std::size_t DEFAULT_CAPACITY{ 1u << 20 };
+
+        //-------------------------------------------------
+        // Ctors. / Dtor.
+        //-------------------------------------------------
+
+        explicit FrameArena(std::size_t t_capacity = DEFAULT_CAPACITY);
+
+        FrameArena(const FrameArena& t_other) = delete;
+        FrameArena(FrameArena&& t_other) noexcept = delete;
+        FrameArena& operator=(const FrameArena& t_other) = delete;
+        FrameArena& operator=(FrameArena&& t_other) noexcept = delete;
+
+        ~FrameArena() noexcept override;
+
+        /**
+         * @brief The arena of the main thread. Is reset at the end of each frame.
+         * @return FrameArena
+         */
+        [[nodiscard]] static FrameArena& Get();
+
+        //-------------------------------------------------
+        // Getter
+        //-------------------------------------------------
+
+        [[nodiscard]] std::pmr::memory_resource* GetResource() noexcept;
+
+        [[nodiscard]] std::size_t GetCapacity() const noexcept;
+
+        /**
+         * @brief The bytes requested since the last Reset().
+         * @return std::size_t
+         */
+        [[nodiscard]] std::size_t GetUsedBytes() const noexcept;
+
+        [[nodiscard]] std::size_t GetLastFrameBytes() const noexcept;
+        [[nodiscard]] std::size_t GetPeakBytes() const noexcept;
+
+        /**
+         * @brief The number of times the arena had to grow.
+         * @return uint32_t
+         */
+        [[nodiscard]] uint32_t GetGrows() const noexcept;
+
+        //-------------------------------------------------
+        // Frame
+        //-------------------------------------------------
+
+        /**
+         * @brief Releases all memory of the frame in O(1) and grows the arena if the frame overflowed it.
+         */
+        void Reset();
+
+    protected:
+        void* do_allocate(std::size_t t_bytes, std::size_t t_alignment) override;
+        void do_deallocate(void* t_ptr, std::size_t t_bytes, std::size_t t_alignment) override;
+        [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource& t_other) const noexcept override;
+
+    private:
+        /**
+         * @brief Gets the memory behind the arena and the overflow from the heap under the SCRATCH Tag.
+         */
+        class Upstream : public std::pmr::memory_resource
+        {
+        protected:
+            void* do_allocate(std::size_t t_bytes, std::size_t t_alignment) override;
+            void do_deallocate(void* t_ptr, std::size_t t_bytes, std::size_t t_alignment) override;
+            [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource& t_other) const noexcept override;
+        };
+
+        Upstream m_upstream;
+
+        std::size_t m_capacity{ 0 };
+        void* m_buffer{ nullptr };
+
+        std::optional<std::pmr::monotonic_buffer_resource> m_resource;
+
+        std::size_t m_usedBytes{ 0 };
+        std::size_t m_lastFrameBytes{ 0 };
+        std::size_t m_peakBytes{ 0 };
+        uint32_t m_grows{ 0 };
+
+        void CreateBuffer(std::size_t t_capacity);
+    };
+}
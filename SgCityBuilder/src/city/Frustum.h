@@ -0,0 +1,113 @@
+// This file is part of the SgCityBuilder package.
+// 
+// Filename: Frustum.h
+// Author:   stwe
+// 
+// License:  MIT
+// 
+// 2020 (c) stwe <https://github.com/stwe/SgCityBuilder>
+
+#pragma once
+
+#include <array>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+#include <glm/mat4x4.hpp>
+#include <glm/geometric.hpp>
+
+namespace sg::city::frustum
+{
+    /**
+     * @brief The six planes of the view frustum, extracted from a (model-) view-projection matrix.
+     *        Only uses glm, so the culling can run without a Gpu.
+     */
+    class Frustum
+    {
+    public:
+        //-------------------------------------------------
+        // Const
+        //-------------------------------------------------
+
+        static constexpr auto NUMBER_OF_PLANES{ 6 };
+
+        //-------------------------------------------------
+        // Ctors. / Dtor.
+        //-------------------------------------------------
+
+        Frustum() = default;
+
+        /**
+         * @brief Extracts the planes (Gribb/Hartmann).
+         *        With a model-view-projection matrix, the planes are in Object Space of the model.
+         * @param t_matrix The view-projection or model-view-projection matrix.
+         */
+        explicit Frustum(const glm::mat4& t_matrix)
+        {
+            Update(t_matrix);
+        }
+
+        //-------------------------------------------------
+        // Update
+        //-------------------------------------------------
+
+        void Update(const glm::mat4& t_matrix)
+        {
+            // glm is column-major: t_matrix[column][row]
+            const auto row = [&t_matrix](const int t_row)
+            {
+                return glm::vec4(t_matrix[0][t_row], t_matrix[1][t_row], t_matrix[2][t_row], t_matrix[3][t_row]);
+            };
+
+            m_planes[0] = row(3) + row(0); // left
+            m_planes[1] = row(3) - row(0); // right
+            m_planes[2] = row(3) + row(1); // bottom
+            m_planes[3] = row(3) - row(1); // top
+            m_planes[4] = row(3) + row(2); // near
+            m_planes[5] = row(3) - row(2); // far
+
+            for (auto& plane : m_planes)
+            {
+                plane /= glm::length(glm::vec3(plane));
+            }
+        }
+
+        //-------------------------------------------------
+        // Test
+        //-------------------------------------------------
+
+        /**
+         * @brief Tests an axis-aligned box against all planes.
+         *        Conservative: a box near a frustum corner can be reported as visible.
+         * @param t_min The minimum corner of the box.
+         * @param t_max The maximum corner of the box.
+         * @return False if the box is completely outside of one plane.
+         */
+        [[nodiscard]] bool IsBoxVisible(const glm::vec3& t_min, const glm::vec3& t_max) const
+        {
+            for (const auto& plane : m_planes)
+            {
+                // the corner farthest along the plane normal
+                const glm::vec3 corner{
+                    plane.x >= 0.0f ? t_max.x : t_min.x,
+                    plane.y >= 0.0f ? t_max.y : t_min.y,
+                    plane.z >= 0.0f ? t_max.z : t_min.z
+                };
+
+                if (glm::dot(glm::vec3(plane), corner) + plane.w < 0.0f)
+                {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+    protected:
+
+    private:
+        /**
+         * @brief The planes as (normal, distance). The normals point inside.
+         */
+        std::array<glm::vec4, NUMBER_OF_PLANES> m_planes{};
+    };
+}
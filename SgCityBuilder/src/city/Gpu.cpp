@@ -0,0 +1,285 @@
+// This file is part of the SgCityBuilder package.
+// 
+// Filename: Gpu.cpp
+// Author:   stwe
+// 
+// License:  MIT
+// 
+// 2020 (c) stwe <https://github.com/stwe/SgCityBuilder>
+
+#include <Core.h>
+#include <resource/Mesh.h>
+#include "Gpu.h"
+
+//-------------------------------------------------
+// GlBackend
+//-------------------------------------------------
+
+void sg::city::gpu::GlBackend::BindVbo(const uint32_t t_vboId)
+{
+    ogl::buffer::Vbo::BindVbo(t_vboId);
+}
+
+void sg::city::gpu::GlBackend::UnbindVbo()
+{
+    ogl::buffer::Vbo::UnbindVbo();
+}
+
+void sg::city::gpu::GlBackend::BufferData(const uint64_t t_sizeInBytes, const void* t_data)
+{
+    glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(t_sizeInBytes), t_data, GL_DYNAMIC_DRAW);
+}
+
+void sg::city::gpu::GlBackend::BufferSubData(const uint64_t t_offsetInBytes, const uint64_t t_sizeInBytes, const void* t_data)
+{
+    glBufferSubData(GL_ARRAY_BUFFER, static_cast<GLintptr>(t_offsetInBytes), static_cast<GLsizeiptr>(t_sizeInBytes), t_data);
+}
+
+void sg::city::gpu::GlBackend::InitDraw(ogl::resource::Mesh& t_mesh)
+{
+    t_mesh.InitDraw();
+}
+
+void sg::city::gpu::GlBackend::EndDraw(ogl::resource::Mesh& t_mesh)
+{
+    t_mesh.EndDraw();
+}
+
+void sg::city::gpu::GlBackend::DrawInstanced(const uint32_t t_vertices, const uint32_t t_instances, const uint32_t t_baseInstance)
+{
+    // OpenGL 4.2 or ARB_base_instance
+    glDrawArraysInstancedBaseInstance(GL_TRIANGLES, 0, static_cast<GLsizei>(t_vertices), static_cast<GLsizei>(t_instances), t_baseInstance);
+}
+
+void sg::city::gpu::GlBackend::MultiDraw(const Primitive t_primitive, const int32_t* t_firsts, const int32_t* t_counts, const uint32_t t_drawCount)
+{
+    GLenum mode{ GL_TRIANGLES };
+    if (t_primitive == Primitive::LINES)
+    {
+        mode = GL_LINES;
+    }
+    else if (t_primitive == Primitive::POINTS)
+    {
+        mode = GL_POINTS;
+    }
+
+    glMultiDrawArrays(mode, t_firsts, t_counts, static_cast<GLsizei>(t_drawCount));
+}
+
+//-------------------------------------------------
+// RecordingBackend
+//-------------------------------------------------
+
+const sg::city::gpu::RecordingBackend::CallContainer& sg::city::gpu::RecordingBackend::GetCalls() const noexcept
+{
+    return m_calls;
+}
+
+uint64_t sg::city::gpu::RecordingBackend::GetUploadBytes() const
+{
+    uint64_t bytes{ 0 };
+    for (const auto& call : m_calls)
+    {
+        if (call.type == CallType::BUFFER_DATA || call.type == CallType::BUFFER_SUB_DATA)
+        {
+            bytes += call.sizeInBytes;
+        }
+    }
+
+    return bytes;
+}
+
+void sg::city::gpu::RecordingBackend::Clear()
+{
+    m_calls.clear();
+}
+
+void sg::city::gpu::RecordingBackend::BindVbo(const uint32_t t_vboId)
+{
+    m_boundVboId = t_vboId;
+    m_calls.push_back({ CallType::BIND_VBO, t_vboId });
+}
+
+void sg::city::gpu::RecordingBackend::UnbindVbo()
+{
+    m_calls.push_back({ CallType::UNBIND_VBO, m_boundVboId });
+    m_boundVboId = 0;
+}
+
+void sg::city::gpu::RecordingBackend::BufferData(const uint64_t t_sizeInBytes, const void* t_data)
+{
+    m_calls.push_back({ CallType::BUFFER_DATA, m_boundVboId, 0, t_sizeInBytes });
+}
+
+void sg::city::gpu::RecordingBackend::BufferSubData(const uint64_t t_offsetInBytes, const uint64_t t_sizeInBytes, const void* t_data)
+{
+    m_calls.push_back({ CallType::BUFFER_SUB_DATA, m_boundVboId, t_offsetInBytes, t_sizeInBytes });
+}
+
+void sg::city::gpu::RecordingBackend::InitDraw(ogl::resource::Mesh& t_mesh)
+{
+    m_calls.push_back({ CallType::INIT_DRAW, m_boundVboId });
+}
+
+void sg::city::gpu::RecordingBackend::EndDraw(ogl::resource::Mesh& t_mesh)
+{
+    m_calls.push_back({ CallType::END_DRAW, m_boundVboId });
+}
+
+void sg::city::gpu::RecordingBackend::DrawInstanced(const uint32_t t_vertices, const uint32_t t_instances, const uint32_t t_baseInstance)
+{
+    m_calls.push_back({ CallType::DRAW_INSTANCED, m_boundVboId, 0, 0, t_vertices, t_instances });
+}
+
+void sg::city::gpu::RecordingBackend::MultiDraw(const Primitive t_primitive, const int32_t* t_firsts, const int32_t* t_counts, const uint32_t t_drawCount)
+{
+    m_calls.push_back({ CallType::MULTI_DRAW, m_boundVboId, 0, 0, t_drawCount });
+}
+
+//-------------------------------------------------
+// Gpu - Backend
+//-------------------------------------------------
+
+void sg::city::gpu::Gpu::SetBackend(std::unique_ptr<Backend> t_backend)
+{
+    s_backend = t_backend ? std::move(t_backend) : std::make_unique<GlBackend>();
+}
+
+sg::city::gpu::Backend& sg::city::gpu::Gpu::GetBackend()
+{
+    if (!s_backend)
+    {
+        s_backend = std::make_unique<GlBackend>();
+    }
+
+    return *s_backend;
+}
+
+//-------------------------------------------------
+// Gpu - Calls
+//-------------------------------------------------
+
+void sg::city::gpu::Gpu::BindVbo(const Source t_source, const uint32_t t_vboId)
+{
+    GetBackend().BindVbo(t_vboId);
+    GetCounters(t_source).binds++;
+}
+
+void sg::city::gpu::Gpu::UnbindVbo(const Source t_source)
+{
+    // resetting to 0 is not counted as a state bind
+    GetBackend().UnbindVbo();
+}
+
+void sg::city::gpu::Gpu::BufferData(const Source t_source, const uint64_t t_sizeInBytes, const void* t_data)
+{
+    GetBackend().BufferData(t_sizeInBytes, t_data);
+
+    // a reallocation without data uploads nothing
+    if (t_data)
+    {
+        auto& counters{ GetCounters(t_source) };
+        counters.uploads++;
+        counters.uploadBytes += t_sizeInBytes;
+    }
+}
+
+void sg::city::gpu::Gpu::BufferSubData(const Source t_source, const uint64_t t_offsetInBytes, const uint64_t t_sizeInBytes, const void* t_data)
+{
+    GetBackend().BufferSubData(t_offsetInBytes, t_sizeInBytes, t_data);
+
+    auto& counters{ GetCounters(t_source) };
+    counters.uploads++;
+    counters.uploadBytes += t_sizeInBytes;
+}
+
+void sg::city::gpu::Gpu::InitDraw(const Source t_source, ogl::resource::Mesh& t_mesh)
+{
+    // binds the Vao of the Mesh
+    GetBackend().InitDraw(t_mesh);
+    GetCounters(t_source).binds++;
+}
+
+void sg::city::gpu::Gpu::EndDraw(const Source t_source, ogl::resource::Mesh& t_mesh)
+{
+    GetBackend().EndDraw(t_mesh);
+}
+
+void sg::city::gpu::Gpu::DrawInstanced(const Source t_source, const uint32_t t_vertices, const uint32_t t_instances, const uint32_t t_baseInstance)
+{
+    GetBackend().DrawInstanced(t_vertices, t_instances, t_baseInstance);
+    GetCounters(t_source).drawCalls++;
+}
+
+void sg::city::gpu::Gpu::MultiDraw(const Source t_source, const Primitive t_primitive, const int32_t* t_firsts, const int32_t* t_counts, const uint32_t t_drawCount)
+{
+    GetBackend().MultiDraw(t_primitive, t_firsts, t_counts, t_drawCount);
+    GetCounters(t_source).drawCalls++;
+}
+
+//-------------------------------------------------
+// Gpu - Counters
+//-------------------------------------------------
+
+const char* sg::city::gpu::Gpu::GetName(const Source t_source)
+{
+    switch (t_source)
+    {
+    case Source::MAP: return "Map";
+    case Source::ROADS: return "Roads";
+    case Source::BUILDINGS: return "Buildings";
+    case Source::DEBUG: return "Debug";
+    default: return "Unknown";
+    }
+}
+
+const sg::city::gpu::Counters& sg::city::gpu::Gpu::GetFrameCounters(const Source t_source)
+{
+    return GetCounters(t_source);
+}
+
+const sg::city::gpu::Counters& sg::city::gpu::Gpu::GetLastFrameCounters(const Source t_source)
+{
+    return s_lastFrameCounters[static_cast<size_t>(t_source)];
+}
+
+sg::city::gpu::Counters sg::city::gpu::Gpu::GetFrameTotal()
+{
+    Counters total;
+    for (const auto& counters : s_frameCounters)
+    {
+        total += counters;
+    }
+
+    return total;
+}
+
+sg::city::gpu::Counters sg::city::gpu::Gpu::GetLastFrameTotal()
+{
+    Counters total;
+    for (const auto& counters : s_lastFrameCounters)
+    {
+        total += counters;
+    }
+
+    return total;
+}
+
+void sg::city::gpu::Gpu::NextFrame()
+{
+    s_lastFrameCounters = s_frameCounters;
+    s_frameCounters = {};
+}
+
+void sg::city::gpu::Gpu::ResetCounters()
+{
+    s_frameCounters = {};
+    s_lastFrameCounters = {};
+}
+
+sg::city::gpu::Counters& sg::city::gpu::Gpu::GetCounters(const Source t_source)
+{
+    SG_OGL_ASSERT(t_source < Source::COUNT, "[Gpu::GetCounters()] Invalid Source.")
+
+    return s_frameCounters[static_cast<size_t>(t_source)];
+}
@@ -0,0 +1,291 @@
+// This file is part of the SgCityBuilder package.
+// 
+// Filename: Gpu.h
+// Author:   stwe
+// 
+// License:  MIT
+// 
+// 2020 (c) stwe <https://github.com/stwe/SgCityBuilder>
+
+#pragma once
+
+#include <array>
+#include <memory>
+#include <vector>
+#include <cstdint>
+
+namespace sg::ogl::resource
+{
+    class Mesh;
+}
+
+namespace sg::city::gpu
+{
+    /**
+     * @brief The subsystem that causes an upload, a draw call or a bind.
+     */
+    enum class Source : uint32_t
+    {
+        MAP,
+        ROADS,
+        BUILDINGS,
+        DEBUG,
+        COUNT
+    };
+
+    enum class Primitive : uint8_t
+    {
+        TRIANGLES,
+        LINES,
+        POINTS
+    };
+
+    struct Counters
+    {
+        uint64_t uploadBytes{ 0 };
+        uint32_t uploads{ 0 };
+        uint32_t drawCalls{ 0 };
+        uint32_t binds{ 0 };
+
+        Counters& operator+=(const Counters& t_other)
+        {
+            uploadBytes += t_other.uploadBytes;
+            uploads += t_other.uploads;
+            drawCalls += t_other.drawCalls;
+            binds += t_other.binds;
+
+            return *this;
+        }
+    };
+
+    //-------------------------------------------------
+    // Backend
+    //-------------------------------------------------
+
+    /**
+     * @brief The Gpu calls of the City. The uploads always target the bound Vbo (GL_ARRAY_BUFFER).
+     */
+    class Backend
+    {
+    public:
+        Backend() = default;
+
+        Backend(const Backend& t_other) = delete;
+        Backend(Backend&& t_other) noexcept = delete;
+        Backend& operator=(const Backend& t_other) = delete;
+        Backend& operator=(Backend&& t_other) noexcept = delete;
+
+        virtual ~Backend() noexcept = default;
+
+        virtual void BindVbo(uint32_t t_vboId) = 0;
+        virtual void UnbindVbo() = 0;
+
+        /**
+         * @brief Reallocates the bound Vbo (GL_DYNAMIC_DRAW).
+         * @param t_sizeInBytes The new size.
+         * @param t_data The new content or nullptr.
+         */
+        virtual void BufferData(uint64_t t_sizeInBytes, const void* t_data) = 0;
+        virtual void BufferSubData(uint64_t t_offsetInBytes, uint64_t t_sizeInBytes, const void* t_data) = 0;
+
+        virtual void InitDraw(ogl::resource::Mesh& t_mesh) = 0;
+        virtual void EndDraw(ogl::resource::Mesh& t_mesh) = 0;
+
+        virtual void DrawInstanced(uint32_t t_vertices, uint32_t t_instances, uint32_t t_baseInstance) = 0;
+        virtual void MultiDraw(Primitive t_primitive, const int32_t* t_firsts, const int32_t* t_counts, uint32_t t_drawCount) = 0;
+
+    protected:
+
+    private:
+
+    };
+
+    /**
+     * @brief Forwards the calls to OpenGL.
+     */
+    class GlBackend : public Backend
+    {
+    public:
+        void BindVbo(uint32_t t_vboId) override;
+        void UnbindVbo() override;
+
+        void BufferData(uint64_t t_sizeInBytes, const void* t_data) override;
+        void BufferSubData(uint64_t t_offsetInBytes, uint64_t t_sizeInBytes, const void* t_data) override;
+
+        void InitDraw(ogl::resource::Mesh& t_mesh) override;
+        void EndDraw(ogl::resource::Mesh& t_mesh) override;
+
+        void DrawInstanced(uint32_t t_vertices, uint32_t t_instances, uint32_t t_baseInstance) override;
+        void MultiDraw(Primitive t_primitive, const int32_t* t_firsts, const int32_t* t_counts, uint32_t t_drawCount) override;
+    };
+
+    /**
+     * @brief Records the calls without a Gpu. Used by the headless runs to check upload budgets.
+     */
+    class RecordingBackend : public Backend
+    {
+    public:
+        enum class CallType : uint8_t
+        {
+            BIND_VBO,
+            UNBIND_VBO,
+            BUFFER_DATA,
+            BUFFER_SUB_DATA,
+            INIT_DRAW,
+            END_DRAW,
+            DRAW_INSTANCED,
+            MULTI_DRAW
+        };
+
+        struct Call
+        {
+            CallType type{ CallType::BIND_VBO };
+
+            /**
+             * @brief The Vbo bound at the time of the call.
+             */
+            uint32_t vboId{ 0 };
+
+            uint64_t offsetInBytes{ 0 };
+            uint64_t sizeInBytes{ 0 };
+
+            /**
+             * @brief The vertices of a DrawInstanced() or the draws of a MultiDraw().
+             */
+            uint32_t count{ 0 };
+            uint32_t instances{ 0 };
+        };
+
+        using CallContainer = std::vector<Call>;
+
+        //-------------------------------------------------
+        // Getter
+        //-------------------------------------------------
+
+        [[nodiscard]] const CallContainer& GetCalls() const noexcept;
+
+        /**
+         * @brief The bytes of all BufferData() and BufferSubData() calls since the last Clear().
+         * @return uint64_t
+         */
+        [[nodiscard]] uint64_t GetUploadBytes() const;
+
+        void Clear();
+
+        //-------------------------------------------------
+        // Override
+        //-------------------------------------------------
+
+        void BindVbo(uint32_t t_vboId) override;
+        void UnbindVbo() override;
+
+        void BufferData(uint64_t t_sizeInBytes, const void* t_data) override;
+        void BufferSubData(uint64_t t_offsetInBytes, uint64_t t_sizeInBytes, const void* t_data) override;
+
+        void InitDraw(ogl::resource::Mesh& t_mesh) override;
+        void EndDraw(ogl::resource::Mesh& t_mesh) override;
+
+        void DrawInstanced(uint32_t t_vertices, uint32_t t_instances, uint32_t t_baseInstance) override;
+        void MultiDraw(Primitive t_primitive, const int32_t* t_firsts, const int32_t* t_counts, uint32_t t_drawCount) override;
+
+    protected:
+
+    private:
+        CallContainer m_calls;
+        uint32_t m_boundVboId{ 0 };
+    };
+
+    //-------------------------------------------------
+    // Gpu
+    //-------------------------------------------------
+
+    /**
+     * @brief Routes the uploads, draw calls and binds of the City to the Backend
+     *        and counts them per frame and per Source. Should only be used from the main thread.
+     */
+    class Gpu
+    {
+    public:
+        static constexpr auto NR_OF_SOURCES{ static_cast<uint32_t>(Source::COUNT) };
+
+        using CountersContainer = std::array<Counters, NR_OF_SOURCES>;
+
+        //-------------------------------------------------
+        // Backend
+        //-------------------------------------------------
+
+        /**
+         * @brief Replaces the Backend.
+         * @param t_backend The new Backend. If nullptr, the GlBackend is used.
+         */
+        static void SetBackend(std::unique_ptr<Backend> t_backend);
+
+        /**
+         * @brief The current Backend. The GlBackend is created with the first call.
+         * @return Backend
+         */
+        [[nodiscard]] static Backend& GetBackend();
+
+        //-------------------------------------------------
+        // Calls
+        //-------------------------------------------------
+
+        static void BindVbo(Source t_source, uint32_t t_vboId);
+        static void UnbindVbo(Source t_source);
+
+        static void BufferData(Source t_source, uint64_t t_sizeInBytes, const void* t_data);
+        static void BufferSubData(Source t_source, uint64_t t_offsetInBytes, uint64_t t_sizeInBytes, const void* t_data);
+
+        static void InitDraw(Source t_source, ogl::resource::Mesh& t_mesh);
+        static void EndDraw(Source t_source, ogl::resource::Mesh& t_mesh);
+
+        /**
+         * @brief An instanced draw of triangles starting at an instance.
+         *        The GlBackend uses glDrawArraysInstancedBaseInstance: OpenGL 4.2 or ARB_base_instance is required.
+         */
+        static void DrawInstanced(Source t_source, uint32_t t_vertices, uint32_t t_instances, uint32_t t_baseInstance);
+        static void MultiDraw(Source t_source, Primitive t_primitive, const int32_t* t_firsts, const int32_t* t_counts, uint32_t t_drawCount);
+
+        //-------------------------------------------------
+        // Counters
+        //-------------------------------------------------
+
+        [[nodiscard]] static const char* GetName(Source t_source);
+
+        /**
+         * @brief The counters of the running frame.
+         * @param t_source The Source.
+         * @return Counters
+         */
+        [[nodiscard]] static const Counters& GetFrameCounters(Source t_source);
+
+        /**
+         * @brief The counters of the last completed frame.
+         * @param t_source The Source.
+         * @return Counters
+         */
+        [[nodiscard]] static const Counters& GetLastFrameCounters(Source t_source);
+
+        [[nodiscard]] static Counters GetFrameTotal();
+        [[nodiscard]] static Counters GetLastFrameTotal();
+
+        /**
+         * @brief Closes the running frame and starts the next one. Should be called once per frame.
+         */
+        static void NextFrame();
+
+        /**
+         * @brief Sets all counters to zero.
+         */
+        static void ResetCounters();
+
+    protected:
+
+    private:
+        inline static std::unique_ptr<Backend> s_backend;
+        inline static CountersContainer s_frameCounters{};
+        inline static CountersContainer s_lastFrameCounters{};
+
+        static Counters& GetCounters(Source t_source);
+    };
+}
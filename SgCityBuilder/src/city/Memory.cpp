@@ -0,0 +1,323 @@
+// This file is part of the SgCityBuilder package.
+// 
+// Filename: Memory.cpp
+// Author:   stwe
+// 
+// License:  MIT
+// 
+// 2020 (c) stwe <https://github.com/stwe/SgCityBuilder>
+
+#include <new>
+#include <array>
+#include <atomic>
+#include <cstdlib>
+#include <algorithm>
+#include <Core.h>
+#include "Build.h"
+#include "Memory.h"
+#include "ThreadPool.h"
+
+#if defined(_WIN32)
+    #include <Windows.h>
+    #include <Psapi.h>
+    #pragma comment(lib, "psapi.lib")
+#elif defined(__linux__) || defined(__APPLE__)
+    #include <sys/resource.h>
+#endif
+
+namespace
+{
+    std::atomic<uint64_t> g_allocations{ 0 };
+    std::atomic<uint64_t> g_allocatedBytes{ 0 };
+
+    struct TagCounters
+    {
+        std::atomic<uint64_t> liveBytes{ 0 };
+        std::atomic<uint64_t> peakBytes{ 0 };
+        std::atomic<uint64_t> allocations{ 0 };
+    };
+
+    std::array<TagCounters, sg::city::memory::Memory::NR_OF_TAGS> g_tagCounters;
+
+#ifdef ENABLE_ALLOCATION_TRACKING
+
+    void CountAllocation(const std::size_t t_size)
+    {
+        g_allocations.fetch_add(1, std::memory_order_relaxed);
+        g_allocatedBytes.fetch_add(t_size, std::memory_order_relaxed);
+    }
+
+    void* Allocate(const std::size_t t_size) noexcept
+    {
+        CountAllocation(t_size);
+
+        return std::malloc(t_size ? t_size : 1);
+    }
+
+    void* AllocateAligned(const std::size_t t_size, const std::align_val_t t_alignment) noexcept
+    {
+        CountAllocation(t_size);
+
+        const auto alignment{ static_cast<std::size_t>(t_alignment) };
+        const auto size{ t_size ? t_size : 1 };
+
+#if defined(_WIN32)
+        return _aligned_malloc(size, alignment);
+#else
+        void* ptr{ nullptr };
+        return posix_memalign(&ptr, std::max(alignment, sizeof(void*)), size) == 0 ? ptr : nullptr;
+#endif
+    }
+
+    void FreeAligned(void* t_ptr) noexcept
+    {
+#if defined(_WIN32)
+        _aligned_free(t_ptr);
+#else
+        std::free(t_ptr);
+#endif
+    }
+
+    void* AllocateOrThrow(const std::size_t t_size)
+    {
+        if (auto* ptr{ Allocate(t_size) })
+        {
+            return ptr;
+        }
+
+        throw std::bad_alloc();
+    }
+
+    void* AllocateAlignedOrThrow(const std::size_t t_size, const std::align_val_t t_alignment)
+    {
+        if (auto* ptr{ AllocateAligned(t_size, t_alignment) })
+        {
+            return ptr;
+        }
+
+        throw std::bad_alloc();
+    }
+
+#endif
+}
+
+#ifdef ENABLE_ALLOCATION_TRACKING
+
+//-------------------------------------------------
+// Global operator new / delete
+//-------------------------------------------------
+
+// the whole replaceable set; a missing overload would pair a counted new with the delete of the runtime
+
+void* operator new(const std::size_t t_size)
+{
+    return AllocateOrThrow(t_size);
+}
+
+void* operator new[](const std::size_t t_size)
+{
+    return AllocateOrThrow(t_size);
+}
+
+void* operator new(const std::size_t t_size, const std::nothrow_t&) noexcept
+{
+    return Allocate(t_size);
+}
+
+void* operator new[](const std::size_t t_size, const std::nothrow_t&) noexcept
+{
+    return Allocate(t_size);
+}
+
+void* operator new(const std::size_t t_size, const std::align_val_t t_alignment)
+{
+    return AllocateAlignedOrThrow(t_size, t_alignment);
+}
+
+void* operator new[](const std::size_t t_size, const std::align_val_t t_alignment)
+{
+    return AllocateAlignedOrThrow(t_size, t_alignment);
+}
+
+void* operator new(const std::size_t t_size, const std::align_val_t t_alignment, const std::nothrow_t&) noexcept
+{
+    return AllocateAligned(t_size, t_alignment);
+}
+
+void* operator new[](const std::size_t t_size, const std::align_val_t t_alignment, const std::nothrow_t&) noexcept
+{
+    return AllocateAligned(t_size, t_alignment);
+}
+
+void operator delete(void* t_ptr) noexcept
+{
+    std::free(t_ptr);
+}
+
+void operator delete[](void* t_ptr) noexcept
+{
+    std::free(t_ptr);
+}
+
+void operator delete(void* t_ptr, std::size_t) noexcept
+{
+    std::free(t_ptr);
+}
+
+void operator delete[](void* t_ptr, std::size_t) noexcept
+{
+    std::free(t_ptr);
+}
+
+void operator delete(void* t_ptr, const std::nothrow_t&) noexcept
+{
+    std::free(t_ptr);
+}
+
+void operator delete[](void* t_ptr, const std::nothrow_t&) noexcept
+{
+    std::free(t_ptr);
+}
+
+void operator delete(void* t_ptr, std::align_val_t) noexcept
+{
+    FreeAligned(t_ptr);
+}
+
+void operator delete[](void* t_ptr, std::align_val_t) noexcept
+{
+    FreeAligned(t_ptr);
+}
+
+void operator delete(void* t_ptr, std::size_t, std::align_val_t) noexcept
+{
+    FreeAligned(t_ptr);
+}
+
+void operator delete[](void* t_ptr, std::size_t, std::align_val_t) noexcept
+{
+    FreeAligned(t_ptr);
+}
+
+void operator delete(void* t_ptr, std::align_val_t, const std::nothrow_t&) noexcept
+{
+    FreeAligned(t_ptr);
+}
+
+void operator delete[](void* t_ptr, std::align_val_t, const std::nothrow_t&) noexcept
+{
+    FreeAligned(t_ptr);
+}
+
+#endif
+
+//-------------------------------------------------
+// Memory
+//-------------------------------------------------
+
+uint64_t sg::city::memory::Memory::GetAllocations()
+{
+    return g_allocations.load(std::memory_order_relaxed);
+}
+
+uint64_t sg::city::memory::Memory::GetAllocatedBytes()
+{
+    return g_allocatedBytes.load(std::memory_order_relaxed);
+}
+
+//-------------------------------------------------
+// Tags
+//-------------------------------------------------
+
+const char* sg::city::memory::Memory::GetName(const Tag t_tag)
+{
+    switch (t_tag)
+    {
+    case Tag::TILES: return "Tiles";
+    case Tag::VERTICES: return "Vertices";
+    case Tag::NAV_NODES: return "Nav nodes";
+    case Tag::TRACKS: return "Tracks";
+    case Tag::AUTOMATA: return "Automata";
+    case Tag::BUILDINGS: return "Buildings";
+    case Tag::SCRATCH: return "Scratch";
+    default: return "Unknown";
+    }
+}
+
+sg::city::memory::TagStats sg::city::memory::Memory::GetTagStats(const Tag t_tag)
+{
+    const auto& counters{ g_tagCounters[static_cast<size_t>(t_tag)] };
+
+    TagStats tagStats;
+    tagStats.liveBytes = counters.liveBytes.load(std::memory_order_relaxed);
+    tagStats.peakBytes = counters.peakBytes.load(std::memory_order_relaxed);
+    tagStats.allocations = counters.allocations.load(std::memory_order_relaxed);
+
+    return tagStats;
+}
+
+void* sg::city::memory::Memory::Allocate(const Tag t_tag, const std::size_t t_size)
+{
+    // the global operator new counts the allocation for the process too
+    auto* ptr{ ::operator new(t_size) };
+
+    auto& counters{ g_tagCounters[static_cast<size_t>(t_tag)] };
+    counters.allocations.fetch_add(1, std::memory_order_relaxed);
+
+    const auto liveBytes{ counters.liveBytes.fetch_add(t_size, std::memory_order_relaxed) + t_size };
+    auto peakBytes{ counters.peakBytes.load(std::memory_order_relaxed) };
+    while (liveBytes > peakBytes && !counters.peakBytes.compare_exchange_weak(peakBytes, liveBytes, std::memory_order_relaxed))
+    {
+    }
+
+    return ptr;
+}
+
+void sg::city::memory::Memory::Deallocate(const Tag t_tag, void* t_ptr, const std::size_t t_size) noexcept
+{
+    if (!t_ptr)
+    {
+        return;
+    }
+
+    g_tagCounters[static_cast<size_t>(t_tag)].liveBytes.fetch_sub(t_size, std::memory_order_relaxed);
+
+    ::operator delete(t_ptr);
+}
+
+void sg::city::memory::Memory::AssertNotInParallelFor()
+{
+    SG_OGL_ASSERT(!thread::ThreadPool::Get().IsInParallelFor(), "[Memory::AssertNotInParallelFor()] A Pool block must not change inside a ParallelFor().")
+}
+
+//-------------------------------------------------
+// Process
+//-------------------------------------------------
+
+uint64_t sg::city::memory::Memory::GetPeakRss()
+{
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+    {
+        return counters.PeakWorkingSetSize;
+    }
+
+    return 0;
+#elif defined(__linux__) || defined(__APPLE__)
+    rusage usage{};
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+    {
+        return 0;
+    }
+
+    #if defined(__APPLE__)
+        return static_cast<uint64_t>(usage.ru_maxrss);
+    #else
+        // Linux reports kilobytes
+        return static_cast<uint64_t>(usage.ru_maxrss) * 1024;
+    #endif
+#else
+    return 0;
+#endif
+}
@@ -0,0 +1,344 @@
+// This file is part of the SgCityBuilder package.
+// 
+// Filename: Memory.h
+// Author:   stwe
+// 
+// License:  MIT
+// 
+// 2020 (c) stwe <https://github.com/stwe/SgCityBuilder>
+
+#pragma once
+
+#include <new>
+#include <mutex>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace sg::city::memory
+{
+    /**
+     * @brief The owner of an allocation.
+     */
+    enum class Tag : uint32_t
+    {
+        TILES,     // the Tile objects, their attributes and slots
+        VERTICES,  // the Cpu-side vertex buffers
+        NAV_NODES, // the navigation nodes of the roads
+        TRACKS,    // the tracks between the navigation nodes
+        AUTOMATA,  // the cars on the tracks and in the SpatialIndex
+        BUILDINGS, // the building instances
+        SCRATCH,   // the FrameArena
+        COUNT
+    };
+
+    struct TagStats
+    {
+        uint64_t liveBytes{ 0 };
+        uint64_t peakBytes{ 0 };
+        uint64_t allocations{ 0 };
+    };
+
+    /**
+     * @brief The allocation counters and the peak memory of the process.
+     *        With ENABLE_ALLOCATION_TRACKING the global operator new is replaced in Memory.cpp, so all allocations are counted.
+     *        The define is set for the Debug build and the benchmark; otherwise the process counters stay 0.
+     */
+    class Memory
+    {
+    public:
+        /**
+         * @brief The number of calls of operator new since the start of the process.
+         * @return uint64_t
+         */
+        [[nodiscard]] static uint64_t GetAllocations();
+
+        /**
+         * @brief The number of bytes requested by operator new since the start of the process.
+         * @return uint64_t
+         */
+        [[nodiscard]] static uint64_t GetAllocatedBytes();
+
+        /**
+         * @brief The peak resident set size (working set) of the process.
+         * @return The size in bytes or 0 if it is unknown on this platform.
+         */
+        [[nodiscard]] static uint64_t GetPeakRss();
+
+        //-------------------------------------------------
+        // Tags
+        //-------------------------------------------------
+
+        static constexpr auto NR_OF_TAGS{ static_cast<uint32_t>(Tag::COUNT) };
+
+        [[nodiscard]] static const char* GetName(Tag t_tag);
+
+        /**
+         * @brief The live and peak bytes and the number of allocations of a Tag since the start of the process.
+         * @param t_tag The Tag.
+         * @return TagStats
+         */
+        [[nodiscard]] static TagStats GetTagStats(Tag t_tag);
+
+        static void* Allocate(Tag t_tag, std::size_t t_size);
+        static void Deallocate(Tag t_tag, void* t_ptr, std::size_t t_size) noexcept;
+
+        /**
+         * @brief Asserts that no ThreadPool::ParallelFor() is running, e.g. before a Pool changes its block.
+         */
+        static void AssertNotInParallelFor();
+
+    protected:
+
+    private:
+
+    };
+
+    /**
+     * @brief A std allocator that counts the memory of a container under a Tag.
+     */
+    template <typename T, Tag TAG>
+    class TrackingAllocator
+    {
+    public:
+        using value_type = T;
+
+        template <typename U>
+        struct rebind
+        {
+            using other = TrackingAllocator<U, TAG>;
+        };
+
+        TrackingAllocator() noexcept = default;
+
+        template <typename U>
+        TrackingAllocator(const TrackingAllocator<U, TAG>&) noexcept {}
+
+        [[nodiscard]] T* allocate(const std::size_t t_n)
+        {
+            return static_cast<T*>(Memory::Allocate(TAG, t_n * sizeof(T)));
+        }
+
+        void deallocate(T* t_ptr, const std::size_t t_n) noexcept
+        {
+            Memory::Deallocate(TAG, t_ptr, t_n * sizeof(T));
+        }
+
+        template <typename U>
+        bool operator==(const TrackingAllocator<U, TAG>&) const noexcept
+        {
+            return true;
+        }
+
+        template <typename U>
+        bool operator!=(const TrackingAllocator<U, TAG>&) const noexcept
+        {
+            return false;
+        }
+    };
+
+    template <typename T, Tag TAG>
+    using TrackedVector = std::vector<T, TrackingAllocator<T, TAG>>;
+
+    /**
+     * @brief Counts the objects of a class created with new under a Tag.
+     *        The sized delete gets the size of the dynamic type, so derived classes are counted correctly.
+     */
+    template <Tag TAG>
+    class Tracked
+    {
+    public:
+        static void* operator new(const std::size_t t_size)
+        {
+            return Memory::Allocate(TAG, t_size);
+        }
+
+        static void operator delete(void* t_ptr, const std::size_t t_size) noexcept
+        {
+            Memory::Deallocate(TAG, t_ptr, t_size);
+        }
+    };
+
+    /**
+     * @brief Fixed-size slots for the objects of one class, counted under a Tag.
+     *        Reserve() allocates the slots of a bulk construction as one block; the threads of a
+     *        ParallelFor take their slots from it without a lock. Freed slots are reused; the blocks
+     *        are kept until Clear(), so the next bulk construction does not allocate again.
+     */
+    template <typename T, Tag TAG>
+    class Pool
+    {
+    public:
+        static Pool& Get()
+        {
+            static Pool pool;
+            return pool;
+        }
+
+        Pool(const Pool& t_other) = delete;
+        Pool(Pool&& t_other) noexcept = delete;
+        Pool& operator=(const Pool& t_other) = delete;
+        Pool& operator=(Pool&& t_other) noexcept = delete;
+
+        /**
+         * @brief Allocates a block for the next objects, minus the free slots.
+         *        Allocate() reads the block without the lock, so Reserve() must not run inside a ParallelFor().
+         * @param t_count The number of objects.
+         */
+        void Reserve(const std::size_t t_count)
+        {
+            Memory::AssertNotInParallelFor();
+
+            std::lock_guard<std::mutex> lock{ m_mutex };
+
+            // the rest of the last block is not lost
+            for (auto i{ m_next.load() }; i < m_end; ++i)
+            {
+                Push(&m_block[i]);
+            }
+
+            m_block = nullptr;
+            m_next = 0;
+            m_end = 0;
+
+            if (t_count <= m_freeCount)
+            {
+                return;
+            }
+
+            m_end = t_count - m_freeCount;
+            m_block = AllocateBlock(m_end);
+        }
+
+        /**
+         * @brief The operator new of the class.
+         * @param t_size The size of the dynamic type. A derived class without its own Pool gets a single allocation.
+         * @return void*
+         */
+        void* Allocate(const std::size_t t_size)
+        {
+            if (t_size != sizeof(T))
+            {
+                return Memory::Allocate(TAG, t_size);
+            }
+
+            ++m_live;
+
+            const auto index{ m_next.fetch_add(1) };
+            if (index < m_end)
+            {
+                return &m_block[index];
+            }
+
+            std::lock_guard<std::mutex> lock{ m_mutex };
+
+            if (m_freeSlots)
+            {
+                auto* slot{ m_freeSlots };
+                m_freeSlots = slot->next;
+                m_freeCount--;
+
+                return slot;
+            }
+
+            return AllocateBlock(1);
+        }
+
+        /**
+         * @brief The operator delete of the class.
+         * @param t_ptr The object.
+         * @param t_size The size of the dynamic type.
+         */
+        void Deallocate(void* t_ptr, const std::size_t t_size) noexcept
+        {
+            if (t_size != sizeof(T))
+            {
+                Memory::Deallocate(TAG, t_ptr, t_size);
+                return;
+            }
+
+            std::lock_guard<std::mutex> lock{ m_mutex };
+
+            // the slot is reused; the blocks are kept until Clear()
+            Push(static_cast<Slot*>(t_ptr));
+            --m_live;
+        }
+
+        /**
+         * @brief Frees all blocks if no object of the Pool is alive.
+         *        While objects are alive, e.g. the Tiles of a second Map, the blocks are kept.
+         */
+        void Clear() noexcept
+        {
+            std::lock_guard<std::mutex> lock{ m_mutex };
+
+            if (m_live > 0)
+            {
+                return;
+            }
+
+            for (const auto& block : m_blocks)
+            {
+                Memory::Deallocate(TAG, block.slots, block.count * sizeof(Slot));
+            }
+
+            m_blocks.clear();
+
+            m_block = nullptr;
+            m_next = 0;
+            m_end = 0;
+
+            m_freeSlots = nullptr;
+            m_freeCount = 0;
+        }
+
+    protected:
+
+    private:
+        union Slot
+        {
+            Slot* next;
+            alignas(T) unsigned char storage[sizeof(T)];
+        };
+
+        struct Block
+        {
+            Slot* slots{ nullptr };
+            std::size_t count{ 0 };
+        };
+
+        std::mutex m_mutex;
+
+        std::vector<Block> m_blocks;
+
+        /**
+         * @brief The reserved block. The slots [m_next, m_end) are still free.
+         */
+        Slot* m_block{ nullptr };
+        std::atomic<std::size_t> m_next{ 0 };
+        std::size_t m_end{ 0 };
+
+        Slot* m_freeSlots{ nullptr };
+        std::size_t m_freeCount{ 0 };
+
+        std::atomic<std::size_t> m_live{ 0 };
+
+        Pool() = default;
+
+        Slot* AllocateBlock(const std::size_t t_count)
+        {
+            auto* slots{ static_cast<Slot*>(Memory::Allocate(TAG, t_count * sizeof(Slot))) };
+            m_blocks.push_back({ slots, t_count });
+
+            return slots;
+        }
+
+        void Push(Slot* t_slot) noexcept
+        {
+            t_slot->next = m_freeSlots;
+            m_freeSlots = t_slot;
+            m_freeCount++;
+        }
+    };
+}
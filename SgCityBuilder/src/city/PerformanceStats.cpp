@@ -0,0 +1,190 @@
+// This file is part of the SgCityBuilder package.
+// 
+// Filename: PerformanceStats.cpp
+// Author:   stwe
+// 
+// License:  MIT
+// 
+// 2020 (c) stwe <https://github.com/stwe/SgCityBuilder>
+
+#include <algorithm>
+#include <numeric>
+#include "PerformanceStats.h"
+#include "Memory.h"
+
+//-------------------------------------------------
+// History
+//-------------------------------------------------
+
+void sg::city::stats::History::Push(const float t_value)
+{
+    m_values[m_next] = t_value;
+    m_next = (m_next + 1) % HISTORY_SIZE;
+    m_count = std::min(m_count + 1, HISTORY_SIZE);
+}
+
+const sg::city::stats::History::ValueContainer& sg::city::stats::History::GetValues() const noexcept
+{
+    return m_values;
+}
+
+int sg::city::stats::History::GetOffset() const
+{
+    return m_next;
+}
+
+float sg::city::stats::History::GetLast() const
+{
+    return m_values[(m_next + HISTORY_SIZE - 1) % HISTORY_SIZE];
+}
+
+float sg::city::stats::History::GetAverage() const
+{
+    // the unused values are 0
+    return m_count > 0 ? std::accumulate(m_values.begin(), m_values.end(), 0.0f) / static_cast<float>(m_count) : 0.0f;
+}
+
+float sg::city::stats::History::GetMax() const
+{
+    return *std::max_element(m_values.begin(), m_values.end());
+}
+
+//-------------------------------------------------
+// Getter
+//-------------------------------------------------
+
+const char* sg::city::stats::PerformanceStats::GetName(const Subsystem t_subsystem)
+{
+    switch (t_subsystem)
+    {
+    case Subsystem::EVENTS: return "Events";
+    case Subsystem::DEMAND: return "Demand";
+    case Subsystem::POPULATION: return "Population";
+    case Subsystem::UPLOADS: return "Uploads";
+    case Subsystem::VEHICLES: return "Vehicles";
+    case Subsystem::MAP_RENDER: return "Map render";
+    case Subsystem::ROAD_NETWORK_RENDER: return "Road network render";
+    case Subsystem::BUILDINGS_RENDER: return "Buildings render";
+    case Subsystem::CARS_RENDER: return "Cars render";
+    case Subsystem::TREES_RENDER: return "Trees render";
+    case Subsystem::SKYBOX_RENDER: return "Skybox render";
+    case Subsystem::IMGUI: return "ImGui";
+    default: return "Unknown";
+    }
+}
+
+bool sg::city::stats::PerformanceStats::CanBeDisabled(const Subsystem t_subsystem)
+{
+    return t_subsystem != Subsystem::EVENTS && t_subsystem != Subsystem::UPLOADS && t_subsystem != Subsystem::IMGUI;
+}
+
+bool sg::city::stats::PerformanceStats::IsEnabled(const Subsystem t_subsystem) const
+{
+    return m_enabled[static_cast<uint32_t>(t_subsystem)];
+}
+
+const sg::city::stats::History& sg::city::stats::PerformanceStats::GetHistory(const Subsystem t_subsystem) const
+{
+    return m_histories[static_cast<uint32_t>(t_subsystem)];
+}
+
+const sg::city::stats::History& sg::city::stats::PerformanceStats::GetFrameHistory() const noexcept
+{
+    return m_frameHistory;
+}
+
+const sg::city::stats::History& sg::city::stats::PerformanceStats::GetTickHistory() const noexcept
+{
+    return m_tickHistory;
+}
+
+const sg::city::stats::History& sg::city::stats::PerformanceStats::GetUploadBytesHistory() const noexcept
+{
+    return m_uploadBytesHistory;
+}
+
+const sg::city::stats::History& sg::city::stats::PerformanceStats::GetAllocationsHistory() const noexcept
+{
+    return m_allocationsHistory;
+}
+
+uint64_t sg::city::stats::PerformanceStats::GetTagAllocations(const memory::Tag t_tag) const
+{
+    return m_tagAllocations[static_cast<uint32_t>(t_tag)];
+}
+
+uint32_t sg::city::stats::PerformanceStats::GetCars() const
+{
+    return m_cars;
+}
+
+uint32_t sg::city::stats::PerformanceStats::GetBlockedCars() const
+{
+    return m_blockedCars;
+}
+
+//-------------------------------------------------
+// Setter
+//-------------------------------------------------
+
+void sg::city::stats::PerformanceStats::SetEnabled(const Subsystem t_subsystem, const bool t_enabled)
+{
+    m_enabled[static_cast<uint32_t>(t_subsystem)] = t_enabled || !CanBeDisabled(t_subsystem);
+}
+
+//-------------------------------------------------
+// Record
+//-------------------------------------------------
+
+void sg::city::stats::PerformanceStats::AddTime(const Subsystem t_subsystem, const float t_ms)
+{
+    m_frameTimes[static_cast<uint32_t>(t_subsystem)] += t_ms;
+}
+
+void sg::city::stats::PerformanceStats::AddUploadBytes(const uint32_t t_bytes)
+{
+    m_frameUploadBytes += t_bytes;
+}
+
+void sg::city::stats::PerformanceStats::SetCars(const uint32_t t_cars, const uint32_t t_blockedCars)
+{
+    m_cars = t_cars;
+    m_blockedCars = t_blockedCars;
+}
+
+void sg::city::stats::PerformanceStats::NextFrame()
+{
+    const auto now{ std::chrono::steady_clock::now() };
+    const std::chrono::duration<float, std::milli> frameTime{ now - m_frameStart };
+
+    // the simulation part of the frame
+    auto tickMs{ 0.0f };
+    for (auto subsystem : { Subsystem::EVENTS, Subsystem::DEMAND, Subsystem::POPULATION, Subsystem::VEHICLES })
+    {
+        tickMs += m_frameTimes[static_cast<uint32_t>(subsystem)];
+    }
+
+    for (auto i{ 0u }; i < NR_OF_SUBSYSTEMS; ++i)
+    {
+        m_histories[i].Push(m_frameTimes[i]);
+    }
+
+    const auto allocations{ memory::Memory::GetAllocations() };
+
+    for (auto i{ 0u }; i < memory::Memory::NR_OF_TAGS; ++i)
+    {
+        const auto tagAllocations{ memory::Memory::GetTagStats(static_cast<memory::Tag>(i)).allocations };
+        m_tagAllocations[i] = tagAllocations - m_frameStartTagAllocations[i];
+        m_frameStartTagAllocations[i] = tagAllocations;
+    }
+
+    m_frameHistory.Push(frameTime.count());
+    m_tickHistory.Push(tickMs);
+    m_uploadBytesHistory.Push(static_cast<float>(m_frameUploadBytes));
+    m_allocationsHistory.Push(static_cast<float>(allocations - m_frameStartAllocations));
+
+    m_frameTimes.fill(0.0f);
+    m_frameUploadBytes = 0;
+    m_frameStartAllocations = allocations;
+    m_frameStart = now;
+}
@@ -0,0 +1,200 @@
+// This file is part of the SgCityBuilder package.
+// 
+// Filename: PerformanceStats.h
+// Author:   stwe
+// 
+// License:  MIT
+// 
+// 2020 (c) stwe <https://github.com/stwe/SgCityBuilder>
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include "Memory.h"
+
+namespace sg::city::stats
+{
+    /**
+     * @brief The measured parts of a frame. Each one can be switched off for an A/B comparison.
+     */
+    enum class Subsystem : uint32_t
+    {
+        EVENTS,
+        DEMAND,
+        POPULATION,
+        UPLOADS,
+        VEHICLES,
+        MAP_RENDER,
+        ROAD_NETWORK_RENDER,
+        BUILDINGS_RENDER,
+        CARS_RENDER,
+        TREES_RENDER,
+        SKYBOX_RENDER,
+        IMGUI,
+        COUNT
+    };
+
+    /**
+     * @brief The last HISTORY_SIZE values of a measurement. The oldest value is overwritten.
+     */
+    class History
+    {
+    public:
+        static constexpr auto HISTORY_SIZE{ 240 };
+
+        using ValueContainer = std::array<float, HISTORY_SIZE>;
+
+        void Push(float t_value);
+
+        [[nodiscard]] const ValueContainer& GetValues() const noexcept;
+
+        /**
+         * @brief The index of the oldest value; used as values_offset of ImGui::PlotLines().
+         * @return int
+         */
+        [[nodiscard]] int GetOffset() const;
+
+        [[nodiscard]] float GetLast() const;
+        [[nodiscard]] float GetAverage() const;
+        [[nodiscard]] float GetMax() const;
+
+    protected:
+
+    private:
+        ValueContainer m_values{};
+        int m_next{ 0 };
+        int m_count{ 0 };
+    };
+
+    /**
+     * @brief The per-frame statistics of the performance overlay.
+     *        The times of a Subsystem are summed up within a frame.
+     */
+    class PerformanceStats
+    {
+    public:
+        //-------------------------------------------------
+        // Const
+        //-------------------------------------------------
+
+        static constexpr auto NR_OF_SUBSYSTEMS{ static_cast<uint32_t>(Subsystem::COUNT) };
+        static constexpr auto FRAME_BUDGET_MS{ 1000.0f / 60.0f };
+
+        //-------------------------------------------------
+        // Getter
+        //-------------------------------------------------
+
+        [[nodiscard]] static const char* GetName(Subsystem t_subsystem);
+
+        /**
+         * @brief The event dispatch, the uploads and the ImGui menu cannot be switched off.
+         * @param t_subsystem The Subsystem.
+         * @return bool
+         */
+        [[nodiscard]] static bool CanBeDisabled(Subsystem t_subsystem);
+
+        [[nodiscard]] bool IsEnabled(Subsystem t_subsystem) const;
+        [[nodiscard]] const History& GetHistory(Subsystem t_subsystem) const;
+
+        [[nodiscard]] const History& GetFrameHistory() const noexcept;
+        [[nodiscard]] const History& GetTickHistory() const noexcept;
+        [[nodiscard]] const History& GetUploadBytesHistory() const noexcept;
+        [[nodiscard]] const History& GetAllocationsHistory() const noexcept;
+
+        /**
+         * @brief The number of allocations of a memory Tag in the last frame.
+         * @param t_tag The memory Tag.
+         * @return uint64_t
+         */
+        [[nodiscard]] uint64_t GetTagAllocations(memory::Tag t_tag) const;
+
+        [[nodiscard]] uint32_t GetCars() const;
+        [[nodiscard]] uint32_t GetBlockedCars() const;
+
+        //-------------------------------------------------
+        // Setter
+        //-------------------------------------------------
+
+        void SetEnabled(Subsystem t_subsystem, bool t_enabled);
+
+        //-------------------------------------------------
+        // Record
+        //-------------------------------------------------
+
+        void AddTime(Subsystem t_subsystem, float t_ms);
+        void AddUploadBytes(uint32_t t_bytes);
+        void SetCars(uint32_t t_cars, uint32_t t_blockedCars);
+
+        /**
+         * @brief Closes the current frame and starts the next one. Should be called once per frame.
+         */
+        void NextFrame();
+
+    protected:
+
+    private:
+        std::array<bool, NR_OF_SUBSYSTEMS> m_enabled{ FillEnabled() };
+        std::array<float, NR_OF_SUBSYSTEMS> m_frameTimes{};
+        std::array<History, NR_OF_SUBSYSTEMS> m_histories;
+
+        History m_frameHistory;
+        History m_tickHistory;
+        History m_uploadBytesHistory;
+        History m_allocationsHistory;
+
+        std::chrono::steady_clock::time_point m_frameStart{ std::chrono::steady_clock::now() };
+        uint64_t m_frameStartAllocations{ 0 };
+
+        std::array<uint64_t, memory::Memory::NR_OF_TAGS> m_frameStartTagAllocations{};
+        std::array<uint64_t, memory::Memory::NR_OF_TAGS> m_tagAllocations{};
+        uint32_t m_frameUploadBytes{ 0 };
+
+        uint32_t m_cars{ 0 };
+        uint32_t m_blockedCars{ 0 };
+
+        static constexpr std::array<bool, NR_OF_SUBSYSTEMS> FillEnabled()
+        {
+            std::array<bool, NR_OF_SUBSYSTEMS> enabled{};
+            for (auto& value : enabled)
+            {
+                value = true;
+            }
+
+            return enabled;
+        }
+    };
+
+    /**
+     * @brief Adds the time of a scope to a Subsystem.
+     */
+    class ScopedTime
+    {
+    public:
+        ScopedTime(PerformanceStats& t_stats, const Subsystem t_subsystem)
+            : m_stats{ t_stats }
+            , m_subsystem{ t_subsystem }
+            , m_start{ std::chrono::steady_clock::now() }
+        {
+        }
+
+        ScopedTime(const ScopedTime& t_other) = delete;
+        ScopedTime(ScopedTime&& t_other) noexcept = delete;
+        ScopedTime& operator=(const ScopedTime& t_other) = delete;
+        ScopedTime& operator=(ScopedTime&& t_other) noexcept = delete;
+
+        ~ScopedTime() noexcept
+        {
+            const std::chrono::duration<float, std::milli> duration{ std::chrono::steady_clock::now() - m_start };
+            m_stats.AddTime(m_subsystem, duration.count());
+        }
+
+    protected:
+
+    private:
+        PerformanceStats& m_stats;
+        Subsystem m_subsystem;
+        std::chrono::steady_clock::time_point m_start;
+    };
+}
@@ -0,0 +1,264 @@
+// This file is part of the SgCityBuilder package.
+// 
+// Filename: Profiler.cpp
+// Author:   stwe
+// 
+// License:  MIT
+// 
+// 2020 (c) stwe <https://github.com/stwe/SgCityBuilder>
+
+#include <mutex>
+#include <chrono>
+#include <memory>
+#include <cstdio>
+#include <fstream>
+#include <unordered_map>
+#include <Core.h>
+#include <Log.h>
+#include "Profiler.h"
+
+namespace
+{
+    using ThreadBufferUniquePtr = std::unique_ptr<sg::city::profiler::ThreadBuffer>;
+
+    /**
+     * @brief All buffers ever created. A buffer outlives its thread, so that its events can be exported.
+     */
+    std::mutex g_buffersMutex;
+    std::vector<ThreadBufferUniquePtr> g_buffers;
+
+    std::chrono::steady_clock::time_point g_sessionStart{ std::chrono::steady_clock::now() };
+
+    thread_local sg::city::profiler::ThreadBuffer* g_threadBuffer{ nullptr };
+
+    /**
+     * @brief Calls the function with the thread id and the events of each thread.
+     */
+    template <typename TFunction>
+    void ForEachThread(TFunction t_function)
+    {
+        std::lock_guard<std::mutex> lock{ g_buffersMutex };
+
+        sg::city::profiler::ThreadBuffer::EventContainer events;
+        for (const auto& buffer : g_buffers)
+        {
+            buffer->CopyEvents(events);
+            t_function(buffer->threadId, events);
+        }
+    }
+
+    void WriteEscaped(std::ofstream& t_file, const char* t_name)
+    {
+        for (auto* c{ t_name }; *c; ++c)
+        {
+            if (*c == '"' || *c == '\\')
+            {
+                t_file << '\\';
+            }
+
+            t_file << *c;
+        }
+    }
+}
+
+//-------------------------------------------------
+// Session
+//-------------------------------------------------
+
+void sg::city::profiler::Profiler::Start()
+{
+    {
+        std::lock_guard<std::mutex> lock{ g_buffersMutex };
+
+        for (auto& buffer : g_buffers)
+        {
+            buffer->Clear();
+        }
+
+        g_sessionStart = std::chrono::steady_clock::now();
+    }
+
+    s_running.store(true, std::memory_order_relaxed);
+
+    SG_OGL_LOG_INFO("[Profiler::Start()] Profiling started.");
+}
+
+void sg::city::profiler::Profiler::Stop()
+{
+    s_running.store(false, std::memory_order_relaxed);
+
+    SG_OGL_LOG_INFO("[Profiler::Stop()] Profiling stopped.");
+}
+
+uint64_t sg::city::profiler::Profiler::Now()
+{
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - g_sessionStart).count());
+}
+
+sg::city::profiler::ThreadBuffer& sg::city::profiler::Profiler::GetThreadBuffer()
+{
+    if (!g_threadBuffer)
+    {
+        std::lock_guard<std::mutex> lock{ g_buffersMutex };
+
+        g_buffers.push_back(std::make_unique<ThreadBuffer>(static_cast<uint32_t>(g_buffers.size())));
+        g_threadBuffer = g_buffers.back().get();
+    }
+
+    return *g_threadBuffer;
+}
+
+//-------------------------------------------------
+// Record
+//-------------------------------------------------
+
+void sg::city::profiler::Profiler::Counter(const char* t_name, const double t_value)
+{
+    if (IsRunning())
+    {
+        GetThreadBuffer().Push({ t_name, Now(), 0, t_value, 0, EventType::COUNTER });
+    }
+}
+
+void sg::city::profiler::Profiler::Marker(const char* t_name)
+{
+    if (IsRunning())
+    {
+        GetThreadBuffer().Push({ t_name, Now(), 0, 0.0, 0, EventType::MARKER });
+    }
+}
+
+//-------------------------------------------------
+// Export
+//-------------------------------------------------
+
+void sg::city::profiler::Profiler::WriteChromeTrace(const std::string& t_fileName)
+{
+    std::ofstream file{ t_fileName };
+    if (!file)
+    {
+        SG_OGL_LOG_WARN("[Profiler::WriteChromeTrace()] Unable to open {}.", t_fileName);
+        return;
+    }
+
+    file << "{\"traceEvents\":[\n";
+
+    auto first{ true };
+    char numbers[128];
+
+    ForEachThread([&](const uint32_t t_threadId, const ThreadBuffer::EventContainer& t_events)
+    {
+        for (const auto& event : t_events)
+        {
+            if (!first)
+            {
+                file << ",\n";
+            }
+            first = false;
+
+            file << "{\"name\":\"";
+            WriteEscaped(file, event.name);
+            file << "\",\"pid\":1,";
+
+            // the timestamps are in microseconds
+            const auto ts{ static_cast<double>(event.start) / 1000.0 };
+
+            switch (event.type)
+            {
+            case EventType::ZONE:
+                std::snprintf(numbers, sizeof(numbers), "\"tid\":%u,\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f}",
+                    t_threadId, ts, static_cast<double>(event.duration) / 1000.0);
+                break;
+            case EventType::COUNTER:
+                std::snprintf(numbers, sizeof(numbers), "\"tid\":%u,\"ph\":\"C\",\"ts\":%.3f,\"args\":{\"value\":%g}}",
+                    t_threadId, ts, event.value);
+                break;
+            case EventType::MARKER:
+                std::snprintf(numbers, sizeof(numbers), "\"tid\":%u,\"ph\":\"i\",\"s\":\"t\",\"ts\":%.3f}",
+                    t_threadId, ts);
+                break;
+            }
+
+            file << numbers;
+        }
+    });
+
+    file << "\n]}\n";
+
+    SG_OGL_LOG_INFO("[Profiler::WriteChromeTrace()] Trace written to {}.", t_fileName);
+}
+
+void sg::city::profiler::Profiler::WriteBinary(const std::string& t_fileName)
+{
+    static constexpr uint16_t VERSION{ 1 };
+
+    std::ofstream file{ t_fileName, std::ios::out | std::ios::binary };
+    if (!file)
+    {
+        SG_OGL_LOG_WARN("[Profiler::WriteBinary()] Unable to open {}.", t_fileName);
+        return;
+    }
+
+    const auto write = [&file](const auto& t_value)
+    {
+        file.write(reinterpret_cast<const char*>(&t_value), sizeof(t_value));
+    };
+
+    // collect the events first to build the name table; the names are literals, so the pointers are unique keys
+    std::vector<std::pair<uint32_t, ThreadBuffer::EventContainer>> threads;
+    std::unordered_map<const char*, uint16_t> nameIndices;
+    std::vector<const char*> names;
+
+    ForEachThread([&](const uint32_t t_threadId, const ThreadBuffer::EventContainer& t_events)
+    {
+        for (const auto& event : t_events)
+        {
+            if (nameIndices.emplace(event.name, static_cast<uint16_t>(names.size())).second)
+            {
+                names.push_back(event.name);
+            }
+        }
+
+        threads.emplace_back(t_threadId, t_events);
+    });
+
+    file.write("SGPROF", 6);
+    write(VERSION);
+
+    // name table: uint32 count, then uint16 length + chars
+    write(static_cast<uint32_t>(names.size()));
+    for (const auto* name : names)
+    {
+        const auto length{ static_cast<uint16_t>(std::char_traits<char>::length(name)) };
+        write(length);
+        file.write(name, length);
+    }
+
+    // threads: uint32 count, then uint32 thread id + uint32 event count + events
+    write(static_cast<uint32_t>(threads.size()));
+    for (const auto& [threadId, events] : threads)
+    {
+        write(threadId);
+        write(static_cast<uint32_t>(events.size()));
+
+        // 21 bytes per event: type, name index, depth, start and the duration or the value
+        for (const auto& event : events)
+        {
+            write(static_cast<uint8_t>(event.type));
+            write(nameIndices[event.name]);
+            write(event.depth);
+            write(event.start);
+
+            if (event.type == EventType::COUNTER)
+            {
+                write(event.value);
+            }
+            else
+            {
+                write(event.duration);
+            }
+        }
+    }
+
+    SG_OGL_LOG_INFO("[Profiler::WriteBinary()] Profile written to {}.", t_fileName);
+}
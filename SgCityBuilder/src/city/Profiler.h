@@ -0,0 +1,241 @@
+// This file is part of the SgCityBuilder package.
+// 
+// Filename: Profiler.h
+// Author:   stwe
+// 
+// License:  MIT
+// 
+// 2020 (c) stwe <https://github.com/stwe/SgCityBuilder>
+
+#pragma once
+
+#include <atomic>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include "Build.h"
+
+namespace sg::city::profiler
+{
+    enum class EventType : uint8_t
+    {
+        ZONE,
+        COUNTER,
+        MARKER
+    };
+
+    struct Event
+    {
+        const char* name{ nullptr }; // must be a string literal
+        uint64_t start{ 0 };         // ns since Profiler::Start()
+        uint64_t duration{ 0 };      // ns; zones only
+        double value{ 0.0 };         // counters only
+        uint16_t depth{ 0 };         // the nesting level of a zone
+        EventType type{ EventType::ZONE };
+    };
+
+    /**
+     * @brief The events of one thread. Only the owning thread writes, so no lock is needed.
+     *        If the buffer is full, the oldest events are overwritten.
+     */
+    class ThreadBuffer
+    {
+    public:
+        using EventContainer = std::vector<Event>;
+
+        //-------------------------------------------------
+        // Const
+        //-------------------------------------------------
+
+        static constexpr uint64_t CAPACITY{ 1u << 16 };
+
+        static_assert((CAPACITY & (CAPACITY - 1)) == 0, "The capacity must be a power of two.");
+
+        //-------------------------------------------------
+        // Public member
+        //-------------------------------------------------
+
+        const uint32_t threadId;
+
+        /**
+         * @brief The nesting level of the next zone.
+         */
+        uint16_t depth{ 0 };
+
+        //-------------------------------------------------
+        // Ctors. / Dtor.
+        //-------------------------------------------------
+
+        ThreadBuffer() = delete;
+
+        explicit ThreadBuffer(const uint32_t t_threadId)
+            : threadId{ t_threadId }
+            , m_events(CAPACITY)
+        {
+        }
+
+        ThreadBuffer(const ThreadBuffer& t_other) = delete;
+        ThreadBuffer(ThreadBuffer&& t_other) noexcept = delete;
+        ThreadBuffer& operator=(const ThreadBuffer& t_other) = delete;
+        ThreadBuffer& operator=(ThreadBuffer&& t_other) noexcept = delete;
+
+        ~ThreadBuffer() noexcept = default;
+
+        //-------------------------------------------------
+        // Write
+        //-------------------------------------------------
+
+        void Push(const Event& t_event)
+        {
+            const auto head{ m_head.load(std::memory_order_relaxed) };
+            m_events[head & (CAPACITY - 1)] = t_event;
+            m_head.store(head + 1, std::memory_order_release);
+        }
+
+        void Clear()
+        {
+            m_head.store(0, std::memory_order_release);
+        }
+
+        //-------------------------------------------------
+        // Read
+        //-------------------------------------------------
+
+        /**
+         * @brief Copies the recorded events, the oldest first.
+         * @param t_events Receives the events.
+         */
+        void CopyEvents(EventContainer& t_events) const
+        {
+            const auto head{ m_head.load(std::memory_order_acquire) };
+            const auto count{ head < CAPACITY ? head : CAPACITY };
+
+            t_events.clear();
+            t_events.reserve(count);
+
+            for (auto i{ head - count }; i < head; ++i)
+            {
+                t_events.push_back(m_events[i & (CAPACITY - 1)]);
+            }
+        }
+
+    protected:
+
+    private:
+        EventContainer m_events;
+        std::atomic<uint64_t> m_head{ 0 };
+    };
+
+    /**
+     * @brief Records zones, counters and markers of all threads between Start() and Stop().
+     *        Start(), Stop() and the export should be called from the main thread between two frames.
+     */
+    class Profiler
+    {
+    public:
+        //-------------------------------------------------
+        // Session
+        //-------------------------------------------------
+
+        static void Start();
+        static void Stop();
+
+        [[nodiscard]] static bool IsRunning() noexcept
+        {
+            return s_running.load(std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief The current time.
+         * @return ns since Start()
+         */
+        [[nodiscard]] static uint64_t Now();
+
+        /**
+         * @brief The buffer of the calling thread. It is created with the first call.
+         * @return ThreadBuffer
+         */
+        [[nodiscard]] static ThreadBuffer& GetThreadBuffer();
+
+        //-------------------------------------------------
+        // Record
+        //-------------------------------------------------
+
+        static void Counter(const char* t_name, double t_value);
+        static void Marker(const char* t_name);
+
+        //-------------------------------------------------
+        // Export
+        //-------------------------------------------------
+
+        /**
+         * @brief Writes the events in the Chrome trace event format (chrome://tracing, Perfetto).
+         * @param t_fileName The Json file.
+         */
+        static void WriteChromeTrace(const std::string& t_fileName);
+
+        /**
+         * @brief Writes the events in a compact binary format.
+         *        Header "SGPROF", uint16 version, the name table and the events of each thread.
+         * @param t_fileName The binary file.
+         */
+        static void WriteBinary(const std::string& t_fileName);
+
+    protected:
+
+    private:
+        inline static std::atomic<bool> s_running{ false };
+    };
+
+    /**
+     * @brief Measures a scope. Costs one atomic load if the Profiler is not running.
+     */
+    class Zone
+    {
+    public:
+        explicit Zone(const char* t_name)
+            : m_name{ t_name }
+        {
+            if (Profiler::IsRunning())
+            {
+                m_buffer = &Profiler::GetThreadBuffer();
+                m_depth = m_buffer->depth++;
+                m_start = Profiler::Now();
+            }
+        }
+
+        Zone(const Zone& t_other) = delete;
+        Zone(Zone&& t_other) noexcept = delete;
+        Zone& operator=(const Zone& t_other) = delete;
+        Zone& operator=(Zone&& t_other) noexcept = delete;
+
+        ~Zone() noexcept
+        {
+            if (m_buffer)
+            {
+                m_buffer->depth--;
+                m_buffer->Push({ m_name, m_start, Profiler::Now() - m_start, 0.0, m_depth, EventType::ZONE });
+            }
+        }
+
+    protected:
+
+    private:
+        const char* m_name{ nullptr };
+        ThreadBuffer* m_buffer{ nullptr };
+        uint64_t m_start{ 0 };
+        uint16_t m_depth{ 0 };
+    };
+}
+
+#ifdef ENABLE_PROFILER
+    #define SG_CITY_PROFILE_CONCAT_IMPL(a, b) a##b
+    #define SG_CITY_PROFILE_CONCAT(a, b) SG_CITY_PROFILE_CONCAT_IMPL(a, b)
+    #define SG_CITY_PROFILE_ZONE(name) const ::sg::city::profiler::Zone SG_CITY_PROFILE_CONCAT(profileZone, __LINE__){ name }
+    #define SG_CITY_PROFILE_COUNTER(name, value) ::sg::city::profiler::Profiler::Counter(name, static_cast<double>(value))
+    #define SG_CITY_PROFILE_MARKER(name) ::sg::city::profiler::Profiler::Marker(name)
+#else
+    #define SG_CITY_PROFILE_ZONE(name)
+    #define SG_CITY_PROFILE_COUNTER(name, value)
+    #define SG_CITY_PROFILE_MARKER(name)
+#endif
@@ -0,0 +1,222 @@
+// This file is part of the SgCityBuilder package.
+// 
+// Filename: Random.h
+// Author:   stwe
+// 
+// License:  MIT
+// 
+// 2020 (c) stwe <https://github.com/stwe/SgCityBuilder>
+
+#pragma once
+
+#include <cstdint>
+
+namespace sg::city::random
+{
+    /**
+     * @brief Each subsystem draws from its own domain so that
+     *        adding draws in one place does not shift the numbers of another.
+     */
+    enum class Domain : uint32_t
+    {
+        REGION_COLORS,
+        SPAWN,
+        BUILDINGS,
+        TRAFFIC,
+        GROWTH,
+        LAYOUT
+    };
+
+    /**
+     * @brief A cheap stream of random numbers for one entity at one tick.
+     *        There is no internal state besides a key and a counter,
+     *        so creating a stream costs nothing.
+     */
+    class RandomStream
+    {
+    public:
+        //-------------------------------------------------
+        // Ctors. / Dtor.
+        //-------------------------------------------------
+
+        constexpr RandomStream() = default;
+
+        constexpr RandomStream(const uint64_t t_key, const uint64_t t_counter)
+            : m_key{ t_key }
+            , m_counter{ t_counter }
+        {
+        }
+
+        //-------------------------------------------------
+        // Getter
+        //-------------------------------------------------
+
+        /**
+         * @brief The key and the counter are the whole state of the stream, e.g. for a save game.
+         * @return uint64_t
+         */
+        [[nodiscard]] constexpr uint64_t GetKey() const noexcept
+        {
+            return m_key;
+        }
+
+        [[nodiscard]] constexpr uint64_t GetCounter() const noexcept
+        {
+            return m_counter;
+        }
+
+        //-------------------------------------------------
+        // Draw
+        //-------------------------------------------------
+
+        /**
+         * @brief Returns the next 32 bit value of the stream.
+         * @return uint32_t
+         */
+        uint32_t NextUint()
+        {
+            return Squares(m_counter++, m_key);
+        }
+
+        /**
+         * @brief Returns a value in the range [0, 1).
+         * @return float
+         */
+        float NextFloat()
+        {
+            // use the upper 24 bits - exactly representable as float
+            return static_cast<float>(NextUint() >> 8) * (1.0f / 16777216.0f);
+        }
+
+        /**
+         * @brief Returns a value in the range [t_min, t_max).
+         * @return float
+         */
+        float NextFloat(const float t_min, const float t_max)
+        {
+            return t_min + (t_max - t_min) * NextFloat();
+        }
+
+        /**
+         * @brief Returns a value in the range [t_min, t_max].
+         * @return int
+         */
+        int NextInt(const int t_min, const int t_max)
+        {
+            return t_min + static_cast<int>(NextIndex(static_cast<uint32_t>(t_max - t_min) + 1u));
+        }
+
+        /**
+         * @brief Returns a value in the range [0, t_count).
+         * @return uint32_t
+         */
+        uint32_t NextIndex(const uint32_t t_count)
+        {
+            return static_cast<uint32_t>((static_cast<uint64_t>(NextUint()) * t_count) >> 32);
+        }
+
+        //-------------------------------------------------
+        // Generator
+        //-------------------------------------------------
+
+        /**
+         * @brief Counter-based generator (Widynski, "Squares: A Fast Counter-Based RNG").
+         * @param t_counter The counter.
+         * @param t_key The key - should be odd.
+         * @return uint32_t
+         */
+        static constexpr uint32_t Squares(const uint64_t t_counter, const uint64_t t_key)
+        {
+            auto x{ t_counter * t_key };
+            const auto y{ x };
+            const auto z{ y + t_key };
+
+            x = x * x + y;
+            x = (x >> 32) | (x << 32);
+
+            x = x * x + z;
+            x = (x >> 32) | (x << 32);
+
+            x = x * x + y;
+            x = (x >> 32) | (x << 32);
+
+            return static_cast<uint32_t>((x * x + z) >> 32);
+        }
+
+    protected:
+
+    private:
+        uint64_t m_key{ 1 };
+        uint64_t m_counter{ 0 };
+    };
+
+    /**
+     * @brief The City-wide random service.
+     *        The same seed, entity and tick always give the same numbers,
+     *        no matter in which order or on which thread they are requested.
+     */
+    class Random
+    {
+    public:
+        //-------------------------------------------------
+        // Const
+        //-------------------------------------------------
+
+        static constexpr uint64_t DEFAULT_SEED{ 0x2020c17b01dULL };
+
+        /**
+         * @brief The lower bits of the counter are reserved for draws within one tick.
+         */
+        static constexpr auto DRAW_BITS{ 24 };
+
+        //-------------------------------------------------
+        // Ctors. / Dtor.
+        //-------------------------------------------------
+
+        constexpr explicit Random(const uint64_t t_seed = DEFAULT_SEED)
+            : m_seed{ t_seed }
+        {
+        }
+
+        //-------------------------------------------------
+        // Getter
+        //-------------------------------------------------
+
+        [[nodiscard]] constexpr uint64_t GetSeed() const noexcept
+        {
+            return m_seed;
+        }
+
+        /**
+         * @brief Returns the stream of an entity at a given tick.
+         * @param t_domain The subsystem that draws the numbers.
+         * @param t_entity E.g. a Tile index or an Automata Id.
+         * @param t_tick The simulation tick.
+         * @return RandomStream
+         */
+        [[nodiscard]] constexpr RandomStream GetStream(const Domain t_domain, const uint64_t t_entity, const uint64_t t_tick) const
+        {
+            const auto key{ SplitMix(m_seed ^ SplitMix(static_cast<uint64_t>(t_domain) + 1) ^ SplitMix(t_entity * 0x9e3779b97f4a7c15ULL)) | 1ULL };
+
+            return RandomStream(key, t_tick << DRAW_BITS);
+        }
+
+        //-------------------------------------------------
+        // Helper
+        //-------------------------------------------------
+
+        static constexpr uint64_t SplitMix(uint64_t t_x)
+        {
+            t_x += 0x9e3779b97f4a7c15ULL;
+            t_x = (t_x ^ (t_x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+            t_x = (t_x ^ (t_x >> 27)) * 0x94d049bb133111ebULL;
+
+            return t_x ^ (t_x >> 31);
+        }
+
+    protected:
+
+    private:
+        uint64_t m_seed{ DEFAULT_SEED };
+    };
+}
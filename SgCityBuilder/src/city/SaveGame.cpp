@@ -0,0 +1,482 @@
+// This file is part of the SgCityBuilder package.
+// 
+// Filename: SaveGame.cpp
+// Author:   stwe
+// 
+// License:  MIT
+// 
+// 2020 (c) stwe <https://github.com/stwe/SgCityBuilder>
+
+#include <fstream>
+#include <iterator>
+#include <algorithm>
+#include <stdexcept>
+#include <Log.h>
+#include "SaveGame.h"
+#include "Profiler.h"
+#include "Timer.h"
+#include "map/BuildingGenerator.h"
+#include "map/tile/RoadTile.h"
+
+namespace
+{
+    using sg::city::save::SaveGame;
+
+    struct ChunkHeader
+    {
+        uint32_t id{ 0 };
+        uint32_t version{ 0 };
+        uint64_t size{ 0 };
+    };
+
+    constexpr uint32_t KNOWN_CHUNKS[]
+    {
+        SaveGame::META, SaveGame::TILE, SaveGame::PLNT, SaveGame::REGN,
+        SaveGame::ROAD, SaveGame::SIGN, SaveGame::BLDG, SaveGame::CARS
+    };
+
+    [[noreturn]] void Fail(const std::string& t_message)
+    {
+        throw std::runtime_error("[SaveGame] " + t_message);
+    }
+
+    std::string ChunkIdToString(const uint32_t t_id)
+    {
+        std::string id(4, ' ');
+        for (auto i{ 0 }; i < 4; ++i)
+        {
+            id[i] = static_cast<char>((t_id >> (i * 8)) & 0xff);
+        }
+
+        return id;
+    }
+
+    //-------------------------------------------------
+    // Write
+    //-------------------------------------------------
+
+    template <typename T>
+    void WriteValue(std::ostream& t_out, const T& t_value)
+    {
+        t_out.write(reinterpret_cast<const char*>(&t_value), sizeof(T));
+    }
+
+    template <typename T>
+    void WriteArray(std::ostream& t_out, const std::vector<T>& t_values)
+    {
+        if (!t_values.empty())
+        {
+            t_out.write(reinterpret_cast<const char*>(t_values.data()), static_cast<std::streamsize>(t_values.size() * sizeof(T)));
+        }
+    }
+
+    void WriteChunkHeader(std::ostream& t_out, const uint32_t t_id, const uint64_t t_size)
+    {
+        WriteValue(t_out, t_id);
+        WriteValue(t_out, SaveGame::CHUNK_VERSION);
+        WriteValue(t_out, t_size);
+    }
+
+    /**
+     * @brief A chunk that holds only an array of records.
+     */
+    template <typename T>
+    void WriteRecordChunk(std::ostream& t_out, const uint32_t t_id, const std::vector<T>& t_records)
+    {
+        WriteChunkHeader(t_out, t_id, t_records.size() * sizeof(T));
+        WriteArray(t_out, t_records);
+    }
+
+    //-------------------------------------------------
+    // Read
+    //-------------------------------------------------
+
+    template <typename T>
+    T ReadValue(std::istream& t_in)
+    {
+        T value{};
+        t_in.read(reinterpret_cast<char*>(&value), sizeof(T));
+
+        return value;
+    }
+
+    template <typename T>
+    void ReadArray(std::istream& t_in, std::vector<T>& t_values, const uint64_t t_count)
+    {
+        t_values.resize(static_cast<size_t>(t_count));
+
+        if (!t_values.empty())
+        {
+            t_in.read(reinterpret_cast<char*>(t_values.data()), static_cast<std::streamsize>(t_values.size() * sizeof(T)));
+        }
+    }
+
+    template <typename T>
+    void ReadRecordChunk(std::istream& t_in, const ChunkHeader& t_header, std::vector<T>& t_records)
+    {
+        if (t_header.size % sizeof(T) != 0)
+        {
+            Fail("The chunk " + ChunkIdToString(t_header.id) + " has an invalid size.");
+        }
+
+        ReadArray(t_in, t_records, t_header.size / sizeof(T));
+    }
+
+    /**
+     * @brief Reads the header of the next chunk.
+     * @return False at the end of the file.
+     */
+    bool ReadChunkHeader(std::istream& t_in, ChunkHeader& t_header)
+    {
+        t_in.read(reinterpret_cast<char*>(&t_header.id), sizeof(t_header.id));
+        if (t_in.gcount() == 0 && t_in.eof())
+        {
+            return false;
+        }
+
+        t_header.version = ReadValue<uint32_t>(t_in);
+        t_header.size = ReadValue<uint64_t>(t_in);
+
+        if (!t_in)
+        {
+            Fail("Unexpected end of file in a chunk header.");
+        }
+
+        return true;
+    }
+
+    void ReadMeta(std::istream& t_in, const ChunkHeader& t_header, sg::city::save::SaveData& t_saveData)
+    {
+        if (t_header.size != 3 * sizeof(uint64_t))
+        {
+            Fail("The chunk META has an invalid size.");
+        }
+
+        t_saveData.seed = ReadValue<uint64_t>(t_in);
+        t_saveData.tick = ReadValue<uint64_t>(t_in);
+        t_saveData.nextAutomataId = ReadValue<uint64_t>(t_in);
+    }
+
+    void ReadTiles(std::istream& t_in, const ChunkHeader& t_header, sg::city::save::SaveData& t_saveData)
+    {
+        const auto mapSize{ t_header.size >= sizeof(int32_t) ? ReadValue<int32_t>(t_in) : 0 };
+        if (mapSize <= 0 || mapSize > SaveGame::MAX_MAP_SIZE)
+        {
+            Fail("Invalid Map size.");
+        }
+
+        const auto nrOfAllTiles{ static_cast<uint64_t>(mapSize) * static_cast<uint64_t>(mapSize) };
+        if (t_header.size != sizeof(int32_t) + nrOfAllTiles)
+        {
+            Fail("The chunk TILE has an invalid size.");
+        }
+
+        t_saveData.mapSize = mapSize;
+        ReadArray(t_in, t_saveData.tileTypes, nrOfAllTiles);
+    }
+
+    void ReadRegions(std::istream& t_in, const ChunkHeader& t_header, sg::city::save::SaveData& t_saveData)
+    {
+        if (t_header.size < sizeof(int32_t) || (t_header.size - sizeof(int32_t)) % sizeof(int32_t) != 0)
+        {
+            Fail("The chunk REGN has an invalid size.");
+        }
+
+        t_saveData.maxRegionId = ReadValue<int32_t>(t_in);
+        ReadArray(t_in, t_saveData.regions, (t_header.size - sizeof(int32_t)) / sizeof(int32_t));
+    }
+
+    //-------------------------------------------------
+    // Check
+    //-------------------------------------------------
+
+    bool IsRoadType(const uint8_t t_roadType)
+    {
+        switch (static_cast<sg::city::map::tile::RoadType>(t_roadType))
+        {
+        case sg::city::map::tile::RoadType::ROAD_V:
+        case sg::city::map::tile::RoadType::ROAD_H:
+        case sg::city::map::tile::RoadType::ROAD_C1:
+        case sg::city::map::tile::RoadType::ROAD_T1:
+        case sg::city::map::tile::RoadType::ROAD_C2:
+        case sg::city::map::tile::RoadType::ROAD_T2:
+        case sg::city::map::tile::RoadType::ROAD_X:
+        case sg::city::map::tile::RoadType::ROAD_T3:
+        case sg::city::map::tile::RoadType::ROAD_C3:
+        case sg::city::map::tile::RoadType::ROAD_T4:
+        case sg::city::map::tile::RoadType::ROAD_C4:
+            return true;
+        default:
+            return false;
+        }
+    }
+}
+
+//-------------------------------------------------
+// Read / Write
+//-------------------------------------------------
+
+void sg::city::save::SaveGame::Write(const std::string& t_fileName, const SaveData& t_saveData)
+{
+    SG_CITY_PROFILE_ZONE("SaveGame::Write");
+
+    std::ofstream file{ t_fileName, std::ios::out | std::ios::binary | std::ios::trunc };
+    if (!file)
+    {
+        Fail("Unable to create " + t_fileName);
+    }
+
+    file.write(MAGIC, sizeof(MAGIC));
+    WriteValue(file, VERSION);
+
+    WriteChunkHeader(file, META, 3 * sizeof(uint64_t));
+    WriteValue(file, t_saveData.seed);
+    WriteValue(file, t_saveData.tick);
+    WriteValue(file, t_saveData.nextAutomataId);
+
+    WriteChunkHeader(file, TILE, sizeof(int32_t) + t_saveData.tileTypes.size());
+    WriteValue(file, t_saveData.mapSize);
+    WriteArray(file, t_saveData.tileTypes);
+
+    WriteRecordChunk(file, PLNT, t_saveData.plantIndices);
+
+    if (!t_saveData.regions.empty())
+    {
+        WriteChunkHeader(file, REGN, sizeof(int32_t) + t_saveData.regions.size() * sizeof(int32_t));
+        WriteValue(file, t_saveData.maxRegionId);
+        WriteArray(file, t_saveData.regions);
+    }
+
+    WriteRecordChunk(file, ROAD, t_saveData.roads);
+    WriteRecordChunk(file, SIGN, t_saveData.signals);
+    WriteRecordChunk(file, BLDG, t_saveData.buildings);
+    WriteRecordChunk(file, CARS, t_saveData.vehicles);
+
+    file.close();
+    if (!file)
+    {
+        Fail("Unable to write " + t_fileName);
+    }
+
+    SG_OGL_LOG_INFO("[SaveGame::Write()] Saved {}x{} Tiles, {} buildings and {} cars to {}.",
+        t_saveData.mapSize, t_saveData.mapSize, t_saveData.buildings.size(), t_saveData.vehicles.size(), t_fileName);
+}
+
+sg::city::save::SaveData sg::city::save::SaveGame::Read(const std::string& t_fileName)
+{
+    SG_CITY_PROFILE_ZONE("SaveGame::Read");
+
+    auto duration{ 0.0f };
+
+    SaveData saveData;
+
+    {
+        timer::Timer timer{ &duration };
+
+        std::ifstream file{ t_fileName, std::ios::in | std::ios::binary };
+        if (!file)
+        {
+            Fail("Unable to open " + t_fileName);
+        }
+
+        // the chunk sizes are checked against the file size before anything is allocated
+        file.seekg(0, std::ios::end);
+        const auto fileSize{ static_cast<uint64_t>(file.tellg()) };
+        file.seekg(0, std::ios::beg);
+
+        char magic[sizeof(MAGIC)]{};
+        file.read(magic, sizeof(magic));
+        const auto version{ ReadValue<uint32_t>(file) };
+
+        if (!file || !std::equal(std::begin(magic), std::end(magic), std::begin(MAGIC)))
+        {
+            Fail(t_fileName + " is not a save file.");
+        }
+
+        if (version > VERSION)
+        {
+            Fail(t_fileName + " was written by a newer version.");
+        }
+
+        auto hasTiles{ false };
+        ChunkHeader header;
+
+        while (ReadChunkHeader(file, header))
+        {
+            const auto begin{ static_cast<uint64_t>(file.tellg()) };
+            if (header.size > fileSize - begin)
+            {
+                Fail("The chunk " + ChunkIdToString(header.id) + " is truncated.");
+            }
+
+            const auto known{ std::find(std::begin(KNOWN_CHUNKS), std::end(KNOWN_CHUNKS), header.id) != std::end(KNOWN_CHUNKS) };
+
+            // a newer version of a chunk may have another layout
+            if (known && header.version > CHUNK_VERSION)
+            {
+                Fail("The chunk " + ChunkIdToString(header.id) + " was written by a newer version.");
+            }
+
+            switch (header.id)
+            {
+            case META:
+                ReadMeta(file, header, saveData);
+                break;
+            case TILE:
+                ReadTiles(file, header, saveData);
+                hasTiles = true;
+                break;
+            case PLNT:
+                ReadRecordChunk(file, header, saveData.plantIndices);
+                break;
+            case REGN:
+                ReadRegions(file, header, saveData);
+                break;
+            case ROAD:
+                ReadRecordChunk(file, header, saveData.roads);
+                break;
+            case SIGN:
+                ReadRecordChunk(file, header, saveData.signals);
+                break;
+            case BLDG:
+                ReadRecordChunk(file, header, saveData.buildings);
+                break;
+            case CARS:
+                ReadRecordChunk(file, header, saveData.vehicles);
+                break;
+            default:
+                SG_OGL_LOG_DEBUG("[SaveGame::Read()] Skip the unknown chunk {}.", ChunkIdToString(header.id));
+                break;
+            }
+
+            file.seekg(static_cast<std::streamoff>(begin + header.size));
+            if (!file)
+            {
+                Fail("Unexpected end of file in the chunk " + ChunkIdToString(header.id) + ".");
+            }
+        }
+
+        if (!hasTiles)
+        {
+            Fail(t_fileName + " has no Tiles.");
+        }
+
+        Check(saveData);
+    }
+
+    SG_OGL_LOG_INFO("[SaveGame::Read()] Read {}x{} Tiles from {} in {} ms.", saveData.mapSize, saveData.mapSize, t_fileName, duration);
+
+    return saveData;
+}
+
+bool sg::city::save::SaveGame::IsSaveFile(const std::string& t_fileName)
+{
+    const std::string extension{ FILE_EXTENSION };
+
+    return t_fileName.size() >= extension.size() && t_fileName.compare(t_fileName.size() - extension.size(), extension.size(), extension) == 0;
+}
+
+//-------------------------------------------------
+// Check
+//-------------------------------------------------
+
+void sg::city::save::SaveGame::Check(const SaveData& t_saveData)
+{
+    const auto nrOfAllTiles{ static_cast<int64_t>(t_saveData.tileTypes.size()) };
+
+    const auto isTile{ [nrOfAllTiles](const int32_t t_tileIndex)
+    {
+        return t_tileIndex >= 0 && t_tileIndex < nrOfAllTiles;
+    } };
+
+    const auto isType{ [&t_saveData](const int32_t t_tileIndex, const map::tile::TileType t_type)
+    {
+        return t_saveData.tileTypes[t_tileIndex] == static_cast<uint8_t>(t_type);
+    } };
+
+    auto roads{ 0ll };
+    for (const auto type : t_saveData.tileTypes)
+    {
+        if (type > static_cast<uint8_t>(map::tile::TileType::TRAFFIC))
+        {
+            Fail("Invalid TileType.");
+        }
+
+        if (type == static_cast<uint8_t>(map::tile::TileType::TRAFFIC))
+        {
+            roads++;
+        }
+    }
+
+    for (const auto plantIndex : t_saveData.plantIndices)
+    {
+        if (!isTile(plantIndex))
+        {
+            Fail("A tree is outside the Map.");
+        }
+    }
+
+    if (!t_saveData.regions.empty())
+    {
+        // the Ids are stable, not dense; but there are never more Ids than Tiles
+        if (static_cast<int64_t>(t_saveData.regions.size()) != nrOfAllTiles || t_saveData.maxRegionId < 0 || t_saveData.maxRegionId > nrOfAllTiles)
+        {
+            Fail("The regions do not fit to the Tiles.");
+        }
+
+        for (const auto region : t_saveData.regions)
+        {
+            if (region < map::tile::Tile::NO_REGION || region > t_saveData.maxRegionId)
+            {
+                Fail("Invalid region.");
+            }
+        }
+    }
+
+    // the tracks of a road are created from its record, so each road needs exactly one
+    std::vector<uint8_t> used(static_cast<size_t>(nrOfAllTiles), 0);
+
+    if (static_cast<int64_t>(t_saveData.roads.size()) != roads)
+    {
+        Fail("The roads do not fit to the Tiles.");
+    }
+
+    for (const auto& road : t_saveData.roads)
+    {
+        if (!isTile(road.tileIndex) || !isType(road.tileIndex, map::tile::TileType::TRAFFIC) || used[road.tileIndex] || !IsRoadType(road.roadType))
+        {
+            Fail("Invalid road.");
+        }
+
+        used[road.tileIndex] = 1;
+    }
+
+    for (const auto& signal : t_saveData.signals)
+    {
+        if (!isTile(signal.tileIndex) || !isType(signal.tileIndex, map::tile::TileType::TRAFFIC) || signal.stopPatternIndex < 0)
+        {
+            Fail("Invalid traffic signal.");
+        }
+    }
+
+    std::fill(used.begin(), used.end(), 0);
+
+    for (const auto& building : t_saveData.buildings)
+    {
+        if (!isTile(building.tileIndex) || !isType(building.tileIndex, map::tile::TileType::RESIDENTIAL) || used[building.tileIndex] ||
+            building.floors < 1 || building.floors > map::BuildingGenerator::MAX_FLOORS)
+        {
+            Fail("Invalid building.");
+        }
+
+        used[building.tileIndex] = 1;
+    }
+
+    for (const auto& vehicle : t_saveData.vehicles)
+    {
+        if (!isTile(vehicle.tileIndex) || !isType(vehicle.tileIndex, map::tile::TileType::TRAFFIC))
+        {
+            Fail("Invalid car.");
+        }
+    }
+}
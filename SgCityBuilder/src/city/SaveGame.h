@@ -0,0 +1,216 @@
+// This file is part of the SgCityBuilder package.
+// 
+// Filename: SaveGame.h
+// Author:   stwe
+// 
+// License:  MIT
+// 
+// 2020 (c) stwe <https://github.com/stwe/SgCityBuilder>
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include "Random.h"
+
+namespace sg::city::save
+{
+    /**
+     * @brief The four characters of a chunk Id in a 32 bit value; the first character is in the lowest byte.
+     * @param t_id E.g. "TILE".
+     * @return uint32_t
+     */
+    constexpr uint32_t MakeChunkId(const char (&t_id)[5])
+    {
+        return static_cast<uint32_t>(static_cast<uint8_t>(t_id[0]))
+            | static_cast<uint32_t>(static_cast<uint8_t>(t_id[1])) << 8
+            | static_cast<uint32_t>(static_cast<uint8_t>(t_id[2])) << 16
+            | static_cast<uint32_t>(static_cast<uint8_t>(t_id[3])) << 24;
+    }
+
+    //-------------------------------------------------
+    // Records
+    //-------------------------------------------------
+
+    /**
+     * @brief A road and its RoadType, the index in the road texture atlas.
+     */
+    struct RoadRecord
+    {
+        int32_t tileIndex{ -1 };
+        uint8_t roadType{ 0 };
+        uint8_t reserved[3]{};
+    };
+
+    /**
+     * @brief The current Stop Pattern of a road with traffic signals.
+     */
+    struct SignalRecord
+    {
+        int32_t tileIndex{ -1 };
+        int32_t stopPatternIndex{ 0 };
+    };
+
+    /**
+     * @brief A building and the population of its Tile.
+     */
+    struct BuildingRecord
+    {
+        int32_t tileIndex{ -1 };
+        float population{ 0.0f };
+        uint8_t floors{ 1 };
+        uint8_t colorIndex{ 0 };
+        uint8_t textureId{ 1 };
+        uint8_t flags{ 0 };
+    };
+
+    /**
+     * @brief A car. The track is the position in the Auto Tracks of the RoadTile.
+     *        The cars of a track are stored in their order on the track, the first one in front.
+     */
+    struct VehicleRecord
+    {
+        int32_t tileIndex{ -1 };
+        uint16_t trackIndex{ 0 };
+        uint8_t rootIsEndNode{ 0 };
+        uint8_t blocked{ 0 };
+        float autoPosition{ 0.0f };
+        float autoLength{ 0.0f };
+        float lifetime{ 0.0f };
+        float positionX{ 0.0f };
+        float positionY{ 0.0f };
+        float positionZ{ 0.0f };
+        uint64_t randomKey{ 1 };
+        uint64_t randomCounter{ 0 };
+    };
+
+    // the records are written as they are in memory
+    static_assert(sizeof(RoadRecord) == 8);
+    static_assert(sizeof(SignalRecord) == 8);
+    static_assert(sizeof(BuildingRecord) == 12);
+    static_assert(sizeof(VehicleRecord) == 48);
+
+    /**
+     * @brief The state of a City in dense arrays, indexed by the Tile index, and lists of records.
+     */
+    struct SaveData
+    {
+        using TypeContainer = std::vector<uint8_t>;
+        using IndexContainer = std::vector<int32_t>;
+        using RoadContainer = std::vector<RoadRecord>;
+        using SignalContainer = std::vector<SignalRecord>;
+        using BuildingContainer = std::vector<BuildingRecord>;
+        using VehicleContainer = std::vector<VehicleRecord>;
+
+        // META
+        uint64_t seed{ random::Random::DEFAULT_SEED };
+        uint64_t tick{ 0 };
+        uint64_t nextAutomataId{ 0 };
+
+        // TILE: the TileType of each Tile
+        int32_t mapSize{ 0 };
+        TypeContainer tileTypes;
+
+        // PLNT: the Tiles with a tree
+        IndexContainer plantIndices;
+
+        // REGN: the region of each Tile; empty if the regions are not saved
+        int32_t maxRegionId{ 0 };
+        IndexContainer regions;
+
+        // ROAD, SIGN, BLDG, CARS
+        RoadContainer roads;
+        SignalContainer signals;
+        BuildingContainer buildings;
+        VehicleContainer vehicles;
+    };
+
+    /**
+     * @brief Reads and writes the save file of a City.
+     *        After the header the file is a list of chunks. Each chunk starts with a four-character Id,
+     *        its own version and the size of its data, so a reader skips the chunks it does not know
+     *        and new chunks can be added without breaking older files. Each array is written and read
+     *        with a single call in the byte order of the machine.
+     */
+    class SaveGame
+    {
+    public:
+        //-------------------------------------------------
+        // Const
+        //-------------------------------------------------
+
+        static constexpr char MAGIC[8]{ 'S', 'G', 'C', 'I', 'T', 'Y', 'S', 'V' };
+        static constexpr uint32_t VERSION{ 1 };
+
+        static constexpr const char* FILE_EXTENSION{ ".city" };
+
+        static constexpr uint32_t META{ MakeChunkId("META") };
+        static constexpr uint32_t TILE{ MakeChunkId("TILE") };
+        static constexpr uint32_t PLNT{ MakeChunkId("PLNT") };
+        static constexpr uint32_t REGN{ MakeChunkId("REGN") };
+        static constexpr uint32_t ROAD{ MakeChunkId("ROAD") };
+        static constexpr uint32_t SIGN{ MakeChunkId("SIGN") };
+        static constexpr uint32_t BLDG{ MakeChunkId("BLDG") };
+        static constexpr uint32_t CARS{ MakeChunkId("CARS") };
+
+        /**
+         * @brief The version written for all chunks. A reader accepts each chunk up to this version.
+         */
+        static constexpr uint32_t CHUNK_VERSION{ 1 };
+
+        /**
+         * @brief The largest accepted Map size.
+         */
+        static constexpr int32_t MAX_MAP_SIZE{ 1 << 14 };
+
+        //-------------------------------------------------
+        // Ctors. / Dtor.
+        //-------------------------------------------------
+
+        SaveGame() = delete;
+
+        SaveGame(const SaveGame& t_other) = delete;
+        SaveGame(SaveGame&& t_other) noexcept = delete;
+        SaveGame& operator=(const SaveGame& t_other) = delete;
+        SaveGame& operator=(SaveGame&& t_other) noexcept = delete;
+
+        ~SaveGame() noexcept = delete;
+
+        //-------------------------------------------------
+        // Read / Write
+        //-------------------------------------------------
+
+        /**
+         * @brief Writes all chunks. Throws a std::runtime_error if the file cannot be written.
+         * @param t_fileName The save file.
+         * @param t_saveData The state of the City.
+         */
+        static void Write(const std::string& t_fileName, const SaveData& t_saveData);
+
+        /**
+         * @brief Reads and checks a save file. After a successful read all indices are in the Map,
+         *        each road has one RoadRecord and each building is on a residential Tile.
+         *        Throws a std::runtime_error if the file is not a valid save file.
+         * @param t_fileName The save file.
+         * @return SaveData
+         */
+        [[nodiscard]] static SaveData Read(const std::string& t_fileName);
+
+        /**
+         * @brief A file with the FILE_EXTENSION.
+         * @param t_fileName The file name.
+         * @return bool
+         */
+        [[nodiscard]] static bool IsSaveFile(const std::string& t_fileName);
+
+    protected:
+
+    private:
+        /**
+         * @brief Throws a std::runtime_error if the records do not fit to the Tiles.
+         * @param t_saveData The data read from the file.
+         */
+        static void Check(const SaveData& t_saveData);
+    };
+}
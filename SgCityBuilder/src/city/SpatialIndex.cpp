@@ -0,0 +1,261 @@
+// This file is part of the SgCityBuilder package.
+// 
+// Filename: SpatialIndex.cpp
+// Author:   stwe
+// 
+// License:  MIT
+// 
+// 2020 (c) stwe <https://github.com/stwe/SgCityBuilder>
+
+#include <cmath>
+#include <algorithm>
+#include <Core.h>
+#include "SpatialIndex.h"
+#include "City.h"
+#include "map/Map.h"
+#include "map/BuildingGenerator.h"
+#include "map/tile/Tile.h"
+#include "automata/Automata.h"
+#include "automata/AutoTrack.h"
+
+//-------------------------------------------------
+// Ctors. / Dtor.
+//-------------------------------------------------
+
+sg::city::spatial::SpatialIndex::SpatialIndex(city::City* t_city, entt::registry& t_registry)
+    : m_city{ t_city }
+    , m_registry{ &t_registry }
+{
+    SG_OGL_ASSERT(m_city, "[SpatialIndex::SpatialIndex()] Null pointer.")
+
+    SG_OGL_LOG_DEBUG("[SpatialIndex::SpatialIndex()] Construct SpatialIndex.");
+
+    m_mapSize = m_city->GetMap().GetMapSize();
+    m_cells.resize(static_cast<size_t>(m_mapSize) * m_mapSize);
+}
+
+sg::city::spatial::SpatialIndex::SpatialIndex(const int t_mapSize, entt::registry& t_registry)
+    : m_registry{ &t_registry }
+    , m_mapSize{ t_mapSize }
+{
+    SG_OGL_LOG_DEBUG("[SpatialIndex::SpatialIndex()] Construct SpatialIndex without buildings.");
+
+    m_cells.resize(static_cast<size_t>(m_mapSize) * m_mapSize);
+}
+
+sg::city::spatial::SpatialIndex::~SpatialIndex() noexcept
+{
+    SG_OGL_LOG_DEBUG("[SpatialIndex::~SpatialIndex()] Destruct SpatialIndex.");
+}
+
+//-------------------------------------------------
+// Vehicles
+//-------------------------------------------------
+
+void sg::city::spatial::SpatialIndex::InsertVehicle(const entt::entity t_entity, automata::Automata& t_automata)
+{
+    SG_OGL_ASSERT(t_automata.spatialTileIndex < 0, "[SpatialIndex::InsertVehicle()] The Automata is already in the index.")
+
+    AddToCell(t_entity, t_automata, GetTileIndex(t_automata));
+    m_vehicleCount++;
+}
+
+void sg::city::spatial::SpatialIndex::UpdateVehicle(const entt::entity t_entity, automata::Automata& t_automata)
+{
+    const auto tileIndex{ GetTileIndex(t_automata) };
+    if (tileIndex == t_automata.spatialTileIndex)
+    {
+        return;
+    }
+
+    RemoveFromCell(t_entity, t_automata);
+    AddToCell(t_entity, t_automata, tileIndex);
+}
+
+void sg::city::spatial::SpatialIndex::RemoveVehicle(const entt::entity t_entity, automata::Automata& t_automata)
+{
+    if (t_automata.spatialTileIndex < 0)
+    {
+        return;
+    }
+
+    RemoveFromCell(t_entity, t_automata);
+    m_vehicleCount--;
+}
+
+const sg::city::spatial::SpatialIndex::VehicleContainer& sg::city::spatial::SpatialIndex::GetVehiclesOnTile(const int t_tileIndex) const
+{
+    return m_cells.at(t_tileIndex);
+}
+
+uint32_t sg::city::spatial::SpatialIndex::GetVehicleCount(const int t_tileIndex) const
+{
+    return static_cast<uint32_t>(m_cells.at(t_tileIndex).size());
+}
+
+uint32_t sg::city::spatial::SpatialIndex::GetVehicleCount() const noexcept
+{
+    return m_vehicleCount;
+}
+
+void sg::city::spatial::SpatialIndex::QueryVehicles(const glm::vec3& t_center, const float t_radius, VehicleContainer& t_vehicles) const
+{
+    t_vehicles.clear();
+
+    int minX, minZ, maxX, maxZ;
+    if (!GetTileRange(t_center, t_radius, minX, minZ, maxX, maxZ))
+    {
+        return;
+    }
+
+    const auto radiusSquared{ t_radius * t_radius };
+
+    for (auto z{ minZ }; z <= maxZ; ++z)
+    {
+        for (auto x{ minX }; x <= maxX; ++x)
+        {
+            for (const auto entity : m_cells[static_cast<size_t>(z) * m_mapSize + x])
+            {
+                const auto& automata{ m_registry->get<automata::Automata>(entity) };
+                const auto dx{ automata.position.x - t_center.x };
+                const auto dz{ automata.position.z - t_center.z };
+
+                if (dx * dx + dz * dz <= radiusSquared)
+                {
+                    t_vehicles.push_back(entity);
+                }
+            }
+        }
+    }
+}
+
+entt::entity sg::city::spatial::SpatialIndex::PickVehicle(const glm::vec3& t_point) const
+{
+    VehicleContainer vehicles;
+    QueryVehicles(t_point, VEHICLE_PICK_RADIUS, vehicles);
+
+    entt::entity nearest{ entt::null };
+    auto nearestDistance{ VEHICLE_PICK_RADIUS * VEHICLE_PICK_RADIUS };
+
+    for (const auto entity : vehicles)
+    {
+        const auto& automata{ m_registry->get<automata::Automata>(entity) };
+        const auto dx{ automata.position.x - t_point.x };
+        const auto dz{ automata.position.z - t_point.z };
+        const auto distance{ dx * dx + dz * dz };
+
+        if (distance <= nearestDistance)
+        {
+            nearest = entity;
+            nearestDistance = distance;
+        }
+    }
+
+    return nearest;
+}
+
+//-------------------------------------------------
+// Buildings
+//-------------------------------------------------
+
+void sg::city::spatial::SpatialIndex::QueryBuildings(const glm::vec3& t_center, const float t_radius, TileIndexContainer& t_tileIndices) const
+{
+    t_tileIndices.clear();
+
+    int minX, minZ, maxX, maxZ;
+    if (!GetTileRange(t_center, t_radius, minX, minZ, maxX, maxZ))
+    {
+        return;
+    }
+
+    SG_OGL_ASSERT(m_city, "[SpatialIndex::QueryBuildings()] The index has no buildings.")
+
+    const auto& buildingGenerator{ m_city->GetBuildingGenerator() };
+    const auto radiusSquared{ t_radius * t_radius };
+
+    for (auto z{ minZ }; z <= maxZ; ++z)
+    {
+        for (auto x{ minX }; x <= maxX; ++x)
+        {
+            const auto tileIndex{ z * m_mapSize + x };
+            if (!buildingGenerator.HasBuilding(tileIndex))
+            {
+                continue;
+            }
+
+            // the center of the Tile
+            const auto dx{ static_cast<float>(x) + 0.5f - t_center.x };
+            const auto dz{ -(static_cast<float>(z) + 0.5f) - t_center.z };
+
+            if (dx * dx + dz * dz <= radiusSquared)
+            {
+                t_tileIndices.push_back(tileIndex);
+            }
+        }
+    }
+}
+
+int sg::city::spatial::SpatialIndex::PickBuilding(const glm::vec3& t_point) const
+{
+    SG_OGL_ASSERT(m_city, "[SpatialIndex::PickBuilding()] The index has no buildings.")
+
+    const auto x{ static_cast<int>(std::floor(t_point.x)) };
+    const auto z{ static_cast<int>(std::floor(-t_point.z)) };
+
+    if (x < 0 || x >= m_mapSize || z < 0 || z >= m_mapSize)
+    {
+        return -1;
+    }
+
+    const auto tileIndex{ z * m_mapSize + x };
+
+    return m_city->GetBuildingGenerator().HasBuilding(tileIndex) ? tileIndex : -1;
+}
+
+//-------------------------------------------------
+// Helper
+//-------------------------------------------------
+
+int sg::city::spatial::SpatialIndex::GetTileIndex(const automata::Automata& t_automata)
+{
+    SG_OGL_ASSERT(t_automata.currentTrack && t_automata.currentTrack->tile, "[SpatialIndex::GetTileIndex()] The Automata is not on a Tile.")
+
+    return t_automata.currentTrack->tile->GetMapIndex();
+}
+
+bool sg::city::spatial::SpatialIndex::GetTileRange(const glm::vec3& t_center, const float t_radius, int& t_minX, int& t_minZ, int& t_maxX, int& t_maxZ) const
+{
+    // the Map lies in the x and -z direction
+    t_minX = std::max(static_cast<int>(std::floor(t_center.x - t_radius)), 0);
+    t_maxX = std::min(static_cast<int>(std::floor(t_center.x + t_radius)), m_mapSize - 1);
+    t_minZ = std::max(static_cast<int>(std::floor(-t_center.z - t_radius)), 0);
+    t_maxZ = std::min(static_cast<int>(std::floor(-t_center.z + t_radius)), m_mapSize - 1);
+
+    return t_minX <= t_maxX && t_minZ <= t_maxZ;
+}
+
+void sg::city::spatial::SpatialIndex::AddToCell(const entt::entity t_entity, automata::Automata& t_automata, const int t_tileIndex)
+{
+    auto& cell{ m_cells.at(t_tileIndex) };
+
+    t_automata.spatialTileIndex = t_tileIndex;
+    t_automata.spatialSlot = static_cast<uint32_t>(cell.size());
+
+    cell.push_back(t_entity);
+}
+
+void sg::city::spatial::SpatialIndex::RemoveFromCell(const entt::entity t_entity, automata::Automata& t_automata)
+{
+    auto& cell{ m_cells.at(t_automata.spatialTileIndex) };
+
+    SG_OGL_ASSERT(cell[t_automata.spatialSlot] == t_entity, "[SpatialIndex::RemoveFromCell()] Invalid slot.")
+
+    // fill the gap with the last vehicle of the cell
+    const auto last{ cell.back() };
+    cell[t_automata.spatialSlot] = last;
+    m_registry->get<automata::Automata>(last).spatialSlot = t_automata.spatialSlot;
+    cell.pop_back();
+
+    t_automata.spatialTileIndex = -1;
+    t_automata.spatialSlot = 0;
+}
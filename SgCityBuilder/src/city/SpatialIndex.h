@@ -0,0 +1,167 @@
+// This file is part of the SgCityBuilder package.
+// 
+// Filename: SpatialIndex.h
+// Author:   stwe
+// 
+// License:  MIT
+// 
+// 2020 (c) stwe <https://github.com/stwe/SgCityBuilder>
+
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <entt/entt.hpp>
+#include <glm/vec3.hpp>
+#include "Memory.h"
+
+namespace sg::city::automata
+{
+    class Automata;
+}
+
+namespace sg::city::city
+{
+    class City;
+}
+
+namespace sg::city::spatial
+{
+    /**
+     * @brief A uniform grid with one cell per Tile.
+     *        The vehicles are kept in the cell of the Tile of their current track and are moved
+     *        only when they change the Tile. The buildings are looked up in the BuildingGenerator,
+     *        which already stores at most one building per Tile.
+     */
+    class SpatialIndex
+    {
+    public:
+        using VehicleContainer = memory::TrackedVector<entt::entity, memory::Tag::AUTOMATA>;
+        using CellContainer = memory::TrackedVector<VehicleContainer, memory::Tag::AUTOMATA>;
+        using TileIndexContainer = std::vector<int>;
+
+        //-------------------------------------------------
+        // Const
+        //-------------------------------------------------
+
+        /**
+         * @brief The maximum distance between the cursor and a car to pick the car.
+         */
+        static constexpr auto VEHICLE_PICK_RADIUS{ 0.25f };
+
+        //-------------------------------------------------
+        // Ctors. / Dtor.
+        //-------------------------------------------------
+
+        SpatialIndex() = delete;
+
+        SpatialIndex(city::City* t_city, entt::registry& t_registry);
+
+        /**
+         * @brief An index of the cars only, e.g. for the headless benchmark. The buildings cannot be queried.
+         * @param t_mapSize The number of Tiles in the x and z direction.
+         * @param t_registry The registry holding the Automata components.
+         */
+        SpatialIndex(int t_mapSize, entt::registry& t_registry);
+
+        SpatialIndex(const SpatialIndex& t_other) = delete;
+        SpatialIndex(SpatialIndex&& t_other) noexcept = delete;
+        SpatialIndex& operator=(const SpatialIndex& t_other) = delete;
+        SpatialIndex& operator=(SpatialIndex&& t_other) noexcept = delete;
+
+        ~SpatialIndex() noexcept;
+
+        //-------------------------------------------------
+        // Vehicles
+        //-------------------------------------------------
+
+        void InsertVehicle(entt::entity t_entity, automata::Automata& t_automata);
+
+        /**
+         * @brief Must be called after the Automata was moved. Does nothing if the Tile has not changed.
+         * @param t_entity The car Entity.
+         * @param t_automata The Automata component of the car.
+         */
+        void UpdateVehicle(entt::entity t_entity, automata::Automata& t_automata);
+
+        void RemoveVehicle(entt::entity t_entity, automata::Automata& t_automata);
+
+        [[nodiscard]] const VehicleContainer& GetVehiclesOnTile(int t_tileIndex) const;
+        [[nodiscard]] uint32_t GetVehicleCount(int t_tileIndex) const;
+        [[nodiscard]] uint32_t GetVehicleCount() const noexcept;
+
+        /**
+         * @brief Finds all vehicles within a radius.
+         * @param t_center The center in World Space.
+         * @param t_radius The radius in World Space.
+         * @param t_vehicles Receives the vehicles.
+         */
+        void QueryVehicles(const glm::vec3& t_center, float t_radius, VehicleContainer& t_vehicles) const;
+
+        /**
+         * @brief Returns the nearest vehicle at a point, e.g. the picked point under the cursor.
+         * @param t_point The point in World Space.
+         * @return The car Entity or entt::null.
+         */
+        [[nodiscard]] entt::entity PickVehicle(const glm::vec3& t_point) const;
+
+        //-------------------------------------------------
+        // Buildings
+        //-------------------------------------------------
+
+        /**
+         * @brief Finds all Tiles with a building whose center is within a radius.
+         * @param t_center The center in World Space.
+         * @param t_radius The radius in World Space.
+         * @param t_tileIndices Receives the Tile indices.
+         */
+        void QueryBuildings(const glm::vec3& t_center, float t_radius, TileIndexContainer& t_tileIndices) const;
+
+        /**
+         * @brief Returns the building at a point. A building is picked by its footprint.
+         * @param t_point The point in World Space.
+         * @return The Tile index of the building or -1.
+         */
+        [[nodiscard]] int PickBuilding(const glm::vec3& t_point) const;
+
+    protected:
+
+    private:
+        /**
+         * @brief A pointer to the parent City. Is nullptr if only the cars are indexed.
+         */
+        city::City* m_city{ nullptr };
+
+        /**
+         * @brief The registry holding the Automata components.
+         */
+        entt::registry* m_registry{ nullptr };
+
+        /**
+         * @brief The number of Tiles in the x and z direction.
+         */
+        int m_mapSize{ 0 };
+
+        /**
+         * @brief The vehicles of each Tile.
+         */
+        CellContainer m_cells;
+
+        uint32_t m_vehicleCount{ 0 };
+
+        //-------------------------------------------------
+        // Helper
+        //-------------------------------------------------
+
+        [[nodiscard]] static int GetTileIndex(const automata::Automata& t_automata);
+
+        /**
+         * @brief Calculates the Tile range covering a circle.
+         * @return False if the circle is outside the Map.
+         */
+        [[nodiscard]] bool GetTileRange(const glm::vec3& t_center, float t_radius, int& t_minX, int& t_minZ, int& t_maxX, int& t_maxZ) const;
+
+        void AddToCell(entt::entity t_entity, automata::Automata& t_automata, int t_tileIndex);
+        void RemoveFromCell(entt::entity t_entity, automata::Automata& t_automata);
+    };
+}
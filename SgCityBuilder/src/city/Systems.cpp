@@ -0,0 +1,236 @@
+// This file is part of the SgCityBuilder package.
+// 
+// Filename: Systems.cpp
+// Author:   stwe
+// 
+// License:  MIT
+// 
+// 2020 (c) stwe <https://github.com/stwe/SgCityBuilder>
+
+#include <algorithm>
+#include <Core.h>
+#include <Log.h>
+#include <glm/vec3.hpp>
+#include <ecs/component/Components.h>
+#include "Systems.h"
+#include "SpatialIndex.h"
+#include "EventBus.h"
+#include "FrameArena.h"
+#include "Profiler.h"
+#include "map/Map.h"
+#include "map/tile/RoadTile.h"
+#include "automata/Automata.h"
+#include "automata/AutoTrack.h"
+#include "simulation/PopulationGrowth.h"
+#include "simulation/Demand.h"
+
+//-------------------------------------------------
+// Ctors. / Dtor.
+//-------------------------------------------------
+
+sg::city::system::Systems::Systems(map::Map& t_map, spatial::SpatialIndex& t_spatialIndex, entt::registry& t_registry, const random::Random& t_random)
+    : m_map{ &t_map }
+    , m_spatialIndex{ &t_spatialIndex }
+    , m_registry{ &t_registry }
+{
+    SG_OGL_LOG_DEBUG("[Systems::Systems()] Construct Systems.");
+
+    m_populationGrowth = std::make_unique<simulation::PopulationGrowth>(t_map, t_random);
+    m_demand = std::make_unique<simulation::Demand>(t_map, *m_populationGrowth);
+}
+
+sg::city::system::Systems::~Systems() noexcept
+{
+    SG_OGL_LOG_DEBUG("[Systems::~Systems()] Destruct Systems.");
+}
+
+//-------------------------------------------------
+// Getter
+//-------------------------------------------------
+
+const sg::city::simulation::PopulationGrowth& sg::city::system::Systems::GetPopulationGrowth() const noexcept
+{
+    return *m_populationGrowth;
+}
+
+const sg::city::simulation::Demand& sg::city::system::Systems::GetDemand() const noexcept
+{
+    return *m_demand;
+}
+
+//-------------------------------------------------
+// Init
+//-------------------------------------------------
+
+void sg::city::system::Systems::InitPopulation() const
+{
+    m_populationGrowth->Init();
+    m_demand->Calc();
+}
+
+void sg::city::system::Systems::RestorePopulation(const save::SaveData& t_saveData) const
+{
+    // keep the saved population
+    m_populationGrowth->Restore(t_saveData);
+    m_demand->Calc();
+}
+
+//-------------------------------------------------
+// Tiles
+//-------------------------------------------------
+
+void sg::city::system::Systems::UpdateChangedTiles(const std::vector<event::TileChanged>& t_events) const
+{
+    auto& tiles{ m_map->GetTiles() };
+
+    for (const auto& tileChanged : t_events)
+    {
+        // the roads are updated together with their neighbours
+        if (tileChanged.newType != map::tile::TileType::TRAFFIC)
+        {
+            tiles[tileChanged.tileIndex]->Update();
+        }
+    }
+}
+
+void sg::city::system::Systems::UpdatePopulationTiles(const std::vector<event::TileChanged>& t_events) const
+{
+    for (const auto& tileChanged : t_events)
+    {
+        m_populationGrowth->OnTileChanged(tileChanged.tileIndex);
+    }
+}
+
+void sg::city::system::Systems::UpdateRegions() const
+{
+    m_map->FindConnectedRegions();
+    m_populationGrowth->ReadRegions();
+}
+
+void sg::city::system::Systems::UpdateRoads(const std::vector<event::RoadTopologyChanged>& t_events)
+{
+    SG_CITY_PROFILE_ZONE("Systems::UpdateRoads");
+
+    auto& tiles{ m_map->GetTiles() };
+
+    // a new road changes the road type and the tracks of its road neighbours
+    m_roadIndices.clear();
+    for (const auto& roadTopologyChanged : t_events)
+    {
+        m_roadIndices.push_back(roadTopologyChanged.tileIndex);
+
+        for (const auto& neighbour : tiles[roadTopologyChanged.tileIndex]->GetNeighbours())
+        {
+            if (tiles[neighbour.second]->type == map::tile::TileType::TRAFFIC)
+            {
+                m_roadIndices.push_back(neighbour.second);
+            }
+        }
+    }
+
+    std::sort(m_roadIndices.begin(), m_roadIndices.end());
+    m_roadIndices.erase(std::unique(m_roadIndices.begin(), m_roadIndices.end()), m_roadIndices.end());
+
+    // the cars refer to the old tracks
+    for (auto roadIndex : m_roadIndices)
+    {
+        DespawnCars(roadIndex);
+    }
+
+    for (auto roadIndex : m_roadIndices)
+    {
+        dynamic_cast<map::tile::RoadTile*>(tiles[roadIndex].get())->ClearTracksAndStops();
+    }
+
+    for (auto roadIndex : m_roadIndices)
+    {
+        tiles[roadIndex]->Update();
+    }
+
+    // RoadTile::Update() uploads only a changed RoadType; a new road must upload its TileType anyway
+    for (const auto& roadTopologyChanged : t_events)
+    {
+        m_map->UpdateMapVboByTileIndex(roadTopologyChanged.tileIndex);
+    }
+}
+
+//-------------------------------------------------
+// Population
+//-------------------------------------------------
+
+void sg::city::system::Systems::UpdateDemand(const uint64_t t_tick) const
+{
+    m_demand->Update(t_tick);
+}
+
+void sg::city::system::Systems::UpdatePopulation(const uint64_t t_tick) const
+{
+    m_populationGrowth->Update(t_tick, *m_demand);
+}
+
+//-------------------------------------------------
+// Cars
+//-------------------------------------------------
+
+void sg::city::system::Systems::DespawnCars(const int t_tileIndex) const
+{
+    // a copy, because the removal changes the cell
+    const auto& cell{ m_spatialIndex->GetVehiclesOnTile(t_tileIndex) };
+    if (cell.empty())
+    {
+        return;
+    }
+
+    const std::pmr::vector<entt::entity> cars{ cell.begin(), cell.end(), memory::FrameArena::Get().GetResource() };
+
+    for (const auto entity : cars)
+    {
+        auto& automata{ m_registry->get<automata::Automata>(entity) };
+        automata.currentTrack->RemoveAutomata(entity);
+        m_spatialIndex->RemoveVehicle(entity, automata);
+    }
+
+    m_registry->destroy(cars.begin(), cars.end());
+}
+
+uint32_t sg::city::system::Systems::UpdateVehicles(const float t_dt)
+{
+    // the group owns the Automata components, so the cars are packed at the front of the storage
+    auto group{ m_registry->group<automata::Automata>(entt::get<ogl::ecs::component::TransformComponent>) };
+
+    m_deadCars.clear();
+    auto blockedCars{ 0u };
+
+    for (auto entity : group)
+    {
+        auto& automata{ group.get<automata::Automata>(entity) };
+        automata.Update(t_dt, entity, *m_registry);
+
+        if (automata.blocked)
+        {
+            blockedCars++;
+        }
+
+        // the Update function may have set deleteAutomata to true
+        if (automata.deleteAutomata)
+        {
+            automata.currentTrack->RemoveAutomata(entity);
+            m_spatialIndex->RemoveVehicle(entity, automata);
+            m_deadCars.push_back(entity);
+
+            continue;
+        }
+
+        // moves the car to another cell only if it has changed the Tile
+        m_spatialIndex->UpdateVehicle(entity, automata);
+
+        auto& transformComponent{ group.get<ogl::ecs::component::TransformComponent>(entity) };
+        transformComponent.position = glm::vec3(automata.position.x, CAR_HEIGHT, automata.position.z);
+        transformComponent.rotation = glm::vec3(0.0f, automata.currentTrack->rotation, 0.0f);
+    }
+
+    // despawn all at once; destroying inside the loop would invalidate the group iterators
+    m_registry->destroy(m_deadCars.begin(), m_deadCars.end());
+
+    return blockedCars;
+}
@@ -0,0 +1,188 @@
+// This file is part of the SgCityBuilder package.
+// 
+// Filename: Systems.h
+// Author:   stwe
+// 
+// License:  MIT
+// 
+// 2020 (c) stwe <https://github.com/stwe/SgCityBuilder>
+
+#pragma once
+
+#include <memory>
+#include <vector>
+#include <cstdint>
+#include <entt/entt.hpp>
+#include "Memory.h"
+
+namespace sg::city::map
+{
+    class Map;
+}
+
+namespace sg::city::spatial
+{
+    class SpatialIndex;
+}
+
+namespace sg::city::random
+{
+    class Random;
+}
+
+namespace sg::city::save
+{
+    struct SaveData;
+}
+
+namespace sg::city::simulation
+{
+    class PopulationGrowth;
+    class Demand;
+}
+
+namespace sg::city::event
+{
+    struct TileChanged;
+    struct RoadTopologyChanged;
+}
+
+namespace sg::city::system
+{
+    /**
+     * @brief The systems reacting on Tile changes, growing the population and moving the cars.
+     *        They need no Gpu, so the City and the headless benchmark run the same code.
+     *        The buildings stay in the City; it reads the changed floors from the PopulationGrowth.
+     */
+    class Systems
+    {
+    public:
+        using TileIndexContainer = std::vector<int>;
+        using EntityContainer = memory::TrackedVector<entt::entity, memory::Tag::AUTOMATA>;
+        using PopulationGrowthUniquePtr = std::unique_ptr<simulation::PopulationGrowth>;
+        using DemandUniquePtr = std::unique_ptr<simulation::Demand>;
+
+        //-------------------------------------------------
+        // Const
+        //-------------------------------------------------
+
+        static constexpr auto CAR_HEIGHT{ 0.015f };
+
+        //-------------------------------------------------
+        // Ctors. / Dtor.
+        //-------------------------------------------------
+
+        Systems() = delete;
+
+        Systems(map::Map& t_map, spatial::SpatialIndex& t_spatialIndex, entt::registry& t_registry, const random::Random& t_random);
+
+        Systems(const Systems& t_other) = delete;
+        Systems(Systems&& t_other) noexcept = delete;
+        Systems& operator=(const Systems& t_other) = delete;
+        Systems& operator=(Systems&& t_other) noexcept = delete;
+
+        ~Systems() noexcept;
+
+        //-------------------------------------------------
+        // Getter
+        //-------------------------------------------------
+
+        [[nodiscard]] const simulation::PopulationGrowth& GetPopulationGrowth() const noexcept;
+        [[nodiscard]] const simulation::Demand& GetDemand() const noexcept;
+
+        //-------------------------------------------------
+        // Init
+        //-------------------------------------------------
+
+        /**
+         * @brief Gives the residential Tiles a start population and calculates the first demand.
+         *        Must be called after the regions were found.
+         */
+        void InitPopulation() const;
+
+        /**
+         * @brief Reads the saved population and calculates the first demand.
+         * @param t_saveData The saved City.
+         */
+        void RestorePopulation(const save::SaveData& t_saveData) const;
+
+        //-------------------------------------------------
+        // Tiles
+        //-------------------------------------------------
+
+        void UpdateChangedTiles(const std::vector<event::TileChanged>& t_events) const;
+
+        /**
+         * @brief Reads the replaced Tiles into the dense arrays of the PopulationGrowth.
+         * @param t_events The replaced Tiles.
+         */
+        void UpdatePopulationTiles(const std::vector<event::TileChanged>& t_events) const;
+
+        /**
+         * @brief Relabels the regions once per tick for all changed Tiles.
+         *        The PopulationGrowth reads only the relabelled Tiles.
+         */
+        void UpdateRegions() const;
+
+        /**
+         * @brief Rebuilds the tracks of the new roads and their road neighbours only.
+         * @param t_events The new roads.
+         */
+        void UpdateRoads(const std::vector<event::RoadTopologyChanged>& t_events);
+
+        //-------------------------------------------------
+        // Population
+        //-------------------------------------------------
+
+        /**
+         * @brief Recalculates the demand every Demand::UPDATE_INTERVAL ticks.
+         * @param t_tick The current simulation tick.
+         */
+        void UpdateDemand(uint64_t t_tick) const;
+
+        /**
+         * @brief Grows the next batch of residential Tiles.
+         *        The Tiles with new floors are in PopulationGrowth::GetChangedFloors().
+         * @param t_tick The current simulation tick.
+         */
+        void UpdatePopulation(uint64_t t_tick) const;
+
+        //-------------------------------------------------
+        // Cars
+        //-------------------------------------------------
+
+        /**
+         * @brief Destroys the cars on a Tile, e.g. before its tracks are rebuilt.
+         * @param t_tileIndex The index of the Tile.
+         */
+        void DespawnCars(int t_tileIndex) const;
+
+        /**
+         * @brief Moves all cars in a single pass over their components.
+         *        The despawned cars are destroyed together at the end.
+         * @param t_dt The elapsed time.
+         * @return The number of blocked cars.
+         */
+        uint32_t UpdateVehicles(float t_dt);
+
+    protected:
+
+    private:
+        map::Map* m_map{ nullptr };
+        spatial::SpatialIndex* m_spatialIndex{ nullptr };
+        entt::registry* m_registry{ nullptr };
+
+        PopulationGrowthUniquePtr m_populationGrowth;
+        DemandUniquePtr m_demand;
+
+        /**
+         * @brief The road indices of the current UpdateRoads(). Reused, so a tick without new roads does not allocate.
+         */
+        TileIndexContainer m_roadIndices;
+
+        /**
+         * @brief The cars despawned in the current UpdateVehicles(). Reused, so a tick without new cars does not allocate.
+         */
+        EntityContainer m_deadCars;
+    };
+}
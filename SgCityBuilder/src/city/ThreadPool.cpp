@@ -0,0 +1,221 @@
+// This file is part of the SgCityBuilder package.
+// 
+// Filename: ThreadPool.cpp
+// Author:   stwe
+// 
+// License:  MIT
+// 
+// 2020 (c) stwe <https://github.com/stwe/SgCityBuilder>
+
+#include <atomic>
+#include <exception>
+#include <algorithm>
+#include <Core.h>
+#include <Log.h>
+#include "ThreadPool.h"
+
+namespace
+{
+    /**
+     * @brief Counts a running ParallelFor(), also if a band throws.
+     */
+    class ParallelForScope
+    {
+    public:
+        explicit ParallelForScope(std::atomic<uint32_t>& t_parallelFors)
+            : m_parallelFors{ t_parallelFors }
+        {
+            ++m_parallelFors;
+        }
+
+        ~ParallelForScope() noexcept
+        {
+            --m_parallelFors;
+        }
+
+    private:
+        std::atomic<uint32_t>& m_parallelFors;
+    };
+}
+
+//-------------------------------------------------
+// Ctors. / Dtor.
+//-------------------------------------------------
+
+sg::city::thread::ThreadPool::ThreadPool(const uint32_t t_workers)
+{
+    SG_OGL_LOG_DEBUG("[ThreadPool::ThreadPool()] Start {} worker threads.", t_workers);
+
+    m_threads.reserve(t_workers);
+    for (auto i{ 0u }; i < t_workers; ++i)
+    {
+        m_threads.emplace_back(&ThreadPool::WorkerLoop, this);
+    }
+}
+
+sg::city::thread::ThreadPool::~ThreadPool() noexcept
+{
+    {
+        std::lock_guard<std::mutex> lock{ m_mutex };
+        m_stop = true;
+    }
+
+    m_condition.notify_all();
+
+    for (auto& thread : m_threads)
+    {
+        thread.join();
+    }
+}
+
+sg::city::thread::ThreadPool& sg::city::thread::ThreadPool::Get()
+{
+    // hardware_concurrency() may return 0 if unknown
+    static ThreadPool threadPool{ std::max(std::thread::hardware_concurrency(), 1u) - 1 };
+    return threadPool;
+}
+
+//-------------------------------------------------
+// Getter
+//-------------------------------------------------
+
+uint32_t sg::city::thread::ThreadPool::GetWorkers() const noexcept
+{
+    return static_cast<uint32_t>(m_threads.size());
+}
+
+bool sg::city::thread::ThreadPool::IsInParallelFor() const noexcept
+{
+    return m_parallelFors.load() > 0;
+}
+
+//-------------------------------------------------
+// Run
+//-------------------------------------------------
+
+void sg::city::thread::ThreadPool::ParallelFor(const int t_begin, const int t_end, const int t_minBandSize, const BandFunction& t_function)
+{
+    SG_OGL_ASSERT(t_minBandSize > 0, "[ThreadPool::ParallelFor()] Invalid band size.")
+
+    const ParallelForScope parallelForScope{ m_parallelFors };
+
+    if (t_end <= t_begin)
+    {
+        return;
+    }
+
+    const auto size{ t_end - t_begin };
+    const auto maxBands{ static_cast<int>(GetWorkers() + 1) * BANDS_PER_THREAD };
+    const auto bands{ std::clamp(size / t_minBandSize, 1, maxBands) };
+
+    if (bands == 1 || m_threads.empty())
+    {
+        t_function(t_begin, t_end);
+        return;
+    }
+
+    // the state of this call; lives until all bands are done
+    std::atomic<int> openBands{ bands };
+    std::exception_ptr exception;
+    std::mutex doneMutex;
+    std::condition_variable done;
+
+    {
+        std::lock_guard<std::mutex> lock{ m_mutex };
+
+        for (auto band{ 0 }; band < bands; ++band)
+        {
+            // the first bands get one more index if the size is not divisible
+            const auto bandBegin{ t_begin + static_cast<int>(static_cast<int64_t>(size) * band / bands) };
+            const auto bandEnd{ t_begin + static_cast<int>(static_cast<int64_t>(size) * (band + 1) / bands) };
+
+            m_tasks.emplace_back([&, bandBegin, bandEnd]()
+            {
+                try
+                {
+                    t_function(bandBegin, bandEnd);
+                }
+                catch (...)
+                {
+                    std::lock_guard<std::mutex> doneLock{ doneMutex };
+                    if (!exception)
+                    {
+                        exception = std::current_exception();
+                    }
+                }
+
+                // under the lock, so that the waiting thread cannot leave before the notify
+                std::lock_guard<std::mutex> doneLock{ doneMutex };
+                if (openBands.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                {
+                    done.notify_one();
+                }
+            });
+        }
+    }
+
+    m_condition.notify_all();
+
+    // help instead of waiting idle
+    while (openBands.load(std::memory_order_acquire) > 0 && RunNextTask())
+    {
+    }
+
+    {
+        std::unique_lock<std::mutex> doneLock{ doneMutex };
+        done.wait(doneLock, [&openBands]() { return openBands.load(std::memory_order_acquire) == 0; });
+    }
+
+    if (exception)
+    {
+        std::rethrow_exception(exception);
+    }
+}
+
+//-------------------------------------------------
+// Helper
+//-------------------------------------------------
+
+void sg::city::thread::ThreadPool::WorkerLoop()
+{
+    while (true)
+    {
+        Task task;
+
+        {
+            std::unique_lock<std::mutex> lock{ m_mutex };
+            m_condition.wait(lock, [this]() { return m_stop || !m_tasks.empty(); });
+
+            if (m_stop && m_tasks.empty())
+            {
+                return;
+            }
+
+            task = std::move(m_tasks.front());
+            m_tasks.pop_front();
+        }
+
+        task();
+    }
+}
+
+bool sg::city::thread::ThreadPool::RunNextTask()
+{
+    Task task;
+
+    {
+        std::lock_guard<std::mutex> lock{ m_mutex };
+
+        if (m_tasks.empty())
+        {
+            return false;
+        }
+
+        task = std::move(m_tasks.front());
+        m_tasks.pop_front();
+    }
+
+    task();
+
+    return true;
+}
@@ -0,0 +1,121 @@
+// This file is part of the SgCityBuilder package.
+// 
+// Filename: ThreadPool.h
+// Author:   stwe
+// 
+// License:  MIT
+// 
+// 2020 (c) stwe <https://github.com/stwe/SgCityBuilder>
+
+#pragma once
+
+#include <deque>
+#include <mutex>
+#include <atomic>
+#include <vector>
+#include <thread>
+#include <cstdint>
+#include <functional>
+#include <condition_variable>
+
+namespace sg::city::thread
+{
+    /**
+     * @brief A fixed number of worker threads for the parallel stages of the startup and the simulation.
+     *        ParallelFor() splits a range into bands and returns when all bands are done,
+     *        so each call is a barrier. The calling thread works on the bands too.
+     */
+    class ThreadPool
+    {
+    public:
+        using Task = std::function<void()>;
+        using TaskContainer = std::deque<Task>;
+        using ThreadContainer = std::vector<std::thread>;
+
+        /**
+         * @brief Is called with the half-open range [begin, end) of a band.
+         */
+        using BandFunction = std::function<void(int, int)>;
+
+        //-------------------------------------------------
+        // Const
+        //-------------------------------------------------
+
+        /**
+         * @brief The number of bands per thread. More bands even out the uneven costs of the bands.
+         */
+        static constexpr auto BANDS_PER_THREAD{ 4 };
+
+        //-------------------------------------------------
+        // Ctors. / Dtor.
+        //-------------------------------------------------
+
+        /**
+         * @brief Starts the worker threads.
+         * @param t_workers The number of worker threads. With 0 all bands run on the calling thread.
+         */
+        explicit ThreadPool(uint32_t t_workers);
+
+        ThreadPool(const ThreadPool& t_other) = delete;
+        ThreadPool(ThreadPool&& t_other) noexcept = delete;
+        ThreadPool& operator=(const ThreadPool& t_other) = delete;
+        ThreadPool& operator=(ThreadPool&& t_other) noexcept = delete;
+
+        ~ThreadPool() noexcept;
+
+        /**
+         * @brief The pool of the City with one worker less than the hardware threads.
+         * @return ThreadPool
+         */
+        [[nodiscard]] static ThreadPool& Get();
+
+        //-------------------------------------------------
+        // Getter
+        //-------------------------------------------------
+
+        [[nodiscard]] uint32_t GetWorkers() const noexcept;
+
+        /**
+         * @brief Whether a ParallelFor() is running, e.g. to keep the block of a memory::Pool unchanged while bands allocate.
+         * @return bool
+         */
+        [[nodiscard]] bool IsInParallelFor() const noexcept;
+
+        //-------------------------------------------------
+        // Run
+        //-------------------------------------------------
+
+        /**
+         * @brief Calls the function for bands of [begin, end) in parallel and waits for all of them.
+         *        The bands must not write to the same data. The first exception of a band is rethrown.
+         * @param t_begin The first index.
+         * @param t_end The index behind the last one.
+         * @param t_minBandSize The smallest band. Small ranges are not worth a thread.
+         * @param t_function The function called for each band.
+         */
+        void ParallelFor(int t_begin, int t_end, int t_minBandSize, const BandFunction& t_function);
+
+    protected:
+
+    private:
+        ThreadContainer m_threads;
+        TaskContainer m_tasks;
+
+        std::mutex m_mutex;
+        std::condition_variable m_condition;
+        bool m_stop{ false };
+
+        /**
+         * @brief The number of running ParallelFor() calls.
+         */
+        std::atomic<uint32_t> m_parallelFors{ 0 };
+
+        void WorkerLoop();
+
+        /**
+         * @brief Runs the next waiting Task on the calling thread.
+         * @return False if there was no Task.
+         */
+        bool RunNextTask();
+    };
+}
@@ -1,27 +1,37 @@
 #pragma once
 
 #include <chrono>
-#include <iostream>
 
 namespace sg::city::timer
 {
+    /**
+     * @brief Measures a scope for the statistics of the ImGui menu.
+     *        Use SG_CITY_PROFILE_ZONE from Profiler.h to trace a scope.
+     */
     struct Timer
     {
         std::chrono::time_point<std::chrono::steady_clock> start, end;
         std::chrono::duration<float> duration;
 
-        Timer()
+        /**
+         * @brief Receives the measured time in ms.
+         */
+        float* result{ nullptr };
+
+        Timer() = delete;
+
+        explicit Timer(float* t_result)
+            : result{ t_result }
         {
-            start = std::chrono::high_resolution_clock::now();
+            start = std::chrono::steady_clock::now();
         }
 
         ~Timer()
         {
-            end = std::chrono::high_resolution_clock::now();
+            end = std::chrono::steady_clock::now();
             duration = end - start;
 
-            const auto ms{ duration.count() * 1000.0f };
-            std::cout << "Timer " << ms << "ms" << std::endl;
+            *result = duration.count() * 1000.0f;
         }
 
     };
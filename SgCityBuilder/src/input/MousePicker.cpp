@@ -7,6 +7,9 @@
 // 
 // 2020 (c) stwe <https://github.com/stwe/SgCityBuilder>
 
+#include <cmath>
+#include <algorithm>
+#include <limits>
 #include <Application.h>
 #include <Window.h>
 #include <camera/Camera.h>
@@ -35,7 +38,17 @@ glm::vec3 sg::city::input::MousePicker::GetCurrentMouseDirection() const
 
 glm::ivec3 sg::city::input::MousePicker::GetCurrentMapPoint() const
 {
-    return m_currentMapPoint;
+    if (!m_currentPickResult.hit)
+    {
+        return glm::ivec3(-1);
+    }
+
+    return glm::ivec3(m_currentPickResult.tile.x, 0, m_currentPickResult.tile.y);
+}
+
+const sg::city::input::PickResult& sg::city::input::MousePicker::GetCurrentPickResult() const noexcept
+{
+    return m_currentPickResult;
 }
 
 //-------------------------------------------------
@@ -44,22 +57,210 @@ glm::ivec3 sg::city::input::MousePicker::GetCurrentMapPoint() const
 
 void sg::city::input::MousePicker::Update(const float t_mouseX, const float t_mouseY)
 {
-    m_currentMouseDirection = GetDirectionFromMouse(t_mouseX, t_mouseY);
+    UpdateInverseMatrices();
+
+    const auto ray{ GetRayFromMouse(t_mouseX, t_mouseY) };
 
-    if (IntersectionInRange(m_currentMouseDirection, 0, RAY_RANGE))
+    m_currentMouseDirection = ray.direction;
+    m_currentPickResult = PickTile(ray, m_map->GetMapSize());
+}
+
+void sg::city::input::MousePicker::PickScreenPoints(const ScreenPointContainer& t_screenPoints, PickResultContainer& t_results)
+{
+    UpdateInverseMatrices();
+
+    RayContainer rays;
+    rays.reserve(t_screenPoints.size());
+
+    for (const auto& screenPoint : t_screenPoints)
     {
-        m_currentMapPoint = BinarySearch(m_currentMouseDirection, 0, RAY_RANGE, 0);
+        rays.push_back(GetRayFromMouse(screenPoint.x, screenPoint.y));
     }
+
+    PickRays(rays, t_results);
+}
+
+void sg::city::input::MousePicker::PickRays(const RayContainer& t_rays, PickResultContainer& t_results) const
+{
+    const auto mapSize{ m_map->GetMapSize() };
+
+    t_results.clear();
+    t_results.reserve(t_rays.size());
+
+    for (const auto& ray : t_rays)
+    {
+        t_results.push_back(PickTile(ray, mapSize));
+    }
+}
+
+//-------------------------------------------------
+// Raycasting
+//-------------------------------------------------
+
+sg::city::input::PickResult sg::city::input::MousePicker::PickTile(const Ray& t_ray, const int t_mapSize)
+{
+    static constexpr auto EPSILON{ 1.0e-6f };
+    static constexpr auto HEIGHT_EPSILON{ 1.0e-4f };
+    static constexpr auto INF{ std::numeric_limits<float>::max() };
+
+    PickResult result;
+
+    if (t_mapSize <= 0)
+    {
+        return result;
+    }
+
+    /*
+
+    The Map lies in the x and -z direction. In grid space the z-axis is flipped,
+    so that the Tile position is simply floor(x) and floor(-z).
+
+         -z
+          |
+          |-------
+          |   |   |
+          |-------
+          |   |   |
+          ---------- x
+
+    */
+
+    const glm::vec3 origin{ t_ray.origin.x, t_ray.origin.y, -t_ray.origin.z };
+    const glm::vec3 direction{ t_ray.direction.x, t_ray.direction.y, -t_ray.direction.z };
+
+    const auto mapSize{ static_cast<float>(t_mapSize) };
+    const glm::vec3 boxMin{ 0.0f, MIN_TERRAIN_HEIGHT, 0.0f };
+    const glm::vec3 boxMax{ mapSize, MAX_TERRAIN_HEIGHT, mapSize };
+
+    // clip the ray to the Map bounds and the terrain height slab
+    auto tMin{ 0.0f };
+    auto tMax{ INF };
+
+    for (auto axis{ 0 }; axis < 3; ++axis)
+    {
+        if (std::abs(direction[axis]) < EPSILON)
+        {
+            if (origin[axis] < boxMin[axis] || origin[axis] > boxMax[axis])
+            {
+                return result;
+            }
+
+            continue;
+        }
+
+        auto t0{ (boxMin[axis] - origin[axis]) / direction[axis] };
+        auto t1{ (boxMax[axis] - origin[axis]) / direction[axis] };
+        if (t0 > t1)
+        {
+            std::swap(t0, t1);
+        }
+
+        tMin = std::max(tMin, t0);
+        tMax = std::min(tMax, t1);
+
+        if (tMin > tMax)
+        {
+            return result;
+        }
+    }
+
+    // walk the Tiles along the ray (Amanatides & Woo)
+    const auto start{ origin + direction * tMin };
+    auto cellX{ std::clamp(static_cast<int>(std::floor(start.x)), 0, t_mapSize - 1) };
+    auto cellZ{ std::clamp(static_cast<int>(std::floor(start.z)), 0, t_mapSize - 1) };
+
+    const auto stepX{ direction.x > 0.0f ? 1 : -1 };
+    const auto stepZ{ direction.z > 0.0f ? 1 : -1 };
+
+    const auto tDeltaX{ std::abs(direction.x) < EPSILON ? INF : std::abs(1.0f / direction.x) };
+    const auto tDeltaZ{ std::abs(direction.z) < EPSILON ? INF : std::abs(1.0f / direction.z) };
+
+    auto tNextX{ std::abs(direction.x) < EPSILON ? INF : (static_cast<float>(cellX + (stepX > 0 ? 1 : 0)) - origin.x) / direction.x };
+    auto tNextZ{ std::abs(direction.z) < EPSILON ? INF : (static_cast<float>(cellZ + (stepZ > 0 ? 1 : 0)) - origin.z) / direction.z };
+
+    auto t{ tMin };
+
+    while (true)
+    {
+        const auto tExit{ std::min({ tNextX, tNextZ, tMax }) };
+        const auto height{ GetTileHeight(cellX, cellZ) };
+
+        // the lowest point of the ray within the Tile
+        const auto lowest{ std::min(origin.y + direction.y * t, origin.y + direction.y * tExit) };
+        if (lowest <= height + HEIGHT_EPSILON)
+        {
+            auto tHit{ t };
+            if (direction.y < -EPSILON)
+            {
+                tHit = std::clamp((height - origin.y) / direction.y, t, tExit);
+            }
+
+            result.hit = true;
+            result.tile = glm::ivec2(cellX, cellZ);
+            result.distance = tHit;
+            result.point = t_ray.origin + t_ray.direction * tHit;
+
+            return result;
+        }
+
+        if (tExit >= tMax)
+        {
+            break;
+        }
+
+        if (tNextX < tNextZ)
+        {
+            cellX += stepX;
+            t = tNextX;
+            tNextX += tDeltaX;
+        }
+        else
+        {
+            cellZ += stepZ;
+            t = tNextZ;
+            tNextZ += tDeltaZ;
+        }
+
+        if (cellX < 0 || cellX >= t_mapSize || cellZ < 0 || cellZ >= t_mapSize)
+        {
+            break;
+        }
+    }
+
+    return result;
+}
+
+bool sg::city::input::MousePicker::IntersectPlane(const Ray& t_ray, const float t_planeY, float& t_distance)
+{
+    if (std::abs(t_ray.direction.y) < 1.0e-6f)
+    {
+        return false;
+    }
+
+    const auto t{ (t_planeY - t_ray.origin.y) / t_ray.direction.y };
+    if (t < 0.0f)
+    {
+        return false;
+    }
+
+    t_distance = t;
+
+    return true;
 }
 
 //-------------------------------------------------
 // Mouse Ray
 //-------------------------------------------------
 
+void sg::city::input::MousePicker::UpdateInverseMatrices()
+{
+    m_inverseProjectionMatrix = inverse(m_scene->GetApplicationContext()->GetWindow().GetProjectionMatrix());
+    m_inverseViewMatrix = inverse(m_scene->GetCurrentCamera().GetViewMatrix());
+}
+
 glm::vec3 sg::city::input::MousePicker::GetDirectionFromMouse(const float t_mouseX, const float t_mouseY) const
 {
     const auto& projectionOptions{ m_scene->GetApplicationContext()->GetProjectionOptions() };
-    const auto& projectionMatrix{ m_scene->GetApplicationContext()->GetWindow().GetProjectionMatrix() };
 
     /*
 
@@ -108,13 +309,13 @@ glm::vec3 sg::city::input::MousePicker::GetDirectionFromMouse(const float t_mous
     // To get into clip space from eye space we multiply the vector by a projection matrix.
     // We can go backwards by multiplying by the inverse of this matrix.
     // range [-x:x, -y:y, -z:z, -w:w]
-    auto rayEye{ inverse(projectionMatrix) * rayClip };
+    auto rayEye{ m_inverseProjectionMatrix * rayClip };
     rayEye = glm::vec4(rayEye.x, rayEye.y, -1.0f, 0.0f);
 
     // 4d World Coordinates
     // Same again, to go back another step in the transformation pipeline.
     // range [-x:x, -y:y, -z:z, -w:w]
-    auto rayWorld{ glm::vec3(inverse(m_scene->GetCurrentCamera().GetViewMatrix()) * rayEye) };
+    auto rayWorld{ glm::vec3(m_inverseViewMatrix * rayEye) };
 
     // normalise the vector - it's just a direction
     rayWorld = normalize(rayWorld);
@@ -122,79 +323,17 @@ glm::vec3 sg::city::input::MousePicker::GetDirectionFromMouse(const float t_mous
     return rayWorld;
 }
 
-bool sg::city::input::MousePicker::IntersectionInRange(const glm::vec3& t_ray, const float t_start, float const t_finish)
-{
-    const auto startPoint{ GetPointOnRay(t_ray, t_start) };
-    const auto endPoint{ GetPointOnRay(t_ray, t_finish) };
-
-    const auto result{ !IsUnderGround(startPoint) && IsUnderGround(endPoint) };
-
-    return result;
-}
-
-glm::vec3 sg::city::input::MousePicker::BinarySearch(const glm::vec3& t_ray, const float t_start, const float t_finish, const int t_count)
+sg::city::input::Ray sg::city::input::MousePicker::GetRayFromMouse(const float t_mouseX, const float t_mouseY) const
 {
-    const auto half{ t_start + ((t_finish - t_start) / 2.0f) };
-
-    if (t_count >= RECURSION_COUNT) // end - return current point as result
-    {
-        auto result{ GetPointOnRay(t_ray, half) };
-        result.x = glm::floor(result.x);
-        result.y = 0.0f;
-        result.z = abs(glm::floor(result.z)) - 1;
-
-        return result;
-    }
-
-    // todo: try out different values
-    if (m_outsideTheMap > 50) // end - it was clicked outside the map
-    {
-        m_outsideTheMap = 0;
-        return glm::vec3(-999.0f); // -999 means that nothing was found
-    }
-
-    if (IntersectionInRange(t_ray, t_start, half))
-    {
-        return BinarySearch(t_ray, t_start, half, t_count + 1);
-    }
-
-    return BinarySearch(t_ray, half, t_finish, t_count + 1);
+    return Ray{ m_scene->GetCurrentCamera().GetPosition(), GetDirectionFromMouse(t_mouseX, t_mouseY) };
 }
 
-glm::vec3 sg::city::input::MousePicker::GetPointOnRay(const glm::vec3& t_ray, const float t_distance) const
-{
-    return m_scene->GetCurrentCamera().GetPosition() + (t_ray * t_distance);
-}
+//-------------------------------------------------
+// Helper
+//-------------------------------------------------
 
-bool sg::city::input::MousePicker::IsUnderGround(const glm::vec3& t_point)
+float sg::city::input::MousePicker::GetTileHeight(const int, const int)
 {
-    const auto mapSize{ static_cast<float>(m_map->GetMapSize()) };
-
-    // a GetHeight() method of the map can be used here
-    if (t_point.x <= mapSize && t_point.x >= 0.0f && t_point.z >= -mapSize && t_point.z <= 0.0)
-    {
-        // return t_point.y < m_map.GetHeight(t_point.x, t_point.z);
-        return t_point.y < 0.0f;
-    }
-
-    // no map height can be requested here
-
-    /*
-                               Camera position
-                              +
-        -------------       +  <------- mouse direction * distance
-        |     |     |     +
-        |     |     |   +
-        ------------- +
-        |     |    +|
-        |     |  +  |
-        -------------
-             +
-           + <-------- t_point, but outside the map, no height can determined
-    */
-
-    // the search is cancelled at a certain value
-    m_outsideTheMap++;
-
-    return t_point.y < 0.0f;
+    // the Map is flat; return m_map->GetHeight(t_mapX, t_mapZ) for a heightfield
+    return 0.0f;
 }
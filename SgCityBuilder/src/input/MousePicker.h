@@ -9,6 +9,17 @@
 
 #pragma once
 
+#include <memory>
+#include <vector>
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+#include <glm/mat4x4.hpp>
+
+namespace sg::ogl::scene
+{
+    class Scene;
+}
+
 namespace sg::city::map
 {
     class Map;
@@ -16,13 +27,41 @@ namespace sg::city::map
 
 namespace sg::city::input
 {
+    /**
+     * @brief A ray in World Space. The direction is normalized.
+     */
+    struct Ray
+    {
+        glm::vec3 origin{ 0.0f };
+        glm::vec3 direction{ 0.0f, -1.0f, 0.0f };
+    };
+
+    struct PickResult
+    {
+        bool hit{ false };
+        glm::ivec2 tile{ -1 };  // Map-x and Map-z position of the Tile
+        glm::vec3 point{ 0.0f }; // the intersection in World Space
+        float distance{ 0.0f };
+    };
+
     class MousePicker
     {
     public:
         using MapSharedPtr = std::shared_ptr<map::Map>;
+        using ScreenPointContainer = std::vector<glm::vec2>;
+        using RayContainer = std::vector<Ray>;
+        using PickResultContainer = std::vector<PickResult>;
+
+        //-------------------------------------------------
+        // Const
+        //-------------------------------------------------
 
-        static constexpr auto RECURSION_COUNT{ 200 };
-        static constexpr auto RAY_RANGE{ 600.0f };
+        /**
+         * @brief The height range of the terrain. The ray is clipped to this slab before the grid is traversed.
+         *        With a flat Map the traversal visits exactly one Tile.
+         */
+        static constexpr auto MIN_TERRAIN_HEIGHT{ 0.0f };
+        static constexpr auto MAX_TERRAIN_HEIGHT{ 0.0f };
 
         //-------------------------------------------------
         // Ctors. / Dtor.
@@ -44,14 +83,64 @@ namespace sg::city::input
         //-------------------------------------------------
 
         [[nodiscard]] glm::vec3 GetCurrentMouseDirection() const;
+
+        /**
+         * @brief Returns the Tile under the mouse of the last Update().
+         * @return The Map position in x and z; -1 if there is no Tile under the mouse.
+         */
         [[nodiscard]] glm::ivec3 GetCurrentMapPoint() const;
 
+        [[nodiscard]] const PickResult& GetCurrentPickResult() const noexcept;
+
         //-------------------------------------------------
         // Logic
         //-------------------------------------------------
 
+        /**
+         * @brief Picks the Tile under the mouse. Cheap enough to be called every frame.
+         * @param t_mouseX The x mouse position.
+         * @param t_mouseY The y mouse position.
+         */
         void Update(float t_mouseX, float t_mouseY);
 
+        /**
+         * @brief Picks the Tiles of many screen positions, e.g. of a selection rectangle.
+         *        The camera matrices are inverted only once for all positions.
+         * @param t_screenPoints The mouse positions.
+         * @param t_results Receives one result for each position.
+         */
+        void PickScreenPoints(const ScreenPointContainer& t_screenPoints, PickResultContainer& t_results);
+
+        /**
+         * @brief Picks the Tiles of many rays.
+         * @param t_rays The rays in World Space.
+         * @param t_results Receives one result for each ray.
+         */
+        void PickRays(const RayContainer& t_rays, PickResultContainer& t_results) const;
+
+        //-------------------------------------------------
+        // Raycasting
+        //-------------------------------------------------
+
+        /**
+         * @brief Intersects a ray with the Map grid. Needs no Gpu and no Scene.
+         *        The ray is clipped to the Map bounds and the terrain height slab,
+         *        then the Tiles along the ray are visited with a DDA until the ray is below a Tile.
+         * @param t_ray The ray in World Space.
+         * @param t_mapSize The number of Tiles in the x and z direction.
+         * @return PickResult
+         */
+        [[nodiscard]] static PickResult PickTile(const Ray& t_ray, int t_mapSize);
+
+        /**
+         * @brief The exact intersection with a horizontal plane.
+         * @param t_ray The ray in World Space.
+         * @param t_planeY The height of the plane.
+         * @param t_distance Receives the distance along the ray.
+         * @return True if the ray hits the plane in front of the origin.
+         */
+        [[nodiscard]] static bool IntersectPlane(const Ray& t_ray, float t_planeY, float& t_distance);
+
     protected:
 
     private:
@@ -66,16 +155,23 @@ namespace sg::city::input
         MapSharedPtr m_map;
 
         glm::vec3 m_currentMouseDirection{ glm::vec3(0.0f) };
-        glm::vec3 m_currentMapPoint{ glm::vec3(0.0f) };
+        PickResult m_currentPickResult;
 
-        int m_outsideTheMap{ 0 };
+        glm::mat4 m_inverseProjectionMatrix{ glm::mat4(1.0f) };
+        glm::mat4 m_inverseViewMatrix{ glm::mat4(1.0f) };
 
         //-------------------------------------------------
         // Mouse Ray
         //-------------------------------------------------
 
+        /**
+         * @brief Inverts the current projection and view matrix.
+         */
+        void UpdateInverseMatrices();
+
         /**
          * @brief Takes mouse position on screen and return direction in world coords.
+         *        UpdateInverseMatrices() must be called before.
          * @see http://antongerdelan.net/opengl/raycasting.html
          * @param t_mouseX The x mouse position.
          * @param t_mouseY The y mouse position.
@@ -83,18 +179,18 @@ namespace sg::city::input
          */
         [[nodiscard]] glm::vec3 GetDirectionFromMouse(float t_mouseX, float t_mouseY) const;
 
-        //-------------------------------------------------
-        // Raycasting
-        //-------------------------------------------------
-
-        [[nodiscard]] bool IntersectionInRange(const glm::vec3& t_ray, float t_start, float t_finish);
-        [[nodiscard]] glm::vec3 BinarySearch(const glm::vec3& t_ray, float t_start, float t_finish, int t_count);
+        [[nodiscard]] Ray GetRayFromMouse(float t_mouseX, float t_mouseY) const;
 
         //-------------------------------------------------
         // Helper
         //-------------------------------------------------
 
-        [[nodiscard]] glm::vec3 GetPointOnRay(const glm::vec3& t_ray, float t_distance) const;
-        [[nodiscard]] bool IsUnderGround(const glm::vec3& t_point);
+        /**
+         * @brief The height of a Tile. A GetHeight() method of the Map can be used here.
+         * @param t_mapX The Map-x position of the Tile.
+         * @param t_mapZ The Map-z position of the Tile.
+         * @return float
+         */
+        [[nodiscard]] static float GetTileHeight(int t_mapX, int t_mapZ);
     };
 }
@@ -7,13 +7,16 @@
 // 
 // 2020 (c) stwe <https://github.com/stwe/SgCityBuilder>
 
+#include <algorithm>
+#include <cstddef>
 #include <Core.h>
 #include <resource/Mesh.h>
 #include <math/Transform.h>
-#include <random>
 #include "BuildingGenerator.h"
 #include "Map.h"
 #include "city/City.h"
+#include "city/Profiler.h"
+#include "city/Gpu.h"
 
 //-------------------------------------------------
 // Ctors. / Dtor.
@@ -49,7 +52,17 @@ sg::ogl::resource::Mesh& sg::city::map::BuildingGenerator::GetMesh() noexcept
 
 uint32_t sg::city::map::BuildingGenerator::GetInstances() const
 {
-    return static_cast<int>(m_instanceDatas.size());
+    return m_instances;
+}
+
+uint32_t sg::city::map::BuildingGenerator::GetLastUploadBytes() const
+{
+    return m_lastUploadBytes;
+}
+
+uint32_t sg::city::map::BuildingGenerator::GetChunkInstances(const uint32_t t_chunkIndex) const
+{
+    return m_chunkInstances[t_chunkIndex];
 }
 
 sg::city::city::City* sg::city::map::BuildingGenerator::GetCity() const
@@ -57,31 +70,116 @@ sg::city::city::City* sg::city::map::BuildingGenerator::GetCity() const
     return m_city;
 }
 
+const sg::city::map::BuildingGenerator::BuildingInstanceContainer& sg::city::map::BuildingGenerator::GetInstanceDatas() const noexcept
+{
+    return m_instanceDatas;
+}
+
 //-------------------------------------------------
 // Add
 //-------------------------------------------------
 
 void sg::city::map::BuildingGenerator::AddBuilding(tile::BuildingTile& t_buildingTile)
 {
-    auto floors{ rand() % 10 + 1 };
-    if (floors == 1)
+    const auto tileIndex{ t_buildingTile.GetMapIndex() };
+
+    SG_OGL_ASSERT(!HasBuilding(tileIndex), "[BuildingGenerator::AddBuilding()] There is already a building on this Tile.")
+
+    auto randomStream{ m_city->GetRandom().GetStream(random::Domain::BUILDINGS, tileIndex, m_city->GetTick()) };
+
+    const auto floors{ 1u };
+    const auto colorIndex{ randomStream.NextInt(0, 255) };
+    const auto textureId{ randomStream.NextInt(1, 2) };
+
+    AddInstance(t_buildingTile, floors, static_cast<uint8_t>(colorIndex), static_cast<uint8_t>(textureId));
+}
+
+void sg::city::map::BuildingGenerator::RestoreBuilding(tile::BuildingTile& t_buildingTile, const uint32_t t_floors, const uint8_t t_colorIndex, const uint8_t t_textureId)
+{
+    SG_OGL_ASSERT(!HasBuilding(t_buildingTile.GetMapIndex()), "[BuildingGenerator::RestoreBuilding()] There is already a building on this Tile.")
+    SG_OGL_ASSERT(t_floors >= 1 && t_floors <= MAX_FLOORS, "[BuildingGenerator::RestoreBuilding()] Invalid number of floors.")
+
+    AddInstance(t_buildingTile, t_floors, t_colorIndex, t_textureId);
+}
+
+//-------------------------------------------------
+// Remove
+//-------------------------------------------------
+
+void sg::city::map::BuildingGenerator::RemoveBuilding(tile::BuildingTile& t_buildingTile)
+{
+    const auto it{ m_tileSlots.find(t_buildingTile.GetMapIndex()) };
+    if (it == m_tileSlots.end())
     {
-        floors++;
+        return;
     }
 
-    std::random_device seeder;
-    std::mt19937 engine(seeder());
+    const auto slot{ it->second };
+    m_tileSlots.erase(it);
+
+    RemoveInstance(slot, m_city->GetMap().GetChunkIndex(t_buildingTile.GetMapIndex()));
+}
 
-    std::uniform_real_distribution<float> col(0.4, 0.8);
-    const auto randomCol{ col(engine) };
+bool sg::city::map::BuildingGenerator::HasBuilding(const int t_tileIndex) const
+{
+    return m_tileSlots.count(t_tileIndex) > 0;
+}
 
-    std::uniform_int_distribution<unsigned int> text(1, 2);
-    const auto textureId{ static_cast<float>(text(engine)) };
+const sg::city::map::BuildingGenerator::BuildingInstanceData* sg::city::map::BuildingGenerator::GetBuilding(const int t_tileIndex) const
+{
+    const auto it{ m_tileSlots.find(t_tileIndex) };
+
+    return it == m_tileSlots.end() ? nullptr : &m_instanceDatas[it->second];
+}
+
+//-------------------------------------------------
+// Change
+//-------------------------------------------------
 
-    for (auto i{ 0 }; i < floors; ++i)
+void sg::city::map::BuildingGenerator::SetFloors(const int t_tileIndex, const uint32_t t_floors)
+{
+    SG_OGL_ASSERT(t_floors >= 1 && t_floors <= MAX_FLOORS, "[BuildingGenerator::SetFloors()] Invalid number of floors.")
+
+    const auto it{ m_tileSlots.find(t_tileIndex) };
+    if (it == m_tileSlots.end())
     {
-        AddFloor(t_buildingTile, glm::vec3(randomCol), textureId);
+        return;
     }
+
+    const auto slot{ it->second };
+    m_instanceDatas[slot].floors = static_cast<uint8_t>(t_floors);
+    m_dirtyInstances.Add(slot);
+}
+
+//-------------------------------------------------
+// Upload
+//-------------------------------------------------
+
+void sg::city::map::BuildingGenerator::FlushInstances()
+{
+    m_lastUploadBytes = 0;
+
+    if (m_dirtyInstances.IsEmpty())
+    {
+        return;
+    }
+
+    SG_CITY_PROFILE_ZONE("BuildingGenerator::FlushInstances");
+
+    // a swap-remove at the front and an append at the end are two small uploads
+    gpu::Gpu::BindVbo(gpu::Source::BUILDINGS, m_vboId);
+
+    for (const auto& range : m_dirtyInstances.Merge())
+    {
+        const auto offsetInBytes{ range.begin * SIZE_IN_BYTES_PER_INSTANCE };
+        const auto sizeInBytes{ (range.end - range.begin) * SIZE_IN_BYTES_PER_INSTANCE };
+
+        gpu::Gpu::BufferSubData(gpu::Source::BUILDINGS, offsetInBytes, sizeInBytes, &m_instanceDatas[range.begin]);
+
+        m_lastUploadBytes += sizeInBytes;
+    }
+
+    gpu::Gpu::UnbindVbo(gpu::Source::BUILDINGS);
 }
 
 //-------------------------------------------------
@@ -169,19 +267,33 @@ void sg::city::map::BuildingGenerator::InitVboForInstancedData()
     // create Vbo for instanced data
     m_vboId = ogl::buffer::Vbo::GenerateVbo();
 
-    const auto floatCount{ m_city->GetMap().GetNrOfAllTiles() * MAX_INSTANCES_PER_TILE * NUMBER_OF_FLOATS_PER_INSTANCE };
-    ogl::buffer::Vbo::InitEmpty(m_vboId, floatCount, GL_DYNAMIC_DRAW);
+    // each Tile can hold one building; so every Chunk has a fixed range of slots
+    const auto capacity{ static_cast<uint32_t>(m_city->GetMap().GetNrOfAllTiles()) };
+
+    m_instanceDatas.resize(capacity);
+    m_instanceTiles.assign(capacity, -1);
+    m_chunkInstances.assign(m_city->GetMap().GetChunks().size(), 0);
+
+    ogl::buffer::Vbo::BindVbo(m_vboId);
+    glBufferData(GL_ARRAY_BUFFER, capacity * SIZE_IN_BYTES_PER_INSTANCE, nullptr, GL_DYNAMIC_DRAW);
 
     // get and bind the Vao of the quad Mesh
     auto& vao{ m_quadMesh->GetVao() };
     vao.BindVao();
 
     // set attributes of the above Vbo
-    ogl::buffer::Vbo::AddInstancedAttribute(m_vboId, 3, 4, NUMBER_OF_FLOATS_PER_INSTANCE, 0); // mat4x4
-    ogl::buffer::Vbo::AddInstancedAttribute(m_vboId, 4, 4, NUMBER_OF_FLOATS_PER_INSTANCE, 4);
-    ogl::buffer::Vbo::AddInstancedAttribute(m_vboId, 5, 4, NUMBER_OF_FLOATS_PER_INSTANCE, 8);
-    ogl::buffer::Vbo::AddInstancedAttribute(m_vboId, 6, 4, NUMBER_OF_FLOATS_PER_INSTANCE, 12);
-    ogl::buffer::Vbo::AddInstancedAttribute(m_vboId, 7, 4, NUMBER_OF_FLOATS_PER_INSTANCE, 16); // 3x color, 1x use texture
+    // one instance per building
+    const auto stride{ static_cast<GLsizei>(SIZE_IN_BYTES_PER_INSTANCE) };
+
+    glEnableVertexAttribArray(3); // x, z position
+    glVertexAttribPointer(3, 2, GL_FLOAT, GL_FALSE, stride, reinterpret_cast<void*>(offsetof(BuildingInstanceData, position)));
+    glVertexAttribDivisor(3, 1);
+
+    glEnableVertexAttribArray(4); // floors, color index, texture, flags
+    glVertexAttribIPointer(4, 4, GL_UNSIGNED_BYTE, stride, reinterpret_cast<void*>(offsetof(BuildingInstanceData, floors)));
+    glVertexAttribDivisor(4, 1);
+
+    ogl::buffer::Vbo::UnbindVbo();
 
     // unbind quad Mesh Vao
     ogl::buffer::Vao::UnbindVao();
@@ -202,43 +314,93 @@ void sg::city::map::BuildingGenerator::Init()
 // Floors
 //-------------------------------------------------
 
-void sg::city::map::BuildingGenerator::AddFloor(tile::BuildingTile& t_buildingTile, const glm::vec3& t_color, const float t_textureId)
+glm::mat4 sg::city::map::BuildingGenerator::CalcFloorMatrix(const BuildingInstanceData& t_instance, const uint32_t t_floor)
 {
-    const auto floor{ t_buildingTile.floors };
-
-    SG_OGL_ASSERT(floor <= MAX_INSTANCES_PER_TILE, "[BuildingGenerator::AddFloor()] The maximum number of floors has already been reached.")
+    // the ground floor is a flat box, the upper floors are unit cubes stacked on top
+    const auto centerY{ t_floor == 0 ? 0.125f : static_cast<float>(t_floor) - 0.25f };
+    const auto scaleY{ t_floor == 0 ? 0.25f : 1.0f };
 
     ogl::math::Transform transform;
-    const auto posY{ floor == 0 ? 0.125f : 0.5f };
+    transform.position = glm::vec3(t_instance.position.x + 0.5f, centerY, t_instance.position.y - 0.5f);
+    transform.scale = glm::vec3(1.0f, scaleY, 1.0f);
 
-    float offsetY;
-    if (floor == 0)
-    {
-        offsetY = 0.0f;
-    } else if (floor == 1)
-    {
-        offsetY = 0.25f;
-    }
-    else
+    return static_cast<glm::mat4>(transform);
+}
+
+void sg::city::map::BuildingGenerator::ExpandFloors(FloorMatrixContainer& t_matrices) const
+{
+    t_matrices.clear();
+
+    const auto& chunks{ m_city->GetMap().GetChunks() };
+
+    for (auto chunkIndex{ 0u }; chunkIndex < chunks.size(); ++chunkIndex)
     {
-        offsetY = floor - 1.0f + 0.25f;
+        const auto firstSlot{ chunks[chunkIndex].firstSlot };
+
+        for (auto slot{ firstSlot }; slot < firstSlot + m_chunkInstances[chunkIndex]; ++slot)
+        {
+            const auto& instance{ m_instanceDatas[slot] };
+
+            for (auto floor{ 0u }; floor < instance.floors; ++floor)
+            {
+                t_matrices.push_back(CalcFloorMatrix(instance, floor));
+            }
+        }
     }
+}
+
+//-------------------------------------------------
+// Instances
+//-------------------------------------------------
+
+void sg::city::map::BuildingGenerator::AddInstance(tile::BuildingTile& t_buildingTile, const uint32_t t_floors, const uint8_t t_colorIndex, const uint8_t t_textureId)
+{
+    const auto tileIndex{ t_buildingTile.GetMapIndex() };
 
-    transform.position = glm::vec3(t_buildingTile.GetWorldX() + 0.5f, posY + offsetY, t_buildingTile.GetWorldZ() + -0.5f);
-    transform.scale = glm::vec3(1.0f, floor == 0 ? 0.25f : 1.0f, 1.0f);
+    BuildingInstanceData instance;
+    instance.position = glm::vec2(t_buildingTile.GetWorldX(), t_buildingTile.GetWorldZ());
+    instance.floors = static_cast<uint8_t>(t_floors);
+    instance.colorIndex = t_colorIndex;
+    instance.textureId = t_textureId;
+    instance.flags = 0;
 
-    const auto useTexture{ floor == 0 ? 0.0f : t_textureId };
-    m_instanceDatas.push_back({ static_cast<glm::mat4>(transform), glm::vec4(t_color, useTexture) } );
+    // append to the buildings of the Chunk
+    const auto& map{ m_city->GetMap() };
+    const auto chunkIndex{ map.GetChunkIndex(tileIndex) };
+    const auto& chunk{ map.GetChunks()[chunkIndex] };
 
-    const auto instances{ GetInstances() };
-    if (instances > 0)
+    SG_OGL_ASSERT(m_chunkInstances[chunkIndex] < chunk.tileCount, "[BuildingGenerator::AddInstance()] Too many buildings in the Chunk.")
+
+    const auto slot{ chunk.firstSlot + m_chunkInstances[chunkIndex] };
+
+    m_instanceDatas[slot] = instance;
+    m_instanceTiles[slot] = tileIndex;
+    m_tileSlots.emplace(tileIndex, slot);
+
+    m_chunkInstances[chunkIndex]++;
+    m_instances++;
+
+    m_dirtyInstances.Add(slot);
+}
+
+void sg::city::map::BuildingGenerator::RemoveInstance(const uint32_t t_slot, const uint32_t t_chunkIndex)
+{
+    const auto lastSlot{ m_city->GetMap().GetChunks()[t_chunkIndex].firstSlot + m_chunkInstances[t_chunkIndex] - 1 };
+
+    if (t_slot != lastSlot)
     {
-        const auto sizeInBytes{ instances * NUMBER_OF_FLOATS_PER_INSTANCE * static_cast<uint32_t>(sizeof(float)) };
+        // move the last instance into the gap
+        m_instanceDatas[t_slot] = m_instanceDatas[lastSlot];
+        m_instanceTiles[t_slot] = m_instanceTiles[lastSlot];
 
-        ogl::buffer::Vbo::BindVbo(m_vboId);
-        glBufferSubData(GL_ARRAY_BUFFER, 0, sizeInBytes, m_instanceDatas.data());
-        ogl::buffer::Vbo::UnbindVbo();
+        // the owner of the moved instance has to know the new slot
+        m_tileSlots.at(m_instanceTiles[t_slot]) = t_slot;
+
+        m_dirtyInstances.Add(t_slot);
     }
 
-    t_buildingTile.floors++;
+    m_instanceTiles[lastSlot] = -1;
+
+    m_chunkInstances[t_chunkIndex]--;
+    m_instances--;
 }
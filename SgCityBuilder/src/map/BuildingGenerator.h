@@ -9,6 +9,9 @@
 
 #pragma once
 
+#include <glm/vec2.hpp>
+#include <glm/mat4x4.hpp>
+#include "DirtyRanges.h"
 #include "tile/BuildingTile.h"
 
 namespace sg::city::city
@@ -18,18 +21,33 @@ namespace sg::city::city
 
 namespace sg::city::map
 {
+    /**
+     * @brief Holds one instance per building. The instances of a Chunk are kept dense:
+     *        a removed building is replaced by the last building of its Chunk (swap-remove).
+     */
     class BuildingGenerator
     {
     public:
+        /**
+         * @brief One instance per building. The vertex shader stretches the box to the floors.
+         */
         struct BuildingInstanceData
         {
-            glm::mat4 transformationMatrix;
-            glm::vec4 color;
+            glm::vec2 position;  // the x and z position of the Tile in World Space
+            uint8_t floors;      // the number of floors including the ground floor
+            uint8_t colorIndex;  // 0 .. 255 is mapped to a gray value from MIN_COLOR to MAX_COLOR
+            uint8_t textureId;   // the texture of the upper floors: 1 or 2
+            uint8_t flags;       // unused
         };
 
         using MeshUniquePtr = std::unique_ptr<ogl::resource::Mesh>;
         using VertexContainer = std::vector<float>;
-        using BuildingInstanceContainer = std::vector<BuildingInstanceData>;
+        using BuildingInstanceContainer = memory::TrackedVector<BuildingInstanceData, memory::Tag::BUILDINGS>;
+
+        using TileSlotContainer = std::unordered_map<int, uint32_t, std::hash<int>, std::equal_to<int>, memory::TrackingAllocator<std::pair<const int, uint32_t>, memory::Tag::BUILDINGS>>;
+        using InstanceTileContainer = memory::TrackedVector<int, memory::Tag::BUILDINGS>;
+        using ChunkInstancesContainer = memory::TrackedVector<uint32_t, memory::Tag::BUILDINGS>;
+        using FloorMatrixContainer = std::vector<glm::mat4>;
 
         //-------------------------------------------------
         // Const
@@ -37,17 +55,19 @@ namespace sg::city::map
 
         static constexpr auto DRAW_COUNT{ 36 };
 
-        // 4x4 tranformation Matrix                                                    = 16 floats
-        // 3x  color                                                                   =  3 floats
-        // 1x  texture flag (use the colors alpha value: 0 = use texture, 1 use color) =  1 float
-        //                                                                             -----------
-        //                                                                             = 20 floats
-        static constexpr uint32_t NUMBER_OF_FLOATS_PER_INSTANCE{ 20 };
+        // 2x  float position                         =  8 bytes
+        // 4x  uint8 floors, color, texture, flags   =  4 bytes
+        //                                           -----------
+        //                                           = 12 bytes
+        static constexpr uint32_t SIZE_IN_BYTES_PER_INSTANCE{ 12 };
 
         /**
-         * @brief Required to calculate the maximum number of quads instances.
+         * @brief The maximum number of floors of a building.
          */
-        static constexpr uint32_t MAX_INSTANCES_PER_TILE{ 10 };
+        static constexpr uint32_t MAX_FLOORS{ 10 };
+
+        static constexpr auto MIN_COLOR{ 0.4f };
+        static constexpr auto MAX_COLOR{ 0.8f };
 
         //-------------------------------------------------
         // Ctors. / Dtor.
@@ -71,15 +91,117 @@ namespace sg::city::map
         [[nodiscard]] const ogl::resource::Mesh& GetMesh() const noexcept;
         [[nodiscard]] ogl::resource::Mesh& GetMesh() noexcept;
 
+        /**
+         * @brief Returns the number of buildings.
+         * @return uint32_t
+         */
         [[nodiscard]] uint32_t GetInstances() const;
+
+        /**
+         * @brief Returns the number of bytes uploaded by the last flush.
+         * @return uint32_t
+         */
+        [[nodiscard]] uint32_t GetLastUploadBytes() const;
+
+        /**
+         * @brief Returns the number of buildings in a Chunk.
+         *        The buildings of a Chunk are stored from the first slot of the Chunk.
+         * @param t_chunkIndex The index of the Chunk in the Map.
+         * @return uint32_t
+         */
+        [[nodiscard]] uint32_t GetChunkInstances(uint32_t t_chunkIndex) const;
+
         [[nodiscard]] city::City* GetCity() const;
 
+        /**
+         * @brief Returns all slots. Only the first GetChunkInstances() slots of each Chunk are used.
+         * @return BuildingInstanceContainer
+         */
+        [[nodiscard]] const BuildingInstanceContainer& GetInstanceDatas() const noexcept;
+
         //-------------------------------------------------
         // Add
         //-------------------------------------------------
 
+        /**
+         * @brief Adds a new building with only the ground floor to the staging buffer.
+         *        The floors are added later by the population growth.
+         *        The new instance is not visible until FlushInstances() is called.
+         * @param t_buildingTile The Tile on which the building is placed.
+         */
         void AddBuilding(tile::BuildingTile& t_buildingTile);
 
+        /**
+         * @brief Adds a saved building. Unlike AddBuilding() nothing is drawn from the random service.
+         *        The new instance is not visible until FlushInstances() is called.
+         * @param t_buildingTile The Tile on which the building is placed.
+         * @param t_floors The number of floors including the ground floor: 1 .. MAX_FLOORS.
+         * @param t_colorIndex The gray value of the building.
+         * @param t_textureId The texture of the upper floors.
+         */
+        void RestoreBuilding(tile::BuildingTile& t_buildingTile, uint32_t t_floors, uint8_t t_colorIndex, uint8_t t_textureId);
+
+        //-------------------------------------------------
+        // Remove
+        //-------------------------------------------------
+
+        /**
+         * @brief Removes the building on the given Tile.
+         *        The gap is filled with the last instance of the Chunk, so the instances of each Chunk stay dense.
+         * @param t_buildingTile The Tile from which the building is removed.
+         */
+        void RemoveBuilding(tile::BuildingTile& t_buildingTile);
+
+        [[nodiscard]] bool HasBuilding(int t_tileIndex) const;
+
+        /**
+         * @brief Returns the instance of the building on a Tile.
+         * @param t_tileIndex The index of the Tile.
+         * @return nullptr if there is no building.
+         */
+        [[nodiscard]] const BuildingInstanceData* GetBuilding(int t_tileIndex) const;
+
+        //-------------------------------------------------
+        // Change
+        //-------------------------------------------------
+
+        /**
+         * @brief Changes the number of floors of the building on the given Tile.
+         *        Only the instance of this building is marked for the next upload.
+         * @param t_tileIndex The index of the Tile. Nothing happens if there is no building.
+         * @param t_floors The new number of floors including the ground floor: 1 .. MAX_FLOORS.
+         */
+        void SetFloors(int t_tileIndex, uint32_t t_floors);
+
+        //-------------------------------------------------
+        // Upload
+        //-------------------------------------------------
+
+        /**
+         * @brief Uploads the instances changed since the last call, one glBufferSubData per merged range.
+         *        Should be called once per frame or once per batch.
+         */
+        void FlushInstances();
+
+        //-------------------------------------------------
+        // Floors
+        //-------------------------------------------------
+
+        /**
+         * @brief Calculates the transformation matrix of a floor on the Cpu.
+         *        The vertex shader draws the same floors as one stacked box; both must be kept in sync.
+         * @param t_instance The building.
+         * @param t_floor The floor: 0 is the ground floor.
+         * @return glm::mat4
+         */
+        [[nodiscard]] static glm::mat4 CalcFloorMatrix(const BuildingInstanceData& t_instance, uint32_t t_floor);
+
+        /**
+         * @brief Expands all buildings into one matrix per floor without a Gpu.
+         * @param t_matrices Receives the matrices.
+         */
+        void ExpandFloors(FloorMatrixContainer& t_matrices) const;
+
     protected:
 
     private:
@@ -99,10 +221,38 @@ namespace sg::city::map
         uint32_t m_vboId{ 0 };
 
         /**
-         * @brief The the instances data.
+         * @brief The instances data. Used as staging buffer for the Vbo.
+         *        Each Chunk owns the slots of its Tiles; a Chunk cannot have more buildings than Tiles.
          */
         BuildingInstanceContainer m_instanceDatas;
 
+        /**
+         * @brief The Tile index of each instance. Needed to fix the slot after a swap-remove.
+         */
+        InstanceTileContainer m_instanceTiles;
+
+        /**
+         * @brief The number of buildings of each Chunk.
+         */
+        ChunkInstancesContainer m_chunkInstances;
+
+        /**
+         * @brief The number of buildings.
+         */
+        uint32_t m_instances{ 0 };
+
+        /**
+         * @brief The instance slot of each building, keyed by Tile index.
+         */
+        TileSlotContainer m_tileSlots;
+
+        /**
+         * @brief The instances changed since the last upload.
+         */
+        DirtyRanges m_dirtyInstances;
+
+        uint32_t m_lastUploadBytes{ 0 };
+
         //-------------------------------------------------
         // Init
         //-------------------------------------------------
@@ -112,9 +262,12 @@ namespace sg::city::map
         void Init();
 
         //-------------------------------------------------
-        // Floors
+        // Instances
         //-------------------------------------------------
 
-        void AddFloor(tile::BuildingTile& t_buildingTile, const glm::vec3& t_color, float t_textureId);
+        void AddInstance(tile::BuildingTile& t_buildingTile, uint32_t t_floors, uint8_t t_colorIndex, uint8_t t_textureId);
+        void RemoveInstance(uint32_t t_slot, uint32_t t_chunkIndex);
     };
+
+    static_assert(sizeof(BuildingGenerator::BuildingInstanceData) == BuildingGenerator::SIZE_IN_BYTES_PER_INSTANCE);
 }
@@ -0,0 +1,45 @@
+// This file is part of the SgCityBuilder package.
+// 
+// Filename: Chunk.h
+// Author:   stwe
+// 
+// License:  MIT
+// 
+// 2020 (c) stwe <https://github.com/stwe/SgCityBuilder>
+
+#pragma once
+
+#include <cstdint>
+#include <glm/vec3.hpp>
+
+namespace sg::city::map
+{
+    /**
+     * @brief A square block of Tiles that is culled and drawn as a whole.
+     *        The Tiles of a Chunk are stored one after the other in the Tile attribute Vbo,
+     *        so the terrain and the roads of a Chunk are one instance range.
+     */
+    struct Chunk
+    {
+        /**
+         * @brief The number of Tiles in the x and z direction.
+         */
+        static constexpr auto SIZE{ 64 };
+
+        /**
+         * @brief The height of the bounds: the top of the highest building.
+         */
+        static constexpr auto MAX_HEIGHT{ 10.0f };
+
+        int originX{ 0 }; // the Map-x position of the first Tile
+        int originZ{ 0 }; // the Map-z position of the first Tile
+        int width{ 0 };   // the Chunks at the right and top edge can be smaller than SIZE
+        int depth{ 0 };
+
+        uint32_t firstSlot{ 0 }; // the first instance in the Tile attribute Vbo
+        uint32_t tileCount{ 0 };
+
+        glm::vec3 boundsMin{ 0.0f }; // Object Space
+        glm::vec3 boundsMax{ 0.0f };
+    };
+}
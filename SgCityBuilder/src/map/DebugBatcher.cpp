@@ -0,0 +1,241 @@
+// This file is part of the SgCityBuilder package.
+// 
+// Filename: DebugBatcher.cpp
+// Author:   stwe
+// 
+// License:  MIT
+// 
+// 2020 (c) stwe <https://github.com/stwe/SgCityBuilder>
+
+#include <algorithm>
+#include <Core.h>
+#include <resource/Mesh.h>
+#include "DebugBatcher.h"
+#include "city/Gpu.h"
+
+//-------------------------------------------------
+// Ctors. / Dtor.
+//-------------------------------------------------
+
+sg::city::map::DebugBatcher::DebugBatcher()
+{
+    SG_OGL_LOG_DEBUG("[DebugBatcher::DebugBatcher()] Construct DebugBatcher.");
+
+    InitBuffer(GetBuffer(Layer::LINES), LINE_VERTICES_PER_BLOCK);
+    InitBuffer(GetBuffer(Layer::POINTS), POINT_VERTICES_PER_BLOCK);
+}
+
+sg::city::map::DebugBatcher::~DebugBatcher() noexcept
+{
+    SG_OGL_LOG_DEBUG("[DebugBatcher::~DebugBatcher()] Destruct DebugBatcher.");
+}
+
+//-------------------------------------------------
+// Getter
+//-------------------------------------------------
+
+uint32_t sg::city::map::DebugBatcher::GetTiles(const Layer t_layer) const
+{
+    return static_cast<uint32_t>(GetBuffer(t_layer).tileBlocks.size());
+}
+
+//-------------------------------------------------
+// Change
+//-------------------------------------------------
+
+void sg::city::map::DebugBatcher::SetVertices(const Layer t_layer, const int t_tileIndex, const ScratchVertexContainer& t_vertices)
+{
+    SG_OGL_ASSERT(t_vertices.size() % FLOATS_PER_VERTEX == 0, "[DebugBatcher::SetVertices()] Invalid number of floats.")
+
+    if (t_vertices.empty())
+    {
+        Remove(t_layer, t_tileIndex);
+        return;
+    }
+
+    auto& buffer{ GetBuffer(t_layer) };
+
+    auto vertexCount{ static_cast<uint32_t>(t_vertices.size()) / FLOATS_PER_VERTEX };
+    if (vertexCount > buffer.blockVertices)
+    {
+        SG_OGL_LOG_WARN("[DebugBatcher::SetVertices()] Too many vertices for Tile {}. Only {} are shown.", t_tileIndex, buffer.blockVertices);
+        vertexCount = buffer.blockVertices;
+    }
+
+    const auto it{ buffer.tileBlocks.find(t_tileIndex) };
+    const auto block{ it != buffer.tileBlocks.end() ? it->second : AllocateBlock(buffer) };
+    buffer.tileBlocks[t_tileIndex] = block;
+
+    const auto first{ block * buffer.blockVertices };
+    std::copy_n(t_vertices.begin(), vertexCount * FLOATS_PER_VERTEX, buffer.vertices.begin() + first * FLOATS_PER_VERTEX);
+
+    buffer.counts[block] = static_cast<int32_t>(vertexCount);
+    buffer.dirty.AddRange(first, first + vertexCount);
+}
+
+void sg::city::map::DebugBatcher::SetColor(const Layer t_layer, const int t_tileIndex, const uint32_t t_vertex, const glm::vec3& t_color)
+{
+    auto& buffer{ GetBuffer(t_layer) };
+
+    const auto it{ buffer.tileBlocks.find(t_tileIndex) };
+    if (it == buffer.tileBlocks.end() || static_cast<int32_t>(t_vertex) >= buffer.counts[it->second])
+    {
+        return;
+    }
+
+    const auto vertex{ it->second * buffer.blockVertices + t_vertex };
+    const auto offset{ vertex * FLOATS_PER_VERTEX + 3 };
+
+    buffer.vertices[offset + 0] = t_color.x;
+    buffer.vertices[offset + 1] = t_color.y;
+    buffer.vertices[offset + 2] = t_color.z;
+
+    buffer.dirty.Add(vertex);
+}
+
+void sg::city::map::DebugBatcher::Remove(const Layer t_layer, const int t_tileIndex)
+{
+    auto& buffer{ GetBuffer(t_layer) };
+
+    const auto it{ buffer.tileBlocks.find(t_tileIndex) };
+    if (it == buffer.tileBlocks.end())
+    {
+        return;
+    }
+
+    // the vertices can stay in the Vbo; a block with count 0 is not drawn
+    buffer.counts[it->second] = 0;
+    buffer.freeBlocks.push_back(it->second);
+    buffer.tileBlocks.erase(it);
+}
+
+//-------------------------------------------------
+// Upload
+//-------------------------------------------------
+
+void sg::city::map::DebugBatcher::Flush()
+{
+    for (auto& buffer : m_buffers)
+    {
+        FlushBuffer(buffer);
+    }
+}
+
+//-------------------------------------------------
+// Draw
+//-------------------------------------------------
+
+void sg::city::map::DebugBatcher::Draw(const Layer t_layer) const
+{
+    const auto& buffer{ GetBuffer(t_layer) };
+
+    if (buffer.tileBlocks.empty())
+    {
+        return;
+    }
+
+    gpu::Gpu::InitDraw(gpu::Source::DEBUG, *buffer.mesh);
+    gpu::Gpu::MultiDraw(
+        gpu::Source::DEBUG,
+        t_layer == Layer::LINES ? gpu::Primitive::LINES : gpu::Primitive::POINTS,
+        buffer.firsts.data(),
+        buffer.counts.data(),
+        buffer.usedBlocks
+    );
+    gpu::Gpu::EndDraw(gpu::Source::DEBUG, *buffer.mesh);
+}
+
+//-------------------------------------------------
+// Helper
+//-------------------------------------------------
+
+sg::city::map::DebugBatcher::Buffer& sg::city::map::DebugBatcher::GetBuffer(const Layer t_layer)
+{
+    return m_buffers[static_cast<size_t>(t_layer)];
+}
+
+const sg::city::map::DebugBatcher::Buffer& sg::city::map::DebugBatcher::GetBuffer(const Layer t_layer) const
+{
+    return m_buffers[static_cast<size_t>(t_layer)];
+}
+
+void sg::city::map::DebugBatcher::InitBuffer(Buffer& t_buffer, const uint32_t t_blockVertices)
+{
+    t_buffer.blockVertices = t_blockVertices;
+    t_buffer.capacity = INITIAL_BLOCKS;
+    t_buffer.vertices.resize(static_cast<size_t>(t_buffer.capacity) * t_blockVertices * FLOATS_PER_VERTEX);
+
+    t_buffer.mesh = std::make_unique<ogl::resource::Mesh>();
+    t_buffer.mesh->GetVao().BindVao();
+
+    t_buffer.vboId = ogl::buffer::Vbo::GenerateVbo();
+    ogl::buffer::Vbo::BindVbo(t_buffer.vboId);
+    glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(t_buffer.vertices.size() * sizeof(float)), nullptr, GL_DYNAMIC_DRAW);
+    ogl::buffer::Vbo::AddAttribute(t_buffer.vboId, 0, 3, FLOATS_PER_VERTEX, 0); // 3x position
+    ogl::buffer::Vbo::AddAttribute(t_buffer.vboId, 1, 3, FLOATS_PER_VERTEX, 3); // 3x color
+    ogl::buffer::Vbo::UnbindVbo();
+
+    ogl::buffer::Vao::UnbindVao();
+}
+
+uint32_t sg::city::map::DebugBatcher::AllocateBlock(Buffer& t_buffer)
+{
+    if (!t_buffer.freeBlocks.empty())
+    {
+        const auto block{ t_buffer.freeBlocks.back() };
+        t_buffer.freeBlocks.pop_back();
+
+        return block;
+    }
+
+    if (t_buffer.usedBlocks == t_buffer.capacity)
+    {
+        // the Vbo is reallocated and refilled with the next flush
+        t_buffer.capacity *= 2;
+        t_buffer.vertices.resize(static_cast<size_t>(t_buffer.capacity) * t_buffer.blockVertices * FLOATS_PER_VERTEX);
+        t_buffer.reallocate = true;
+    }
+
+    const auto block{ t_buffer.usedBlocks++ };
+    t_buffer.firsts.push_back(static_cast<int32_t>(block * t_buffer.blockVertices));
+    t_buffer.counts.push_back(0);
+
+    return block;
+}
+
+void sg::city::map::DebugBatcher::FlushBuffer(Buffer& t_buffer)
+{
+    const auto bytesPerVertex{ static_cast<uint64_t>(FLOATS_PER_VERTEX * sizeof(float)) };
+
+    if (t_buffer.reallocate)
+    {
+        // glBufferData keeps the Vbo Id, so the attributes of the Vao are still valid
+        gpu::Gpu::BindVbo(gpu::Source::DEBUG, t_buffer.vboId);
+        gpu::Gpu::BufferData(gpu::Source::DEBUG, t_buffer.vertices.size() * sizeof(float), t_buffer.vertices.data());
+        gpu::Gpu::UnbindVbo(gpu::Source::DEBUG);
+
+        t_buffer.dirty.Merge();
+        t_buffer.reallocate = false;
+
+        return;
+    }
+
+    if (t_buffer.dirty.IsEmpty())
+    {
+        return;
+    }
+
+    gpu::Gpu::BindVbo(gpu::Source::DEBUG, t_buffer.vboId);
+
+    for (const auto& range : t_buffer.dirty.Merge())
+    {
+        gpu::Gpu::BufferSubData(
+            gpu::Source::DEBUG,
+            range.begin * bytesPerVertex,
+            (range.end - range.begin) * bytesPerVertex,
+            &t_buffer.vertices[static_cast<size_t>(range.begin) * FLOATS_PER_VERTEX]
+        );
+    }
+
+    gpu::Gpu::UnbindVbo(gpu::Source::DEBUG);
+}
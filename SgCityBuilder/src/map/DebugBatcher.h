@@ -0,0 +1,170 @@
+// This file is part of the SgCityBuilder package.
+// 
+// Filename: DebugBatcher.h
+// Author:   stwe
+// 
+// License:  MIT
+// 
+// 2020 (c) stwe <https://github.com/stwe/SgCityBuilder>
+
+#pragma once
+
+#include <array>
+#include <memory>
+#include <vector>
+#include <memory_resource>
+#include <unordered_map>
+#include <glm/vec3.hpp>
+#include "DirtyRanges.h"
+#include "city/Memory.h"
+
+namespace sg::ogl::resource
+{
+    class Mesh;
+}
+
+namespace sg::city::map
+{
+    /**
+     * @brief Collects the debug geometry of all Tiles in one line buffer and one point buffer.
+     *        Each Tile owns a fixed-size block of vertices, so a Tile can be re-emitted
+     *        or recolored without touching the other Tiles. Each buffer is drawn with a single call.
+     */
+    class DebugBatcher
+    {
+    public:
+        enum class Layer
+        {
+            LINES,
+            POINTS
+        };
+
+        using MeshUniquePtr = std::unique_ptr<ogl::resource::Mesh>;
+        using VertexContainer = memory::TrackedVector<float, memory::Tag::VERTICES>;
+        using ScratchVertexContainer = std::pmr::vector<float>;
+        using TileBlockContainer = std::unordered_map<int, uint32_t>;
+        using BlockContainer = std::vector<uint32_t>;
+        using FirstContainer = std::vector<int32_t>;
+        using CountContainer = std::vector<int32_t>;
+
+        //-------------------------------------------------
+        // Const
+        //-------------------------------------------------
+
+        static constexpr uint32_t FLOATS_PER_VERTEX{ 6 }; // 3x position + 3x color
+
+        /**
+         * @brief The line vertices of a Tile: 2 per Auto Track.
+         */
+        static constexpr uint32_t LINE_VERTICES_PER_BLOCK{ 64 };
+
+        /**
+         * @brief The point vertices of a Tile: 1 per Navigation Node.
+         */
+        static constexpr uint32_t POINT_VERTICES_PER_BLOCK{ 49 };
+
+        /**
+         * @brief The initial number of blocks of each buffer. The buffers grow geometrically.
+         */
+        static constexpr uint32_t INITIAL_BLOCKS{ 64 };
+
+        //-------------------------------------------------
+        // Ctors. / Dtor.
+        //-------------------------------------------------
+
+        DebugBatcher();
+
+        DebugBatcher(const DebugBatcher& t_other) = delete;
+        DebugBatcher(DebugBatcher&& t_other) noexcept = delete;
+        DebugBatcher& operator=(const DebugBatcher& t_other) = delete;
+        DebugBatcher& operator=(DebugBatcher&& t_other) noexcept = delete;
+
+        ~DebugBatcher() noexcept;
+
+        //-------------------------------------------------
+        // Getter
+        //-------------------------------------------------
+
+        /**
+         * @brief Returns the number of Tiles with geometry in the given layer.
+         * @param t_layer The layer.
+         * @return uint32_t
+         */
+        [[nodiscard]] uint32_t GetTiles(Layer t_layer) const;
+
+        //-------------------------------------------------
+        // Change
+        //-------------------------------------------------
+
+        /**
+         * @brief Replaces the geometry of a Tile. An empty container removes the Tile.
+         * @param t_layer The layer.
+         * @param t_tileIndex The index of the Tile in the Map.
+         * @param t_vertices 3x position + 3x color for each vertex. Usually built in the FrameArena.
+         */
+        void SetVertices(Layer t_layer, int t_tileIndex, const ScratchVertexContainer& t_vertices);
+
+        /**
+         * @brief Changes the color of a single vertex of a Tile.
+         * @param t_layer The layer.
+         * @param t_tileIndex The index of the Tile in the Map.
+         * @param t_vertex The vertex index within the Tile.
+         * @param t_color The new color.
+         */
+        void SetColor(Layer t_layer, int t_tileIndex, uint32_t t_vertex, const glm::vec3& t_color);
+
+        void Remove(Layer t_layer, int t_tileIndex);
+
+        //-------------------------------------------------
+        // Upload
+        //-------------------------------------------------
+
+        /**
+         * @brief Uploads the changed vertices of both buffers. Should be called once per frame.
+         */
+        void Flush();
+
+        //-------------------------------------------------
+        // Draw
+        //-------------------------------------------------
+
+        /**
+         * @brief Draws all Tiles of a layer with one glMultiDrawArrays.
+         *        The shader must be bound by the caller.
+         * @param t_layer The layer.
+         */
+        void Draw(Layer t_layer) const;
+
+    protected:
+
+    private:
+        struct Buffer
+        {
+            MeshUniquePtr mesh;
+            uint32_t vboId{ 0 };
+            uint32_t blockVertices{ 0 };
+            uint32_t capacity{ 0 };        // in blocks
+            uint32_t usedBlocks{ 0 };      // the blocks behind are never used
+            VertexContainer vertices;      // staging buffer
+            FirstContainer firsts;         // the first vertex of each block
+            CountContainer counts;         // the used vertices of each block
+            TileBlockContainer tileBlocks; // the block of each Tile
+            BlockContainer freeBlocks;
+            DirtyRanges dirty;             // in vertices
+            bool reallocate{ false };
+        };
+
+        std::array<Buffer, 2> m_buffers;
+
+        //-------------------------------------------------
+        // Helper
+        //-------------------------------------------------
+
+        [[nodiscard]] Buffer& GetBuffer(Layer t_layer);
+        [[nodiscard]] const Buffer& GetBuffer(Layer t_layer) const;
+
+        static void InitBuffer(Buffer& t_buffer, uint32_t t_blockVertices);
+        static uint32_t AllocateBlock(Buffer& t_buffer);
+        static void FlushBuffer(Buffer& t_buffer);
+    };
+}
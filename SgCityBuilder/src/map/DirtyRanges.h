@@ -0,0 +1,127 @@
+// This file is part of the SgCityBuilder package.
+// 
+// Filename: DirtyRanges.h
+// Author:   stwe
+// 
+// License:  MIT
+// 
+// 2020 (c) stwe <https://github.com/stwe/SgCityBuilder>
+
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+
+namespace sg::city::map
+{
+    /**
+     * @brief Collects the changed slots of a buffer during a frame and merges them
+     *        into as few contiguous ranges as possible before the upload.
+     */
+    class DirtyRanges
+    {
+    public:
+        struct Range
+        {
+            uint32_t begin{ 0 };
+            uint32_t end{ 0 }; // one past the last slot
+        };
+
+        using RangeContainer = std::vector<Range>;
+
+        //-------------------------------------------------
+        // Const
+        //-------------------------------------------------
+
+        /**
+         * @brief Two ranges are merged if there are not more than this number of clean slots between them.
+         *        Uploading a few clean slots is cheaper than another glBufferSubData.
+         */
+        static constexpr uint32_t DEFAULT_MAX_GAP{ 16 };
+
+        //-------------------------------------------------
+        // Ctors. / Dtor.
+        //-------------------------------------------------
+
+        explicit DirtyRanges(const uint32_t t_maxGap = DEFAULT_MAX_GAP)
+            : m_maxGap{ t_maxGap }
+        {
+        }
+
+        //-------------------------------------------------
+        // Getter
+        //-------------------------------------------------
+
+        [[nodiscard]] bool IsEmpty() const
+        {
+            return m_ranges.empty();
+        }
+
+        //-------------------------------------------------
+        // Add
+        //-------------------------------------------------
+
+        void Add(const uint32_t t_slot)
+        {
+            AddRange(t_slot, t_slot + 1);
+        }
+
+        void AddRange(const uint32_t t_begin, const uint32_t t_end)
+        {
+            if (t_begin < t_end)
+            {
+                m_ranges.push_back({ t_begin, t_end });
+            }
+        }
+
+        //-------------------------------------------------
+        // Merge
+        //-------------------------------------------------
+
+        /**
+         * @brief Sorts and merges the collected ranges. The tracker is empty afterwards.
+         * @return The merged ranges; valid until the next call.
+         */
+        const RangeContainer& Merge()
+        {
+            m_merged.clear();
+
+            std::sort(m_ranges.begin(), m_ranges.end(), [](const Range& t_lhs, const Range& t_rhs)
+            {
+                return t_lhs.begin < t_rhs.begin;
+            });
+
+            for (const auto& range : m_ranges)
+            {
+                if (!m_merged.empty() && range.begin <= m_merged.back().end + m_maxGap)
+                {
+                    m_merged.back().end = std::max(m_merged.back().end, range.end);
+                }
+                else
+                {
+                    m_merged.push_back(range);
+                }
+            }
+
+            m_ranges.clear();
+
+            return m_merged;
+        }
+
+    protected:
+
+    private:
+        uint32_t m_maxGap{ DEFAULT_MAX_GAP };
+
+        /**
+         * @brief The ranges added since the last merge; unsorted and maybe overlapping.
+         */
+        RangeContainer m_ranges;
+
+        /**
+         * @brief The result of the last merge. Kept to reuse the memory.
+         */
+        RangeContainer m_merged;
+    };
+}
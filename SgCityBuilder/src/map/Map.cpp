@@ -7,8 +7,8 @@
 // 
 // 2020 (c) stwe <https://github.com/stwe/SgCityBuilder>
 
-#include <iostream>
-#include <random>
+#include <array>
+#include <algorithm>
 #include <Color.h>
 #include <Application.h>
 #include <Window.h>
@@ -19,6 +19,16 @@
 #include <resource/TextureManager.h>
 #include <math/Transform.h>
 #include "Map.h"
+#include "Build.h"
+#include "DebugBatcher.h"
+#include "MapImporter.h"
+#include "city/Profiler.h"
+#include "city/Gpu.h"
+#include "city/FrameArena.h"
+#include "city/Frustum.h"
+#include "city/ThreadPool.h"
+#include "city/Timer.h"
+#include "city/SaveGame.h"
 #include "shader/LineShader.h"
 #include "shader/NodeShader.h"
 #include "automata/AutoNode.h"
@@ -29,18 +39,29 @@
 // Ctors. / Dtor.
 //-------------------------------------------------
 
-sg::city::map::Map::Map(ogl::scene::Scene* t_scene, std::string t_mapFileName)
+sg::city::map::Map::Map(ogl::scene::Scene* t_scene, std::string t_mapFileName, const random::Random& t_random)
     : m_scene{ t_scene }
     , m_mapFileName{ std::move(t_mapFileName) }
+    , m_random{ t_random }
 {
-    SG_OGL_ASSERT(t_scene, "[Map::Map()] Null pointer.")
-
     SG_OGL_LOG_DEBUG("[Map::Map()] Construct Map.");
 }
 
 sg::city::map::Map::~Map() noexcept
 {
     SG_OGL_LOG_DEBUG("[Map::~Map()] Destruct Map.");
+
+    if (m_paletteTextureId)
+    {
+        glDeleteTextures(1, &m_paletteTextureId);
+    }
+
+    // the Tiles of another Map keep the blocks of the Pools alive
+    m_tiles.clear();
+
+    tile::Tile::ClearPool();
+    tile::RoadTile::ClearPool();
+    tile::BuildingTile::ClearPool();
 }
 
 //-------------------------------------------------
@@ -107,9 +128,14 @@ sg::ogl::resource::Mesh& sg::city::map::Map::GetMapMesh() noexcept
     return *m_mapMesh;
 }
 
-uint32_t sg::city::map::Map::GetFloatCountOfMap() const
+const sg::city::map::Map::TileAttributeContainer& sg::city::map::Map::GetTileAttributes() const noexcept
 {
-    return static_cast<uint32_t>(m_tiles.size()) * tile::Tile::FLOATS_PER_TILE;
+    return m_tileAttributes;
+}
+
+uint32_t sg::city::map::Map::GetPaletteTextureId() const
+{
+    return m_paletteTextureId;
 }
 
 const sg::city::map::Map::TileNavigationNodeContainer& sg::city::map::Map::GetNavigationNodes() const noexcept
@@ -132,11 +158,54 @@ sg::city::map::Map::NavigationNodeContainer& sg::city::map::Map::GetNavigationNo
     return m_tileNavigationNodes[t_index];
 }
 
+const sg::city::map::Map::ChunkContainer& sg::city::map::Map::GetChunks() const noexcept
+{
+    return m_chunks;
+}
+
+uint32_t sg::city::map::Map::GetTileSlot(const int t_tileIndex) const
+{
+    return m_tileSlots[t_tileIndex];
+}
+
+uint32_t sg::city::map::Map::GetChunkIndex(const int t_tileIndex) const
+{
+    const auto chunkX{ (t_tileIndex % m_mapSize) / Chunk::SIZE };
+    const auto chunkZ{ (t_tileIndex / m_mapSize) / Chunk::SIZE };
+
+    return static_cast<uint32_t>(chunkZ * m_chunksPerRow + chunkX);
+}
+
+uint32_t sg::city::map::Map::GetLastTileUploads() const
+{
+    return m_lastTileUploads;
+}
+
+uint32_t sg::city::map::Map::GetLastTileUploadBytes() const
+{
+    return m_lastTileUploadBytes;
+}
+
+sg::city::map::DebugBatcher& sg::city::map::Map::GetDebugBatcher() noexcept
+{
+    return *m_debugBatcher;
+}
+
 int sg::city::map::Map::GetNumRegions() const
 {
     return m_numRegions;
 }
 
+int sg::city::map::Map::GetMaxRegionId() const
+{
+    return m_maxRegionId;
+}
+
+const sg::city::map::Map::RelabelledTileContainer& sg::city::map::Map::GetRelabelledTiles() const noexcept
+{
+    return m_relabelledTiles;
+}
+
 //-------------------------------------------------
 // Get Tile
 //-------------------------------------------------
@@ -165,197 +234,391 @@ int sg::city::map::Map::GetTileMapIndexByMapPosition(const int t_mapX, const int
 
 void sg::city::map::Map::CreateMap()
 {
-    // shader needed for debug
-    m_scene->GetApplicationContext()->GetShaderManager().AddShaderProgram<shader::NodeShader>();
-    m_scene->GetApplicationContext()->GetShaderManager().AddShaderProgram<shader::LineShader>();
+    // init tiles from the map file
+    StoreMapFileValues();
+    StorePlantPositions();
 
-    // load map file as texture
-    m_mapTextureId = m_scene->GetApplicationContext()->GetTextureManager().GetTextureIdFromPath(m_mapFileName);
+    CreateMap(m_mapSize, ClassifyMapValues(mapValues));
+}
 
-    // get texture meta data
-    const auto w{ m_scene->GetApplicationContext()->GetTextureManager().GetMetadata(m_mapFileName).width };
-    const auto h{ m_scene->GetApplicationContext()->GetTextureManager().GetMetadata(m_mapFileName).height };
+void sg::city::map::Map::CreateMap(const int t_mapSize, const TypeContainer& t_tileTypes)
+{
+    SG_OGL_ASSERT(m_scene, "[Map::CreateMap()] Null pointer.")
+    SG_OGL_ASSERT(t_mapSize > 0 && t_tileTypes.size() == static_cast<size_t>(t_mapSize) * t_mapSize, "[Map::CreateMap()] Invalid TileTypes.")
 
-    SG_OGL_ASSERT(w == h, "[Map::CreateMap()] Width and height must have the same value.");
+    m_mapSize = t_mapSize;
 
-    m_mapSize = h;
+    // shader needed for debug
+    m_scene->GetApplicationContext()->GetShaderManager().AddShaderProgram<shader::NodeShader>();
+    m_scene->GetApplicationContext()->GetShaderManager().AddShaderProgram<shader::LineShader>();
 
     // init tiles
-    StoreMapFileValues();
     StoreTextures();
-    StoreTiles();
-    StoreTileNeighbours();
-    StoreRandomColors();
-    StoreTileNavigationNodes();
-    LinkTileNavigationNodes();
+    StoreMapData(t_tileTypes);
 
-#ifdef ENABLE_TRAFFIC_DEBUG
-    CreateNavigationNodesMesh();
-#endif
+    // the Tiles add their debug geometry later
+    m_debugBatcher = std::make_unique<DebugBatcher>();
 
     // create an bind a new Vao
     m_mapMesh = std::make_unique<ogl::resource::Mesh>();
     m_mapMesh->GetVao().BindVao();
 
-    // create a new Vbo and store Tiles
+    // create the Vbos and store Tiles with a single upload
     CreateVbo();
     StoreTilesInVbo();
+    FlushTileAttributes();
 
     // unbind Vao
     ogl::buffer::Vao::UnbindVao();
 
-    // set draw count
-    m_mapMesh->GetVao().SetDrawCount(GetVerticesCountOfMap());
+    // set draw count - the vertices of one Tile; the Tiles are instances
+    m_mapMesh->GetVao().SetDrawCount(VERTICES_PER_TILE);
+
+    // the colors to show regions
+    CreatePaletteTexture();
+}
+
+void sg::city::map::Map::CreateMapFromValues(const int t_mapSize, MapValuesContainer t_mapValues)
+{
+    SG_OGL_ASSERT(t_mapSize > 0 && t_mapValues.size() == static_cast<size_t>(t_mapSize) * t_mapSize, "[Map::CreateMapFromValues()] Invalid values.")
+
+    m_mapSize = t_mapSize;
+    mapValues = std::move(t_mapValues);
+    StorePlantPositions();
+
+    CreateMapFromTypes(t_mapSize, ClassifyMapValues(mapValues));
+}
+
+void sg::city::map::Map::CreateMapFromTypes(const int t_mapSize, const TypeContainer& t_tileTypes)
+{
+    SG_OGL_ASSERT(t_mapSize > 0 && t_tileTypes.size() == static_cast<size_t>(t_mapSize) * t_mapSize, "[Map::CreateMapFromTypes()] Invalid TileTypes.")
+
+    m_mapSize = t_mapSize;
+
+    // the same steps as CreateMap() without textures, shaders and Vbos
+    StoreMapData(t_tileTypes);
+
+    // the packed attributes are kept on the Cpu only
+    m_tileAttributes.resize(GetNrOfAllTiles());
+    StoreTilesInVbo();
 }
 
 //-------------------------------------------------
 // Update
 //-------------------------------------------------
 
-void sg::city::map::Map::UpdateMapVboByTileIndex(const int t_tileIndex) const
+void sg::city::map::Map::UpdateMapVboByTileIndex(const int t_tileIndex)
 {
-    ogl::buffer::Vbo::BindVbo(m_vboId);
-    glBufferSubData(GL_ARRAY_BUFFER, t_tileIndex * tile::Tile::SIZE_IN_BYTES_PER_TILE, tile::Tile::SIZE_IN_BYTES_PER_TILE, m_tiles[t_tileIndex]->GetVertices().data());
-    ogl::buffer::Vbo::UnbindVbo();
+    const auto& tile{ *m_tiles[t_tileIndex] };
+    const auto slot{ m_tileSlots[t_tileIndex] };
+    m_tileAttributes[slot] = tile.GetAttribute(GetRegionColorIndex(tile.region));
+
+    m_dirtyTiles.Add(slot);
+}
+
+void sg::city::map::Map::FlushTileAttributes()
+{
+    SG_CITY_PROFILE_ZONE("Map::FlushTileAttributes");
+
+    m_lastTileUploads = 0;
+    m_lastTileUploadBytes = 0;
+
+    if (m_dirtyTiles.IsEmpty())
+    {
+        SG_CITY_PROFILE_COUNTER("Tile uploads", 0);
+        return;
+    }
+
+    gpu::Gpu::BindVbo(gpu::Source::MAP, m_vboId);
+
+    for (const auto& range : m_dirtyTiles.Merge())
+    {
+        gpu::Gpu::BufferSubData(
+            gpu::Source::MAP,
+            static_cast<uint64_t>(range.begin) * tile::Tile::SIZE_IN_BYTES_PER_TILE,
+            static_cast<uint64_t>(range.end - range.begin) * tile::Tile::SIZE_IN_BYTES_PER_TILE,
+            &m_tileAttributes[range.begin]
+        );
+
+        m_lastTileUploads++;
+        m_lastTileUploadBytes += (range.end - range.begin) * tile::Tile::SIZE_IN_BYTES_PER_TILE;
+    }
+
+    gpu::Gpu::UnbindVbo(gpu::Source::MAP);
+
+    SG_CITY_PROFILE_COUNTER("Tile uploads", m_lastTileUploads);
 }
 
 //-------------------------------------------------
-// Regions
+// Edit
 //-------------------------------------------------
 
-void sg::city::map::Map::FindConnectedRegions()
+void sg::city::map::Map::ReplaceTile(const int t_tileIndex, const tile::TileType t_tileType)
 {
-    // todo: in city update
+    const auto mapX{ static_cast<float>(t_tileIndex % m_mapSize) };
+    const auto mapZ{ static_cast<float>(t_tileIndex / m_mapSize) };
+
+    // store neighbours
+    const auto neighbours{ m_tiles[t_tileIndex]->GetNeighbours() };
 
-    auto regions{ 0 };
+    // delete the unique pointer
+    m_tiles[t_tileIndex].reset();
 
-    // delete the regions Id from all Tiles
-    for (auto& tile : m_tiles)
+    if (t_tileType == tile::TileType::TRAFFIC)
+    {
+        m_tiles[t_tileIndex] = std::make_unique<tile::RoadTile>(mapX, mapZ, this);
+        roadIndices.push_back(t_tileIndex);
+    }
+    else if (t_tileType == tile::TileType::RESIDENTIAL)
+    {
+        m_tiles[t_tileIndex] = std::make_unique<tile::BuildingTile>(mapX, mapZ, this);
+    }
+    else
     {
-        tile->region = tile::Tile::NO_REGION;
+        // default: create a new Tile with the new type
+        m_tiles[t_tileIndex] = std::make_unique<tile::Tile>(mapX, mapZ, t_tileType, this);
     }
 
-    for (auto& tile : m_tiles)
+    m_tiles[t_tileIndex]->GetNeighbours() = neighbours;
+
+    // a Tile that was a road before keeps its Nodes and their links
+    if (t_tileType == tile::TileType::TRAFFIC && m_tileNavigationNodes[t_tileIndex].empty())
     {
-        auto found{ false };
-        const auto tileIndex{ tile->GetMapIndex() };
+        StoreNavigationNodes(t_tileIndex);
+        LinkNavigationNodes(t_tileIndex, true);
+    }
+}
 
-        for (auto tileType : tile::Tile::REGION_TILE_TYPES)
+//-------------------------------------------------
+// Regions
+//-------------------------------------------------
+
+void sg::city::map::Map::FindConnectedRegions()
+{
+    SG_CITY_PROFILE_ZONE("Map::FindConnectedRegions");
+
+    const auto nrOfAllTiles{ GetNrOfAllTiles() };
+
+    // label the connected areas in scan order; the Tiles keep their old region Id for now
+    m_regionLabels.assign(nrOfAllTiles, tile::Tile::NO_REGION);
+
+    // the stack is shared by all searches and lives in the FrameArena
+    ScratchIndexContainer stack{ memory::FrameArena::Get().GetResource() };
+
+    auto labels{ 0 };
+    for (auto i{ 0 }; i < nrOfAllTiles; ++i)
+    {
+        if (m_regionLabels[i] == tile::Tile::NO_REGION && IsRegionTileType(m_tiles[i]->type))
         {
-            if (tileType == m_tiles[tileIndex]->type)
-            {
-                found = true;
-                break;
-            }
+            labels++;
+            DepthSearch(i, labels, stack);
         }
+    }
+
+    AssignRegionIds(labels);
 
-        if (m_tiles[tileIndex]->region == tile::Tile::NO_REGION && found)
+    // only the changed region colors are uploaded with the next flush
+    ApplyRegionIds();
+
+    m_numRegions = labels;
+}
+
+//-------------------------------------------------
+// Chunks
+//-------------------------------------------------
+
+void sg::city::map::Map::FindVisibleChunks(const glm::mat4& t_matrix, ChunkIndexContainer& t_visibleChunks) const
+{
+    t_visibleChunks.clear();
+
+    const frustum::Frustum frustum{ t_matrix };
+
+    for (auto i{ 0u }; i < m_chunks.size(); ++i)
+    {
+        if (frustum.IsBoxVisible(m_chunks[i].boundsMin, m_chunks[i].boundsMax))
         {
-            regions++;
-            DepthSearch(*m_tiles[tileIndex], regions);
+            t_visibleChunks.push_back(i);
         }
     }
-
-    m_numRegions = regions;
 }
 
 //-------------------------------------------------
-// File I/O
+// Save game
 //-------------------------------------------------
 
-void sg::city::map::Map::SaveMap()
+void sg::city::map::Map::Save(save::SaveData& t_saveData) const
 {
-    // open file
-    std::ofstream outFile;
-    outFile.open(MAP_FILE_NAME, std::ios::out | std::ios::binary);
+    SG_CITY_PROFILE_ZONE("Map::Save");
 
-    // write header info
-    std::string info{ MAP_FILE_HEADER_INFO };
-    outFile.write(reinterpret_cast<char*>(info.data()), MAP_FILE_HEADER_LENGTH);
+    const auto nrOfAllTiles{ static_cast<size_t>(GetNrOfAllTiles()) };
+
+    t_saveData.mapSize = m_mapSize;
+    t_saveData.tileTypes.resize(nrOfAllTiles);
+    t_saveData.maxRegionId = m_maxRegionId;
+    t_saveData.regions.resize(nrOfAllTiles);
+
+    thread::ThreadPool::Get().ParallelFor(0, m_mapSize, MIN_ROWS_PER_BAND, [this, &t_saveData](const int t_zBegin, const int t_zEnd)
+    {
+        for (auto i{ t_zBegin * m_mapSize }; i < t_zEnd * m_mapSize; ++i)
+        {
+            t_saveData.tileTypes[i] = static_cast<uint8_t>(m_tiles[i]->type);
+            t_saveData.regions[i] = m_tiles[i]->region;
+        }
+    });
 
-    // write size of Map
-    outFile.write(reinterpret_cast<char*>(&m_mapSize), sizeof(int));
+    t_saveData.plantIndices.clear();
+    t_saveData.plantIndices.reserve(plantPositions.size());
 
-    // write tiles
-    for (auto& tile : m_tiles)
+    for (const auto& plant : plantPositions)
     {
-        // write type
-        outFile.write(reinterpret_cast<char*>(&tile->type), sizeof(tile::TileType));
+        t_saveData.plantIndices.push_back(GetTileMapIndexByMapPosition(static_cast<int>(plant.x), static_cast<int>(plant.z)));
     }
 
-    // close file
-    outFile.close();
+    // the RoadType is read from the packed attribute (flags in bits 8 .. 15), only a signal needs the RoadTile
+    t_saveData.roads.clear();
+    t_saveData.signals.clear();
+
+    for (auto i{ 0 }; i < static_cast<int>(nrOfAllTiles); ++i)
+    {
+        if (m_tiles[i]->type != tile::TileType::TRAFFIC)
+        {
+            continue;
+        }
+
+        save::RoadRecord road;
+        road.tileIndex = i;
+        road.roadType = static_cast<uint8_t>(m_tileAttributes[m_tileSlots[i]] >> tile::Tile::ATTRIBUTE_FLAGS_SHIFT);
+        t_saveData.roads.push_back(road);
 
-    SG_OGL_LOG_INFO("[Map::SaveMap()] Map saved successfully.");
+        const auto* roadTile{ static_cast<const tile::RoadTile*>(m_tiles[i].get()) };
+        if (!roadTile->GetStopPatterns().empty())
+        {
+            save::SignalRecord signal;
+            signal.tileIndex = i;
+            signal.stopPatternIndex = roadTile->GetCurrentStopPatternIndex();
+            t_saveData.signals.push_back(signal);
+        }
+    }
 }
 
-void sg::city::map::Map::LoadMap()
+void sg::city::map::Map::Restore(const save::SaveData& t_saveData)
 {
-    // open file
-    std::ifstream inFile;
-    inFile.open(MAP_FILE_NAME, std::ios::in | std::ios::binary);
+    SG_OGL_ASSERT(t_saveData.mapSize == m_mapSize, "[Map::Restore()] The Map must be created from the saved TileTypes.")
 
-    // read info
-    std::string info;
-    info.resize(MAP_FILE_HEADER_LENGTH);
-    inFile.read(reinterpret_cast<char*>(info.data()), MAP_FILE_HEADER_LENGTH);
-    SG_OGL_ASSERT(info == MAP_FILE_HEADER_INFO, "[Map::LoadMap()] Invalid file format.")
+    SG_CITY_PROFILE_ZONE("Map::Restore");
 
-    // read size of Map
-    auto mapSize{ 0 };
-    inFile.read(reinterpret_cast<char*>(&mapSize), sizeof(int));
-    SG_OGL_ASSERT(mapSize, "[Map::LoadMap()] Invalid map size.")
+    // the saved RoadTypes in a dense array, indexed by the Tile
+    const auto nrOfAllTiles{ GetNrOfAllTiles() };
+    TypeContainer roadTypes(nrOfAllTiles, 0);
 
-    // read tiles
-    std::vector<tile::TileType> types;
-    for (auto i{ 0 }; i < mapSize * mapSize; ++i)
+    for (const auto& road : t_saveData.roads)
     {
-        tile::TileType type;
-        inFile.read(reinterpret_cast<char*>(&type), sizeof(tile::TileType));
-        types.push_back(type);
+        roadTypes[road.tileIndex] = road.roadType;
+    }
+
+    // the Tiles were created from the saved TileTypes
+    const auto restoreStripe = [this, &roadTypes, nrOfAllTiles](const int t_stripe)
+    {
+        const auto end{ std::min((t_stripe + 1) * MIN_ROWS_PER_BAND * m_mapSize, nrOfAllTiles) };
+
+        for (auto i{ t_stripe * MIN_ROWS_PER_BAND * m_mapSize }; i < end; ++i)
+        {
+            if (m_tiles[i]->type == tile::TileType::TRAFFIC)
+            {
+                static_cast<tile::RoadTile*>(m_tiles[i].get())->Restore(static_cast<tile::RoadType>(roadTypes[i]));
+            }
+        }
+    };
+
+    const auto stripes{ (m_mapSize + MIN_ROWS_PER_BAND - 1) / MIN_ROWS_PER_BAND };
+
+#ifdef ENABLE_TRAFFIC_DEBUG
+    // the debug lines and points are not written in parallel
+    for (auto stripe{ 0 }; stripe < stripes; ++stripe)
+    {
+        restoreStripe(stripe);
+    }
+#else
+    // the tracks of neighbouring roads share the border Nodes; two stripes of rows share Nodes only if they are adjacent,
+    // so the even stripes are restored in parallel, then the odd ones
+    for (auto parity{ 0 }; parity < 2; ++parity)
+    {
+        thread::ThreadPool::Get().ParallelFor(0, (stripes - parity + 1) / 2, 1, [&restoreStripe, parity](const int t_begin, const int t_end)
+        {
+            for (auto i{ t_begin }; i < t_end; ++i)
+            {
+                restoreStripe(2 * i + parity);
+            }
+        });
     }
+#endif
 
-    // close file
-    inFile.close();
+    for (const auto& signal : t_saveData.signals)
+    {
+        SG_OGL_ASSERT(m_tiles[signal.tileIndex]->type == tile::TileType::TRAFFIC, "[Map::Restore()] The Tile is not a road.")
+        auto* roadTile{ static_cast<tile::RoadTile*>(m_tiles[signal.tileIndex].get()) };
 
-    SG_OGL_LOG_INFO("[Map::LoadMap()] Map loaded successfully.");
+        if (signal.stopPatternIndex < static_cast<int>(roadTile->GetStopPatterns().size()))
+        {
+            roadTile->ApplyStopPattern(signal.stopPatternIndex);
+        }
+        else
+        {
+            SG_OGL_LOG_WARN("[Map::Restore()] The road {} has no Stop Pattern {}.", signal.tileIndex, signal.stopPatternIndex);
+        }
+    }
 
-    std::cout << "-----------------------------" << std::endl;
-    std::cout << "File: " << MAP_FILE_NAME << std::endl;
-    std::cout << "Info: " << info << std::endl;
-    std::cout << "Map size: " << mapSize << std::endl;
+    plantPositions.clear();
+    plantPositions.reserve(t_saveData.plantIndices.size());
 
-    auto i{ 0 };
-    for (auto z{ 0 }; z < mapSize; ++z)
+    for (const auto plantIndex : t_saveData.plantIndices)
     {
-        for (auto x{ 0 }; x < mapSize; ++x)
+        plantPositions.emplace_back(plantIndex % m_mapSize, 0.0f, plantIndex / m_mapSize);
+    }
+
+    if (t_saveData.regions.empty())
+    {
+        // an older file without regions
+        FindConnectedRegions();
+    }
+    else
+    {
+        thread::ThreadPool::Get().ParallelFor(0, m_mapSize, MIN_ROWS_PER_BAND, [this, &t_saveData](const int t_zBegin, const int t_zEnd)
         {
-            std::cout << "Type: " << tile::Tile::TileTypeToString(types[i]) << std::endl;
-            i++;
+            for (auto i{ t_zBegin * m_mapSize }; i < t_zEnd * m_mapSize; ++i)
+            {
+                m_tiles[i]->region = t_saveData.regions[i];
+            }
+        });
+
+        // the saved Ids may have gaps
+        std::vector<bool> usedRegionIds(static_cast<size_t>(t_saveData.maxRegionId) + 1, false);
+        for (const auto region : t_saveData.regions)
+        {
+            usedRegionIds[region] = true;
         }
+
+        m_maxRegionId = t_saveData.maxRegionId;
+        m_numRegions = static_cast<int>(std::count(usedRegionIds.begin() + 1, usedRegionIds.end(), true));
     }
 
-    std::cout << "-----------------------------" << std::endl;
+    // all Tiles are packed again in parallel and uploaded as one range with the next flush
+    StoreTilesInVbo();
 }
 
 //-------------------------------------------------
 // Debug
 //-------------------------------------------------
 
-void sg::city::map::Map::CreateNavigationNodesMesh()
+void sg::city::map::Map::UpdateNavigationNodesDebugPoints(const int t_tileIndex)
 {
-    SG_OGL_ASSERT(!m_tileNavigationNodes.empty(), "[Map::CreateNavigationNodesMesh()] No Navigation Nodes available.")
-
-    VertexContainer vertexContainer;
+    DebugBatcher::ScratchVertexContainer vertexContainer{ memory::FrameArena::Get().GetResource() };
 
-    for (auto tileIndex{ 0 }; tileIndex < GetNrOfAllTiles(); ++tileIndex)
+    if (m_tiles[t_tileIndex]->type == tile::TileType::TRAFFIC)
     {
-        if (m_tiles[tileIndex]->type != tile::TileType::TRAFFIC)
-        {
-            continue;
-        }
+        vertexContainer.reserve(m_tileNavigationNodes[t_tileIndex].size() * DebugBatcher::FLOATS_PER_VERTEX);
 
-        for (auto& node : m_tileNavigationNodes[tileIndex])
+        for (auto& node : m_tileNavigationNodes[t_tileIndex])
         {
             // some nodes are nullptr
             if (node)
@@ -365,54 +628,33 @@ void sg::city::map::Map::CreateNavigationNodesMesh()
                 vertexContainer.push_back(VERTEX_HEIGHT);
                 vertexContainer.push_back(node->position.z);
 
-                // color
-                if (node->block)
-                {
-                    // red
-                    vertexContainer.push_back(1.0f);
-                    vertexContainer.push_back(0.0f);
-                    vertexContainer.push_back(0.0f);
-                }
-                else
-                {
-                    // green
-                    vertexContainer.push_back(0.0f);
-                    vertexContainer.push_back(1.0f);
-                    vertexContainer.push_back(0.0f);
-                }
+                // color: red if blocked, otherwise green
+                vertexContainer.push_back(node->block ? 1.0f : 0.0f);
+                vertexContainer.push_back(node->block ? 0.0f : 1.0f);
+                vertexContainer.push_back(0.0f);
             }
         }
     }
 
-    if (vertexContainer.empty())
-    {
-        return;
-    }
+    m_debugBatcher->SetVertices(DebugBatcher::Layer::POINTS, t_tileIndex, vertexContainer);
+}
 
-    if (m_navigationNodesMesh)
+void sg::city::map::Map::UpdateNavigationNodesDebugColors(const int t_tileIndex)
+{
+    // the points are stored in the order of the non-null nodes
+    auto point{ 0u };
+    for (auto& node : m_tileNavigationNodes[t_tileIndex])
     {
-        m_navigationNodesMesh.reset();
+        if (node)
+        {
+            const auto color{ node->block ? glm::vec3(1.0f, 0.0f, 0.0f) : glm::vec3(0.0f, 1.0f, 0.0f) };
+            m_debugBatcher->SetColor(DebugBatcher::Layer::POINTS, t_tileIndex, point++, color);
+        }
     }
-
-    m_navigationNodesMesh = std::make_unique<ogl::resource::Mesh>();
-
-    const ogl::buffer::BufferLayout bufferLayout{
-        { ogl::buffer::VertexAttributeType::POSITION, "aPosition" },
-        { ogl::buffer::VertexAttributeType::COLOR, "aColor" },
-    };
-
-    m_navigationNodesMesh->GetVao().AddVertexDataVbo(vertexContainer.data(), static_cast<int32_t>(vertexContainer.size()) / 6, bufferLayout);
 }
 
 void sg::city::map::Map::RenderNavigationNodes() const
 {
-    if (!m_navigationNodesMesh)
-    {
-        SG_OGL_LOG_WARN("[Map::RenderNavigationNodes()] Mesh was not created.");
-
-        return;
-    }
-
     ogl::math::Transform t;
     t.position = position;
     t.rotation = rotation;
@@ -428,24 +670,64 @@ void sg::city::map::Map::RenderNavigationNodes() const
 
     glPointSize(POINT_SIZE);
 
-    m_navigationNodesMesh->InitDraw();
-    m_navigationNodesMesh->DrawPrimitives(GL_POINTS);
-    m_navigationNodesMesh->EndDraw();
+    m_debugBatcher->Draw(DebugBatcher::Layer::POINTS);
 
     ogl::resource::ShaderProgram::Unbind();
 }
 
+void sg::city::map::Map::RenderAutoTracks() const
+{
+    ogl::math::Transform t;
+    t.position = position;
+    t.rotation = rotation;
+    t.scale = scale;
+
+    auto& shader{ m_scene->GetApplicationContext()->GetShaderManager().GetShaderProgram<shader::LineShader>() };
+    shader.Bind();
+
+    const auto projectionMatrix{ m_scene->GetApplicationContext()->GetWindow().GetProjectionMatrix() };
+    const auto mvp{ projectionMatrix * m_scene->GetCurrentCamera().GetViewMatrix() * static_cast<glm::mat4>(t) };
+
+    shader.SetUniform("mvpMatrix", mvp);
+
+    m_debugBatcher->Draw(DebugBatcher::Layer::LINES);
+
+    ogl::resource::ShaderProgram::Unbind();
+}
+
+//-------------------------------------------------
+// Values
+//-------------------------------------------------
+
+bool sg::city::map::Map::IsRoadValue(const float t_value)
+{
+    return t_value == 1.0f;
+}
+
+bool sg::city::map::Map::IsBuildingValue(const float t_value)
+{
+    return t_value > 0.4f && t_value < 0.6f;
+}
+
+bool sg::city::map::Map::IsTreeValue(const float t_value)
+{
+    return t_value > 0.2 && t_value < 0.3f; // 0.25f ==> Tree
+}
+
 //-------------------------------------------------
 // Init
 //-------------------------------------------------
 
 void sg::city::map::Map::StoreMapFileValues()
 {
-    ogl::resource::TextureManager::Bind(m_mapTextureId);
+    // decoded on the Cpu; the map file is not needed as texture
+    auto importedMap{ MapImporter::Import(m_mapFileName) };
 
-    // Create float buffer of red channel texture data.
-    mapValues.resize(GetNrOfAllTiles());
-    glGetTexImage(GL_TEXTURE_2D, 0, GL_RED, GL_FLOAT, mapValues.data());
+    SG_OGL_ASSERT(importedMap.width == importedMap.height, "[Map::StoreMapFileValues()] Width and height must have the same value.")
+
+    m_mapSize = static_cast<int>(importedMap.height);
+    mapValues = std::move(importedMap.values);
+    heightValues = std::move(importedMap.heights);
 }
 
 void sg::city::map::Map::StoreTextures()
@@ -470,61 +752,89 @@ void sg::city::map::Map::StoreTextures()
     m_buildingTextures.push_back(m_scene->GetApplicationContext()->GetTextureManager().GetTextureIdFromPath("res/texture/line2.png", true));
 }
 
-void sg::city::map::Map::StoreTiles()
+void sg::city::map::Map::StorePlantPositions()
 {
-    SG_OGL_ASSERT(!mapValues.empty(), "[Map::StoreTiles()] Load a map file before.");
-    SG_OGL_LOG_DEBUG("[Map::StoreTiles()] Create {}x{} Tiles from the file {}.", m_mapSize, m_mapSize, m_mapFileName);
-
-    for (auto z{ 0 }; z < m_mapSize; ++z)
+    for (auto index{ 0 }; index < static_cast<int>(mapValues.size()); ++index)
     {
-        for (auto x{ 0 }; x < m_mapSize; ++x)
+        if (IsTreeValue(mapValues[index]))
         {
-            const auto index{ GetTileMapIndexByMapPosition(x, z) };
-            const auto color{ mapValues[index] };
+            plantPositions.emplace_back(index % m_mapSize, 0.0f, index / m_mapSize);
+        }
+    }
+}
 
-            // create Tiles
-            if (color == 1.0f)
-            {
-                auto tile{ std::make_unique<tile::RoadTile>(
-                        static_cast<float>(x),
-                        static_cast<float>(z),
-                        this
-                    )
-                };
-
-                m_tiles.push_back(std::move(tile));
-                roadIndices.push_back(index);
-            }
-            else if (color > 0.4f && color < 0.6f)
-            {
-                auto tile{ std::make_unique<tile::BuildingTile>(
-                        static_cast<float>(x),
-                        static_cast<float>(z),
-                        this
-                    )
-                };
-
-                m_tiles.push_back(std::move(tile));
-            }
-            else
-            {
-                auto tile{ std::make_unique<tile::Tile>(
-                        static_cast<float>(x),
-                        static_cast<float>(z),
-                        tile::TileType::NONE,
-                        this
-                    )
-                };
-
-                m_tiles.push_back(std::move(tile));
-            }
+void sg::city::map::Map::StoreMapData(const TypeContainer& t_tileTypes)
+{
+    SG_CITY_PROFILE_ZONE("Map::StoreMapData");
+
+    auto duration{ 0.0f };
 
-            // store plant positions
-            if (color > 0.2 && color < 0.3f) // 0.25f ==> Tree
+    {
+        timer::Timer timer{ &duration };
+
+        // each step is a barrier; the steps run in parallel row bands
+        StoreTiles(t_tileTypes);
+        StoreTileNeighbours();
+        StoreRandomColors();
+        StoreTileNavigationNodes();
+        LinkTileNavigationNodes();
+        StoreChunks();
+    }
+
+    SG_OGL_LOG_INFO("[Map::StoreMapData()] Stored {} Tiles in {} ms with {} worker threads.", GetNrOfAllTiles(), duration, thread::ThreadPool::Get().GetWorkers());
+}
+
+void sg::city::map::Map::StoreTiles(const TypeContainer& t_tileTypes)
+{
+    SG_CITY_PROFILE_ZONE("Map::StoreTiles");
+
+    SG_OGL_ASSERT(static_cast<int>(t_tileTypes.size()) == GetNrOfAllTiles(), "[Map::StoreTiles()] Invalid TileTypes.");
+    SG_OGL_LOG_DEBUG("[Map::StoreTiles()] Create {}x{} Tiles.", m_mapSize, m_mapSize);
+
+    // one block per Tile class; the bands take their Tiles from it without a lock
+    const auto roads{ static_cast<std::size_t>(std::count(t_tileTypes.begin(), t_tileTypes.end(), static_cast<uint8_t>(tile::TileType::TRAFFIC))) };
+    const auto buildings{ static_cast<std::size_t>(std::count(t_tileTypes.begin(), t_tileTypes.end(), static_cast<uint8_t>(tile::TileType::RESIDENTIAL))) };
+
+    tile::RoadTile::Reserve(roads);
+    tile::BuildingTile::Reserve(buildings);
+    tile::Tile::Reserve(t_tileTypes.size() - roads - buildings);
+
+    // each band creates the Tiles of its rows
+    m_tiles.resize(GetNrOfAllTiles());
+
+    thread::ThreadPool::Get().ParallelFor(0, m_mapSize, MIN_ROWS_PER_BAND, [this, &t_tileTypes](const int t_zBegin, const int t_zEnd)
+    {
+        for (auto z{ t_zBegin }; z < t_zEnd; ++z)
+        {
+            for (auto x{ 0 }; x < m_mapSize; ++x)
             {
-                plantPositions.emplace_back(x, 0.0f, z);
+                const auto index{ GetTileMapIndexByMapPosition(x, z) };
+                const auto type{ static_cast<tile::TileType>(t_tileTypes[index]) };
+
+                // create Tiles
+                if (type == tile::TileType::TRAFFIC)
+                {
+                    m_tiles[index] = std::make_unique<tile::RoadTile>(static_cast<float>(x), static_cast<float>(z), this);
+                }
+                else if (type == tile::TileType::RESIDENTIAL)
+                {
+                    m_tiles[index] = std::make_unique<tile::BuildingTile>(static_cast<float>(x), static_cast<float>(z), this);
+                }
+                else
+                {
+                    m_tiles[index] = std::make_unique<tile::Tile>(static_cast<float>(x), static_cast<float>(z), type, this);
+                }
             }
         }
+    });
+
+    // the roads in the order of the Tiles
+    for (auto index{ 0 }; index < GetNrOfAllTiles(); ++index)
+    {
+        if (t_tileTypes[index] == static_cast<uint8_t>(tile::TileType::TRAFFIC))
+        {
+            roadIndices.push_back(index);
+        }
     }
 }
 
@@ -532,154 +842,185 @@ void sg::city::map::Map::StoreTileNeighbours()
 {
     SG_OGL_ASSERT(!m_tiles.empty(), "[Map::StoreTileNeighbours()] No Tiles available.")
 
+    SG_CITY_PROFILE_ZONE("Map::StoreTileNeighbours");
+
     SG_OGL_LOG_DEBUG("[Map::StoreTileNeighbours()] Store Tile neighbors.");
 
-    for (auto z{ 0 }; z < m_mapSize; ++z)
+    // a Tile only writes its own neighbours
+    thread::ThreadPool::Get().ParallelFor(0, m_mapSize, MIN_ROWS_PER_BAND, [this](const int t_zBegin, const int t_zEnd)
     {
-        for (auto x{ 0 }; x < m_mapSize; ++x)
+        for (auto z{ t_zBegin }; z < t_zEnd; ++z)
         {
-            const auto tileIndex{ GetTileMapIndexByMapPosition(x, z) };
-
-            if (z < m_mapSize - 1)
+            for (auto x{ 0 }; x < m_mapSize; ++x)
             {
-                m_tiles[tileIndex]->GetNeighbours().emplace(tile::Direction::NORTH, GetTileMapIndexByMapPosition(x, z + 1));
-            }
+                const auto tileIndex{ GetTileMapIndexByMapPosition(x, z) };
 
-            if (x < m_mapSize - 1)
-            {
-                m_tiles[tileIndex]->GetNeighbours().emplace(tile::Direction::EAST, GetTileMapIndexByMapPosition(x + 1, z));
-            }
+                if (z < m_mapSize - 1)
+                {
+                    m_tiles[tileIndex]->GetNeighbours().emplace(tile::Direction::NORTH, GetTileMapIndexByMapPosition(x, z + 1));
+                }
 
-            if (z > 0)
-            {
-                m_tiles[tileIndex]->GetNeighbours().emplace(tile::Direction::SOUTH, GetTileMapIndexByMapPosition(x, z - 1));
-            }
+                if (x < m_mapSize - 1)
+                {
+                    m_tiles[tileIndex]->GetNeighbours().emplace(tile::Direction::EAST, GetTileMapIndexByMapPosition(x + 1, z));
+                }
 
-            if (x > 0)
-            {
-                m_tiles[tileIndex]->GetNeighbours().emplace(tile::Direction::WEST, GetTileMapIndexByMapPosition(x - 1, z));
+                if (z > 0)
+                {
+                    m_tiles[tileIndex]->GetNeighbours().emplace(tile::Direction::SOUTH, GetTileMapIndexByMapPosition(x, z - 1));
+                }
+
+                if (x > 0)
+                {
+                    m_tiles[tileIndex]->GetNeighbours().emplace(tile::Direction::WEST, GetTileMapIndexByMapPosition(x - 1, z));
+                }
             }
         }
-    }
+    });
 }
 
 void sg::city::map::Map::StoreTileNavigationNodes()
 {
+    SG_CITY_PROFILE_ZONE("Map::StoreTileNavigationNodes");
+
     SG_OGL_ASSERT(!m_tiles.empty(), "[Map::StoreTileNavigationNodes()] No Tiles available.")
     SG_OGL_ASSERT(m_tileNavigationNodes.empty(), "[Map::StoreTileNavigationNodes()] Navigation Nodes already exists.")
 
-    SG_OGL_LOG_DEBUG("[Map::StoreTileNavigationNodes()] Store Navigation Nodes for the Tiles.");
+    SG_OGL_LOG_DEBUG("[Map::StoreTileNavigationNodes()] Store Navigation Nodes for the roads.");
 
+    // an empty container does not allocate; the other Tiles get their Nodes when they become a road
     m_tileNavigationNodes.resize(GetNrOfAllTiles());
 
-    auto tileIndex{ 0 };
-    for (auto& tile : m_tiles)
+    thread::ThreadPool::Get().ParallelFor(0, m_mapSize, MIN_ROWS_PER_BAND, [this](const int t_zBegin, const int t_zEnd)
     {
-        NavigationNodeContainer navigationNodes;
-
-        for (auto z{ 0 }; z < 7; ++z)
+        for (auto tileIndex{ t_zBegin * m_mapSize }; tileIndex < t_zEnd * m_mapSize; ++tileIndex)
         {
-            auto zOffset{ 0.0f };
-            switch (z)
+            if (m_tiles[tileIndex]->type == tile::TileType::TRAFFIC)
             {
-            case 0: zOffset = 0.000f; break;
-            case 1: zOffset = -0.083f; break;
-            case 2: zOffset = -0.333f; break;
-            case 3: zOffset = -0.500f; break;
-            case 4: zOffset = -0.667f; break;
-            case 5: zOffset = -0.917f; break;
-            case 6: zOffset = -1.000f; break;
-            default:;
-            }
-
-            for (auto x{ 0 }; x < 7; ++x)
-            {
-                auto xOffset{ 0.0f };
-                switch (x)
-                {
-                case 0: xOffset = 0.000f; break;
-                case 1: xOffset = 0.083f; break;
-                case 2: xOffset = 0.333f; break;
-                case 3: xOffset = 0.500f; break;
-                case 4: xOffset = 0.667f; break;
-                case 5: xOffset = 0.917f; break;
-                case 6: xOffset = 1.000f; break;
-                default:;
-                }
-
-                // converting unique_ptr to shared_ptr
-                navigationNodes.push_back(std::make_unique<automata::AutoNode>(glm::vec3(
-                        tile->GetWorldX() + xOffset,
-                        0.0f,
-                        tile->GetWorldZ() + zOffset)
-                    )
-                );
+                StoreNavigationNodes(tileIndex);
             }
         }
-
-        m_tileNavigationNodes[tileIndex] = navigationNodes;
-        tileIndex++;
-    }
+    });
 }
 
 void sg::city::map::Map::LinkTileNavigationNodes()
 {
+    SG_CITY_PROFILE_ZONE("Map::LinkTileNavigationNodes");
+
     SG_OGL_ASSERT(!m_tiles.empty(), "[Map::LinkTileNavigationNodes()] No Tiles available.")
     SG_OGL_ASSERT(!m_tileNavigationNodes.empty(), "[Map::LinkTileNavigationNodes()] No Navigation Nodes available.")
 
     SG_OGL_LOG_DEBUG("[Map::LinkTileNavigationNodes()] Link neighboring Navigation Nodes.");
 
-    for (auto z{ 0 }; z < m_mapSize; ++z)
+    /*
+        A Tile only reads the inner edge Nodes of its north and east neighbour,
+        which nobody writes, and only writes its own Nodes. The bands need no order.
+    */
+
+    thread::ThreadPool::Get().ParallelFor(0, m_mapSize, MIN_ROWS_PER_BAND, [this](const int t_zBegin, const int t_zEnd)
     {
-        for (auto x{ 0 }; x < m_mapSize; ++x)
+        for (auto tileIndex{ t_zBegin * m_mapSize }; tileIndex < t_zEnd * m_mapSize; ++tileIndex)
         {
-            const auto currentTileIndex{ GetTileMapIndexByMapPosition(x, z) };
-            auto& currentTile{ m_tiles[currentTileIndex] };
-
-            if (z < m_mapSize - 1)
+            if (!m_tileNavigationNodes[tileIndex].empty())
             {
-                const auto northTileIndex{ currentTile->GetNeighbours().at(tile::Direction::NORTH) };
-
-                m_tileNavigationNodes[currentTileIndex][42] = m_tileNavigationNodes[northTileIndex][0];
-                m_tileNavigationNodes[currentTileIndex][43] = m_tileNavigationNodes[northTileIndex][1];
-                m_tileNavigationNodes[currentTileIndex][44] = m_tileNavigationNodes[northTileIndex][2];
-                m_tileNavigationNodes[currentTileIndex][45] = m_tileNavigationNodes[northTileIndex][3];
-                m_tileNavigationNodes[currentTileIndex][46] = m_tileNavigationNodes[northTileIndex][4];
-                m_tileNavigationNodes[currentTileIndex][47] = m_tileNavigationNodes[northTileIndex][5];
-                m_tileNavigationNodes[currentTileIndex][48] = m_tileNavigationNodes[northTileIndex][6];
+                LinkNavigationNodes(tileIndex, false);
             }
+        }
+    });
+}
 
-            if (x < m_mapSize - 1)
-            {
-                const auto eastTileIndex{ currentTile->GetNeighbours().at(tile::Direction::EAST) };
-
-                m_tileNavigationNodes[currentTileIndex][48] = m_tileNavigationNodes[eastTileIndex][42];
-                m_tileNavigationNodes[currentTileIndex][41] = m_tileNavigationNodes[eastTileIndex][35];
-                m_tileNavigationNodes[currentTileIndex][34] = m_tileNavigationNodes[eastTileIndex][28];
-                m_tileNavigationNodes[currentTileIndex][27] = m_tileNavigationNodes[eastTileIndex][21];
-                m_tileNavigationNodes[currentTileIndex][20] = m_tileNavigationNodes[eastTileIndex][14];
-                m_tileNavigationNodes[currentTileIndex][13] = m_tileNavigationNodes[eastTileIndex][7];
-                m_tileNavigationNodes[currentTileIndex][6] = m_tileNavigationNodes[eastTileIndex][0];
-            }
+void sg::city::map::Map::StoreNavigationNodes(const int t_tileIndex)
+{
+    using NavigationNodeBlock = std::array<automata::AutoNode, NODES_PER_TILE>;
+
+    static constexpr float Z_OFFSETS[7]{ 0.000f, -0.083f, -0.333f, -0.500f, -0.667f, -0.917f, -1.000f };
+    static constexpr float X_OFFSETS[7]{ 0.000f, 0.083f, 0.333f, 0.500f, 0.667f, 0.917f, 1.000f };
+    static constexpr uint8_t UNUSED[NODES_PER_TILE]
+    {
+        1, 0, 0, 0, 0, 0, 1,
+        0, 0, 1, 0, 1, 0, 0,
+        0, 1, 0, 0, 0, 1, 0,
+        0, 0, 0, 0, 0, 0, 0,
+        0, 1, 0, 0, 0, 1, 0,
+        0, 0, 1, 0, 1, 0, 0,
+        1, 0, 0, 0, 0, 0, 1
+    };
+
+    const auto& tile{ *m_tiles[t_tileIndex] };
+
+    auto& navigationNodes{ m_tileNavigationNodes[t_tileIndex] };
+    navigationNodes.resize(NODES_PER_TILE);
+
+    // each pointer shares the ownership of the block
+    const auto block{ std::allocate_shared<NavigationNodeBlock>(memory::TrackingAllocator<NavigationNodeBlock, memory::Tag::NAV_NODES>()) };
+
+    for (auto i{ 0 }; i < NODES_PER_TILE; ++i)
+    {
+        if (UNUSED[i])
+        {
+            continue;
         }
+
+        auto& node{ (*block)[i] };
+        node.position = glm::vec3(tile.GetWorldX() + X_OFFSETS[i % 7], 0.0f, tile.GetWorldZ() + Z_OFFSETS[i / 7]);
+
+        navigationNodes[i] = NavigationNodeSharedPtr(block, &node);
     }
+}
 
-    for (auto tileIndex{ 0 }; tileIndex < GetNrOfAllTiles(); ++tileIndex)
+void sg::city::map::Map::LinkNavigationNodes(const int t_tileIndex, const bool t_allNeighbours)
+{
+    const auto& neighbours{ m_tiles[t_tileIndex]->GetNeighbours() };
+    auto& nodes{ m_tileNavigationNodes[t_tileIndex] };
+
+    // the Nodes of a neighbour, if it has any
+    const auto neighbourNodes = [this, &neighbours](const tile::Direction t_direction) -> const NavigationNodeContainer*
     {
-        m_tileNavigationNodes[tileIndex][37].reset();
-        m_tileNavigationNodes[tileIndex][39].reset();
-        m_tileNavigationNodes[tileIndex][29].reset();
-        m_tileNavigationNodes[tileIndex][33].reset();
-        m_tileNavigationNodes[tileIndex][15].reset();
-        m_tileNavigationNodes[tileIndex][19].reset();
-        m_tileNavigationNodes[tileIndex][9].reset();
-        m_tileNavigationNodes[tileIndex][11].reset();
+        if (neighbours.count(t_direction) == 0)
+        {
+            return nullptr;
+        }
+
+        const auto& container{ m_tileNavigationNodes[neighbours.at(t_direction)] };
+
+        return container.empty() ? nullptr : &container;
+    };
 
-        // the 4 corners
-        m_tileNavigationNodes[tileIndex][42].reset();
-        m_tileNavigationNodes[tileIndex][48].reset();
-        m_tileNavigationNodes[tileIndex][0].reset();
-        m_tileNavigationNodes[tileIndex][6].reset();
+    if (const auto* northNodes{ neighbourNodes(tile::Direction::NORTH) })
+    {
+        for (auto i{ 1 }; i <= 5; ++i)
+        {
+            nodes[42 + i] = (*northNodes)[i];
+        }
+    }
+
+    if (const auto* eastNodes{ neighbourNodes(tile::Direction::EAST) })
+    {
+        for (auto z{ 1 }; z <= 5; ++z)
+        {
+            nodes[z * 7 + 6] = (*eastNodes)[z * 7];
+        }
+    }
+
+    if (!t_allNeighbours)
+    {
+        return;
+    }
+
+    if (const auto* southNodes{ neighbourNodes(tile::Direction::SOUTH) })
+    {
+        for (auto i{ 1 }; i <= 5; ++i)
+        {
+            nodes[i] = (*southNodes)[42 + i];
+        }
+    }
+
+    if (const auto* westNodes{ neighbourNodes(tile::Direction::WEST) })
+    {
+        for (auto z{ 1 }; z <= 5; ++z)
+        {
+            nodes[z * 7] = (*westNodes)[z * 7 + 6];
+        }
     }
 }
 
@@ -687,16 +1028,55 @@ void sg::city::map::Map::StoreRandomColors()
 {
     SG_OGL_LOG_DEBUG("[Map::StoreRandomColors()] Store {} random Colors.", MAX_REGION_COLORS);
 
-    std::random_device seeder;
-    std::mt19937 engine(seeder());
+    for (auto i{ 0 }; i < MAX_REGION_COLORS; ++i)
+    {
+        auto randomStream{ m_random.GetStream(random::Domain::REGION_COLORS, i, 0) };
 
-    std::uniform_int_distribution<unsigned int> r(7, 164);
-    std::uniform_int_distribution<unsigned int> g(1, 160);
-    std::uniform_int_distribution<unsigned int> b(124, 254);
+        const auto r{ static_cast<unsigned int>(randomStream.NextInt(7, 164)) };
+        const auto g{ static_cast<unsigned int>(randomStream.NextInt(1, 160)) };
+        const auto b{ static_cast<unsigned int>(randomStream.NextInt(124, 254)) };
 
-    for (auto i{ 0 }; i < MAX_REGION_COLORS; ++i)
+        m_randomColors.emplace(i, ogl::Color(r, g, b));
+    }
+}
+
+void sg::city::map::Map::StoreChunks()
+{
+    m_chunksPerRow = (m_mapSize + Chunk::SIZE - 1) / Chunk::SIZE;
+
+    SG_OGL_LOG_DEBUG("[Map::StoreChunks()] Store {} Chunks.", m_chunksPerRow * m_chunksPerRow);
+
+    m_chunks.clear();
+    m_tileSlots.resize(GetNrOfAllTiles());
+
+    auto slot{ 0u };
+    for (auto chunkZ{ 0 }; chunkZ < m_chunksPerRow; ++chunkZ)
     {
-        m_randomColors.emplace(i, ogl::Color(r(engine), g(engine), b(engine)));
+        for (auto chunkX{ 0 }; chunkX < m_chunksPerRow; ++chunkX)
+        {
+            Chunk chunk;
+            chunk.originX = chunkX * Chunk::SIZE;
+            chunk.originZ = chunkZ * Chunk::SIZE;
+            chunk.width = std::min(Chunk::SIZE, m_mapSize - chunk.originX);
+            chunk.depth = std::min(Chunk::SIZE, m_mapSize - chunk.originZ);
+            chunk.firstSlot = slot;
+            chunk.tileCount = static_cast<uint32_t>(chunk.width * chunk.depth);
+
+            // the Map grows in the negative z direction
+            chunk.boundsMin = glm::vec3(chunk.originX, 0.0f, -static_cast<float>(chunk.originZ + chunk.depth));
+            chunk.boundsMax = glm::vec3(chunk.originX + chunk.width, Chunk::MAX_HEIGHT, -static_cast<float>(chunk.originZ));
+
+            // the Tiles of a Chunk are stored row by row
+            for (auto z{ chunk.originZ }; z < chunk.originZ + chunk.depth; ++z)
+            {
+                for (auto x{ chunk.originX }; x < chunk.originX + chunk.width; ++x)
+                {
+                    m_tileSlots[GetTileMapIndexByMapPosition(x, z)] = slot++;
+                }
+            }
+
+            m_chunks.push_back(chunk);
+        }
     }
 }
 
@@ -704,43 +1084,205 @@ void sg::city::map::Map::StoreRandomColors()
 // Helper
 //-------------------------------------------------
 
-int32_t sg::city::map::Map::GetVerticesCountOfMap() const
+sg::city::map::Map::TypeContainer sg::city::map::Map::ClassifyMapValues(const MapValuesContainer& t_mapValues)
 {
-    return static_cast<int32_t>(m_tiles.size()) * tile::Tile::VERTICES_PER_TILE;
+    TypeContainer tileTypes(t_mapValues.size(), static_cast<uint8_t>(tile::TileType::NONE));
+
+    for (auto i{ static_cast<size_t>(0) }; i < t_mapValues.size(); ++i)
+    {
+        if (IsRoadValue(t_mapValues[i]))
+        {
+            tileTypes[i] = static_cast<uint8_t>(tile::TileType::TRAFFIC);
+        }
+        else if (IsBuildingValue(t_mapValues[i]))
+        {
+            tileTypes[i] = static_cast<uint8_t>(tile::TileType::RESIDENTIAL);
+        }
+    }
+
+    return tileTypes;
 }
 
-void sg::city::map::Map::DepthSearch(tile::Tile& t_startTile, const int t_region)
+uint32_t sg::city::map::Map::GetRegionColorIndex(const int t_region)
 {
-    if (t_startTile.region != tile::Tile::NO_REGION)
+    if (t_region == tile::Tile::NO_REGION)
     {
-        return;
+        return 0;
     }
 
-    auto found{ false };
+    return static_cast<uint32_t>((t_region - 1) % MAX_REGION_COLORS) + 1;
+}
 
+bool sg::city::map::Map::IsRegionTileType(const tile::TileType t_tileType)
+{
     for (auto tileType : tile::Tile::REGION_TILE_TYPES)
     {
-        if (tileType == t_startTile.type)
+        if (tileType == t_tileType)
         {
-            found = true;
-            break;
+            return true;
         }
     }
 
-    if (!found)
+    return false;
+}
+
+void sg::city::map::Map::DepthSearch(const int t_startIndex, const int t_label, ScratchIndexContainer& t_stack)
+{
+    // an explicit stack - the recursion overflows on large regions
+    t_stack.clear();
+    t_stack.push_back(t_startIndex);
+
+    while (!t_stack.empty())
     {
-        return;
+        const auto index{ t_stack.back() };
+        t_stack.pop_back();
+
+        if (m_regionLabels[index] != tile::Tile::NO_REGION || !IsRegionTileType(m_tiles[index]->type))
+        {
+            continue;
+        }
+
+        m_regionLabels[index] = t_label;
+
+        for (auto& neighbour : m_tiles[index]->GetNeighbours())
+        {
+            t_stack.push_back(neighbour.second);
+        }
+    }
+}
+
+void sg::city::map::Map::AssignRegionIds(const int t_labels)
+{
+    const auto nrOfAllTiles{ GetNrOfAllTiles() };
+
+    // each label votes for the old region of its Tiles (majority vote); the new Tiles have no region and do not vote
+    m_regionCandidates.assign(static_cast<size_t>(t_labels) + 1, tile::Tile::NO_REGION);
+    m_regionVotes.assign(static_cast<size_t>(t_labels) + 1, 0);
+
+    for (auto i{ 0 }; i < nrOfAllTiles; ++i)
+    {
+        const auto label{ m_regionLabels[i] };
+        const auto region{ m_tiles[i]->region };
+
+        if (label == tile::Tile::NO_REGION || region == tile::Tile::NO_REGION)
+        {
+            continue;
+        }
+
+        if (m_regionVotes[label] == 0)
+        {
+            m_regionCandidates[label] = region;
+            m_regionVotes[label] = 1;
+        }
+        else if (m_regionCandidates[label] == region)
+        {
+            m_regionVotes[label]++;
+        }
+        else
+        {
+            m_regionVotes[label]--;
+        }
+    }
+
+    // the parts of a split vote for the same region; the largest part keeps the Id
+    std::vector<int> claims;
+    for (auto label{ 1 }; label <= t_labels; ++label)
+    {
+        if (m_regionVotes[label] > 0)
+        {
+            claims.push_back(label);
+        }
+    }
+
+    std::sort(claims.begin(), claims.end(), [this](const int t_lhs, const int t_rhs)
+    {
+        return m_regionVotes[t_lhs] != m_regionVotes[t_rhs] ? m_regionVotes[t_lhs] > m_regionVotes[t_rhs] : t_lhs < t_rhs;
+    });
+
+    m_regionIds.assign(static_cast<size_t>(t_labels) + 1, tile::Tile::NO_REGION);
+    std::vector<bool> usedRegionIds(static_cast<size_t>(std::max(m_maxRegionId, t_labels)) + 1, false);
+
+    for (const auto label : claims)
+    {
+        const auto region{ m_regionCandidates[label] };
+        if (!usedRegionIds[region])
+        {
+            m_regionIds[label] = region;
+            usedRegionIds[region] = true;
+        }
     }
 
-    t_startTile.region = t_region;
+    // new areas and the smaller parts of a split get the smallest free Ids
+    auto freeRegionId{ 1 };
+    m_maxRegionId = 0;
+
+    for (auto label{ 1 }; label <= t_labels; ++label)
+    {
+        if (m_regionIds[label] == tile::Tile::NO_REGION)
+        {
+            while (usedRegionIds[freeRegionId])
+            {
+                freeRegionId++;
+            }
 
-    // changing the color needs also a Vbo update
-    t_startTile.SetColor(static_cast<glm::vec3>(m_randomColors[t_region - 1]));
-    UpdateMapVboByTileIndex(t_startTile.GetMapIndex());
+            m_regionIds[label] = freeRegionId;
+            usedRegionIds[freeRegionId] = true;
+        }
 
-    for (auto& neighbour : t_startTile.GetNeighbours())
+        m_maxRegionId = std::max(m_maxRegionId, m_regionIds[label]);
+    }
+}
+
+void sg::city::map::Map::ApplyRegionIds()
+{
+    SG_CITY_PROFILE_ZONE("Map::ApplyRegionIds");
+
+    // a fixed number of bands, so the slots are always marked in the same order
+    const auto bands{ (m_mapSize + MIN_ROWS_PER_BAND - 1) / MIN_ROWS_PER_BAND };
+    m_changedRegionTiles.resize(bands);
+
+    thread::ThreadPool::Get().ParallelFor(0, bands, 1, [this](const int t_bandBegin, const int t_bandEnd)
     {
-        DepthSearch(*m_tiles[neighbour.second], t_region);
+        for (auto band{ t_bandBegin }; band < t_bandEnd; ++band)
+        {
+            auto& changedTiles{ m_changedRegionTiles[band] };
+            changedTiles.clear();
+
+            const auto begin{ band * MIN_ROWS_PER_BAND * m_mapSize };
+            const auto end{ std::min(begin + MIN_ROWS_PER_BAND * m_mapSize, GetNrOfAllTiles()) };
+
+            for (auto i{ begin }; i < end; ++i)
+            {
+                auto& tile{ *m_tiles[i] };
+                const auto region{ m_regionIds[m_regionLabels[i]] };
+
+                if (tile.region != region)
+                {
+                    tile.region = region;
+                    m_tileAttributes[m_tileSlots[i]] = tile.GetAttribute(GetRegionColorIndex(region));
+                    changedTiles.push_back(i);
+                }
+            }
+        }
+    });
+
+    // the bands are in row order, so the Tiles are sorted
+    m_relabelledTiles.clear();
+    for (const auto& changedTiles : m_changedRegionTiles)
+    {
+        m_relabelledTiles.insert(m_relabelledTiles.end(), changedTiles.begin(), changedTiles.end());
+    }
+
+    // e.g. the first search: one range instead of single slots
+    if (m_relabelledTiles.size() > m_tileAttributes.size() / 4)
+    {
+        m_dirtyTiles.AddRange(0, static_cast<uint32_t>(m_tileAttributes.size()));
+        return;
+    }
+
+    for (const auto tileIndex : m_relabelledTiles)
+    {
+        m_dirtyTiles.Add(m_tileSlots[tileIndex]);
     }
 }
 
@@ -750,27 +1292,97 @@ void sg::city::map::Map::DepthSearch(tile::Tile& t_startTile, const int t_region
 
 void sg::city::map::Map::CreateVbo()
 {
+    /*
+        tL       tR
+        +--------+
+        |  +   2 |
+        |    +   |
+        | 1    + |
+        +--------+
+        bL       bR
+
+        x and z of the unit quad; also used as uv
+    */
+
+    const std::vector<float> quadVertices{
+        0.0f, 0.0f, // bL
+        1.0f, 0.0f, // bR
+        0.0f, 1.0f, // tL
+
+        0.0f, 1.0f, // tL
+        1.0f, 0.0f, // bR
+        1.0f, 1.0f  // tR
+    };
+
+    m_quadVboId = ogl::buffer::Vbo::GenerateVbo();
+    ogl::buffer::Vbo::BindVbo(m_quadVboId);
+    glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(quadVertices.size() * sizeof(float)), quadVertices.data(), GL_STATIC_DRAW);
+    ogl::buffer::Vbo::AddAttribute(m_quadVboId, 0, 2, 2, 0); // 2x position
+
+    // one packed attribute per Tile instance
+    m_tileAttributes.resize(GetNrOfAllTiles());
+
     m_vboId = ogl::buffer::Vbo::GenerateVbo();
+    ogl::buffer::Vbo::BindVbo(m_vboId);
+    glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(m_tileAttributes.size() * tile::Tile::SIZE_IN_BYTES_PER_TILE), nullptr, GL_DYNAMIC_DRAW);
 
-    ogl::buffer::Vbo::InitEmpty(m_vboId, GetFloatCountOfMap(), GL_DYNAMIC_DRAW);
+    glEnableVertexAttribArray(1); // type, flags, region
+    glVertexAttribIPointer(1, 1, GL_UNSIGNED_INT, tile::Tile::SIZE_IN_BYTES_PER_TILE, nullptr);
+    glVertexAttribDivisor(1, 1);
 
-    ogl::buffer::Vbo::AddAttribute(m_vboId, 0, 3, tile::Tile::FLOATS_PER_VERTEX, 0);  // 3x position
-    ogl::buffer::Vbo::AddAttribute(m_vboId, 1, 3, tile::Tile::FLOATS_PER_VERTEX, 3);  // 3x normal
-    ogl::buffer::Vbo::AddAttribute(m_vboId, 2, 3, tile::Tile::FLOATS_PER_VERTEX, 6);  // 3x color
-    ogl::buffer::Vbo::AddAttribute(m_vboId, 3, 1, tile::Tile::FLOATS_PER_VERTEX, 9);  // 1x texture
-    ogl::buffer::Vbo::AddAttribute(m_vboId, 4, 2, tile::Tile::FLOATS_PER_VERTEX, 10); // 2x uv
+    ogl::buffer::Vbo::UnbindVbo();
 }
 
 void sg::city::map::Map::StoreTilesInVbo()
 {
-    ogl::buffer::Vbo::BindVbo(m_vboId);
+    SG_CITY_PROFILE_ZONE("Map::StoreTilesInVbo");
+
+    // all Tiles are packed in parallel and uploaded with the next flush as one range
+    thread::ThreadPool::Get().ParallelFor(0, m_mapSize, MIN_ROWS_PER_BAND, [this](const int t_zBegin, const int t_zEnd)
+    {
+        for (auto i{ t_zBegin * m_mapSize }; i < t_zEnd * m_mapSize; ++i)
+        {
+            m_tileAttributes[m_tileSlots[i]] = m_tiles[i]->GetAttribute(GetRegionColorIndex(m_tiles[i]->region));
+        }
+    });
 
-    auto offset{ 0 };
-    for (const auto& tile : m_tiles)
+    m_dirtyTiles.AddRange(0, static_cast<uint32_t>(m_tileAttributes.size()));
+}
+
+void sg::city::map::Map::CreatePaletteTexture()
+{
+    // row 0: region colors, row 1: TileType colors
+    std::vector<uint8_t> texels(MAX_REGION_COLORS * 2 * 3, 0);
+
+    const auto toByte = [](const float t_value)
+    {
+        return static_cast<uint8_t>(t_value * 255.0f);
+    };
+
+    for (auto i{ 0 }; i < MAX_REGION_COLORS; ++i)
     {
-        glBufferSubData(GL_ARRAY_BUFFER, offset * tile::Tile::SIZE_IN_BYTES_PER_TILE, tile::Tile::SIZE_IN_BYTES_PER_TILE, tile->GetVertices().data());
-        offset++;
+        const auto color{ static_cast<glm::vec3>(m_randomColors.at(i)) };
+
+        texels[i * 3 + 0] = toByte(color.x);
+        texels[i * 3 + 1] = toByte(color.y);
+        texels[i * 3 + 2] = toByte(color.z);
     }
 
-    ogl::buffer::Vbo::UnbindVbo();
+    for (auto tileType : tile::Tile::TILE_TYPES)
+    {
+        const auto& color{ tile::Tile::TILE_TYPE_COLOR.at(tileType) };
+        const auto offset{ (MAX_REGION_COLORS + static_cast<int>(tileType)) * 3 };
+
+        texels[offset + 0] = toByte(color.x);
+        texels[offset + 1] = toByte(color.y);
+        texels[offset + 2] = toByte(color.z);
+    }
+
+    glGenTextures(1, &m_paletteTextureId);
+    glBindTexture(GL_TEXTURE_2D, m_paletteTextureId);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB8, MAX_REGION_COLORS, 2, 0, GL_RGB, GL_UNSIGNED_BYTE, texels.data());
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glBindTexture(GL_TEXTURE_2D, 0);
 }
@@ -9,8 +9,13 @@
 
 #pragma once
 
+#include <memory_resource>
+#include <glm/mat4x4.hpp>
 #include "Color.h"
+#include "Chunk.h"
+#include "DirtyRanges.h"
 #include "tile/Tile.h"
+#include "city/Random.h"
 
 namespace sg::ogl::scene
 {
@@ -27,29 +32,52 @@ namespace sg::city::automata
     class AutoNode;
 }
 
+namespace sg::city::save
+{
+    struct SaveData;
+}
+
 namespace sg::city::map
 {
+    class DebugBatcher;
+
     class Map
     {
     public:
         using VertexContainer = std::vector<float>;
         using MapValuesContainer = std::vector<float>;
+        using HeightContainer = std::vector<float>;
+        using TypeContainer = std::vector<uint8_t>;
 
         using TileTypeTextureContainer = std::unordered_map<tile::TileType, uint32_t, tile::TileTypeHash>;
 
         using TileUniquePtr = std::unique_ptr<tile::Tile>;
-        using TileContainer = std::vector<TileUniquePtr>;
+        using TileContainer = memory::TrackedVector<TileUniquePtr, memory::Tag::TILES>;
 
         using NavigationNodeSharedPtr = std::shared_ptr<automata::AutoNode>;
-        using NavigationNodeContainer = std::vector<NavigationNodeSharedPtr>;
-        using TileNavigationNodeContainer = std::vector<NavigationNodeContainer>;
+        using NavigationNodeContainer = memory::TrackedVector<NavigationNodeSharedPtr, memory::Tag::NAV_NODES>;
+        using TileNavigationNodeContainer = memory::TrackedVector<NavigationNodeContainer, memory::Tag::NAV_NODES>;
 
         using RandomColorContainer = std::unordered_map<int, ogl::Color>;
 
         using MeshUniquePtr = std::unique_ptr<ogl::resource::Mesh>;
+        using DebugBatcherUniquePtr = std::unique_ptr<DebugBatcher>;
 
         using BuildingTextureContainer = std::vector<uint32_t>;
 
+        using TileAttributeContainer = memory::TrackedVector<uint32_t, memory::Tag::TILES>;
+        using TileSlotContainer = memory::TrackedVector<uint32_t, memory::Tag::TILES>;
+
+        using ChunkContainer = std::vector<Chunk>;
+        using ChunkIndexContainer = std::vector<uint32_t>;
+
+        using ScratchIndexContainer = std::pmr::vector<int>;
+
+        using RegionLabelContainer = memory::TrackedVector<int, memory::Tag::TILES>;
+        using RegionIdContainer = std::vector<int>;
+        using RegionTileContainer = std::vector<std::vector<int>>;
+        using RelabelledTileContainer = std::vector<int>;
+
         //-------------------------------------------------
         // Const
         //-------------------------------------------------
@@ -59,6 +87,11 @@ namespace sg::city::map
          */
         static constexpr auto MAX_REGION_COLORS{ 200 };
 
+        /**
+         * @brief Each Tile is drawn as an instance of a unit quad with 2 triangles.
+         */
+        static constexpr auto VERTICES_PER_TILE{ 6 };
+
         /**
          * @brief The default height for debug stuff.
          */
@@ -74,9 +107,10 @@ namespace sg::city::map
          */
         static constexpr auto NODES_PER_TILE{ 49 };
 
-        static constexpr const char* MAP_FILE_NAME{ "res/config/CityMap.map" };
-        inline static const auto MAP_FILE_HEADER_INFO{ "sg_city_map" };
-        static constexpr auto MAP_FILE_HEADER_LENGTH{ 11 };
+        /**
+         * @brief The smallest row band of the parallel creation steps.
+         */
+        static constexpr auto MIN_ROWS_PER_BAND{ 16 };
 
         //-------------------------------------------------
         // Public member
@@ -89,6 +123,11 @@ namespace sg::city::map
         bool wireframeMode{ false };
         bool showRegions{ false };
 
+        /**
+         * @brief The Map-x and Map-z position of the Tile under the mouse; -1 if there is none.
+         */
+        glm::ivec2 hoveredTile{ -1 };
+
         /**
          * @brief Here all indices are pushed from roads so that iterations can be made more quickly later.
          */
@@ -98,13 +137,24 @@ namespace sg::city::map
 
         MapValuesContainer mapValues;
 
+        /**
+         * @brief The terrain height of each Tile from the height channel of the map file; empty without one.
+         */
+        HeightContainer heightValues;
+
         //-------------------------------------------------
         // Ctors. / Dtor.
         //-------------------------------------------------
 
         Map() = delete;
 
-        Map(ogl::scene::Scene* t_scene, std::string t_mapFileName);
+        /**
+         * @brief Constructs an empty Map.
+         * @param t_scene The parent Scene. May be nullptr if the Map is created with CreateMapFromValues().
+         * @param t_mapFileName The Map file loaded by CreateMap().
+         * @param t_random The random service.
+         */
+        Map(ogl::scene::Scene* t_scene, std::string t_mapFileName, const random::Random& t_random);
 
         Map(const Map& t_other) = delete;
         Map(Map&& t_other) noexcept = delete;
@@ -136,16 +186,66 @@ namespace sg::city::map
         [[nodiscard]] const ogl::resource::Mesh& GetMapMesh() const noexcept;
         [[nodiscard]] ogl::resource::Mesh& GetMapMesh() noexcept;
 
-        [[nodiscard]] uint32_t GetFloatCountOfMap() const;
+        [[nodiscard]] const TileAttributeContainer& GetTileAttributes() const noexcept;
+
+        /**
+         * @brief Returns the Id of the palette texture.
+         *        Row 0 holds the region colors, row 1 the TileType colors.
+         * @return uint32_t
+         */
+        [[nodiscard]] uint32_t GetPaletteTextureId() const;
 
         [[nodiscard]] const TileNavigationNodeContainer& GetNavigationNodes() const noexcept;
         [[nodiscard]] TileNavigationNodeContainer& GetNavigationNodes() noexcept;
 
+        /**
+         * @brief The Navigation Nodes of a Tile. Only roads have Nodes; the container of any other Tile is empty,
+         *        unless the Tile was a road before.
+         * @param t_index The index of the Tile.
+         * @return NavigationNodeContainer
+         */
         [[nodiscard]] const NavigationNodeContainer& GetNavigationNodes(int t_index) const noexcept;
         [[nodiscard]] NavigationNodeContainer& GetNavigationNodes(int t_index) noexcept;
 
         [[nodiscard]] int GetNumRegions() const;
 
+        /**
+         * @brief The region Ids are stable and may have gaps. All Ids are in [1, GetMaxRegionId()].
+         * @return int
+         */
+        [[nodiscard]] int GetMaxRegionId() const;
+
+        /**
+         * @brief The Tiles whose region Id was changed by the last FindConnectedRegions(), in ascending order.
+         * @return RelabelledTileContainer
+         */
+        [[nodiscard]] const RelabelledTileContainer& GetRelabelledTiles() const noexcept;
+
+        [[nodiscard]] const ChunkContainer& GetChunks() const noexcept;
+
+        /**
+         * @brief The Tiles are stored Chunk by Chunk in the Tile attribute Vbo.
+         * @param t_tileIndex The index of the Tile in the Map.
+         * @return The instance slot of the Tile in the Vbo.
+         */
+        [[nodiscard]] uint32_t GetTileSlot(int t_tileIndex) const;
+
+        [[nodiscard]] uint32_t GetChunkIndex(int t_tileIndex) const;
+
+        /**
+         * @brief Returns the number of glBufferSubData calls of the last flush that had changed Tiles.
+         * @return uint32_t
+         */
+        [[nodiscard]] uint32_t GetLastTileUploads() const;
+
+        /**
+         * @brief Returns the number of bytes uploaded by the last flush; 0 if nothing has changed.
+         * @return uint32_t
+         */
+        [[nodiscard]] uint32_t GetLastTileUploadBytes() const;
+
+        [[nodiscard]] DebugBatcher& GetDebugBatcher() noexcept;
+
         //-------------------------------------------------
         // Get Tile
         //-------------------------------------------------
@@ -168,39 +268,140 @@ namespace sg::city::map
 
         void CreateMap();
 
+        /**
+         * @brief Creates the Map from saved TileTypes instead of the Map file.
+         *        The roads get their saved state later with Restore().
+         * @param t_mapSize The number of Tiles in the x and z direction.
+         * @param t_tileTypes One TileType per Tile.
+         */
+        void CreateMap(int t_mapSize, const TypeContainer& t_tileTypes);
+
+        /**
+         * @brief Creates the Tiles, Nodes and Chunks from the given values without any Gpu resources.
+         *        The Map cannot be rendered afterwards. Used by the benchmarks.
+         * @param t_mapSize The number of Tiles in the x and z direction.
+         * @param t_mapValues One value per Tile, encoded like the red channel of a Map file.
+         */
+        void CreateMapFromValues(int t_mapSize, MapValuesContainer t_mapValues);
+
+        /**
+         * @brief Like CreateMapFromValues(), but from saved TileTypes.
+         * @param t_mapSize The number of Tiles in the x and z direction.
+         * @param t_tileTypes One TileType per Tile.
+         */
+        void CreateMapFromTypes(int t_mapSize, const TypeContainer& t_tileTypes);
+
         //-------------------------------------------------
         // Update
         //-------------------------------------------------
 
-        void UpdateMapVboByTileIndex(int t_tileIndex) const;
+        /**
+         * @brief Packs the Tile into 4 bytes and marks them for the next upload.
+         * @param t_tileIndex The index of the changed Tile.
+         */
+        void UpdateMapVboByTileIndex(int t_tileIndex);
+
+        /**
+         * @brief Uploads all Tiles changed since the last call; one glBufferSubData per merged range.
+         *        Should be called once per frame.
+         */
+        void FlushTileAttributes();
+
+        //-------------------------------------------------
+        // Edit
+        //-------------------------------------------------
+
+        /**
+         * @brief Creates a new Tile object for the given type. The neighbours of the old Tile are kept.
+         *        The caller is responsible for the buildings, tracks and events of the old Tile.
+         * @param t_tileIndex The index of the Tile.
+         * @param t_tileType The new TileType.
+         */
+        void ReplaceTile(int t_tileIndex, tile::TileType t_tileType);
 
         //-------------------------------------------------
         // Regions
         //-------------------------------------------------
 
+        /**
+         * @brief Gives all connected Tiles of the REGION_TILE_TYPES the same region Id.
+         *        The region Ids start with 1; Tile::NO_REGION is 0.
+         *        The Ids are stable: a connected area keeps the Id of the old region most of its Tiles
+         *        belonged to, so a growing region and the larger part of a merge or split keep their color.
+         *        The other areas get the smallest free Ids. Only the Tiles with a new Id are packed again.
+         */
         void FindConnectedRegions();
 
         //-------------------------------------------------
-        // File I/O
+        // Chunks
         //-------------------------------------------------
 
-        void SaveMap();
-        void LoadMap();
+        /**
+         * @brief Collects all Chunks whose bounds intersect the view frustum.
+         * @param t_matrix The model-view-projection matrix of the Map.
+         * @param t_visibleChunks Receives the indices of the visible Chunks.
+         */
+        void FindVisibleChunks(const glm::mat4& t_matrix, ChunkIndexContainer& t_visibleChunks) const;
+
+        //-------------------------------------------------
+        // Save game
+        //-------------------------------------------------
+
+        /**
+         * @brief Stores the Tiles, trees, regions, road types and traffic signals.
+         * @param t_saveData Receives the state of the Map.
+         */
+        void Save(save::SaveData& t_saveData) const;
+
+        /**
+         * @brief Gives the roads their saved types and signals and the Tiles their saved regions.
+         *        The Map must be created from the saved TileTypes before. Nothing is derived
+         *        from the neighbours; all Tiles are packed once for the next flush.
+         * @param t_saveData The state of the Map.
+         */
+        void Restore(const save::SaveData& t_saveData);
 
         //-------------------------------------------------
         // Debug
         //-------------------------------------------------
 
         /**
-         * @brief Create a Mesh from the Navigation Nodes.
+         * @brief Replaces the debug points of the Navigation Nodes of a Tile.
+         * @param t_tileIndex The index of the Tile.
+         */
+        void UpdateNavigationNodesDebugPoints(int t_tileIndex);
+
+        /**
+         * @brief Recolors the debug points of a Tile after the block state of its Nodes has changed.
+         * @param t_tileIndex The index of the Tile.
          */
-        void CreateNavigationNodesMesh();
+        void UpdateNavigationNodesDebugColors(int t_tileIndex);
 
         /**
-         * @brief Render the Navigation Nodes.
+         * @brief Render the Navigation Nodes of all Tiles with one draw call.
          */
         void RenderNavigationNodes() const;
 
+        /**
+         * @brief Render the Auto Tracks of all Tiles with one draw call.
+         */
+        void RenderAutoTracks() const;
+
+        //-------------------------------------------------
+        // Values
+        //-------------------------------------------------
+
+        /**
+         * @brief The classification of a map value.
+         *        A value is encoded like the red channel of a Map file: 1.0 road, 0.4 - 0.6 building, 0.2 - 0.3 tree.
+         * @param t_value The value.
+         * @return bool
+         */
+        [[nodiscard]] static bool IsRoadValue(float t_value);
+
+        [[nodiscard]] static bool IsBuildingValue(float t_value);
+        [[nodiscard]] static bool IsTreeValue(float t_value);
+
     protected:
 
     private:
@@ -216,9 +417,9 @@ namespace sg::city::map
         std::string m_mapFileName;
 
         /**
-         * @brief The Id of the map texture.
+         * @brief A copy of the random service of the City.
          */
-        uint32_t m_mapTextureId{ 0 };
+        random::Random m_random;
 
         /**
          * @brief The number of tiles in the x and z direction.
@@ -256,25 +457,90 @@ namespace sg::city::map
         MeshUniquePtr m_mapMesh;
 
         /**
-         * @brief The Id of Vbo holding the vertices.
+         * @brief The Id of the Vbo holding the unit quad.
+         */
+        uint32_t m_quadVboId{ 0 };
+
+        /**
+         * @brief The packed Tile attributes. Used as staging buffer for the Vbo.
+         */
+        TileAttributeContainer m_tileAttributes;
+
+        /**
+         * @brief The Id of Vbo holding one attribute per Tile.
          */
         uint32_t m_vboId{ 0 };
 
+        /**
+         * @brief The slots of the Tile attributes changed since the last flush.
+         */
+        DirtyRanges m_dirtyTiles;
+
+        uint32_t m_lastTileUploads{ 0 };
+        uint32_t m_lastTileUploadBytes{ 0 };
+
+        /**
+         * @brief The Id of the palette texture with the region and TileType colors.
+         */
+        uint32_t m_paletteTextureId{ 0 };
+
+        /**
+         * @brief The Chunks of the Map, row by row.
+         */
+        ChunkContainer m_chunks;
+
+        /**
+         * @brief The number of Chunks in the x and z direction.
+         */
+        int m_chunksPerRow{ 0 };
+
+        /**
+         * @brief The instance slot of each Tile in the Tile attribute Vbo.
+         */
+        TileSlotContainer m_tileSlots;
+
         /**
          * @brief The current number of regions.
          */
         int m_numRegions{ 0 };
 
         /**
-         * @brief Navigation Nodes for each Tile.
+         * @brief The largest region Id in use.
+         */
+        int m_maxRegionId{ 0 };
+
+        /**
+         * @brief The connected area of each Tile, numbered in scan order by the last search.
+         */
+        RegionLabelContainer m_regionLabels;
+
+        /**
+         * @brief The region Id of each label; the old region with the most votes and its number of votes.
+         */
+        RegionIdContainer m_regionIds;
+        RegionIdContainer m_regionCandidates;
+        RegionIdContainer m_regionVotes;
+
+        /**
+         * @brief The Tiles whose region Id has changed, one container per row band. Kept to reuse the memory.
+         */
+        RegionTileContainer m_changedRegionTiles;
+
+        /**
+         * @brief The Tiles of all bands of the last search.
+         */
+        RelabelledTileContainer m_relabelledTiles;
+
+        /**
+         * @brief Navigation Nodes for each Tile. Empty for a Tile that has never been a road.
          */
         TileNavigationNodeContainer m_tileNavigationNodes;
 
         /**
-         * @brief A Mesh with one Vertex for each Navigation Node.
+         * @brief The lines of the Auto Tracks and the points of the Navigation Nodes.
          *        Used for debugging purposes.
          */
-        MeshUniquePtr m_navigationNodesMesh;
+        DebugBatcherUniquePtr m_debugBatcher;
 
         //-------------------------------------------------
         // Init
@@ -282,19 +548,62 @@ namespace sg::city::map
 
         void StoreMapFileValues();
         void StoreTextures();
-        void StoreTiles();
+
+        /**
+         * @brief Creates Tiles, neighbours, Navigation Nodes and Chunks.
+         * @param t_tileTypes One TileType per Tile.
+         */
+        void StoreMapData(const TypeContainer& t_tileTypes);
+
+        void StoreTiles(const TypeContainer& t_tileTypes);
+        void StorePlantPositions();
         void StoreTileNeighbours();
         void StoreTileNavigationNodes();
         void LinkTileNavigationNodes();
+
+        /**
+         * @brief Creates the Navigation Nodes of a Tile in one allocation.
+         *        The corners and the inner Nodes next to the center are not used by any track and stay nullptr.
+         * @param t_tileIndex The index of the Tile.
+         */
+        void StoreNavigationNodes(int t_tileIndex);
+
+        /**
+         * @brief Replaces the border Nodes of a Tile with the shared Nodes of its neighbours that have Nodes.
+         * @param t_tileIndex The index of the Tile.
+         * @param t_allNeighbours Also the south and west neighbour. Only for a single new road; when all roads
+         *                        are linked at once, the north and east neighbour own the shared Nodes.
+         */
+        void LinkNavigationNodes(int t_tileIndex, bool t_allNeighbours);
         void StoreRandomColors();
+        void StoreChunks();
 
         //-------------------------------------------------
         // Helper
         //-------------------------------------------------
 
-        [[nodiscard]] int32_t GetVerticesCountOfMap() const;
+        [[nodiscard]] static uint32_t GetRegionColorIndex(int t_region);
 
-        void DepthSearch(tile::Tile& t_startTile, int t_region);
+        /**
+         * @brief The TileType of each map value: a road, a building or nothing.
+         * @param t_mapValues The values.
+         * @return TypeContainer
+         */
+        [[nodiscard]] static TypeContainer ClassifyMapValues(const MapValuesContainer& t_mapValues);
+
+        [[nodiscard]] static bool IsRegionTileType(tile::TileType t_tileType);
+        void DepthSearch(int t_startIndex, int t_label, ScratchIndexContainer& t_stack);
+
+        /**
+         * @brief Maps each label of the last search to a region Id.
+         * @param t_labels The number of labels.
+         */
+        void AssignRegionIds(int t_labels);
+
+        /**
+         * @brief Writes the new region Ids in row bands and marks the changed Tiles for the next flush.
+         */
+        void ApplyRegionIds();
 
         //-------------------------------------------------
         // Vbo
@@ -302,5 +611,6 @@ namespace sg::city::map
 
         void CreateVbo();
         void StoreTilesInVbo();
+        void CreatePaletteTexture();
     };
 };
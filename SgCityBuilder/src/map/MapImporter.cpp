@@ -0,0 +1,169 @@
+// This file is part of the SgCityBuilder package.
+// 
+// Filename: MapImporter.cpp
+// Author:   stwe
+// 
+// License:  MIT
+// 
+// 2020 (c) stwe <https://github.com/stwe/SgCityBuilder>
+
+#include <vector>
+#include <stdexcept>
+#include <Log.h>
+#include "MapImporter.h"
+#include "PngDecoder.h"
+#include "city/Profiler.h"
+
+//-------------------------------------------------
+// Import
+//-------------------------------------------------
+
+sg::city::map::ImportedMap sg::city::map::MapImporter::Import(const std::string& t_fileName, const ImportOptions& t_options)
+{
+    SG_CITY_PROFILE_ZONE("MapImporter::Import");
+
+    PngDecoder decoder{ t_fileName };
+
+    const auto& header{ decoder.GetHeader() };
+    const auto channels{ static_cast<int>(decoder.GetChannels()) };
+
+    const auto isValidChannel{ [channels](const int t_channel)
+    {
+        return t_channel == ImportOptions::NO_CHANNEL || (t_channel >= 0 && t_channel < channels);
+    } };
+
+    if (t_options.zoneChannel < 0 || !isValidChannel(t_options.zoneChannel) || !isValidChannel(t_options.treeChannel) || !isValidChannel(t_options.heightChannel))
+    {
+        throw std::runtime_error("[MapImporter::Import()] The image " + t_fileName + " has only " + std::to_string(channels) + " channels.");
+    }
+
+    SG_OGL_LOG_DEBUG("[MapImporter::Import()] Import {}x{} pixels with {} channels from {}.", header.width, header.height, channels, t_fileName);
+
+    const auto zoneLut{ CreateZoneLut() };
+    const auto heightLut{ CreateHeightLut(t_options.maxHeight) };
+
+    ImportedMap importedMap;
+    importedMap.width = header.width;
+    importedMap.height = header.height;
+    importedMap.values.resize(static_cast<size_t>(header.width) * header.height);
+
+    const auto hasTrees{ t_options.treeChannel != ImportOptions::NO_CHANNEL };
+    const auto hasHeights{ t_options.heightChannel != ImportOptions::NO_CHANNEL };
+    if (hasHeights)
+    {
+        importedMap.heights.resize(importedMap.values.size());
+    }
+
+    // without a tree channel the tree lookup reads the zone channel and never finds a tree
+    auto treeLut{ CreateTreeLut(t_options.treeThreshold) };
+    if (!hasTrees)
+    {
+        treeLut.fill(NONE);
+    }
+
+    const auto zoneChannel{ static_cast<size_t>(t_options.zoneChannel) };
+    const auto treeChannel{ static_cast<size_t>(hasTrees ? t_options.treeChannel : t_options.zoneChannel) };
+    const auto heightChannel{ static_cast<size_t>(hasHeights ? t_options.heightChannel : t_options.zoneChannel) };
+    const auto stride{ static_cast<size_t>(channels) };
+
+    std::vector<uint8_t> zones(header.width);
+    std::array<uint64_t, NR_OF_ZONES> zoneCounts{};
+
+    static_assert(NONE == 0, "A tree is masked in on NONE.");
+
+    // a row of the image is a row of Tiles; the loops over a row have no branches per pixel
+    decoder.Decode([&](const uint32_t t_row, const uint8_t* t_pixels)
+    {
+        const auto offset{ static_cast<size_t>(t_row) * header.width };
+
+        // a tree grows only on a Tile without a zone
+        for (auto x{ 0u }; x < header.width; ++x)
+        {
+            const auto zone{ zoneLut[t_pixels[x * stride + zoneChannel]] };
+            const auto tree{ treeLut[t_pixels[x * stride + treeChannel]] };
+            zones[x] = zone | (tree & static_cast<uint8_t>(-static_cast<int>(zone == NONE)));
+        }
+
+        auto* values{ importedMap.values.data() + offset };
+        for (auto x{ 0u }; x < header.width; ++x)
+        {
+            values[x] = ZONE_VALUES[zones[x]];
+            zoneCounts[zones[x]]++;
+        }
+
+        if (hasHeights)
+        {
+            auto* heights{ importedMap.heights.data() + offset };
+            for (auto x{ 0u }; x < header.width; ++x)
+            {
+                heights[x] = heightLut[t_pixels[x * stride + heightChannel]];
+            }
+        }
+    });
+
+    importedMap.roads = static_cast<uint32_t>(zoneCounts[ROAD]);
+    importedMap.buildings = static_cast<uint32_t>(zoneCounts[BUILDING]);
+    importedMap.trees = static_cast<uint32_t>(zoneCounts[TREE]);
+
+    SG_OGL_LOG_DEBUG("[MapImporter::Import()] {} roads, {} buildings and {} trees.", importedMap.roads, importedMap.buildings, importedMap.trees);
+
+    return importedMap;
+}
+
+//-------------------------------------------------
+// Lookup tables
+//-------------------------------------------------
+
+sg::city::map::MapImporter::ZoneLut sg::city::map::MapImporter::CreateZoneLut()
+{
+    ZoneLut zoneLut{};
+
+    for (auto i{ 0u }; i < zoneLut.size(); ++i)
+    {
+        // the same float as an unsigned normalized texel read back from GL
+        const auto value{ static_cast<float>(i) / 255.0f };
+
+        if (Map::IsRoadValue(value))
+        {
+            zoneLut[i] = ROAD;
+        }
+        else if (Map::IsBuildingValue(value))
+        {
+            zoneLut[i] = BUILDING;
+        }
+        else if (Map::IsTreeValue(value))
+        {
+            zoneLut[i] = TREE;
+        }
+        else
+        {
+            zoneLut[i] = NONE;
+        }
+    }
+
+    return zoneLut;
+}
+
+sg::city::map::MapImporter::TreeLut sg::city::map::MapImporter::CreateTreeLut(const uint8_t t_threshold)
+{
+    TreeLut treeLut{};
+
+    for (auto i{ 0u }; i < treeLut.size(); ++i)
+    {
+        treeLut[i] = i >= t_threshold ? TREE : NONE;
+    }
+
+    return treeLut;
+}
+
+sg::city::map::MapImporter::HeightLut sg::city::map::MapImporter::CreateHeightLut(const float t_maxHeight)
+{
+    HeightLut heightLut{};
+
+    for (auto i{ 0u }; i < heightLut.size(); ++i)
+    {
+        heightLut[i] = static_cast<float>(i) / 255.0f * t_maxHeight;
+    }
+
+    return heightLut;
+}
@@ -0,0 +1,124 @@
+// This file is part of the SgCityBuilder package.
+// 
+// Filename: MapImporter.h
+// Author:   stwe
+// 
+// License:  MIT
+// 
+// 2020 (c) stwe <https://github.com/stwe/SgCityBuilder>
+
+#pragma once
+
+#include <array>
+#include <string>
+#include "Map.h"
+
+namespace sg::city::map
+{
+    /**
+     * @brief Which channels of the image hold the zones, the trees and the terrain height.
+     */
+    struct ImportOptions
+    {
+        static constexpr auto NO_CHANNEL{ -1 };
+
+        /**
+         * @brief Classified with the thresholds of the Map: 1.0 road, 0.4 - 0.6 building, 0.2 - 0.3 tree.
+         */
+        int zoneChannel{ 0 };
+
+        /**
+         * @brief A value of at least treeThreshold plants a tree on an empty Tile.
+         */
+        int treeChannel{ NO_CHANNEL };
+        uint8_t treeThreshold{ 128 };
+
+        /**
+         * @brief 0 is the ground, 255 is maxHeight.
+         */
+        int heightChannel{ NO_CHANNEL };
+        float maxHeight{ 1.0f };
+    };
+
+    /**
+     * @brief The result of an import.
+     */
+    struct ImportedMap
+    {
+        uint32_t width{ 0 };
+        uint32_t height{ 0 };
+
+        /**
+         * @brief One value per Tile with the encoding of Map::mapValues.
+         */
+        Map::MapValuesContainer values;
+
+        /**
+         * @brief One height per Tile; empty without a height channel.
+         */
+        Map::HeightContainer heights;
+
+        uint32_t roads{ 0 };
+        uint32_t buildings{ 0 };
+        uint32_t trees{ 0 };
+    };
+
+    /**
+     * @brief Creates the values of a Map from an image file on the Cpu.
+     *        The image is decoded once by libpng and classified row by row with lookup tables.
+     *        The loops over a row have no branches per pixel. No GL context is needed.
+     */
+    class MapImporter
+    {
+    public:
+        //-------------------------------------------------
+        // Ctors. / Dtor.
+        //-------------------------------------------------
+
+        MapImporter() = delete;
+
+        MapImporter(const MapImporter& t_other) = delete;
+        MapImporter(MapImporter&& t_other) noexcept = delete;
+        MapImporter& operator=(const MapImporter& t_other) = delete;
+        MapImporter& operator=(MapImporter&& t_other) noexcept = delete;
+
+        ~MapImporter() noexcept = delete;
+
+        //-------------------------------------------------
+        // Import
+        //-------------------------------------------------
+
+        /**
+         * @brief Imports a PNG file. Throws a std::runtime_error if the file cannot be used.
+         * @param t_fileName The image file.
+         * @param t_options The channels to use.
+         * @return ImportedMap
+         */
+        static ImportedMap Import(const std::string& t_fileName, const ImportOptions& t_options = ImportOptions());
+
+    protected:
+
+    private:
+        enum Zone : uint8_t
+        {
+            NONE,
+            ROAD,
+            BUILDING,
+            TREE,
+            NR_OF_ZONES
+        };
+
+        using ZoneLut = std::array<uint8_t, 256>;
+        using TreeLut = std::array<uint8_t, 256>; // TREE or NONE
+        using HeightLut = std::array<float, 256>;
+
+        /**
+         * @brief The value stored in the Map for each Zone.
+         */
+        static constexpr float ZONE_VALUES[NR_OF_ZONES]{ 0.0f, 1.0f, 0.5f, 0.25f };
+
+        [[nodiscard]] static ZoneLut CreateZoneLut();
+        [[nodiscard]] static TreeLut CreateTreeLut(uint8_t t_threshold);
+        [[nodiscard]] static HeightLut CreateHeightLut(float t_maxHeight);
+    };
+}
@@ -0,0 +1,215 @@
+// This file is part of the SgCityBuilder package.
+// 
+// Filename: PngDecoder.cpp
+// Author:   stwe
+// 
+// License:  MIT
+// 
+// 2020 (c) stwe <https://github.com/stwe/SgCityBuilder>
+
+#include <csetjmp>
+#include <stdexcept>
+#include "PngDecoder.h"
+
+//-------------------------------------------------
+// Ctors. / Dtor.
+//-------------------------------------------------
+
+sg::city::map::PngDecoder::PngDecoder(const std::string& t_fileName)
+    : m_fileName{ t_fileName }
+    , m_file{ std::fopen(t_fileName.c_str(), "rb"), &std::fclose }
+{
+    if (!m_file)
+    {
+        throw std::runtime_error("[PngDecoder::PngDecoder()] Unable to open " + t_fileName);
+    }
+
+    // the destructor is not called if the constructor throws
+    try
+    {
+        Open();
+    }
+    catch (...)
+    {
+        Destroy();
+        throw;
+    }
+}
+
+sg::city::map::PngDecoder::~PngDecoder() noexcept
+{
+    Destroy();
+}
+
+//-------------------------------------------------
+// Getter
+//-------------------------------------------------
+
+const sg::city::map::PngDecoder::Header& sg::city::map::PngDecoder::GetHeader() const noexcept
+{
+    return m_header;
+}
+
+uint32_t sg::city::map::PngDecoder::GetChannels() const noexcept
+{
+    return m_channels;
+}
+
+//-------------------------------------------------
+// Decode
+//-------------------------------------------------
+
+void sg::city::map::PngDecoder::Decode(const RowFunction& t_rowFunction)
+{
+    if (m_decoded)
+    {
+        Fail("[PngDecoder::Decode()] The image is already decoded.");
+    }
+
+    m_decoded = true;
+
+    ByteContainer row(m_rowBytes);
+
+    for (auto y{ 0u }; y < m_header.height; ++y)
+    {
+        if (!ReadRow(row.data()))
+        {
+            Fail("[PngDecoder::Decode()] " + m_error);
+        }
+
+        t_rowFunction(y, row.data());
+    }
+
+    // the CRC of the last chunks
+    if (!ReadEnd())
+    {
+        Fail("[PngDecoder::Decode()] " + m_error);
+    }
+}
+
+//-------------------------------------------------
+// libpng
+//-------------------------------------------------
+
+void sg::city::map::PngDecoder::Open()
+{
+    m_png = png_create_read_struct(PNG_LIBPNG_VER_STRING, this, &OnError, &OnWarning);
+    if (!m_png)
+    {
+        Fail("[PngDecoder::Open()] Unable to create the png read struct.");
+    }
+
+    m_info = png_create_info_struct(m_png);
+    if (!m_info)
+    {
+        Fail("[PngDecoder::Open()] Unable to create the png info struct.");
+    }
+
+    png_init_io(m_png, m_file.get());
+    png_set_user_limits(m_png, MAX_SIZE, MAX_SIZE);
+
+    if (!ReadInfo())
+    {
+        Fail("[PngDecoder::Open()] " + m_error);
+    }
+
+    if (m_header.interlace != PNG_INTERLACE_NONE)
+    {
+        Fail("[PngDecoder::Open()] Interlaced files are not supported.");
+    }
+}
+
+void sg::city::map::PngDecoder::Destroy() noexcept
+{
+    if (m_png)
+    {
+        png_destroy_read_struct(&m_png, m_info ? &m_info : nullptr, nullptr);
+    }
+
+    m_png = nullptr;
+    m_info = nullptr;
+}
+
+bool sg::city::map::PngDecoder::ReadInfo() noexcept
+{
+    if (setjmp(png_jmpbuf(m_png)))
+    {
+        return false;
+    }
+
+    png_read_info(m_png, m_info);
+
+    m_header.width = png_get_image_width(m_png, m_info);
+    m_header.height = png_get_image_height(m_png, m_info);
+    m_header.bitDepth = png_get_bit_depth(m_png, m_info);
+    m_header.colorType = png_get_color_type(m_png, m_info);
+    m_header.interlace = png_get_interlace_type(m_png, m_info);
+
+    // 8 bit samples: 16 bit keeps the most significant byte, 1, 2 and 4 bit gray is scaled to 0..255
+    png_set_strip_16(m_png);
+    png_set_packing(m_png);
+
+    if (m_header.colorType == COLOR_TYPE_GRAY && m_header.bitDepth < 8)
+    {
+        png_set_expand_gray_1_2_4_to_8(m_png);
+    }
+
+    if (m_header.colorType == COLOR_TYPE_PALETTE)
+    {
+        png_set_palette_to_rgb(m_png);
+
+        if (png_get_valid(m_png, m_info, PNG_INFO_tRNS))
+        {
+            png_set_tRNS_to_alpha(m_png);
+        }
+    }
+
+    png_read_update_info(m_png, m_info);
+
+    m_channels = png_get_channels(m_png, m_info);
+    m_rowBytes = static_cast<uint32_t>(png_get_rowbytes(m_png, m_info));
+
+    return true;
+}
+
+bool sg::city::map::PngDecoder::ReadRow(uint8_t* t_row) noexcept
+{
+    if (setjmp(png_jmpbuf(m_png)))
+    {
+        return false;
+    }
+
+    png_read_row(m_png, t_row, nullptr);
+
+    return true;
+}
+
+bool sg::city::map::PngDecoder::ReadEnd() noexcept
+{
+    if (setjmp(png_jmpbuf(m_png)))
+    {
+        return false;
+    }
+
+    png_read_end(m_png, nullptr);
+
+    return true;
+}
+
+void sg::city::map::PngDecoder::OnError(png_structp t_png, const png_const_charp t_message)
+{
+    auto* decoder{ static_cast<PngDecoder*>(png_get_error_ptr(t_png)) };
+    decoder->m_error = t_message;
+
+    png_longjmp(t_png, 1);
+}
+
+void sg::city::map::PngDecoder::OnWarning(png_structp, png_const_charp)
+{
+    // e.g. an unknown ancillary chunk; the image data is still valid
+}
+
+[[noreturn]] void sg::city::map::PngDecoder::Fail(const std::string& t_message) const
+{
+    throw std::runtime_error(t_message + " File: " + m_fileName);
+}
@@ -0,0 +1,150 @@
+// This file is part of the SgCityBuilder package.
+// 
+// Filename: PngDecoder.h
+// Author:   stwe
+// 
+// License:  MIT
+// 
+// 2020 (c) stwe <https://github.com/stwe/SgCityBuilder>
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdio>
+#include <cstdint>
+#include <functional>
+#include <png.h>
+
+namespace sg::city::map
+{
+    /**
+     * @brief Decodes a PNG file on the Cpu with libpng, without a GL context.
+     *        The image is streamed row by row, so large Map files do not need a full pixel buffer.
+     *        Interlaced files are not supported.
+     */
+    class PngDecoder
+    {
+    public:
+        using ByteContainer = std::vector<uint8_t>;
+
+        /**
+         * @brief Is called for each row from top to bottom with 8 bit samples, the channels interleaved.
+         */
+        using RowFunction = std::function<void(uint32_t, const uint8_t*)>;
+
+        struct Header
+        {
+            uint32_t width{ 0 };
+            uint32_t height{ 0 };
+            uint8_t bitDepth{ 0 };
+            uint8_t colorType{ 0 };
+            uint8_t interlace{ 0 };
+        };
+
+        //-------------------------------------------------
+        // Const
+        //-------------------------------------------------
+
+        static constexpr uint8_t COLOR_TYPE_GRAY{ PNG_COLOR_TYPE_GRAY };
+        static constexpr uint8_t COLOR_TYPE_RGB{ PNG_COLOR_TYPE_RGB };
+        static constexpr uint8_t COLOR_TYPE_PALETTE{ PNG_COLOR_TYPE_PALETTE };
+        static constexpr uint8_t COLOR_TYPE_GRAY_ALPHA{ PNG_COLOR_TYPE_GRAY_ALPHA };
+        static constexpr uint8_t COLOR_TYPE_RGBA{ PNG_COLOR_TYPE_RGBA };
+
+        /**
+         * @brief The largest accepted width and height.
+         */
+        static constexpr uint32_t MAX_SIZE{ 1u << 15 };
+
+        //-------------------------------------------------
+        // Ctors. / Dtor.
+        //-------------------------------------------------
+
+        /**
+         * @brief Opens the file and reads all chunks before the image data.
+         *        Throws a std::runtime_error if the file is not a supported PNG.
+         * @param t_fileName The PNG file.
+         */
+        explicit PngDecoder(const std::string& t_fileName);
+
+        PngDecoder(const PngDecoder& t_other) = delete;
+        PngDecoder(PngDecoder&& t_other) noexcept = delete;
+        PngDecoder& operator=(const PngDecoder& t_other) = delete;
+        PngDecoder& operator=(PngDecoder&& t_other) noexcept = delete;
+
+        ~PngDecoder() noexcept;
+
+        //-------------------------------------------------
+        // Getter
+        //-------------------------------------------------
+
+        /**
+         * @brief The header of the file: the bit depth and color type before the conversion to 8 bit samples.
+         * @return Header
+         */
+        [[nodiscard]] const Header& GetHeader() const noexcept;
+
+        /**
+         * @brief The channels of a decoded row: 1 gray, 2 gray + alpha, 3 RGB or 4 RGBA.
+         *        A palette is expanded to RGB, or to RGBA if it has transparency.
+         * @return uint32_t
+         */
+        [[nodiscard]] uint32_t GetChannels() const noexcept;
+
+        //-------------------------------------------------
+        // Decode
+        //-------------------------------------------------
+
+        /**
+         * @brief Decodes the image. Can only be called once.
+         *        Throws a std::runtime_error if the data is corrupt or truncated.
+         * @param t_rowFunction Receives each row.
+         */
+        void Decode(const RowFunction& t_rowFunction);
+
+    protected:
+
+    private:
+        using FileUniquePtr = std::unique_ptr<std::FILE, int(*)(std::FILE*)>;
+
+        std::string m_fileName;
+        FileUniquePtr m_file{ nullptr, &std::fclose };
+
+        png_structp m_png{ nullptr };
+        png_infop m_info{ nullptr };
+
+        /**
+         * @brief The message of the last libpng error.
+         */
+        std::string m_error;
+
+        Header m_header;
+        uint32_t m_channels{ 0 };
+        uint32_t m_rowBytes{ 0 };
+
+        bool m_decoded{ false };
+
+        //-------------------------------------------------
+        // libpng
+        //-------------------------------------------------
+
+        void Open();
+        void Destroy() noexcept;
+
+        /**
+         * @brief Reads the chunks before the image data and sets the conversion to 8 bit samples.
+         *        libpng reports errors with longjmp, so the Read functions do not create objects with destructors.
+         * @return False on a libpng error.
+         */
+        bool ReadInfo() noexcept;
+        bool ReadRow(uint8_t* t_row) noexcept;
+        bool ReadEnd() noexcept;
+
+        static void OnError(png_structp t_png, png_const_charp t_message);
+        static void OnWarning(png_structp t_png, png_const_charp t_message);
+
+        [[noreturn]] void Fail(const std::string& t_message) const;
+    };
+}
@@ -21,9 +21,6 @@ namespace sg::city::map
     class RoadNetwork
     {
     public:
-        using MeshUniquePtr = std::unique_ptr<ogl::resource::Mesh>;
-        using VertexContainer = std::vector<float>;
-
         //-------------------------------------------------
         // Const
         //-------------------------------------------------
@@ -50,16 +47,17 @@ namespace sg::city::map
         // Getter
         //-------------------------------------------------
 
+        /**
+         * @brief The roads share the Mesh and the Chunks of the Map.
+         *        The road shader skips all Tiles that are not of type TRAFFIC.
+         * @return ogl::resource::Mesh
+         */
         [[nodiscard]] const ogl::resource::Mesh& GetMesh() const noexcept;
         [[nodiscard]] ogl::resource::Mesh& GetMesh() noexcept;
 
-        [[nodiscard]] uint32_t GetRoadTextureAtlasId() const;
+        [[nodiscard]] city::City* GetCity() const;
 
-        //-------------------------------------------------
-        // Create
-        //-------------------------------------------------
-
-        void CreateRoadNetworkMesh() const;
+        [[nodiscard]] uint32_t GetRoadTextureAtlasId() const;
 
     protected:
 
@@ -68,22 +66,5 @@ namespace sg::city::map
          * @brief A pointer to the parent City.
          */
         city::City* m_city{ nullptr };
-
-        /**
-         * @brief A Mesh instance for the RoadNetwork.
-         */
-        MeshUniquePtr m_roadNetworkMesh;
-
-        /**
-         * @brief The Id of Vbo holding the vertices.
-         */
-        uint32_t m_vboId{ 0 };
-
-        //-------------------------------------------------
-        // Init
-        //-------------------------------------------------
-
-        void CreateVbo();
-        void Init();
     };
 }
@@ -24,6 +24,30 @@ sg::city::map::tile::BuildingTile::~BuildingTile() noexcept
 {
 }
 
+//-------------------------------------------------
+// Pool
+//-------------------------------------------------
+
+void* sg::city::map::tile::BuildingTile::operator new(const std::size_t t_size)
+{
+    return memory::Pool<BuildingTile, memory::Tag::TILES>::Get().Allocate(t_size);
+}
+
+void sg::city::map::tile::BuildingTile::operator delete(void* t_ptr, const std::size_t t_size) noexcept
+{
+    memory::Pool<BuildingTile, memory::Tag::TILES>::Get().Deallocate(t_ptr, t_size);
+}
+
+void sg::city::map::tile::BuildingTile::Reserve(const std::size_t t_count)
+{
+    memory::Pool<BuildingTile, memory::Tag::TILES>::Get().Reserve(t_count);
+}
+
+void sg::city::map::tile::BuildingTile::ClearPool()
+{
+    memory::Pool<BuildingTile, memory::Tag::TILES>::Get().Clear();
+}
+
 //-------------------------------------------------
 // Logic
 //-------------------------------------------------
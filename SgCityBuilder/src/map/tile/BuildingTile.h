@@ -16,12 +16,6 @@ namespace sg::city::map::tile
     class BuildingTile : public Tile
     {
     public:
-        //-------------------------------------------------
-        // Public member
-        //-------------------------------------------------
-
-        uint32_t floors{ 0 };
-
         //-------------------------------------------------
         // Ctors. / Dtor.
         //-------------------------------------------------
@@ -37,6 +31,24 @@ namespace sg::city::map::tile
 
         virtual ~BuildingTile() noexcept;
 
+        //-------------------------------------------------
+        // Pool
+        //-------------------------------------------------
+
+        static void* operator new(std::size_t t_size);
+        static void operator delete(void* t_ptr, std::size_t t_size) noexcept;
+
+        /**
+         * @brief Allocates the memory of the next BuildingTiles in one block, e.g. before the Tiles are created in parallel.
+         * @param t_count The number of BuildingTiles.
+         */
+        static void Reserve(std::size_t t_count);
+
+        /**
+         * @brief Frees the memory of the BuildingTiles if none is alive.
+         */
+        static void ClearPool();
+
         //-------------------------------------------------
         // Logic
         //-------------------------------------------------
@@ -7,19 +7,16 @@
 // 
 // 2020 (c) stwe <https://github.com/stwe/SgCityBuilder>
 
-#include <Application.h>
-#include <Window.h>
-#include <camera/Camera.h>
-#include <resource/Mesh.h>
-#include <resource/ShaderManager.h>
-#include <scene/Scene.h>
-#include <math/Transform.h>
+#include <algorithm>
+#include <glm/geometric.hpp>
+#include <Core.h>
 #include "RoadTile.h"
 #include "Build.h"
 #include "map/Map.h"
+#include "map/DebugBatcher.h"
+#include "city/FrameArena.h"
 #include "automata/AutoNode.h"
 #include "automata/AutoTrack.h"
-#include "shader/LineShader.h"
 
 //-------------------------------------------------
 // Ctors. / Dtor.
@@ -34,6 +31,30 @@ sg::city::map::tile::RoadTile::~RoadTile() noexcept
 {
 }
 
+//-------------------------------------------------
+// Pool
+//-------------------------------------------------
+
+void* sg::city::map::tile::RoadTile::operator new(const std::size_t t_size)
+{
+    return memory::Pool<RoadTile, memory::Tag::TILES>::Get().Allocate(t_size);
+}
+
+void sg::city::map::tile::RoadTile::operator delete(void* t_ptr, const std::size_t t_size) noexcept
+{
+    memory::Pool<RoadTile, memory::Tag::TILES>::Get().Deallocate(t_ptr, t_size);
+}
+
+void sg::city::map::tile::RoadTile::Reserve(const std::size_t t_count)
+{
+    memory::Pool<RoadTile, memory::Tag::TILES>::Get().Reserve(t_count);
+}
+
+void sg::city::map::tile::RoadTile::ClearPool()
+{
+    memory::Pool<RoadTile, memory::Tag::TILES>::Get().Clear();
+}
+
 //-------------------------------------------------
 // Getter
 //-------------------------------------------------
@@ -68,13 +89,23 @@ int sg::city::map::tile::RoadTile::GetCurrentStopPatternIndex() const
     return m_currentStopPatternIndex;
 }
 
+uint32_t sg::city::map::tile::RoadTile::GetFlags() const
+{
+    return static_cast<uint32_t>(roadType);
+}
+
 //-------------------------------------------------
 // Logic
 //-------------------------------------------------
 
 void sg::city::map::tile::RoadTile::Update()
 {
-    DetermineRoadType();
+    // a new RoadType changes only the 4 bytes of this Tile
+    if (DetermineRoadType())
+    {
+        m_map->UpdateMapVboByTileIndex(GetMapIndex());
+    }
+
     CreateAutoTracks();
     CreateStopPatterns();
 
@@ -82,8 +113,24 @@ void sg::city::map::tile::RoadTile::Update()
     ApplyStopPattern(0);
 
 #ifdef ENABLE_TRAFFIC_DEBUG
-    CreateAutoTracksMesh();
-    m_map->CreateNavigationNodesMesh();
+    CreateAutoTracksDebugLines();
+    m_map->UpdateNavigationNodesDebugPoints(GetMapIndex());
+#endif
+}
+
+void sg::city::map::tile::RoadTile::Restore(const RoadType t_roadType)
+{
+    // the saved type; the neighbours are not asked and the Vbo is written by the caller for all Tiles
+    roadType = t_roadType;
+
+    CreateAutoTracks();
+    CreateStopPatterns();
+
+    ApplyStopPattern(0);
+
+#ifdef ENABLE_TRAFFIC_DEBUG
+    CreateAutoTracksDebugLines();
+    m_map->UpdateNavigationNodesDebugPoints(GetMapIndex());
 #endif
 }
 
@@ -108,7 +155,7 @@ void sg::city::map::tile::RoadTile::ApplyStopPattern(const int t_index)
         m_currentStopPatternIndex = t_index;
 
 #ifdef ENABLE_TRAFFIC_DEBUG
-        m_map->CreateNavigationNodesMesh();
+        m_map->UpdateNavigationNodesDebugColors(GetMapIndex());
 #endif
     }
 }
@@ -117,11 +164,11 @@ void sg::city::map::tile::RoadTile::ApplyStopPattern(const int t_index)
 // Debug
 //-------------------------------------------------
 
-void sg::city::map::tile::RoadTile::CreateAutoTracksMesh()
+void sg::city::map::tile::RoadTile::CreateAutoTracksDebugLines() const
 {
-    SG_OGL_ASSERT(!m_autoTracks.empty(), "[RoadTile::CreateAutoTracksMesh()] No Auto Tracks available.")
-
-    VertexContainer vertexContainer;
+    // 2 vertices per track
+    DebugBatcher::ScratchVertexContainer vertexContainer{ memory::FrameArena::Get().GetResource() };
+    vertexContainer.reserve(m_autoTracks.size() * 2 * DebugBatcher::FLOATS_PER_VERTEX);
 
     for (auto& autoTrack : m_autoTracks)
     {
@@ -146,43 +193,8 @@ void sg::city::map::tile::RoadTile::CreateAutoTracksMesh()
         vertexContainer.push_back(1.0f);
     }
 
-    if (m_autoTracksMesh)
-    {
-        m_autoTracksMesh.reset();
-    }
-
-    m_autoTracksMesh = std::make_unique<ogl::resource::Mesh>();
-
-    const ogl::buffer::BufferLayout bufferLayout{
-        { ogl::buffer::VertexAttributeType::POSITION, "aPosition" },
-        { ogl::buffer::VertexAttributeType::COLOR, "aColor" },
-    };
-
-    m_autoTracksMesh->GetVao().AddVertexDataVbo(vertexContainer.data(), static_cast<int32_t>(m_autoTracks.size()) * 2, bufferLayout);
-}
-
-void sg::city::map::tile::RoadTile::RenderAutoTracks() const
-{
-    SG_OGL_ASSERT(m_autoTracksMesh, "[RoadTile::RenderAutoTracks()] Null pointer.")
-
-    ogl::math::Transform t;
-    t.position = m_map->position;
-    t.rotation = m_map->rotation;
-    t.scale = m_map->scale;
-
-    auto& shader{ m_map->GetScene()->GetApplicationContext()->GetShaderManager().GetShaderProgram<shader::LineShader>() };
-    shader.Bind();
-
-    const auto projectionMatrix{ m_map->GetScene()->GetApplicationContext()->GetWindow().GetProjectionMatrix() };
-    const auto mvp{ projectionMatrix * m_map->GetScene()->GetCurrentCamera().GetViewMatrix() * static_cast<glm::mat4>(t) };
-
-    shader.SetUniform("mvpMatrix", mvp);
-
-    m_autoTracksMesh->InitDraw();
-    m_autoTracksMesh->DrawPrimitives(GL_LINES);
-    m_autoTracksMesh->EndDraw();
-
-    ogl::resource::ShaderProgram::Unbind();
+    // only the block of this Tile is replaced
+    m_map->GetDebugBatcher().SetVertices(DebugBatcher::Layer::LINES, GetMapIndex(), vertexContainer);
 }
 
 //-------------------------------------------------
@@ -195,11 +207,15 @@ void sg::city::map::tile::RoadTile::ClearTracksAndStops()
     m_autoTracks.clear();
 
     // clear Auto Tracks from Nodes
+    // the border nodes are shared with the neighbours, so only the tracks of this Tile are removed
     for (auto& node : m_map->GetNavigationNodes(GetMapIndex()))
     {
         if (node)
         {
-            node->autoTracks.clear();
+            node->autoTracks.erase(std::remove_if(node->autoTracks.begin(), node->autoTracks.end(), [this](const AutoTrackSharedPtr& t_autoTrack)
+            {
+                return t_autoTrack->tile == this;
+            }), node->autoTracks.end());
         }
     }
 
@@ -880,7 +896,7 @@ void sg::city::map::tile::RoadTile::AddAutoTrack(const int t_fromNodeIndex, cons
     auto& to{ navigationNodes[t_toNodeIndex] };
 
     // generate a new auto track
-    auto track{ std::make_shared<automata::AutoTrack>() };
+    auto track{ std::allocate_shared<automata::AutoTrack>(memory::TrackingAllocator<automata::AutoTrack, memory::Tag::TRACKS>()) };
     track->startNode = from;
     track->endNode = to;
     track->tile = this;
@@ -53,7 +53,7 @@ namespace sg::city::map::tile
     {
     public:
         using AutoTrackSharedPtr = std::shared_ptr<automata::AutoTrack>;
-        using AutoTrackContainer = std::list<AutoTrackSharedPtr>;
+        using AutoTrackContainer = std::list<AutoTrackSharedPtr, memory::TrackingAllocator<AutoTrackSharedPtr, memory::Tag::TRACKS>>;
 
         using StopPattern = std::vector<bool>;
         using StopPatternContainer = std::vector<StopPattern>;
@@ -91,6 +91,24 @@ namespace sg::city::map::tile
 
         virtual ~RoadTile() noexcept;
 
+        //-------------------------------------------------
+        // Pool
+        //-------------------------------------------------
+
+        static void* operator new(std::size_t t_size);
+        static void operator delete(void* t_ptr, std::size_t t_size) noexcept;
+
+        /**
+         * @brief Allocates the memory of the next RoadTiles in one block, e.g. before the Tiles are created in parallel.
+         * @param t_count The number of RoadTiles.
+         */
+        static void Reserve(std::size_t t_count);
+
+        /**
+         * @brief Frees the memory of the RoadTiles if none is alive.
+         */
+        static void ClearPool();
+
         //-------------------------------------------------
         // Getter
         //-------------------------------------------------
@@ -105,12 +123,25 @@ namespace sg::city::map::tile
 
         [[nodiscard]] int GetCurrentStopPatternIndex() const;
 
+        /**
+         * @brief The RoadType is stored in the flags. The road shader uses it as atlas index.
+         * @return uint32_t
+         */
+        [[nodiscard]] uint32_t GetFlags() const override;
+
         //-------------------------------------------------
         // Logic
         //-------------------------------------------------
 
         void Update() override;
 
+        /**
+         * @brief Sets a saved RoadType and creates the Auto Tracks and Stop Patterns.
+         *        Unlike Update() the RoadType is not determined from the neighbours.
+         * @param t_roadType The saved RoadType.
+         */
+        void Restore(RoadType t_roadType);
+
         /**
          * @brief Apply a Stop Pattern to Nodes.
          * @param t_index The index of the Stop Pattern.
@@ -122,14 +153,9 @@ namespace sg::city::map::tile
         //-------------------------------------------------
 
         /**
-         * @brief Create a Mesh from the Auto Tracks.
+         * @brief Replaces the debug lines of this Tile with the current Auto Tracks.
          */
-        void CreateAutoTracksMesh();
-
-        /**
-         * @brief Render the Auto Tracks.
-         */
-        void RenderAutoTracks() const;
+        void CreateAutoTracksDebugLines() const;
 
         //-------------------------------------------------
         // Clear
@@ -137,6 +163,7 @@ namespace sg::city::map::tile
 
         /**
          * @brief Clear the AutoTracks and StopPatterns from the Tile and Nodes.
+         *        The tracks of the neighbours stay in the shared Nodes.
          */
         void ClearTracksAndStops();
 
@@ -153,11 +180,6 @@ namespace sg::city::map::tile
          */
         StopPatternContainer m_stopPatterns;
 
-        /**
-         * @brief A Mesh holding the whole Auto Tracks for debug.
-         */
-        MeshUniquePtr m_autoTracksMesh;
-
         /**
          * @brief The index of the current StopPattern.
          */
@@ -28,6 +28,30 @@ sg::city::map::tile::Tile::~Tile() noexcept
 {
 }
 
+//-------------------------------------------------
+// Pool
+//-------------------------------------------------
+
+void* sg::city::map::tile::Tile::operator new(const std::size_t t_size)
+{
+    return memory::Pool<Tile, memory::Tag::TILES>::Get().Allocate(t_size);
+}
+
+void sg::city::map::tile::Tile::operator delete(void* t_ptr, const std::size_t t_size) noexcept
+{
+    memory::Pool<Tile, memory::Tag::TILES>::Get().Deallocate(t_ptr, t_size);
+}
+
+void sg::city::map::tile::Tile::Reserve(const std::size_t t_count)
+{
+    memory::Pool<Tile, memory::Tag::TILES>::Get().Reserve(t_count);
+}
+
+void sg::city::map::tile::Tile::ClearPool()
+{
+    memory::Pool<Tile, memory::Tag::TILES>::Get().Clear();
+}
+
 //-------------------------------------------------
 // Getter
 //-------------------------------------------------
@@ -66,16 +90,6 @@ glm::vec3 sg::city::map::tile::Tile::GetWorldCenter() const
     );
 }
 
-const sg::city::map::tile::Tile::VertexContainer& sg::city::map::tile::Tile::GetVertices() const noexcept
-{
-    return m_vertices;
-}
-
-sg::city::map::tile::Tile::VertexContainer& sg::city::map::tile::Tile::GetVertices() noexcept
-{
-    return m_vertices;
-}
-
 const sg::city::map::tile::Tile::NeighbourContainer& sg::city::map::tile::Tile::GetNeighbours() const noexcept
 {
     return m_neighbours;
@@ -91,120 +105,16 @@ int sg::city::map::tile::Tile::GetMapIndex() const
     return m_map->GetTileMapIndexByMapPosition(GetMapX(), GetMapZ());
 }
 
-//-------------------------------------------------
-// Setter
-//-------------------------------------------------
-
-void sg::city::map::tile::Tile::SetVertexPositions()
-{
-    m_vertices[BOTTOM_LEFT_POS_X_T1] = m_bottomLeft.x;
-    m_vertices[BOTTOM_LEFT_POS_Y_T1] = m_bottomLeft.y;
-    m_vertices[BOTTOM_LEFT_POS_Z_T1] = m_bottomLeft.z;
-
-    m_vertices[BOTTOM_RIGHT_POS_X_T1] = m_bottomRight.x;
-    m_vertices[BOTTOM_RIGHT_POS_Y_T1] = m_bottomRight.y;
-    m_vertices[BOTTOM_RIGHT_POS_Z_T1] = m_bottomRight.z;
-
-    m_vertices[TOP_LEFT_POS_X_T1] = m_topLeft.x;
-    m_vertices[TOP_LEFT_POS_Y_T1] = m_topLeft.y;
-    m_vertices[TOP_LEFT_POS_Z_T1] = m_topLeft.z;
-
-    m_vertices[TOP_LEFT_POS_X_T2] = m_topLeft.x;
-    m_vertices[TOP_LEFT_POS_Y_T2] = m_topLeft.y;
-    m_vertices[TOP_LEFT_POS_Z_T2] = m_topLeft.z;
-
-    m_vertices[BOTTOM_RIGHT_POS_X_T2] = m_bottomRight.x;
-    m_vertices[BOTTOM_RIGHT_POS_Y_T2] = m_bottomRight.y;
-    m_vertices[BOTTOM_RIGHT_POS_Z_T2] = m_bottomRight.z;
-
-    m_vertices[TOP_RIGHT_POS_X_T2] = m_topRight.x;
-    m_vertices[TOP_RIGHT_POS_Y_T2] = m_topRight.y;
-    m_vertices[TOP_RIGHT_POS_Z_T2] = m_topRight.z;
-}
-
-void sg::city::map::tile::Tile::SetNormal(const glm::vec3& t_normal)
+uint32_t sg::city::map::tile::Tile::GetFlags() const
 {
-    m_vertices[BOTTOM_LEFT_NORMAL_X_T1] = t_normal.x;
-    m_vertices[BOTTOM_LEFT_NORMAL_Y_T1] = t_normal.y;
-    m_vertices[BOTTOM_LEFT_NORMAL_Z_T1] = t_normal.z;
-
-    m_vertices[BOTTOM_RIGHT_NORMAL_X_T1] = t_normal.x;
-    m_vertices[BOTTOM_RIGHT_NORMAL_Y_T1] = t_normal.y;
-    m_vertices[BOTTOM_RIGHT_NORMAL_Z_T1] = t_normal.z;
-
-    m_vertices[TOP_LEFT_NORMAL_X_T1] = t_normal.x;
-    m_vertices[TOP_LEFT_NORMAL_Y_T1] = t_normal.y;
-    m_vertices[TOP_LEFT_NORMAL_Z_T1] = t_normal.z;
-
-    m_vertices[TOP_LEFT_NORMAL_X_T2] = t_normal.x;
-    m_vertices[TOP_LEFT_NORMAL_Y_T2] = t_normal.y;
-    m_vertices[TOP_LEFT_NORMAL_Z_T2] = t_normal.z;
-
-    m_vertices[BOTTOM_RIGHT_NORMAL_X_T2] = t_normal.x;
-    m_vertices[BOTTOM_RIGHT_NORMAL_Y_T2] = t_normal.y;
-    m_vertices[BOTTOM_RIGHT_NORMAL_Z_T2] = t_normal.z;
-
-    m_vertices[TOP_RIGHT_NORMAL_X_T2] = t_normal.x;
-    m_vertices[TOP_RIGHT_NORMAL_Y_T2] = t_normal.y;
-    m_vertices[TOP_RIGHT_NORMAL_Z_T2] = t_normal.z;
+    return 0;
 }
 
-void sg::city::map::tile::Tile::SetColor(const glm::vec3& t_color)
+uint32_t sg::city::map::tile::Tile::GetAttribute(const uint32_t t_regionColorIndex) const
 {
-    m_vertices[BOTTOM_LEFT_COLOR_X_T1] = t_color.x;
-    m_vertices[BOTTOM_LEFT_COLOR_Y_T1] = t_color.y;
-    m_vertices[BOTTOM_LEFT_COLOR_Z_T1] = t_color.z;
-
-    m_vertices[BOTTOM_RIGHT_COLOR_X_T1] = t_color.x;
-    m_vertices[BOTTOM_RIGHT_COLOR_Y_T1] = t_color.y;
-    m_vertices[BOTTOM_RIGHT_COLOR_Z_T1] = t_color.z;
-
-    m_vertices[TOP_LEFT_COLOR_X_T1] = t_color.x;
-    m_vertices[TOP_LEFT_COLOR_Y_T1] = t_color.y;
-    m_vertices[TOP_LEFT_COLOR_Z_T1] = t_color.z;
-
-    m_vertices[TOP_LEFT_COLOR_X_T2] = t_color.x;
-    m_vertices[TOP_LEFT_COLOR_Y_T2] = t_color.y;
-    m_vertices[TOP_LEFT_COLOR_Z_T2] = t_color.z;
-
-    m_vertices[BOTTOM_RIGHT_COLOR_X_T2] = t_color.x;
-    m_vertices[BOTTOM_RIGHT_COLOR_Y_T2] = t_color.y;
-    m_vertices[BOTTOM_RIGHT_COLOR_Z_T2] = t_color.z;
-
-    m_vertices[TOP_RIGHT_COLOR_X_T2] = t_color.x;
-    m_vertices[TOP_RIGHT_COLOR_Y_T2] = t_color.y;
-    m_vertices[TOP_RIGHT_COLOR_Z_T2] = t_color.z;
-}
-
-void sg::city::map::tile::Tile::SetTexture(const float t_texture)
-{
-    m_vertices[BOTTOM_LEFT_TEXTURE_NR_T1] = t_texture;
-    m_vertices[BOTTOM_RIGHT_TEXTURE_NR_T1] = t_texture;
-    m_vertices[TOP_LEFT_TEXTURE_NR_T1] = t_texture;
-    m_vertices[TOP_LEFT_TEXTURE_NR_T2] = t_texture;
-    m_vertices[BOTTOM_RIGHT_TEXTURE_NR_T2] = t_texture;
-    m_vertices[TOP_RIGHT_TEXTURE_NR_T2] = t_texture;
-}
-
-void sg::city::map::tile::Tile::SetUv(const glm::vec2& t_bL, const glm::vec2& t_bR, const glm::vec2& t_tL, const glm::vec2& t_tR)
-{
-    m_vertices[BOTTOM_LEFT_TEXTURE_X_T1] = t_bL.x;
-    m_vertices[BOTTOM_LEFT_TEXTURE_Y_T1] = t_bL.y;
-
-    m_vertices[BOTTOM_RIGHT_TEXTURE_X_T1] = t_bR.x;
-    m_vertices[BOTTOM_RIGHT_TEXTURE_Y_T1] = t_bR.y;
-
-    m_vertices[TOP_LEFT_TEXTURE_X_T1] = t_tL.x;
-    m_vertices[TOP_LEFT_TEXTURE_Y_T1] = t_tL.y;
-
-    m_vertices[TOP_LEFT_TEXTURE_X_T2] = t_tL.x;
-    m_vertices[TOP_LEFT_TEXTURE_Y_T2] = t_tL.y;
-
-    m_vertices[BOTTOM_RIGHT_TEXTURE_X_T2] = t_bR.x;
-    m_vertices[BOTTOM_RIGHT_TEXTURE_Y_T2] = t_bR.y;
-
-    m_vertices[TOP_RIGHT_TEXTURE_X_T2] = t_tR.x;
-    m_vertices[TOP_RIGHT_TEXTURE_Y_T2] = t_tR.y;
+    return static_cast<uint32_t>(type) |
+        (GetFlags() & 0xFF) << ATTRIBUTE_FLAGS_SHIFT |
+        t_regionColorIndex << ATTRIBUTE_REGION_SHIFT;
 }
 
 //-------------------------------------------------
@@ -213,15 +123,7 @@ void sg::city::map::tile::Tile::SetUv(const glm::vec2& t_bL, const glm::vec2& t_
 
 void sg::city::map::tile::Tile::Update()
 {
-    // if the type has changed, the color and texture must also be changed
-
-    // we use the TileType number as value for the texture
-    SetTexture(static_cast<float>(type));
-
-    // we use the TileType color as Tile color
-    SetColor(TILE_TYPE_COLOR.at(type));
-
-    // update Vbo
+    // the shader selects the texture and the color by the TileType - update Vbo
     m_map->UpdateMapVboByTileIndex(GetMapIndex());
 }
 
@@ -258,16 +160,8 @@ void sg::city::map::tile::Tile::Create()
         bL       bR
     */
 
-    m_vertices.resize(FLOATS_PER_TILE);
-
     m_bottomLeft = glm::vec3(m_mapX, DEFAULT_HEIGHT, -m_mapZ);
     m_bottomRight = glm::vec3(m_mapX + 1.0f, DEFAULT_HEIGHT, -m_mapZ);
     m_topLeft = glm::vec3(m_mapX, DEFAULT_HEIGHT, -(m_mapZ + 1.0f));
     m_topRight = glm::vec3(m_mapX + 1.0f, DEFAULT_HEIGHT, -(m_mapZ + 1.0f));
-
-    SetVertexPositions();
-    SetNormal(DEFAULT_NORMAL);
-    SetColor(TILE_TYPE_COLOR.at(type));
-    SetTexture(static_cast<float>(type));
-    SetUv();
 }
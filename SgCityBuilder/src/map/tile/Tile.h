@@ -9,12 +9,16 @@
 
 #pragma once
 
+#include <array>
 #include <string>
 #include <vector>
+#include <utility>
+#include <algorithm>
+#include <stdexcept>
 #include <unordered_map>
 #include <glm/vec3.hpp>
-#include <glm/vec2.hpp>
 #include <memory>
+#include "city/Memory.h"
 
 namespace sg::ogl::resource
 {
@@ -53,19 +57,64 @@ namespace sg::city::map::tile
         WEST
     };
 
-    struct DirectionHash
+    /**
+     * @brief The up to 4 neighbours of a Tile with their Tile index, stored in the Tile itself.
+     *        Unlike a hash map it needs no allocation, so the Tiles of a large Map are created without one.
+     */
+    class Neighbours
     {
-        std::size_t operator()(Direction t_direction) const
+    public:
+        using Neighbour = std::pair<Direction, int>;
+        using NeighbourArray = std::array<Neighbour, 4>;
+        using ConstIterator = NeighbourArray::const_iterator;
+
+        void emplace(const Direction t_direction, const int t_tileIndex)
+        {
+            if (count(t_direction) == 0)
+            {
+                m_neighbours[m_size++] = { t_direction, t_tileIndex };
+            }
+        }
+
+        [[nodiscard]] std::size_t count(const Direction t_direction) const noexcept
+        {
+            return std::find_if(begin(), end(), [t_direction](const Neighbour& t_neighbour) { return t_neighbour.first == t_direction; }) != end() ? 1 : 0;
+        }
+
+        /**
+         * @brief The Tile index of a neighbour. Throws a std::out_of_range if the Tile has no neighbour in this direction.
+         * @param t_direction The direction.
+         * @return int
+         */
+        [[nodiscard]] int at(const Direction t_direction) const
         {
-            return static_cast<std::size_t>(t_direction);
+            for (const auto& neighbour : *this)
+            {
+                if (neighbour.first == t_direction)
+                {
+                    return neighbour.second;
+                }
+            }
+
+            throw std::out_of_range("[Neighbours::at()] No neighbour in this direction.");
         }
+
+        [[nodiscard]] ConstIterator begin() const noexcept { return m_neighbours.cbegin(); }
+        [[nodiscard]] ConstIterator end() const noexcept { return m_neighbours.cbegin() + m_size; }
+
+        [[nodiscard]] std::size_t size() const noexcept { return m_size; }
+
+    protected:
+
+    private:
+        NeighbourArray m_neighbours{};
+        uint8_t m_size{ 0 };
     };
 
     class Tile
     {
     public:
-        using VertexContainer = std::vector<float>;
-        using NeighbourContainer = std::unordered_map<Direction, int, DirectionHash>;
+        using NeighbourContainer = Neighbours;
         using MeshUniquePtr = std::unique_ptr<ogl::resource::Mesh>;
 
         //-------------------------------------------------
@@ -73,11 +122,14 @@ namespace sg::city::map::tile
         //-------------------------------------------------
 
         static constexpr auto DEFAULT_HEIGHT{ 0.0f };
-        static constexpr auto DEFAULT_NORMAL{ glm::vec3(0.0f, 1.0f, 0.0f) };
-        static constexpr auto FLOATS_PER_VERTEX{ 12u }; // 3x position + 3x normal + 3x color + 1x texture + 2x uv
-        static constexpr auto VERTICES_PER_TILE{ 6u };  // 2 triangles with 3 vertices
-        static constexpr auto FLOATS_PER_TILE{ FLOATS_PER_VERTEX * VERTICES_PER_TILE };         // = 72 floats
-        static constexpr auto SIZE_IN_BYTES_PER_TILE{ FLOATS_PER_TILE * sizeof(float) }; // = 288 bytes
+
+        // The Tile is stored in a single 32 bit value for the Gpu:
+        // bits  0 ..  7  TileType
+        // bits  8 .. 15  flags
+        // bits 16 .. 31  region color index (0 = no region)
+        static constexpr uint32_t ATTRIBUTE_FLAGS_SHIFT{ 8 };
+        static constexpr uint32_t ATTRIBUTE_REGION_SHIFT{ 16 };
+        static constexpr uint32_t SIZE_IN_BYTES_PER_TILE{ sizeof(uint32_t) };
 
         /**
          * @brief The default max population value.
@@ -89,122 +141,8 @@ namespace sg::city::map::tile
          */
         static constexpr auto NO_REGION{ 0 };
 
-        // Bottom left T1
-
-        static constexpr auto BOTTOM_LEFT_POS_X_T1{ 0 };
-        static constexpr auto BOTTOM_LEFT_POS_Y_T1{ 1 };
-        static constexpr auto BOTTOM_LEFT_POS_Z_T1{ 2 };
-
-        static constexpr auto BOTTOM_LEFT_NORMAL_X_T1{ 3 };
-        static constexpr auto BOTTOM_LEFT_NORMAL_Y_T1{ 4 };
-        static constexpr auto BOTTOM_LEFT_NORMAL_Z_T1{ 5 };
-
-        static constexpr auto BOTTOM_LEFT_COLOR_X_T1{ 6 };
-        static constexpr auto BOTTOM_LEFT_COLOR_Y_T1{ 7 };
-        static constexpr auto BOTTOM_LEFT_COLOR_Z_T1{ 8 };
-
-        static constexpr auto BOTTOM_LEFT_TEXTURE_NR_T1{ 9 };
-
-        static constexpr auto BOTTOM_LEFT_TEXTURE_X_T1{ 10 };
-        static constexpr auto BOTTOM_LEFT_TEXTURE_Y_T1{ 11 };
-
-        // Bottom right T1
-
-        static constexpr auto BOTTOM_RIGHT_POS_X_T1{ 12 };
-        static constexpr auto BOTTOM_RIGHT_POS_Y_T1{ 13 };
-        static constexpr auto BOTTOM_RIGHT_POS_Z_T1{ 14 };
-
-        static constexpr auto BOTTOM_RIGHT_NORMAL_X_T1{ 15 };
-        static constexpr auto BOTTOM_RIGHT_NORMAL_Y_T1{ 16 };
-        static constexpr auto BOTTOM_RIGHT_NORMAL_Z_T1{ 17 };
-
-        static constexpr auto BOTTOM_RIGHT_COLOR_X_T1{ 18 };
-        static constexpr auto BOTTOM_RIGHT_COLOR_Y_T1{ 19 };
-        static constexpr auto BOTTOM_RIGHT_COLOR_Z_T1{ 20 };
-
-        static constexpr auto BOTTOM_RIGHT_TEXTURE_NR_T1{ 21 };
-
-        static constexpr auto BOTTOM_RIGHT_TEXTURE_X_T1{ 22 };
-        static constexpr auto BOTTOM_RIGHT_TEXTURE_Y_T1{ 23 };
-
-        // Top left T1
-
-        static constexpr auto TOP_LEFT_POS_X_T1{ 24 };
-        static constexpr auto TOP_LEFT_POS_Y_T1{ 25 };
-        static constexpr auto TOP_LEFT_POS_Z_T1{ 26 };
-
-        static constexpr auto TOP_LEFT_NORMAL_X_T1{ 27 };
-        static constexpr auto TOP_LEFT_NORMAL_Y_T1{ 28 };
-        static constexpr auto TOP_LEFT_NORMAL_Z_T1{ 29 };
-
-        static constexpr auto TOP_LEFT_COLOR_X_T1{ 30 };
-        static constexpr auto TOP_LEFT_COLOR_Y_T1{ 31 };
-        static constexpr auto TOP_LEFT_COLOR_Z_T1{ 32 };
-
-        static constexpr auto TOP_LEFT_TEXTURE_NR_T1{ 33 };
-
-        static constexpr auto TOP_LEFT_TEXTURE_X_T1{ 34 };
-        static constexpr auto TOP_LEFT_TEXTURE_Y_T1{ 35 };
-
-        // Top left T2
-
-        static constexpr auto TOP_LEFT_POS_X_T2{ 36 };
-        static constexpr auto TOP_LEFT_POS_Y_T2{ 37 };
-        static constexpr auto TOP_LEFT_POS_Z_T2{ 38 };
-
-        static constexpr auto TOP_LEFT_NORMAL_X_T2{ 39 };
-        static constexpr auto TOP_LEFT_NORMAL_Y_T2{ 40 };
-        static constexpr auto TOP_LEFT_NORMAL_Z_T2{ 41 };
-
-        static constexpr auto TOP_LEFT_COLOR_X_T2{ 42 };
-        static constexpr auto TOP_LEFT_COLOR_Y_T2{ 43 };
-        static constexpr auto TOP_LEFT_COLOR_Z_T2{ 44 };
-
-        static constexpr auto TOP_LEFT_TEXTURE_NR_T2{ 45 };
-
-        static constexpr auto TOP_LEFT_TEXTURE_X_T2{ 46 };
-        static constexpr auto TOP_LEFT_TEXTURE_Y_T2{ 47 };
-
-        // Bottom right T2
-
-        static constexpr auto BOTTOM_RIGHT_POS_X_T2{ 48 };
-        static constexpr auto BOTTOM_RIGHT_POS_Y_T2{ 49 };
-        static constexpr auto BOTTOM_RIGHT_POS_Z_T2{ 50 };
-
-        static constexpr auto BOTTOM_RIGHT_NORMAL_X_T2{ 51 };
-        static constexpr auto BOTTOM_RIGHT_NORMAL_Y_T2{ 52 };
-        static constexpr auto BOTTOM_RIGHT_NORMAL_Z_T2{ 53 };
-
-        static constexpr auto BOTTOM_RIGHT_COLOR_X_T2{ 54 };
-        static constexpr auto BOTTOM_RIGHT_COLOR_Y_T2{ 55 };
-        static constexpr auto BOTTOM_RIGHT_COLOR_Z_T2{ 56 };
-
-        static constexpr auto BOTTOM_RIGHT_TEXTURE_NR_T2{ 57 };
-
-        static constexpr auto BOTTOM_RIGHT_TEXTURE_X_T2{ 58 };
-        static constexpr auto BOTTOM_RIGHT_TEXTURE_Y_T2{ 59 };
-
-        // Top right T2
-
-        static constexpr auto TOP_RIGHT_POS_X_T2{ 60 };
-        static constexpr auto TOP_RIGHT_POS_Y_T2{ 61 };
-        static constexpr auto TOP_RIGHT_POS_Z_T2{ 62 };
-
-        static constexpr auto TOP_RIGHT_NORMAL_X_T2{ 63 };
-        static constexpr auto TOP_RIGHT_NORMAL_Y_T2{ 64 };
-        static constexpr auto TOP_RIGHT_NORMAL_Z_T2{ 65 };
-
-        static constexpr auto TOP_RIGHT_COLOR_X_T2{ 66 };
-        static constexpr auto TOP_RIGHT_COLOR_Y_T2{ 67 };
-        static constexpr auto TOP_RIGHT_COLOR_Z_T2{ 68 };
-
-        static constexpr auto TOP_RIGHT_TEXTURE_NR_T2{ 69 };
-
-        static constexpr auto TOP_RIGHT_TEXTURE_X_T2{ 70 };
-        static constexpr auto TOP_RIGHT_TEXTURE_Y_T2{ 71 };
-
         /**
-         * @brief Tile color.
+         * @brief Tile color. Is uploaded into the second row of the Map palette texture.
          */
         inline static const std::unordered_map<TileType, glm::vec3, TileTypeHash> TILE_TYPE_COLOR
         {
@@ -247,11 +185,6 @@ namespace sg::city::map::tile
          */
         TileType type{ TileType::NONE };
 
-        /**
-         * @brief Current residents / employees.
-         */
-        float population{ 0.0 };
-
         /**
          * @brief The region Id of the Tile. Tiles in the same region are connected.
          */
@@ -272,6 +205,24 @@ namespace sg::city::map::tile
 
         virtual ~Tile() noexcept;
 
+        //-------------------------------------------------
+        // Pool
+        //-------------------------------------------------
+
+        static void* operator new(std::size_t t_size);
+        static void operator delete(void* t_ptr, std::size_t t_size) noexcept;
+
+        /**
+         * @brief Allocates the memory of the next Tiles in one block, e.g. before the Tiles are created in parallel.
+         * @param t_count The number of Tiles.
+         */
+        static void Reserve(std::size_t t_count);
+
+        /**
+         * @brief Frees the memory of the Tiles if none is alive.
+         */
+        static void ClearPool();
+
         //-------------------------------------------------
         // Getter
         //-------------------------------------------------
@@ -312,9 +263,6 @@ namespace sg::city::map::tile
          */
         [[nodiscard]] glm::vec3 GetWorldCenter() const;
 
-        [[nodiscard]] const VertexContainer& GetVertices() const noexcept;
-        [[nodiscard]] VertexContainer& GetVertices() noexcept;
-
         [[nodiscard]] const NeighbourContainer& GetNeighbours() const noexcept;
         [[nodiscard]] NeighbourContainer& GetNeighbours() noexcept;
 
@@ -325,20 +273,18 @@ namespace sg::city::map::tile
          */
         [[nodiscard]] int GetMapIndex() const;
 
-        //-------------------------------------------------
-        // Setter
-        //-------------------------------------------------
+        /**
+         * @brief Returns the flags stored in the Gpu attribute of the Tile.
+         * @return uint32_t 8 bits
+         */
+        [[nodiscard]] virtual uint32_t GetFlags() const;
 
-        void SetVertexPositions();
-        void SetNormal(const glm::vec3& t_normal);
-        void SetColor(const glm::vec3& t_color);
-        void SetTexture(float t_texture);
-        void SetUv(
-            const glm::vec2& t_bL = glm::vec2(0.0f, 0.0f),
-            const glm::vec2& t_bR = glm::vec2(1.0f, 0.0f),
-            const glm::vec2& t_tL = glm::vec2(0.0f, 1.0f),
-            const glm::vec2& t_tR = glm::vec2(1.0f, 1.0f)
-            );
+        /**
+         * @brief Packs the type, the flags and the region color index for the Gpu.
+         * @param t_regionColorIndex 0 for no region, otherwise 1 .. the number of region colors.
+         * @return uint32_t
+         */
+        [[nodiscard]] uint32_t GetAttribute(uint32_t t_regionColorIndex) const;
 
         //-------------------------------------------------
         // Logic
@@ -394,11 +340,6 @@ namespace sg::city::map::tile
          */
         glm::vec3 m_topRight{ glm::vec3(0.0f) };
 
-        /**
-         * @brief Vertices of the Tile.
-         */
-        VertexContainer m_vertices;
-
         //-------------------------------------------------
         // Init
         //-------------------------------------------------
@@ -10,9 +10,15 @@
 #pragma once
 
 #include "shader/BuildingsShader.h"
+#include "city/Profiler.h"
+#include "city/Gpu.h"
 
 namespace sg::city::renderer
 {
+    /**
+     * @brief Draws the buildings of each visible Chunk with one instanced draw call.
+     *        The draw starts at the first slot of the Chunk, so OpenGL 4.2 or ARB_base_instance is required.
+     */
     class BuildingsRenderer : public ogl::ecs::system::RenderSystem<shader::BuildingsShader>
     {
     public:
@@ -33,6 +39,8 @@ namespace sg::city::renderer
 
         void Render() override
         {
+            SG_CITY_PROFILE_ZONE("BuildingsRenderer::Render");
+
             PrepareRendering();
 
             auto& shader{ m_scene->GetApplicationContext()->GetShaderManager().GetShaderProgram<shader::BuildingsShader>() };
@@ -47,11 +55,36 @@ namespace sg::city::renderer
             {
                 auto& buildingsComponent{ view.get<ecs::BuildingsComponent>(entity) };
 
-                shader.UpdateUniforms(*m_scene, entity, buildingsComponent.buildingGenerator->GetMesh());
+                auto& buildingGenerator{ *buildingsComponent.buildingGenerator };
+
+                shader.UpdateUniforms(*m_scene, entity, buildingGenerator.GetMesh());
+
+                // the buildings are in World Space
+                const auto& map{ buildingGenerator.GetCity()->GetMap() };
+
+                const auto projectionMatrix{ m_scene->GetApplicationContext()->GetWindow().GetProjectionMatrix() };
+                map.FindVisibleChunks(projectionMatrix * m_scene->GetCurrentCamera().GetViewMatrix(), m_visibleChunks);
 
-                buildingsComponent.buildingGenerator->GetMesh().InitDraw();
-                buildingsComponent.buildingGenerator->GetMesh().DrawInstanced(buildingsComponent.buildingGenerator->GetInstances());
-                buildingsComponent.buildingGenerator->GetMesh().EndDraw();
+                const auto& chunks{ map.GetChunks() };
+
+                gpu::Gpu::InitDraw(gpu::Source::BUILDINGS, buildingGenerator.GetMesh());
+                for (auto chunkIndex : m_visibleChunks)
+                {
+                    const auto instances{ buildingGenerator.GetChunkInstances(chunkIndex) };
+                    if (instances == 0)
+                    {
+                        continue;
+                    }
+
+                    // one stacked box per building
+                    gpu::Gpu::DrawInstanced(
+                        gpu::Source::BUILDINGS,
+                        map::BuildingGenerator::DRAW_COUNT,
+                        instances,
+                        chunks[chunkIndex].firstSlot
+                    );
+                }
+                gpu::Gpu::EndDraw(gpu::Source::BUILDINGS, buildingGenerator.GetMesh());
             }
 
             ogl::resource::ShaderProgram::Unbind();
@@ -71,6 +104,9 @@ namespace sg::city::renderer
         }
 
     private:
-
+        /**
+         * @brief The visible Chunks of the current frame.
+         */
+        map::Map::ChunkIndexContainer m_visibleChunks;
     };
 }
@@ -13,6 +13,8 @@
 #include <resource/ShaderManager.h>
 #include <resource/Mesh.h>
 #include "shader/MapShader.h"
+#include "city/Profiler.h"
+#include "city/Gpu.h"
 
 namespace sg::city::renderer
 {
@@ -36,6 +38,8 @@ namespace sg::city::renderer
 
         void Render() override
         {
+            SG_CITY_PROFILE_ZONE("MapRenderer::Render");
+
             PrepareRendering();
 
             auto& shader{ m_scene->GetApplicationContext()->GetShaderManager().GetShaderProgram<shader::MapShader>() };
@@ -55,11 +59,29 @@ namespace sg::city::renderer
                     ogl::OpenGl::EnableWireframeMode();
                 }
 
+                auto& transformComponent{ view.get<ogl::ecs::component::TransformComponent>(entity) };
+
                 shader.UpdateUniforms(*m_scene, entity, mapComponent.map->GetMapMesh());
 
-                mapComponent.map->GetMapMesh().InitDraw();
-                mapComponent.map->GetMapMesh().DrawPrimitives();
-                mapComponent.map->GetMapMesh().EndDraw();
+                // cull the Chunks in Object Space of the Map
+                const auto projectionMatrix{ m_scene->GetApplicationContext()->GetWindow().GetProjectionMatrix() };
+                const auto mvp{ projectionMatrix * m_scene->GetCurrentCamera().GetViewMatrix() * static_cast<glm::mat4>(transformComponent) };
+                mapComponent.map->FindVisibleChunks(mvp, m_visibleChunks);
+
+                const auto& chunks{ mapComponent.map->GetChunks() };
+
+                gpu::Gpu::InitDraw(gpu::Source::MAP, mapComponent.map->GetMapMesh());
+                for (auto chunkIndex : m_visibleChunks)
+                {
+                    const auto& chunk{ chunks[chunkIndex] };
+
+                    shader.SetUniform("chunkOriginX", chunk.originX);
+                    shader.SetUniform("chunkOriginZ", chunk.originZ);
+                    shader.SetUniform("chunkWidth", chunk.width);
+
+                    gpu::Gpu::DrawInstanced(gpu::Source::MAP, map::Map::VERTICES_PER_TILE, chunk.tileCount, chunk.firstSlot);
+                }
+                gpu::Gpu::EndDraw(gpu::Source::MAP, mapComponent.map->GetMapMesh());
 
                 if (mapComponent.map->wireframeMode)
                 {
@@ -84,6 +106,9 @@ namespace sg::city::renderer
         }
 
     private:
-
+        /**
+         * @brief The visible Chunks of the current frame.
+         */
+        map::Map::ChunkIndexContainer m_visibleChunks;
     };
 }
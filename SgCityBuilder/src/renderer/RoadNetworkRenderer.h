@@ -10,6 +10,8 @@
 #pragma once
 
 #include "shader/RoadNetworkShader.h"
+#include "city/Profiler.h"
+#include "city/Gpu.h"
 
 namespace sg::city::renderer
 {
@@ -33,6 +35,8 @@ namespace sg::city::renderer
 
         void Render() override
         {
+            SG_CITY_PROFILE_ZONE("RoadNetworkRenderer::Render");
+
             PrepareRendering();
 
             auto& shader{ m_scene->GetApplicationContext()->GetShaderManager().GetShaderProgram<shader::RoadNetworkShader>() };
@@ -47,11 +51,31 @@ namespace sg::city::renderer
             {
                 auto& roadNetworkComponent{ view.get<ecs::RoadNetworkComponent>(entity) };
 
+                auto& transformComponent{ view.get<ogl::ecs::component::TransformComponent>(entity) };
+
                 shader.UpdateUniforms(*m_scene, entity, roadNetworkComponent.roadNetwork->GetMesh());
 
-                roadNetworkComponent.roadNetwork->GetMesh().InitDraw();
-                roadNetworkComponent.roadNetwork->GetMesh().DrawPrimitives();
-                roadNetworkComponent.roadNetwork->GetMesh().EndDraw();
+                // the roads use the Chunks of the Map
+                const auto& map{ roadNetworkComponent.roadNetwork->GetCity()->GetMap() };
+
+                const auto projectionMatrix{ m_scene->GetApplicationContext()->GetWindow().GetProjectionMatrix() };
+                const auto mvp{ projectionMatrix * m_scene->GetCurrentCamera().GetViewMatrix() * static_cast<glm::mat4>(transformComponent) };
+                map.FindVisibleChunks(mvp, m_visibleChunks);
+
+                const auto& chunks{ map.GetChunks() };
+
+                gpu::Gpu::InitDraw(gpu::Source::ROADS, roadNetworkComponent.roadNetwork->GetMesh());
+                for (auto chunkIndex : m_visibleChunks)
+                {
+                    const auto& chunk{ chunks[chunkIndex] };
+
+                    shader.SetUniform("chunkOriginX", chunk.originX);
+                    shader.SetUniform("chunkOriginZ", chunk.originZ);
+                    shader.SetUniform("chunkWidth", chunk.width);
+
+                    gpu::Gpu::DrawInstanced(gpu::Source::ROADS, map::Map::VERTICES_PER_TILE, chunk.tileCount, chunk.firstSlot);
+                }
+                gpu::Gpu::EndDraw(gpu::Source::ROADS, roadNetworkComponent.roadNetwork->GetMesh());
             }
 
             ogl::resource::ShaderProgram::Unbind();
@@ -71,6 +95,9 @@ namespace sg::city::renderer
         }
 
     private:
-
+        /**
+         * @brief The visible Chunks of the current frame.
+         */
+        map::Map::ChunkIndexContainer m_visibleChunks;
     };
 }
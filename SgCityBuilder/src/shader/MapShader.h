@@ -36,6 +36,8 @@ namespace sg::city::shader
             SetUniform("directionalLight", t_scene.GetCurrentDirectionalLight());
 
             SetUniform("showRegionColor", mapComponent.map->showRegions);
+            SetUniform("hoveredTileX", mapComponent.map->hoveredTile.x);
+            SetUniform("hoveredTileZ", mapComponent.map->hoveredTile.y);
 
             SetUniform("tileTexture[0]", 0);
             SetUniform("tileTexture[1]", 1);
@@ -48,6 +50,9 @@ namespace sg::city::shader
             ogl::resource::TextureManager::BindForReading(mapComponent.map->GetTileTypeTextures().at(map::tile::TileType::COMMERCIAL), GL_TEXTURE2);
             ogl::resource::TextureManager::BindForReading(mapComponent.map->GetTileTypeTextures().at(map::tile::TileType::INDUSTRIAL), GL_TEXTURE3);
             ogl::resource::TextureManager::BindForReading(mapComponent.map->GetTileTypeTextures().at(map::tile::TileType::TRAFFIC), GL_TEXTURE4);
+
+            SetUniform("palette", 5);
+            ogl::resource::TextureManager::BindForReading(mapComponent.map->GetPaletteTextureId(), GL_TEXTURE5);
         }
 
         [[nodiscard]] std::string GetFolderName() const override
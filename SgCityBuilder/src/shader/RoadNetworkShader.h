@@ -28,6 +28,9 @@ namespace sg::city::shader
             SetUniform("cameraPosition", t_scene.GetCurrentCamera().GetPosition());
             SetUniform("directionalLight", t_scene.GetCurrentDirectionalLight());
 
+            SetUniform("roadHeight", map::RoadNetwork::ROAD_VERTICES_HEIGHT);
+            SetUniform("textureAtlasRows", map::RoadNetwork::TEXTURE_ATLAS_ROWS);
+
             SetUniform("roadTextureAtlas", 0);
             ogl::resource::TextureManager::BindForReading(roadNetworkComponent.roadNetwork->GetRoadTextureAtlasId(), GL_TEXTURE0);
         }
@@ -0,0 +1,198 @@
+// This file is part of the SgCityBuilder package.
+//
+// Filename: Demand.cpp
+// Author:   stwe
+//
+// License:  MIT
+//
+// 2020 (c) stwe <https://github.com/stwe/SgCityBuilder>
+
+#include <algorithm>
+#include <Core.h>
+#include "Demand.h"
+#include "PopulationGrowth.h"
+#include "city/Profiler.h"
+#include "city/ThreadPool.h"
+#include "map/Map.h"
+
+//-------------------------------------------------
+// Ctors. / Dtor.
+//-------------------------------------------------
+
+sg::city::simulation::Demand::Demand(const map::Map& t_map, const PopulationGrowth& t_populationGrowth)
+    : m_map{ &t_map }
+    , m_populationGrowth{ &t_populationGrowth }
+{
+    SG_OGL_LOG_DEBUG("[Demand::Demand()] Construct Demand.");
+}
+
+sg::city::simulation::Demand::~Demand() noexcept
+{
+    SG_OGL_LOG_DEBUG("[Demand::~Demand()] Destruct Demand.");
+}
+
+//-------------------------------------------------
+// Getter
+//-------------------------------------------------
+
+sg::city::simulation::RegionDemand sg::city::simulation::Demand::GetRegionDemand(const int t_region) const
+{
+    if (t_region < 0 || t_region >= static_cast<int>(m_regionDemands.size()))
+    {
+        return {};
+    }
+
+    return m_regionDemands[t_region];
+}
+
+const sg::city::simulation::RegionDemand& sg::city::simulation::Demand::GetCityDemand() const noexcept
+{
+    return m_cityDemand;
+}
+
+const sg::city::simulation::RegionStats& sg::city::simulation::Demand::GetCityStats() const noexcept
+{
+    return m_cityStats;
+}
+
+const sg::city::simulation::Demand::RegionStatsContainer& sg::city::simulation::Demand::GetRegionStats() const noexcept
+{
+    return m_regionStats;
+}
+
+//-------------------------------------------------
+// Logic
+//-------------------------------------------------
+
+void sg::city::simulation::Demand::Update(const uint64_t t_tick)
+{
+    if (t_tick % UPDATE_INTERVAL == 0)
+    {
+        Calc();
+    }
+}
+
+void sg::city::simulation::Demand::Calc()
+{
+    SG_CITY_PROFILE_ZONE("Demand::Calc");
+
+    const auto nrOfAllTiles{ static_cast<uint32_t>(m_map->GetNrOfAllTiles()) };
+    const auto nrOfRegionSlots{ static_cast<size_t>(m_map->GetMaxRegionId()) + 1 };
+
+    // the bands depend only on the Map size, so the partial sums are always merged in the same order
+    const auto bands{ std::clamp(nrOfAllTiles / MIN_TILES_PER_BAND, 1u, MAX_BANDS) };
+    const auto tilesPerBand{ (nrOfAllTiles + bands - 1) / bands };
+
+    m_bandStats.resize(bands);
+    for (auto& stats : m_bandStats)
+    {
+        stats.assign(nrOfRegionSlots, RegionStats());
+    }
+
+    // the pool only decides which thread reduces which band
+    thread::ThreadPool::Get().ParallelFor(0, static_cast<int>(bands), 1, [&](const int t_bandBegin, const int t_bandEnd)
+    {
+        for (auto band{ t_bandBegin }; band < t_bandEnd; ++band)
+        {
+            const auto begin{ std::min(static_cast<uint32_t>(band) * tilesPerBand, nrOfAllTiles) };
+            const auto end{ std::min(begin + tilesPerBand, nrOfAllTiles) };
+
+            ReduceRange(begin, end, m_bandStats[band]);
+        }
+    });
+
+    // merge
+    m_regionStats.assign(nrOfRegionSlots, RegionStats());
+    m_cityStats = RegionStats();
+
+    for (const auto& stats : m_bandStats)
+    {
+        for (auto region{ 0u }; region < nrOfRegionSlots; ++region)
+        {
+            m_regionStats[region] += stats[region];
+        }
+    }
+
+    m_regionDemands.resize(nrOfRegionSlots);
+    for (auto region{ 0u }; region < nrOfRegionSlots; ++region)
+    {
+        m_regionDemands[region] = CalcDemand(m_regionStats[region]);
+        m_cityStats += m_regionStats[region];
+    }
+
+    m_cityDemand = CalcDemand(m_cityStats);
+
+    SG_CITY_PROFILE_COUNTER("Demand regions", nrOfRegionSlots - 1);
+}
+
+//-------------------------------------------------
+// Helper
+//-------------------------------------------------
+
+sg::city::simulation::RegionDemand sg::city::simulation::Demand::CalcDemand(const RegionStats& t_stats)
+{
+    const auto residents{ static_cast<float>(t_stats.residents) / POPULATION_SCALE };
+    const auto shopJobs{ static_cast<float>(t_stats.commercialTiles) * JOBS_PER_COMMERCIAL_TILE };
+    const auto factoryJobs{ static_cast<float>(t_stats.industrialTiles) * JOBS_PER_INDUSTRIAL_TILE };
+
+    const auto jobs{ shopJobs + factoryJobs };
+    const auto workforce{ residents * WORKFORCE_RATIO };
+    const auto wantedShopJobs{ residents * COMMERCE_PER_RESIDENT };
+    const auto wantedFactoryJobs{ residents * INDUSTRY_PER_RESIDENT };
+
+    // (wanted - existing) / max(wanted, existing) is in the range [-1, 1]
+    const auto balance = [](const float t_wanted, const float t_existing)
+    {
+        const auto norm{ std::max(std::max(t_wanted, t_existing), 1.0f) };
+        return std::clamp((t_wanted - t_existing) / norm, -1.0f, 1.0f);
+    };
+
+    RegionDemand demand;
+    demand.residential = balance(jobs, workforce);
+    demand.commercial = balance(wantedShopJobs, shopJobs);
+    demand.industrial = balance(wantedFactoryJobs, factoryJobs);
+
+    return demand;
+}
+
+void sg::city::simulation::Demand::ReduceRange(const uint32_t t_begin, const uint32_t t_end, RegionStatsContainer& t_stats) const
+{
+    SG_CITY_PROFILE_ZONE("Demand::ReduceRange");
+
+    const auto& populationGrowth{ *m_populationGrowth };
+    const auto& types{ populationGrowth.GetTypes() };
+    const auto& population{ populationGrowth.GetPopulation() };
+    const auto& regions{ populationGrowth.GetRegions() };
+
+    const auto maxRegion{ static_cast<int>(t_stats.size()) - 1 };
+
+    for (auto i{ t_begin }; i < t_end; ++i)
+    {
+        const auto region{ regions[i] };
+        if (region > maxRegion)
+        {
+            continue;
+        }
+
+        auto& stats{ t_stats[region] };
+
+        switch (static_cast<map::tile::TileType>(types[i]))
+        {
+        case map::tile::TileType::RESIDENTIAL:
+            stats.residentialTiles++;
+            stats.residents += static_cast<uint64_t>(population[i] * POPULATION_SCALE);
+            break;
+        case map::tile::TileType::COMMERCIAL:
+            stats.commercialTiles++;
+            break;
+        case map::tile::TileType::INDUSTRIAL:
+            stats.industrialTiles++;
+            break;
+        case map::tile::TileType::TRAFFIC:
+            stats.trafficTiles++;
+            break;
+        default:
+            break;
+        }
+    }
+}
@@ -0,0 +1,190 @@
+// This file is part of the SgCityBuilder package.
+//
+// Filename: Demand.h
+// Author:   stwe
+//
+// License:  MIT
+//
+// 2020 (c) stwe <https://github.com/stwe/SgCityBuilder>
+
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+namespace sg::city::map
+{
+    class Map;
+}
+
+namespace sg::city::simulation
+{
+    class PopulationGrowth;
+
+    /**
+     * @brief The aggregated values of all Tiles of a region.
+     *        Only integers, so the parallel sum does not depend on the order.
+     */
+    struct RegionStats
+    {
+        uint64_t residents{ 0 }; // fixed point: population * Demand::POPULATION_SCALE
+        uint32_t residentialTiles{ 0 };
+        uint32_t commercialTiles{ 0 };
+        uint32_t industrialTiles{ 0 };
+        uint32_t trafficTiles{ 0 };
+
+        RegionStats& operator+=(const RegionStats& t_other)
+        {
+            residents += t_other.residents;
+            residentialTiles += t_other.residentialTiles;
+            commercialTiles += t_other.commercialTiles;
+            industrialTiles += t_other.industrialTiles;
+            trafficTiles += t_other.trafficTiles;
+
+            return *this;
+        }
+    };
+
+    /**
+     * @brief The RCI demand in the range [-1, 1]. Positive values mean more of this zone is wanted.
+     */
+    struct RegionDemand
+    {
+        float residential{ 0.0f };
+        float commercial{ 0.0f };
+        float industrial{ 0.0f };
+    };
+
+    /**
+     * @brief The residential, commercial and industrial demand of each region and of the whole City.
+     *        The Tiles are reduced in parallel: each worker sums a fixed range of Tiles into its own stats.
+     *        The cost is reported in the profiler and in the Subsystem::DEMAND history of the City.
+     */
+    class Demand
+    {
+    public:
+        using RegionStatsContainer = std::vector<RegionStats>;
+        using RegionDemandContainer = std::vector<RegionDemand>;
+
+        //-------------------------------------------------
+        // Const
+        //-------------------------------------------------
+
+        /**
+         * @brief The demand is updated once in this number of ticks.
+         */
+        static constexpr uint64_t UPDATE_INTERVAL{ 8 };
+
+        /**
+         * @brief Below this number of Tiles per band, more bands do not pay off.
+         */
+        static constexpr uint32_t MIN_TILES_PER_BAND{ 65536 };
+
+        static constexpr uint32_t MAX_BANDS{ 8 };
+
+        static constexpr auto POPULATION_SCALE{ 16.0f };
+
+        static constexpr auto JOBS_PER_COMMERCIAL_TILE{ 20.0f };
+        static constexpr auto JOBS_PER_INDUSTRIAL_TILE{ 30.0f };
+
+        /**
+         * @brief The part of the residents looking for a job.
+         */
+        static constexpr auto WORKFORCE_RATIO{ 0.5f };
+
+        /**
+         * @brief The number of shop jobs each resident can support.
+         */
+        static constexpr auto COMMERCE_PER_RESIDENT{ 0.2f };
+
+        /**
+         * @brief The number of factory jobs each resident can support.
+         */
+        static constexpr auto INDUSTRY_PER_RESIDENT{ 0.3f };
+
+        //-------------------------------------------------
+        // Ctors. / Dtor.
+        //-------------------------------------------------
+
+        Demand() = delete;
+
+        Demand(const map::Map& t_map, const PopulationGrowth& t_populationGrowth);
+
+        Demand(const Demand& t_other) = delete;
+        Demand(Demand&& t_other) noexcept = delete;
+        Demand& operator=(const Demand& t_other) = delete;
+        Demand& operator=(Demand&& t_other) noexcept = delete;
+
+        ~Demand() noexcept;
+
+        //-------------------------------------------------
+        // Getter
+        //-------------------------------------------------
+
+        /**
+         * @brief Returns the demand of a region. A neutral demand for unknown regions.
+         * @param t_region The region Id.
+         * @return RegionDemand
+         */
+        [[nodiscard]] RegionDemand GetRegionDemand(int t_region) const;
+
+        [[nodiscard]] const RegionDemand& GetCityDemand() const noexcept;
+        [[nodiscard]] const RegionStats& GetCityStats() const noexcept;
+        [[nodiscard]] const RegionStatsContainer& GetRegionStats() const noexcept;
+
+        //-------------------------------------------------
+        // Logic
+        //-------------------------------------------------
+
+        /**
+         * @brief Recalculates the demand every UPDATE_INTERVAL ticks.
+         * @param t_tick The current simulation tick.
+         */
+        void Update(uint64_t t_tick);
+
+        /**
+         * @brief Recalculates the demand now.
+         */
+        void Calc();
+
+        //-------------------------------------------------
+        // Helper
+        //-------------------------------------------------
+
+        [[nodiscard]] static RegionDemand CalcDemand(const RegionStats& t_stats);
+
+    protected:
+
+    private:
+        const map::Map* m_map{ nullptr };
+
+        /**
+         * @brief The dense Tile arrays the demand is reduced from.
+         */
+        const PopulationGrowth* m_populationGrowth{ nullptr };
+
+        /**
+         * @brief The partial stats of each band. Reused, so a Calc() does not allocate.
+         */
+        std::vector<RegionStatsContainer> m_bandStats;
+
+        /**
+         * @brief The stats of each region. Index 0 holds the Tiles without region.
+         */
+        RegionStatsContainer m_regionStats;
+
+        /**
+         * @brief The demand of each region.
+         */
+        RegionDemandContainer m_regionDemands;
+
+        RegionStats m_cityStats;
+        RegionDemand m_cityDemand;
+
+        //-------------------------------------------------
+        // Helper
+        //-------------------------------------------------
+
+        void ReduceRange(uint32_t t_begin, uint32_t t_end, RegionStatsContainer& t_stats) const;
+    };
+}
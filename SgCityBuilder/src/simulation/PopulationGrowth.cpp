@@ -0,0 +1,336 @@
+// This file is part of the SgCityBuilder package.
+// 
+// Filename: PopulationGrowth.cpp
+// Author:   stwe
+// 
+// License:  MIT
+// 
+// 2020 (c) stwe <https://github.com/stwe/SgCityBuilder>
+
+#include <algorithm>
+#include <Core.h>
+#include "PopulationGrowth.h"
+#include "Demand.h"
+#include "city/Random.h"
+#include "city/Profiler.h"
+#include "city/SaveGame.h"
+#include "map/Map.h"
+#include "map/BuildingGenerator.h"
+
+//-------------------------------------------------
+// Ctors. / Dtor.
+//-------------------------------------------------
+
+sg::city::simulation::PopulationGrowth::PopulationGrowth(const map::Map& t_map, const random::Random& t_random)
+    : m_map{ &t_map }
+    , m_random{ &t_random }
+{
+    SG_OGL_LOG_DEBUG("[PopulationGrowth::PopulationGrowth()] Construct PopulationGrowth.");
+}
+
+sg::city::simulation::PopulationGrowth::~PopulationGrowth() noexcept
+{
+    SG_OGL_LOG_DEBUG("[PopulationGrowth::~PopulationGrowth()] Destruct PopulationGrowth.");
+}
+
+//-------------------------------------------------
+// Getter
+//-------------------------------------------------
+
+float sg::city::simulation::PopulationGrowth::GetTotalPopulation() const
+{
+    auto total{ 0.0f };
+    for (auto tileIndex : m_residentialIndices)
+    {
+        total += m_population[tileIndex];
+    }
+
+    return total;
+}
+
+uint32_t sg::city::simulation::PopulationGrowth::GetResidentialTiles() const
+{
+    return static_cast<uint32_t>(m_residentialIndices.size());
+}
+
+uint32_t sg::city::simulation::PopulationGrowth::GetLastUpdatedTiles() const
+{
+    return m_lastUpdatedTiles;
+}
+
+const sg::city::simulation::PopulationGrowth::TypeContainer& sg::city::simulation::PopulationGrowth::GetTypes() const noexcept
+{
+    return m_types;
+}
+
+const sg::city::simulation::PopulationGrowth::PopulationContainer& sg::city::simulation::PopulationGrowth::GetPopulation() const noexcept
+{
+    return m_population;
+}
+
+const sg::city::simulation::PopulationGrowth::RegionContainer& sg::city::simulation::PopulationGrowth::GetRegions() const noexcept
+{
+    return m_regions;
+}
+
+const sg::city::simulation::PopulationGrowth::FloorContainer& sg::city::simulation::PopulationGrowth::GetFloors() const noexcept
+{
+    return m_floors;
+}
+
+const sg::city::simulation::PopulationGrowth::TileIndexContainer& sg::city::simulation::PopulationGrowth::GetChangedFloors() const noexcept
+{
+    return m_changedFloors;
+}
+
+//-------------------------------------------------
+// Logic
+//-------------------------------------------------
+
+void sg::city::simulation::PopulationGrowth::Init()
+{
+    SG_OGL_LOG_DEBUG("[PopulationGrowth::Init()] Initialize PopulationGrowth.");
+
+    ReadTiles();
+
+    // give the existing buildings a start population
+    m_changedFloors.clear();
+    for (auto tileIndex : m_residentialIndices)
+    {
+        auto randomStream{ m_random->.GetStream(random::Domain::GROWTH, tileIndex, 0) };
+        const auto population{ m_roadAccess[tileIndex] ? randomStream.NextFloat(0.0f, MAX_INITIAL_POPULATION) : 0.0f };
+
+        ApplyPopulation(tileIndex, population);
+    }
+}
+
+void sg::city::simulation::PopulationGrowth::Restore(const save::SaveData& t_saveData)
+{
+    SG_OGL_LOG_DEBUG("[PopulationGrowth::Restore()] Restore PopulationGrowth.");
+
+    ReadTiles();
+
+    // the buildings already have their saved floors
+    for (const auto& building : t_saveData.buildings)
+    {
+        m_population[building.tileIndex] = building.population;
+        m_floors[building.tileIndex] = building.floors;
+    }
+}
+
+void sg::city::simulation::PopulationGrowth::OnTileChanged(const int t_tileIndex)
+{
+    RemoveResidential(t_tileIndex);
+    ReadTile(t_tileIndex);
+
+    // a new or removed road changes the access of the neighbours
+    const auto mapX{ t_tileIndex % m_mapSize };
+    const auto mapZ{ t_tileIndex / m_mapSize };
+
+    UpdateRoadAccess(t_tileIndex);
+    if (mapX > 0)             UpdateRoadAccess(t_tileIndex - 1);
+    if (mapX < m_mapSize - 1) UpdateRoadAccess(t_tileIndex + 1);
+    if (mapZ > 0)             UpdateRoadAccess(t_tileIndex - m_mapSize);
+    if (mapZ < m_mapSize - 1) UpdateRoadAccess(t_tileIndex + m_mapSize);
+}
+
+void sg::city::simulation::PopulationGrowth::ReadRegions()
+{
+    const auto& tiles{ m_map->GetTiles() };
+
+    for (const auto tileIndex : m_map->GetRelabelledTiles())
+    {
+        m_regions[tileIndex] = tiles[tileIndex]->region;
+    }
+}
+
+void sg::city::simulation::PopulationGrowth::Update(const uint64_t t_tick, const Demand& t_demand)
+{
+    SG_CITY_PROFILE_ZONE("PopulationGrowth::Update");
+
+    m_lastUpdatedTiles = 0;
+    m_changedFloors.clear();
+
+    const auto residentialTiles{ GetResidentialTiles() };
+    if (residentialTiles == 0)
+    {
+        return;
+    }
+
+    const auto tilesPerTick{ std::min((residentialTiles + STAGGER_TICKS - 1) / STAGGER_TICKS, MAX_TILES_PER_TICK) };
+    const auto maxPopulation{ static_cast<float>(map::tile::Tile::MAX_POPULATION) };
+
+    for (auto i{ 0u }; i < tilesPerTick; ++i)
+    {
+        if (m_cursor >= residentialTiles)
+        {
+            m_cursor = 0;
+        }
+
+        const auto tileIndex{ m_residentialIndices[m_cursor++] };
+        const auto population{ m_population[tileIndex] };
+
+        auto newPopulation{ population };
+        if (m_roadAccess[tileIndex])
+        {
+            auto randomStream{ m_random->GetStream(random::Domain::GROWTH, tileIndex, t_tick) };
+
+            // logistic growth: slows down near the maximum
+            auto growth{ BASE_GROWTH * (1.0f + DENSITY_BONUS * CalcNeighbourDensity(tileIndex)) };
+            if (m_regions[tileIndex] != map::tile::Tile::NO_REGION)
+            {
+                growth *= REGION_BONUS;
+            }
+
+            // more jobs than workers in the region attract residents
+            growth *= 1.0f + DEMAND_WEIGHT * t_demand.GetRegionDemand(m_regions[tileIndex]).residential;
+
+            newPopulation += growth * randomStream.NextFloat(0.5f, 1.5f) * (1.0f - population / maxPopulation);
+        }
+        else
+        {
+            newPopulation -= DECLINE;
+        }
+
+        newPopulation = std::clamp(newPopulation, 0.0f, maxPopulation);
+
+        ApplyPopulation(tileIndex, newPopulation);
+    }
+
+    m_lastUpdatedTiles = tilesPerTick;
+}
+
+//-------------------------------------------------
+// Helper
+//-------------------------------------------------
+
+uint32_t sg::city::simulation::PopulationGrowth::FloorsForPopulation(const float t_population)
+{
+    const auto maxFloors{ map::BuildingGenerator::MAX_FLOORS };
+    const auto upperFloors{ static_cast<uint32_t>(t_population / static_cast<float>(map::tile::Tile::MAX_POPULATION) * static_cast<float>(maxFloors - 1)) };
+
+    return std::min(1 + upperFloors, maxFloors);
+}
+
+void sg::city::simulation::PopulationGrowth::ReadTiles()
+{
+    m_mapSize = m_map->GetMapSize();
+    const auto nrOfAllTiles{ static_cast<size_t>(m_map->GetNrOfAllTiles()) };
+
+    m_types.assign(nrOfAllTiles, static_cast<uint8_t>(map::tile::TileType::NONE));
+    m_roadAccess.assign(nrOfAllTiles, 0);
+    m_population.assign(nrOfAllTiles, 0.0f);
+    m_floors.assign(nrOfAllTiles, 0);
+    m_regions.assign(nrOfAllTiles, map::tile::Tile::NO_REGION);
+    m_residentialSlots.assign(nrOfAllTiles, -1);
+    m_residentialIndices.clear();
+    m_cursor = 0;
+
+    for (auto i{ 0 }; i < static_cast<int>(nrOfAllTiles); ++i)
+    {
+        ReadTile(i);
+    }
+
+    for (auto i{ 0 }; i < static_cast<int>(nrOfAllTiles); ++i)
+    {
+        UpdateRoadAccess(i);
+    }
+}
+
+void sg::city::simulation::PopulationGrowth::ReadTile(const int t_tileIndex)
+{
+    const auto& tile{ *m_map->GetTiles()[t_tileIndex] };
+
+    // a replaced Tile starts without residents; a new building has only the ground floor
+    m_types[t_tileIndex] = static_cast<uint8_t>(tile.type);
+    m_population[t_tileIndex] = 0.0f;
+    m_floors[t_tileIndex] = 0;
+    m_regions[t_tileIndex] = tile.region;
+
+    if (tile.type == map::tile::TileType::RESIDENTIAL)
+    {
+        m_floors[t_tileIndex] = static_cast<uint8_t>(FloorsForPopulation(0.0f));
+        AddResidential(t_tileIndex);
+    }
+}
+
+void sg::city::simulation::PopulationGrowth::UpdateRoadAccess(const int t_tileIndex)
+{
+    const auto mapX{ t_tileIndex % m_mapSize };
+    const auto mapZ{ t_tileIndex / m_mapSize };
+
+    m_roadAccess[t_tileIndex] = IsRoad(mapX - 1, mapZ) || IsRoad(mapX + 1, mapZ) || IsRoad(mapX, mapZ - 1) || IsRoad(mapX, mapZ + 1);
+}
+
+void sg::city::simulation::PopulationGrowth::AddResidential(const int t_tileIndex)
+{
+    if (m_residentialSlots[t_tileIndex] >= 0)
+    {
+        return;
+    }
+
+    m_residentialSlots[t_tileIndex] = static_cast<int>(m_residentialIndices.size());
+    m_residentialIndices.push_back(t_tileIndex);
+}
+
+void sg::city::simulation::PopulationGrowth::RemoveResidential(const int t_tileIndex)
+{
+    const auto slot{ m_residentialSlots[t_tileIndex] };
+    if (slot < 0)
+    {
+        return;
+    }
+
+    // swap-remove; the moved Tile may skip one round
+    const auto lastTileIndex{ m_residentialIndices.back() };
+    m_residentialIndices[slot] = lastTileIndex;
+    m_residentialSlots[lastTileIndex] = slot;
+
+    m_residentialIndices.pop_back();
+    m_residentialSlots[t_tileIndex] = -1;
+}
+
+float sg::city::simulation::PopulationGrowth::CalcNeighbourDensity(const int t_tileIndex) const
+{
+    const auto mapX{ t_tileIndex % m_mapSize };
+    const auto mapZ{ t_tileIndex / m_mapSize };
+
+    auto sum{ 0.0f };
+    for (auto z{ std::max(mapZ - 1, 0) }; z <= std::min(mapZ + 1, m_mapSize - 1); ++z)
+    {
+        for (auto x{ std::max(mapX - 1, 0) }; x <= std::min(mapX + 1, m_mapSize - 1); ++x)
+        {
+            const auto index{ z * m_mapSize + x };
+            if (index != t_tileIndex && m_types[index] == static_cast<uint8_t>(map::tile::TileType::RESIDENTIAL))
+            {
+                sum += m_population[index];
+            }
+        }
+    }
+
+    // 0 .. 1: all 8 neighbours at the maximum population
+    return sum / (8.0f * static_cast<float>(map::tile::Tile::MAX_POPULATION));
+}
+
+bool sg::city::simulation::PopulationGrowth::IsRoad(const int t_mapX, const int t_mapZ) const
+{
+    if (t_mapX < 0 || t_mapZ < 0 || t_mapX >= m_mapSize || t_mapZ >= m_mapSize)
+    {
+        return false;
+    }
+
+    return m_types[t_mapZ * m_mapSize + t_mapX] == static_cast<uint8_t>(map::tile::TileType::TRAFFIC);
+}
+
+void sg::city::simulation::PopulationGrowth::ApplyPopulation(const int t_tileIndex, const float t_population)
+{
+    m_population[t_tileIndex] = t_population;
+
+    // only a changed floor count touches the building instances
+    const auto floors{ static_cast<uint8_t>(FloorsForPopulation(t_population)) };
+    if (m_floors[t_tileIndex] != floors)
+    {
+        m_floors[t_tileIndex] = floors;
+        m_changedFloors.push_back(t_tileIndex);
+    }
+}
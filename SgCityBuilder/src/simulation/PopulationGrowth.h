@@ -0,0 +1,265 @@
+// This file is part of the SgCityBuilder package.
+// 
+// Filename: PopulationGrowth.h
+// Author:   stwe
+// 
+// License:  MIT
+// 
+// 2020 (c) stwe <https://github.com/stwe/SgCityBuilder>
+
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+namespace sg::city::map
+{
+    class Map;
+}
+
+namespace sg::city::random
+{
+    class Random;
+}
+
+namespace sg::city::save
+{
+    struct SaveData;
+}
+
+namespace sg::city::simulation
+{
+    class Demand;
+
+    /**
+     * @brief Grows and shrinks the population of the residential Tiles.
+     *        Only a fixed fraction of the Tiles is updated per tick (round-robin),
+     *        so the cost per tick does not depend on the size of the City.
+     *        All inputs and the population and floors are kept in dense arrays indexed by the Tile index;
+     *        The Tiles whose number of floors changed are collected for the buildings; no Gpu is needed.
+     */
+    class PopulationGrowth
+    {
+    public:
+        using TypeContainer = std::vector<uint8_t>;
+        using PopulationContainer = std::vector<float>;
+        using FloorContainer = std::vector<uint8_t>;
+        using RegionContainer = std::vector<int>;
+        using TileIndexContainer = std::vector<int>;
+
+        //-------------------------------------------------
+        // Const
+        //-------------------------------------------------
+
+        /**
+         * @brief Each residential Tile is updated once in this number of ticks.
+         */
+        static constexpr uint32_t STAGGER_TICKS{ 16 };
+
+        /**
+         * @brief The upper limit of Tiles updated per tick.
+         */
+        static constexpr uint32_t MAX_TILES_PER_TICK{ 65536 };
+
+        /**
+         * @brief The growth per update of a Tile with road access.
+         */
+        static constexpr auto BASE_GROWTH{ 2.0f };
+
+        /**
+         * @brief The loss per update of a Tile without road access.
+         */
+        static constexpr auto DECLINE{ 1.5f };
+
+        /**
+         * @brief Dense neighbourhoods grow faster: up to (1 + DENSITY_BONUS) times.
+         */
+        static constexpr auto DENSITY_BONUS{ 1.0f };
+
+        /**
+         * @brief Tiles that belong to a region grow a little faster.
+         */
+        static constexpr auto REGION_BONUS{ 1.25f };
+
+        /**
+         * @brief The upper limit of the random start population of an existing Tile.
+         */
+        static constexpr auto MAX_INITIAL_POPULATION{ 25.0f };
+
+        /**
+         * @brief How strong the residential demand of the region changes the growth: 1 +- DEMAND_WEIGHT.
+         */
+        static constexpr auto DEMAND_WEIGHT{ 0.5f };
+
+        //-------------------------------------------------
+        // Ctors. / Dtor.
+        //-------------------------------------------------
+
+        PopulationGrowth() = delete;
+
+        PopulationGrowth(const map::Map& t_map, const random::Random& t_random);
+
+        PopulationGrowth(const PopulationGrowth& t_other) = delete;
+        PopulationGrowth(PopulationGrowth&& t_other) noexcept = delete;
+        PopulationGrowth& operator=(const PopulationGrowth& t_other) = delete;
+        PopulationGrowth& operator=(PopulationGrowth&& t_other) noexcept = delete;
+
+        ~PopulationGrowth() noexcept;
+
+        //-------------------------------------------------
+        // Getter
+        //-------------------------------------------------
+
+        [[nodiscard]] float GetTotalPopulation() const;
+        [[nodiscard]] uint32_t GetResidentialTiles() const;
+
+        /**
+         * @brief Returns the number of Tiles updated by the last call of Update().
+         * @return uint32_t
+         */
+        [[nodiscard]] uint32_t GetLastUpdatedTiles() const;
+
+        [[nodiscard]] const TypeContainer& GetTypes() const noexcept;
+        [[nodiscard]] const PopulationContainer& GetPopulation() const noexcept;
+        [[nodiscard]] const RegionContainer& GetRegions() const noexcept;
+
+        /**
+         * @brief The number of floors each Tile should have, including the ground floor; 0 if the Tile is not residential.
+         * @return FloorContainer
+         */
+        [[nodiscard]] const FloorContainer& GetFloors() const noexcept;
+
+        /**
+         * @brief The Tiles whose number of floors was changed by the last Init() or Update().
+         * @return TileIndexContainer
+         */
+        [[nodiscard]] const TileIndexContainer& GetChangedFloors() const noexcept;
+
+        //-------------------------------------------------
+        // Logic
+        //-------------------------------------------------
+
+        /**
+         * @brief Reads all Tiles into the dense arrays and gives the existing buildings a start population.
+         *        Must be called after the buildings were created.
+         */
+        void Init();
+
+        /**
+         * @brief Reads all Tiles of a restored City and the saved population of the buildings.
+         *        The round-robin starts again with the first residential Tile.
+         * @param t_saveData The saved City.
+         */
+        void Restore(const save::SaveData& t_saveData);
+
+        /**
+         * @brief Must be called for each replaced Tile.
+         * @param t_tileIndex The index of the replaced Tile.
+         */
+        void OnTileChanged(int t_tileIndex);
+
+        /**
+         * @brief Must be called after the regions of the Map were changed.
+         *        Reads only the Tiles relabelled by the last Map::FindConnectedRegions().
+         */
+        void ReadRegions();
+
+        /**
+         * @brief Updates the next batch of residential Tiles and collects the Tiles with new floors.
+         * @param t_tick The current simulation tick.
+         * @param t_demand The demand of the regions.
+         */
+        void Update(uint64_t t_tick, const Demand& t_demand);
+
+        //-------------------------------------------------
+        // Helper
+        //-------------------------------------------------
+
+        /**
+         * @brief Maps a population to the number of floors, including the ground floor.
+         * @param t_population The population of a Tile.
+         * @return uint32_t
+         */
+        [[nodiscard]] static uint32_t FloorsForPopulation(float t_population);
+
+    protected:
+
+    private:
+        const map::Map* m_map{ nullptr };
+        const random::Random* m_random{ nullptr };
+
+        /**
+         * @brief The Map size in one direction.
+         */
+        int m_mapSize{ 0 };
+
+        /**
+         * @brief The TileType of each Tile.
+         */
+        TypeContainer m_types;
+
+        /**
+         * @brief 1 if the Tile has a road as direct neighbour.
+         */
+        TypeContainer m_roadAccess;
+
+        /**
+         * @brief The population of each Tile.
+         */
+        PopulationContainer m_population;
+
+        /**
+         * @brief The region of each Tile.
+         */
+        RegionContainer m_regions;
+
+        /**
+         * @brief The number of floors of each residential Tile for its population.
+         */
+        FloorContainer m_floors;
+
+        /**
+         * @brief The Tiles whose number of floors has changed. Reused, so an update does not allocate.
+         */
+        TileIndexContainer m_changedFloors;
+
+        /**
+         * @brief The indices of all residential Tiles. The order of the round-robin.
+         */
+        TileIndexContainer m_residentialIndices;
+
+        /**
+         * @brief The position of each Tile in m_residentialIndices or -1.
+         */
+        TileIndexContainer m_residentialSlots;
+
+        /**
+         * @brief The position of the next Tile to update in m_residentialIndices.
+         */
+        uint32_t m_cursor{ 0 };
+
+        /**
+         * @brief The number of Tiles updated by the last call of Update().
+         */
+        uint32_t m_lastUpdatedTiles{ 0 };
+
+        //-------------------------------------------------
+        // Helper
+        //-------------------------------------------------
+
+        /**
+         * @brief Reads all Tiles into the dense arrays.
+         */
+        void ReadTiles();
+
+        void ReadTile(int t_tileIndex);
+        void UpdateRoadAccess(int t_tileIndex);
+        void AddResidential(int t_tileIndex);
+        void RemoveResidential(int t_tileIndex);
+
+        [[nodiscard]] float CalcNeighbourDensity(int t_tileIndex) const;
+        [[nodiscard]] bool IsRoad(int t_mapX, int t_mapZ) const;
+
+        void ApplyPopulation(int t_tileIndex, float t_population);
+    };
+}
@@ -52,6 +52,86 @@ project "SgCityBuilder"
         "/IGNORE:4099"
     }
 
+    filter "system:windows"
+        systemversion "latest"
+
+    filter "configurations:Debug"
+        defines
+        {
+            "SG_OGL_DEBUG_BUILD",
+            "SG_CITY_DEBUG_BUILD",
+            "ENABLE_ALLOCATION_TRACKING"
+        }
+        runtime "Debug"
+        symbols "On"
+        libdirs
+        {
+            "bin/" .. outputdir .. "/SgOglLib/",
+        }
+
+    filter "configurations:Release"
+        runtime "Release"
+        optimize "On"
+        libdirs
+        {
+            "bin/" .. outputdir .. "/SgOglLib/",
+        }
+
+project "SgCityBenchmark"
+    location "SgCityBenchmark"
+    architecture "x64"
+    kind "ConsoleApp"
+    language "C++"
+    cppdialect "C++17"
+
+    targetdir ("bin/" .. outputdir .. "/%{prj.name}")
+    objdir ("obj/" .. outputdir .. "/%{prj.name}")
+
+    linkoptions { conan_exelinkflags }
+
+    files
+    {
+        "%{prj.name}/src/**.h",
+        "%{prj.name}/src/**.cpp",
+        "SgCityBuilder/src/**.h",
+        "SgCityBuilder/src/**.cpp"
+    }
+
+    removefiles
+    {
+        "SgCityBuilder/src/CityApplication.cpp"
+    }
+
+    includedirs
+    {
+        "%{prj.name}/src",
+        "SgCityBuilder/src",
+        "SgOglLib/SgOglLib/src",
+        "SgOglLib/SgOglLib/src/SgOglLib",
+    }
+
+    links
+    {
+        "SgOglLib"
+    }
+
+    linkoptions
+    {
+        "/IGNORE:4099"
+    }
+
+    -- the steady-state allocation checks need the counting operator new
+    defines
+    {
+        "ENABLE_ALLOCATION_TRACKING"
+    }
+
+    -- the checks exit with a non-zero code if one fails, which fails the build
+    postbuildcommands
+    {
+        "\"%{cfg.buildtarget.abspath}\" checks"
+    }
+
     filter "system:windows"
         systemversion "latest"
 